@@ -67,6 +67,8 @@ hk_device_init_meta(struct hk_device *dev)
       dev->meta.buffer_access.optimal_wg_size[i] = 64;
    }
 
+   vk_meta_device_enable_persistence(&dev->vk, &dev->meta);
+
    return VK_SUCCESS;
 }
 
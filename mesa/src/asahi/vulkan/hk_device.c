@@ -474,6 +474,8 @@ hk_CreateDevice(VkPhysicalDevice physicalDevice,
    util_dynarray_init(&dev->external_bos.counts, NULL);
    util_dynarray_init(&dev->external_bos.list, NULL);
 
+   vk_meta_device_start_warm_up(&dev->vk, &dev->meta);
+
    return VK_SUCCESS;
 
 fail_mem_cache:
@@ -0,0 +1,69 @@
+/*
+ * Copyright 2025 Mesa3D authors
+ * SPDX-License-Identifier: MIT
+ */
+
+/*
+ * Lookups of existing array and struct types from several threads, as
+ * happens when shaders are compiled concurrently.  Prints the time per
+ * lookup for each thread count, which stays flat as long as the lookups
+ * don't contend on a lock.
+ *
+ * Usage: ./glsl_types_bench [lookups per thread]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <thread>
+#include <vector>
+
+#include "compiler/glsl_types.h"
+#include "util/os_time.h"
+
+#define NUM_TYPES 64
+
+static void
+lookup_types(unsigned count)
+{
+   const glsl_struct_field fields[2] = {
+      glsl_struct_field(&glsl_type_builtin_float, "a"),
+      glsl_struct_field(&glsl_type_builtin_vec4, "b"),
+   };
+
+   for (unsigned i = 0; i < count; i++) {
+      glsl_array_type(&glsl_type_builtin_vec4, i % NUM_TYPES + 1, 0);
+      glsl_struct_type(fields, 2, "s", false);
+   }
+}
+
+int
+main(int argc, char **argv)
+{
+   unsigned count = argc > 1 ? atoi(argv[1]) : 1000000;
+
+   glsl_type_singleton_init_or_ref();
+
+   /* Intern the types up front, only lookups are timed. */
+   lookup_types(NUM_TYPES);
+
+   for (unsigned num_threads = 1; num_threads <= 8; num_threads *= 2) {
+      std::vector<std::thread> threads;
+
+      int64_t start = os_time_get_nano();
+      for (unsigned t = 0; t < num_threads; t++)
+         threads.emplace_back(lookup_types, count);
+      for (std::thread &thread : threads)
+         thread.join();
+      int64_t end = os_time_get_nano();
+
+      /* Each iteration does an array and a struct lookup. */
+      printf("%u threads: %8.2f ms, %6.1f ns per lookup per thread\n",
+             num_threads, (end - start) / 1e6,
+             (double)(end - start) / (2.0 * count));
+   }
+
+   glsl_type_singleton_decref();
+
+   return 0;
+}
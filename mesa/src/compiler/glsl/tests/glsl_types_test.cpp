@@ -0,0 +1,127 @@
+/*
+ * Copyright 2025 Mesa3D authors
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+#include "compiler/glsl_types.h"
+
+namespace {
+
+#define NUM_THREADS 8
+#define NUM_TYPES 512
+#define NUM_ROUNDS 20
+
+struct interned_types {
+   const glsl_type *arrays[NUM_TYPES];
+   const glsl_type *structs[NUM_TYPES];
+   const glsl_type *interfaces[NUM_TYPES];
+};
+
+class glsl_types_test : public ::testing::Test {
+protected:
+   glsl_types_test()
+   {
+      glsl_type_singleton_init_or_ref();
+   }
+
+   ~glsl_types_test()
+   {
+      glsl_type_singleton_decref();
+   }
+};
+
+/* More types than lookup cache slots, so that they collide and keep
+ * evicting each other from the cache.
+ */
+static void
+intern_types(struct interned_types *types)
+{
+   char name[16];
+
+   for (unsigned round = 0; round < NUM_ROUNDS; round++) {
+      for (unsigned i = 0; i < NUM_TYPES; i++) {
+         types->arrays[i] = glsl_array_type(&glsl_type_builtin_vec4, i + 1,
+                                            (i % 2) * 16);
+
+         const glsl_struct_field fields[2] = {
+            glsl_struct_field(&glsl_type_builtin_float, "a"),
+            glsl_struct_field(types->arrays[i], "b"),
+         };
+
+         snprintf(name, sizeof(name), "s%u", i);
+         types->structs[i] = glsl_struct_type(fields, 2, name, false);
+
+         snprintf(name, sizeof(name), "block%u", i);
+         types->interfaces[i] =
+            glsl_interface_type(fields, 2, GLSL_INTERFACE_PACKING_STD140,
+                                false, name);
+      }
+   }
+}
+
+TEST_F(glsl_types_test, intern_from_threads)
+{
+   std::vector<interned_types> types(NUM_THREADS);
+   std::vector<std::thread> threads;
+
+   for (unsigned t = 0; t < NUM_THREADS; t++)
+      threads.emplace_back(intern_types, &types[t]);
+   for (std::thread &thread : threads)
+      thread.join();
+
+   for (unsigned i = 0; i < NUM_TYPES; i++) {
+      EXPECT_TRUE(glsl_type_is_array(types[0].arrays[i]));
+      EXPECT_EQ(glsl_get_length(types[0].arrays[i]), i + 1);
+      EXPECT_EQ(glsl_get_explicit_stride(types[0].arrays[i]), (i % 2) * 16);
+      EXPECT_TRUE(glsl_type_is_struct(types[0].structs[i]));
+      EXPECT_TRUE(glsl_type_is_interface(types[0].interfaces[i]));
+
+      for (unsigned t = 1; t < NUM_THREADS; t++) {
+         EXPECT_EQ(types[t].arrays[i], types[0].arrays[i]);
+         EXPECT_EQ(types[t].structs[i], types[0].structs[i]);
+         EXPECT_EQ(types[t].interfaces[i], types[0].interfaces[i]);
+      }
+   }
+
+   /* Lookups from this thread, after the others are done, agree too. */
+   interned_types again;
+   intern_types(&again);
+   for (unsigned i = 0; i < NUM_TYPES; i++) {
+      EXPECT_EQ(again.arrays[i], types[0].arrays[i]);
+      EXPECT_EQ(again.structs[i], types[0].structs[i]);
+      EXPECT_EQ(again.interfaces[i], types[0].interfaces[i]);
+   }
+}
+
+/* Types which already exist are found through the lookup cache without
+ * taking the type cache mutex, check that these lookups return the types
+ * interned first.
+ */
+TEST_F(glsl_types_test, lookup_from_threads)
+{
+   interned_types first;
+   intern_types(&first);
+
+   std::vector<interned_types> types(NUM_THREADS);
+   std::vector<std::thread> threads;
+
+   for (unsigned t = 0; t < NUM_THREADS; t++)
+      threads.emplace_back(intern_types, &types[t]);
+   for (std::thread &thread : threads)
+      thread.join();
+
+   for (unsigned t = 0; t < NUM_THREADS; t++) {
+      for (unsigned i = 0; i < NUM_TYPES; i++) {
+         EXPECT_EQ(types[t].arrays[i], first.arrays[i]);
+         EXPECT_EQ(types[t].structs[i], first.structs[i]);
+         EXPECT_EQ(types[t].interfaces[i], first.interfaces[i]);
+      }
+   }
+}
+
+} // namespace
@@ -29,12 +29,24 @@
 #include "util/hash_table.h"
 #include "util/macros.h"
 #include "util/ralloc.h"
+#include "util/u_atomic.h"
 #include "util/u_math.h"
 #include "util/u_string.h"
 #include "util/simple_mtx.h"
 
 static simple_mtx_t glsl_type_cache_mutex = SIMPLE_MTX_INITIALIZER;
 
+/* Number of slots in each of the lock-free lookup caches, see
+ * lookup_cache_find().
+ */
+#define LOOKUP_CACHE_SIZE 256
+
+struct lookup_cache_entry {
+   uint32_t hash;
+   const void *key;
+   const glsl_type *type;
+};
+
 static struct {
    void *mem_ctx;
 
@@ -55,8 +67,60 @@ static struct {
    struct hash_table *struct_types;
    struct hash_table *interface_types;
    struct hash_table *subroutine_types;
+
+   /* Direct-mapped caches of recently returned derived types, probed
+    * without taking the mutex.
+    */
+   struct lookup_cache_entry *array_lookup[LOOKUP_CACHE_SIZE];
+   struct lookup_cache_entry *struct_lookup[LOOKUP_CACHE_SIZE];
+   struct lookup_cache_entry *interface_lookup[LOOKUP_CACHE_SIZE];
 } glsl_type_cache;
 
+/* Derived types are looked up from many compiler threads at once, and most
+ * lookups hit types that already exist. The lookup caches let those hits
+ * skip glsl_type_cache_mutex.
+ *
+ * Each type has a single entry, allocated in lin_ctx along with it and
+ * stored as the data of its hash table entry, so refreshing a slot never
+ * allocates. Entries are immutable and slots are only stored with the mutex
+ * held, with release semantics, so a reader seeing an entry pointer also
+ * sees its contents. A miss, or a slot that was overwritten with another
+ * type, just falls back to the locked hash table lookup.
+ */
+static const glsl_type *
+lookup_cache_find(struct lookup_cache_entry **cache, uint32_t hash,
+                  const void *key, bool (*equal)(const void *, const void *))
+{
+   struct lookup_cache_entry *entry = p_atomic_read(&cache[hash % LOOKUP_CACHE_SIZE]);
+   if (entry && entry->hash == hash && equal(entry->key, key))
+      return entry->type;
+
+   return NULL;
+}
+
+static struct lookup_cache_entry *
+lookup_cache_entry_create(uint32_t hash, const void *key, const glsl_type *type)
+{
+   simple_mtx_assert_locked(&glsl_type_cache_mutex);
+
+   struct lookup_cache_entry *entry =
+      linear_alloc(glsl_type_cache.lin_ctx, struct lookup_cache_entry);
+   entry->hash = hash;
+   entry->key = key;
+   entry->type = type;
+
+   return entry;
+}
+
+static void
+lookup_cache_publish(struct lookup_cache_entry **cache,
+                     struct lookup_cache_entry *entry)
+{
+   simple_mtx_assert_locked(&glsl_type_cache_mutex);
+
+   p_atomic_set(&cache[entry->hash % LOOKUP_CACHE_SIZE], entry);
+}
+
 static const glsl_type *
 make_vector_matrix_type(linear_ctx *lin_ctx, uint32_t gl_type,
                         enum glsl_base_type base_type, unsigned vector_elements,
@@ -1260,29 +1324,35 @@ glsl_array_type(const glsl_type *element,
 
    const uint32_t key_hash = array_key_hash(&key);
 
-   simple_mtx_lock(&glsl_type_cache_mutex);
-   assert(glsl_type_cache.users > 0);
-   void *mem_ctx = glsl_type_cache.mem_ctx;
+   const glsl_type *t = lookup_cache_find(glsl_type_cache.array_lookup,
+                                          key_hash, &key, array_key_equal);
+   if (t == NULL) {
+      simple_mtx_lock(&glsl_type_cache_mutex);
+      assert(glsl_type_cache.users > 0);
+      void *mem_ctx = glsl_type_cache.mem_ctx;
 
-   if (glsl_type_cache.array_types == NULL) {
-      glsl_type_cache.array_types = array_key_table_create(mem_ctx);
-   }
-   struct hash_table *array_types = glsl_type_cache.array_types;
+      if (glsl_type_cache.array_types == NULL) {
+         glsl_type_cache.array_types = array_key_table_create(mem_ctx);
+      }
+      struct hash_table *array_types = glsl_type_cache.array_types;
 
-   const struct hash_entry *entry = _mesa_hash_table_search_pre_hashed(array_types, key_hash, &key);
-   if (entry == NULL) {
-      linear_ctx *lin_ctx = glsl_type_cache.lin_ctx;
-      const glsl_type *t = make_array_type(lin_ctx, element, array_size, explicit_stride);
-      struct array_key *stored_key = linear_zalloc(lin_ctx, struct array_key);
-      memcpy(stored_key, &key, sizeof(key));
+      const struct hash_entry *entry = _mesa_hash_table_search_pre_hashed(array_types, key_hash, &key);
+      if (entry == NULL) {
+         linear_ctx *lin_ctx = glsl_type_cache.lin_ctx;
+         t = make_array_type(lin_ctx, element, array_size, explicit_stride);
+         struct array_key *stored_key = linear_zalloc(lin_ctx, struct array_key);
+         memcpy(stored_key, &key, sizeof(key));
 
-      entry = _mesa_hash_table_insert_pre_hashed(array_types, key_hash,
-                                                 stored_key,
-                                                 (void *) t);
-   }
+         entry = _mesa_hash_table_insert_pre_hashed(array_types, key_hash,
+                                                    stored_key,
+                                                    lookup_cache_entry_create(key_hash, stored_key, t));
+      }
 
-   const glsl_type *t = (const glsl_type *) entry->data;
-   simple_mtx_unlock(&glsl_type_cache_mutex);
+      struct lookup_cache_entry *lookup = entry->data;
+      lookup_cache_publish(glsl_type_cache.array_lookup, lookup);
+      t = lookup->type;
+      simple_mtx_unlock(&glsl_type_cache_mutex);
+   }
 
    assert(t->base_type == GLSL_TYPE_ARRAY);
    assert(t->length == array_size);
@@ -1538,27 +1608,34 @@ glsl_struct_type_with_explicit_alignment(const glsl_struct_field *fields,
    fill_struct_type(&key, fields, num_fields, name, packed, explicit_alignment);
    const uint32_t key_hash = record_key_hash(&key);
 
-   simple_mtx_lock(&glsl_type_cache_mutex);
-   assert(glsl_type_cache.users > 0);
-   void *mem_ctx = glsl_type_cache.mem_ctx;
+   const glsl_type *t = lookup_cache_find(glsl_type_cache.struct_lookup,
+                                          key_hash, &key, record_key_compare);
+   if (t == NULL) {
+      simple_mtx_lock(&glsl_type_cache_mutex);
+      assert(glsl_type_cache.users > 0);
+      void *mem_ctx = glsl_type_cache.mem_ctx;
 
-   if (glsl_type_cache.struct_types == NULL) {
-      glsl_type_cache.struct_types =
-         _mesa_hash_table_create(mem_ctx, record_key_hash, record_key_compare);
-   }
-   struct hash_table *struct_types = glsl_type_cache.struct_types;
+      if (glsl_type_cache.struct_types == NULL) {
+         glsl_type_cache.struct_types =
+            _mesa_hash_table_create(mem_ctx, record_key_hash, record_key_compare);
+      }
+      struct hash_table *struct_types = glsl_type_cache.struct_types;
 
-   const struct hash_entry *entry = _mesa_hash_table_search_pre_hashed(struct_types,
-                                                                       key_hash, &key);
-   if (entry == NULL) {
-      const glsl_type *t = make_struct_type(glsl_type_cache.lin_ctx, fields, num_fields,
-                                            name, packed, explicit_alignment);
+      const struct hash_entry *entry = _mesa_hash_table_search_pre_hashed(struct_types,
+                                                                          key_hash, &key);
+      if (entry == NULL) {
+         t = make_struct_type(glsl_type_cache.lin_ctx, fields, num_fields,
+                              name, packed, explicit_alignment);
 
-      entry = _mesa_hash_table_insert_pre_hashed(struct_types, key_hash, t, (void *) t);
-   }
+         entry = _mesa_hash_table_insert_pre_hashed(struct_types, key_hash, t,
+                                                    lookup_cache_entry_create(key_hash, t, t));
+      }
 
-   const glsl_type *t = (const glsl_type *) entry->data;
-   simple_mtx_unlock(&glsl_type_cache_mutex);
+      struct lookup_cache_entry *lookup = entry->data;
+      lookup_cache_publish(glsl_type_cache.struct_lookup, lookup);
+      t = lookup->type;
+      simple_mtx_unlock(&glsl_type_cache_mutex);
+   }
 
    assert(t->base_type == GLSL_TYPE_STRUCT);
    assert(t->length == num_fields);
@@ -1581,27 +1658,34 @@ glsl_interface_type(const glsl_struct_field *fields,
    fill_interface_type(&key, fields, num_fields, packing, row_major, block_name);
    const uint32_t key_hash = record_key_hash(&key);
 
-   simple_mtx_lock(&glsl_type_cache_mutex);
-   assert(glsl_type_cache.users > 0);
-   void *mem_ctx = glsl_type_cache.mem_ctx;
+   const glsl_type *t = lookup_cache_find(glsl_type_cache.interface_lookup,
+                                          key_hash, &key, record_key_compare);
+   if (t == NULL) {
+      simple_mtx_lock(&glsl_type_cache_mutex);
+      assert(glsl_type_cache.users > 0);
+      void *mem_ctx = glsl_type_cache.mem_ctx;
 
-   if (glsl_type_cache.interface_types == NULL) {
-      glsl_type_cache.interface_types =
-         _mesa_hash_table_create(mem_ctx, record_key_hash, record_key_compare);
-   }
-   struct hash_table *interface_types = glsl_type_cache.interface_types;
+      if (glsl_type_cache.interface_types == NULL) {
+         glsl_type_cache.interface_types =
+            _mesa_hash_table_create(mem_ctx, record_key_hash, record_key_compare);
+      }
+      struct hash_table *interface_types = glsl_type_cache.interface_types;
 
-   const struct hash_entry *entry = _mesa_hash_table_search_pre_hashed(interface_types,
-                                                                       key_hash, &key);
-   if (entry == NULL) {
-      const glsl_type *t = make_interface_type(glsl_type_cache.lin_ctx, fields, num_fields,
-                                               packing, row_major, block_name);
+      const struct hash_entry *entry = _mesa_hash_table_search_pre_hashed(interface_types,
+                                                                          key_hash, &key);
+      if (entry == NULL) {
+         t = make_interface_type(glsl_type_cache.lin_ctx, fields, num_fields,
+                                 packing, row_major, block_name);
 
-      entry = _mesa_hash_table_insert_pre_hashed(interface_types, key_hash, t, (void *) t);
-   }
+         entry = _mesa_hash_table_insert_pre_hashed(interface_types, key_hash, t,
+                                                    lookup_cache_entry_create(key_hash, t, t));
+      }
 
-   const glsl_type *t = (const glsl_type *) entry->data;
-   simple_mtx_unlock(&glsl_type_cache_mutex);
+      struct lookup_cache_entry *lookup = entry->data;
+      lookup_cache_publish(glsl_type_cache.interface_lookup, lookup);
+      t = lookup->type;
+      simple_mtx_unlock(&glsl_type_cache_mutex);
+   }
 
    assert(t->base_type == GLSL_TYPE_INTERFACE);
    assert(t->length == num_fields);
@@ -88,6 +88,8 @@ static const struct debug_named_value nir_debug_control[] = {
      "Print shaders even if they are marked as internal" },
    { "print_pass_flags", NIR_DEBUG_PRINT_PASS_FLAGS,
      "Print pass_flags for every instruction when pass_flags are non-zero" },
+   { "sweep_stats", NIR_DEBUG_SWEEP_STATS,
+     "Print instruction memory usage and timing of each nir_sweep call" },
    DEBUG_NAMED_VALUE_END
 };
 
@@ -92,6 +92,7 @@ extern bool nir_debug_print_shader[MESA_SHADER_KERNEL + 1];
 #define NIR_DEBUG_PRINT_NO_INLINE_CONSTS (1u << 20)
 #define NIR_DEBUG_PRINT_INTERNAL         (1u << 21)
 #define NIR_DEBUG_PRINT_PASS_FLAGS       (1u << 22)
+#define NIR_DEBUG_SWEEP_STATS            (1u << 23)
 
 #define NIR_DEBUG_PRINT (NIR_DEBUG_PRINT_VS |  \
                          NIR_DEBUG_PRINT_TCS | \
@@ -5533,6 +5534,28 @@ bool nir_shader_lower_instructions(nir_shader *shader,
                                    nir_lower_instr_cb lower,
                                    void *cb_data);
 
+typedef bool (*nir_impl_pass_cb)(nir_function_impl *impl, void *data);
+
+/** Run an impl-local pass over all the function_impls of a shader, using
+ *  the threads of \p queue when there is more than one impl.
+ *
+ * The pass must be safe to run concurrently on different impls: it may
+ * create, rewrite and free instructions of the impl it is given, but must
+ * not read or modify other impls, create blocks or variables, or allocate
+ * anything else from the shader's ralloc context. Metadata the pass needs
+ * must be listed in \p required so that it is computed up front. The pass is
+ * responsible for preserving or invalidating metadata, as usual.
+ *
+ * The queue is owned by the caller, which decides whether a shader is worth
+ * spreading over threads. With a NULL \p queue the impls are processed in
+ * order on the calling thread. The calling thread always takes part, so the
+ * queue may be shared with other work.
+ */
+struct util_queue;
+bool nir_shader_impl_pass_parallel(nir_shader *shader, nir_impl_pass_cb pass,
+                                   nir_metadata required, void *data,
+                                   struct util_queue *queue);
+
 void nir_calc_dominance_impl(nir_function_impl *impl);
 void nir_calc_dominance(nir_shader *shader);
 
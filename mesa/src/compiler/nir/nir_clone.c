@@ -46,6 +46,13 @@ typedef struct {
    /* maps orig ptr -> cloned ptr: */
    struct hash_table *remap_table;
 
+   /* When cloning a whole function_impl, SSA defs are remapped through this
+    * array indexed by nir_def::index instead of remap_table, since defs
+    * make up the bulk of the remapped objects.
+    */
+   nir_def **def_remap;
+   unsigned def_remap_size;
+
    /* List of phi sources. */
    struct list_head phi_srcs;
 
@@ -59,6 +66,8 @@ init_clone_state(clone_state *state, struct hash_table *remap_table,
 {
    state->global_clone = global;
    state->allow_remap_fallback = allow_remap_fallback;
+   state->def_remap = NULL;
+   state->def_remap_size = 0;
 
    if (remap_table) {
       state->remap_table = remap_table;
@@ -112,6 +121,24 @@ remap_local(clone_state *state, const void *ptr)
    return _lookup_ptr(state, ptr, false);
 }
 
+static void
+add_remap_def(clone_state *state, nir_def *ndef, const nir_def *def)
+{
+   if (def->index < state->def_remap_size)
+      state->def_remap[def->index] = ndef;
+   else if (likely(state->remap_table))
+      add_remap(state, ndef, def);
+}
+
+static nir_def *
+remap_def(clone_state *state, const nir_def *def)
+{
+   if (def->index < state->def_remap_size && state->def_remap[def->index])
+      return state->def_remap[def->index];
+
+   return remap_local(state, def);
+}
+
 static void *
 remap_global(clone_state *state, const void *ptr)
 {
@@ -206,7 +233,7 @@ static void
 __clone_src(clone_state *state, void *ninstr_or_if,
             nir_src *nsrc, const nir_src *src)
 {
-   nsrc->ssa = remap_local(state, src->ssa);
+   nsrc->ssa = remap_def(state, src->ssa);
 }
 
 static void
@@ -214,8 +241,7 @@ __clone_def(clone_state *state, nir_instr *ninstr,
             nir_def *ndef, const nir_def *def)
 {
    nir_def_init(ninstr, ndef, def->num_components, def->bit_size);
-   if (likely(state->remap_table))
-      add_remap(state, ndef, def);
+   add_remap_def(state, ndef, def);
 }
 
 static nir_alu_instr *
@@ -325,8 +351,7 @@ clone_load_const(clone_state *state, const nir_load_const_instr *lc)
 
    memcpy(&nlc->value, &lc->value, sizeof(*nlc->value) * lc->def.num_components);
 
-   if (likely(state->remap_table))
-      add_remap(state, &nlc->def, &lc->def);
+   add_remap_def(state, &nlc->def, &lc->def);
 
    return nlc;
 }
@@ -338,8 +363,7 @@ clone_ssa_undef(clone_state *state, const nir_undef_instr *sa)
       nir_undef_instr_create(state->ns, sa->def.num_components,
                              sa->def.bit_size);
 
-   if (likely(state->remap_table))
-      add_remap(state, &nsa->def, &sa->def);
+   add_remap_def(state, &nsa->def, &sa->def);
 
    return nsa;
 }
@@ -617,7 +641,7 @@ fixup_phi_srcs(clone_state *state)
       /* Remove from this list */
       list_del(&src->src.use_link);
 
-      src->src.ssa = remap_local(state, src->src.ssa);
+      src->src.ssa = remap_def(state, src->src.ssa);
       list_addtail(&src->src.use_link, &src->src.ssa->uses);
    }
    assert(list_is_empty(&state->phi_srcs));
@@ -666,10 +690,18 @@ clone_function_impl(clone_state *state, const nir_function_impl *fi)
 
    assert(list_is_empty(&state->phi_srcs));
 
+   state->def_remap = calloc(fi->ssa_alloc, sizeof(nir_def *));
+   if (state->def_remap)
+      state->def_remap_size = fi->ssa_alloc;
+
    clone_cf_list(state, &nfi->body, &fi->body);
 
    fixup_phi_srcs(state);
 
+   free(state->def_remap);
+   state->def_remap = NULL;
+   state->def_remap_size = 0;
+
    /* All metadata is invalidated in the cloning process */
    nfi->valid_metadata = 0;
 
@@ -0,0 +1,119 @@
+/*
+ * Copyright 2025 Mesa3D authors
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "nir.h"
+#include "util/u_atomic.h"
+#include "util/u_queue.h"
+
+/**
+ * \file nir_parallel_impls.c
+ *
+ * Runs a thread-safe, impl-local pass over the function_impls of a shader
+ * concurrently, on the threads of a queue owned by the caller. This mostly
+ * helps OpenCL and ray-tracing shaders, which can carry hundreds of
+ * functions before inlining.
+ *
+ * Workers pull impls from a shared counter, so a few large functions don't
+ * leave the other threads idle. While the workers run, the shader's gc_ctx
+ * is put in thread-safe mode since every instruction allocation and free
+ * goes through it.
+ */
+
+#define MAX_JOBS 16
+
+struct parallel_state {
+   nir_function_impl **impls;
+   unsigned num_impls;
+
+   nir_impl_pass_cb pass;
+   void *data;
+
+   /* Index of the next impl to process. */
+   unsigned next;
+
+   bool progress;
+};
+
+static void
+parallel_worker(void *_state, void *gdata, int thread_index)
+{
+   struct parallel_state *state = _state;
+   bool progress = false;
+
+   while (true) {
+      unsigned i = p_atomic_inc_return(&state->next) - 1;
+      if (i >= state->num_impls)
+         break;
+
+      progress |= state->pass(state->impls[i], state->data);
+   }
+
+   if (progress)
+      p_atomic_set(&state->progress, true);
+}
+
+bool
+nir_shader_impl_pass_parallel(nir_shader *shader, nir_impl_pass_cb pass,
+                              nir_metadata required, void *data,
+                              struct util_queue *queue)
+{
+   unsigned num_impls = 0;
+   nir_foreach_function_impl(impl, shader)
+      num_impls++;
+
+   unsigned num_jobs = 0;
+   if (queue != NULL)
+      num_jobs = MIN3(queue->num_threads, num_impls - 1, MAX_JOBS);
+
+   if (num_jobs == 0) {
+      bool progress = false;
+      nir_foreach_function_impl(impl, shader) {
+         nir_metadata_require(impl, required);
+         progress |= pass(impl, data);
+      }
+      return progress;
+   }
+
+   struct parallel_state state = {
+      .impls = malloc(num_impls * sizeof(nir_function_impl *)),
+      .pass = pass,
+      .data = data,
+   };
+   if (!state.impls)
+      return false;
+
+   /* Metadata is allocated from the shader, so it has to be computed before
+    * the workers start.
+    */
+   nir_foreach_function_impl(impl, shader) {
+      nir_metadata_require(impl, required);
+      state.impls[state.num_impls++] = impl;
+   }
+
+   gc_set_thread_safe(shader->gctx, true);
+
+   struct util_queue_fence fences[MAX_JOBS];
+   for (unsigned i = 0; i < num_jobs; i++) {
+      util_queue_fence_init(&fences[i]);
+      util_queue_add_job(queue, &state, &fences[i], parallel_worker, NULL, 0);
+   }
+
+   /* The calling thread works too, so a queue busy with other jobs only
+    * costs parallelism. Jobs which haven't started by the time it's done
+    * have nothing left to do and are dropped.
+    */
+   parallel_worker(&state, NULL, -1);
+
+   for (unsigned i = 0; i < num_jobs; i++) {
+      util_queue_drop_job(queue, &fences[i]);
+      util_queue_fence_destroy(&fences[i]);
+   }
+
+   gc_set_thread_safe(shader->gctx, false);
+
+   free(state.impls);
+
+   return state.progress;
+}
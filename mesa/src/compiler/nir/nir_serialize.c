@@ -52,6 +52,12 @@ typedef struct {
     */
    struct util_dynarray phi_fixups;
 
+   /* maps glsl_type pointer to type table index */
+   struct hash_table *type_table;
+
+   /* the next index to assign to a glsl_type, 0 is reserved for NULL */
+   uint32_t next_type_idx;
+
    /* The last serialized type. */
    const struct glsl_type *last_type;
    const struct glsl_type *last_interface_type;
@@ -83,6 +89,9 @@ typedef struct {
    /* List of phi sources. */
    struct list_head phi_srcs;
 
+   /* Array of already decoded glsl_types, indexed by type table index - 1 */
+   struct util_dynarray types;
+
    /* The last deserialized type. */
    const struct glsl_type *last_type;
    const struct glsl_type *last_interface_type;
@@ -125,6 +134,49 @@ read_object(read_ctx *ctx)
    return read_lookup_object(ctx, blob_read_uint32(ctx->blob));
 }
 
+/* Types are written once per blob and referenced by index afterwards, so
+ * that struct and array types (which carry field names and layouts) are
+ * only decoded and interned once per deserialized shader.
+ */
+static void
+write_type(write_ctx *ctx, const struct glsl_type *type)
+{
+   if (!type) {
+      blob_write_uint32(ctx->blob, 0);
+      return;
+   }
+
+   struct hash_entry *entry = _mesa_hash_table_search(ctx->type_table, type);
+   if (entry) {
+      blob_write_uint32(ctx->blob, (uint32_t)(uintptr_t)entry->data);
+      return;
+   }
+
+   uint32_t index = ctx->next_type_idx++;
+   _mesa_hash_table_insert(ctx->type_table, type, (void *)(uintptr_t)index);
+   blob_write_uint32(ctx->blob, index);
+   encode_type_to_blob(ctx->blob, type);
+}
+
+static const struct glsl_type *
+read_type(read_ctx *ctx)
+{
+   uint32_t index = blob_read_uint32(ctx->blob);
+   if (index == 0)
+      return NULL;
+
+   unsigned num_types =
+      util_dynarray_num_elements(&ctx->types, const struct glsl_type *);
+   if (index <= num_types)
+      return *util_dynarray_element(&ctx->types, const struct glsl_type *, index - 1);
+
+   /* A new type is always the next one in the table. */
+   assert(index == num_types + 1 || ctx->blob->overrun);
+   const struct glsl_type *type = decode_type_from_blob(ctx->blob);
+   util_dynarray_append(&ctx->types, const struct glsl_type *, type);
+   return type;
+}
+
 static uint32_t
 encode_bit_size_3bits(uint8_t bit_size)
 {
@@ -285,12 +337,12 @@ write_variable(write_ctx *ctx, const nir_variable *var)
    blob_write_uint32(ctx->blob, flags.u32);
 
    if (!flags.u.type_same_as_last) {
-      encode_type_to_blob(ctx->blob, var->type);
+      write_type(ctx, var->type);
       ctx->last_type = var->type;
    }
 
    if (var->interface_type && !flags.u.interface_type_same_as_last) {
-      encode_type_to_blob(ctx->blob, var->interface_type);
+      write_type(ctx, var->interface_type);
       ctx->last_interface_type = var->interface_type;
    }
 
@@ -342,7 +394,7 @@ read_variable(read_ctx *ctx)
    if (flags.u.type_same_as_last) {
       var->type = ctx->last_type;
    } else {
-      var->type = decode_type_from_blob(ctx->blob);
+      var->type = read_type(ctx);
       ctx->last_type = var->type;
    }
 
@@ -350,7 +402,7 @@ read_variable(read_ctx *ctx)
       if (flags.u.interface_type_same_as_last) {
          var->interface_type = ctx->last_interface_type;
       } else {
-         var->interface_type = decode_type_from_blob(ctx->blob);
+         var->interface_type = read_type(ctx);
          ctx->last_interface_type = var->interface_type;
       }
    }
@@ -945,7 +997,7 @@ write_deref(write_ctx *ctx, const nir_deref_instr *deref)
       blob_write_uint32(ctx->blob, deref->cast.align_mul);
       blob_write_uint32(ctx->blob, deref->cast.align_offset);
       if (!header.deref.cast_type_same_as_last) {
-         encode_type_to_blob(ctx->blob, deref->type);
+         write_type(ctx, deref->type);
          ctx->last_type = deref->type;
       }
       break;
@@ -1013,7 +1065,7 @@ read_deref(read_ctx *ctx, union packed_instr header)
       if (header.deref.cast_type_same_as_last) {
          deref->type = ctx->last_type;
       } else {
-         deref->type = decode_type_from_blob(ctx->blob);
+         deref->type = read_type(ctx);
          ctx->last_type = deref->type;
       }
       break;
@@ -1988,7 +2040,7 @@ write_function(write_ctx *ctx, const nir_function *fxn)
    blob_write_uint32(ctx->blob, fxn->subroutine_index);
    blob_write_uint32(ctx->blob, fxn->num_subroutine_types);
    for (unsigned i = 0; i < fxn->num_subroutine_types; i++) {
-      encode_type_to_blob(ctx->blob, fxn->subroutine_types[i]);
+      write_type(ctx, fxn->subroutine_types[i]);
    }
 
    write_add_object(ctx, fxn);
@@ -2011,7 +2063,7 @@ write_function(write_ctx *ctx, const nir_function *fxn)
       if (has_name)
          blob_write_string(ctx->blob, fxn->params[i].name);
 
-      encode_type_to_blob(ctx->blob, fxn->params[i].type);
+      write_type(ctx, fxn->params[i].type);
       blob_write_uint32(ctx->blob, encode_deref_modes(fxn->params[i].mode));
       blob_write_uint32(ctx->blob, fxn->params[i].driver_attributes);
    }
@@ -2043,7 +2095,7 @@ read_function(read_ctx *ctx)
    fxn->subroutine_index = blob_read_uint32(ctx->blob);
    fxn->num_subroutine_types = blob_read_uint32(ctx->blob);
    for (unsigned i = 0; i < fxn->num_subroutine_types; i++) {
-      fxn->subroutine_types[i] = decode_type_from_blob(ctx->blob);
+      fxn->subroutine_types[i] = read_type(ctx);
    }
 
    read_add_object(ctx, fxn);
@@ -2060,7 +2112,7 @@ read_function(read_ctx *ctx)
       fxn->params[i].bit_size = (val >> 8) & 0xff;
       fxn->params[i].is_return = val & (1u << 16);
       fxn->params[i].is_uniform = val & (1u << 17);
-      fxn->params[i].type = decode_type_from_blob(ctx->blob);
+      fxn->params[i].type = read_type(ctx);
       fxn->params[i].mode = decode_deref_modes(blob_read_uint32(ctx->blob));
       fxn->params[i].driver_attributes = blob_read_uint32(ctx->blob);
    }
@@ -2113,6 +2165,8 @@ nir_serialize(struct blob *blob, const nir_shader *nir, bool strip)
 {
    write_ctx ctx = { 0 };
    ctx.remap_table = _mesa_pointer_hash_table_create(NULL);
+   ctx.type_table = _mesa_pointer_hash_table_create(NULL);
+   ctx.next_type_idx = 1;
    ctx.blob = blob;
    ctx.nir = nir;
    ctx.strip = strip;
@@ -2162,6 +2216,7 @@ nir_serialize(struct blob *blob, const nir_shader *nir, bool strip)
    blob_overwrite_uint32(blob, idx_size_offset, ctx.next_idx);
 
    _mesa_hash_table_destroy(ctx.remap_table, NULL);
+   _mesa_hash_table_destroy(ctx.type_table, NULL);
    util_dynarray_fini(&ctx.phi_fixups);
 }
 
@@ -2173,6 +2228,7 @@ nir_deserialize(void *mem_ctx,
    read_ctx ctx = { 0 };
    ctx.blob = blob;
    list_inithead(&ctx.phi_srcs);
+   util_dynarray_init(&ctx.types, NULL);
    ctx.idx_table_len = blob_read_uint32(blob);
    ctx.idx_table = calloc(ctx.idx_table_len, sizeof(uintptr_t));
 
@@ -2223,6 +2279,7 @@ nir_deserialize(void *mem_ctx,
    }
 
    free(ctx.idx_table);
+   util_dynarray_fini(&ctx.types);
 
    nir_validate_shader(ctx.nir, "after deserialize");
 
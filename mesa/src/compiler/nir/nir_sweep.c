@@ -22,6 +22,7 @@
  */
 
 #include "nir.h"
+#include "util/os_time.h"
 
 /**
  * \file nir_sweep.c
@@ -137,9 +138,32 @@ sweep_function(nir_shader *nir, nir_function *f)
       sweep_impl(nir, f->impl);
 }
 
+static void
+print_sweep_stats(nir_shader *nir, const struct gc_stats *before, int64_t time_ns)
+{
+   struct gc_stats after;
+   gc_get_stats(nir->gctx, &after);
+
+   fprintf(stderr, "nir_sweep(%s): %u -> %u objects (%zu -> %zu bytes), "
+                   "%u -> %u slabs (%zu -> %zu bytes), %u large objects, %.3f ms\n",
+           nir->info.name ? nir->info.name : gl_shader_stage_name(nir->info.stage),
+           before->num_objects, after.num_objects,
+           before->object_bytes, after.object_bytes,
+           before->num_slabs, after.num_slabs,
+           before->slab_bytes, after.slab_bytes,
+           after.num_large_objects, time_ns / 1000000.0);
+}
+
 void
 nir_sweep(nir_shader *nir)
 {
+   struct gc_stats before_stats;
+   int64_t start_time = 0;
+   if (NIR_DEBUG(SWEEP_STATS)) {
+      gc_get_stats(nir->gctx, &before_stats);
+      start_time = os_time_get_nano();
+   }
+
    void *rubbish = ralloc_context(NULL);
 
    struct list_head instr_gc_list;
@@ -175,4 +199,7 @@ nir_sweep(nir_shader *nir)
    /* Free everything we didn't steal back. */
    gc_sweep_end(nir->gctx);
    ralloc_free(rubbish);
+
+   if (NIR_DEBUG(SWEEP_STATS))
+      print_sweep_stats(nir, &before_stats, os_time_get_nano() - start_time);
 }
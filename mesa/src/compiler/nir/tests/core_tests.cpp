@@ -117,4 +117,42 @@ TEST_F(nir_core_test, nir_instr_free_and_dce_multiple_src_test)
    nir_validate_shader(b->shader, "after remove_and_dce");
 }
 
+TEST_F(nir_core_test, nir_shader_clone_remaps_loop_phi)
+{
+   nir_def *zero = nir_imm_int(b, 0);
+
+   nir_phi_instr *phi = nir_phi_instr_create(b->shader);
+
+   nir_loop *loop = nir_push_loop(b);
+   {
+      nir_def_init(&phi->instr, &phi->def, 1, 32);
+      nir_phi_instr_add_src(phi, zero->parent_instr->block, zero);
+
+      nir_break_if(b, nir_ige_imm(b, &phi->def, 4));
+
+      nir_def *inc = nir_iadd_imm(b, &phi->def, 1);
+      nir_phi_instr_add_src(phi, inc->parent_instr->block, inc);
+   }
+   nir_pop_loop(b, loop);
+
+   b->cursor = nir_before_block(nir_loop_first_block(loop));
+   nir_builder_instr_insert(b, &phi->instr);
+
+   nir_validate_shader(b->shader, "before clone");
+
+   nir_shader *clone = nir_shader_clone(b->shader, b->shader);
+   nir_validate_shader(clone, "after clone");
+
+   nir_function_impl *impl = nir_shader_get_entrypoint(clone);
+   ASSERT_EQ(impl->ssa_alloc, b->impl->ssa_alloc);
+
+   nir_loop *nloop = nir_cf_node_as_loop(nir_cf_node_next(&nir_start_block(impl)->cf_node));
+   nir_phi_instr *nphi = nir_instr_as_phi(nir_block_first_instr(nir_loop_first_block(nloop)));
+
+   nir_foreach_phi_src(src, nphi) {
+      ASSERT_EQ(nir_cf_node_get_function(&src->pred->cf_node), impl);
+      ASSERT_EQ(nir_cf_node_get_function(&src->src.ssa->parent_instr->block->cf_node), impl);
+   }
+}
+
 }
@@ -0,0 +1,117 @@
+/*
+ * Copyright 2025 Mesa3D authors
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "nir_test.h"
+#include "util/u_queue.h"
+
+namespace {
+
+class nir_parallel_impls_test : public nir_test {
+protected:
+   nir_parallel_impls_test()
+      : nir_test::nir_test("nir_parallel_impls_test")
+   {
+      util_queue_init(&queue, "nir_par", 16, 4, 0, NULL);
+   }
+
+   ~nir_parallel_impls_test()
+   {
+      util_queue_destroy(&queue);
+   }
+
+   void add_functions(unsigned count);
+   unsigned count_alus();
+
+   struct util_queue queue;
+};
+
+/* Add functions made of an iadd chain whose operands all go through movs,
+ * so copy propagation has something to do in each of them.
+ */
+void
+nir_parallel_impls_test::add_functions(unsigned count)
+{
+   for (unsigned i = 0; i < count; i++) {
+      nir_function *func = nir_function_create(b->shader, "func");
+      nir_builder fb = nir_builder_at(nir_after_impl(nir_function_impl_create(func)));
+
+      nir_def *val = nir_imm_int(&fb, i);
+      for (unsigned j = 0; j < 64; j++)
+         val = nir_iadd(&fb, nir_mov(&fb, val), nir_mov(&fb, nir_imm_int(&fb, j)));
+   }
+}
+
+unsigned
+nir_parallel_impls_test::count_alus()
+{
+   unsigned count = 0;
+   nir_foreach_function_impl(impl, b->shader) {
+      nir_foreach_block(block, impl) {
+         nir_foreach_instr(instr, block)
+            count += instr->type == nir_instr_type_alu;
+      }
+   }
+   return count;
+}
+
+static bool
+copy_prop_and_dce(nir_function_impl *impl, void *data)
+{
+   bool progress = nir_copy_prop_impl(impl);
+
+   /* Free the now unused movs, to exercise gc_free from several threads. */
+   nir_foreach_block(block, impl) {
+      nir_foreach_instr_safe(instr, block) {
+         if (instr->type == nir_instr_type_alu &&
+             nir_def_is_unused(&nir_instr_as_alu(instr)->def)) {
+            nir_instr_remove(instr);
+            nir_instr_free(instr);
+         }
+      }
+   }
+
+   p_atomic_inc((unsigned *)data);
+   return progress;
+}
+
+TEST_F(nir_parallel_impls_test, copy_prop_many_functions)
+{
+   add_functions(64);
+
+   unsigned num_calls = 0;
+   ASSERT_TRUE(nir_shader_impl_pass_parallel(b->shader, copy_prop_and_dce,
+                                             nir_metadata_none, &num_calls,
+                                             &queue));
+   EXPECT_EQ(num_calls, 65);
+
+   nir_validate_shader(b->shader, "after parallel copy-prop");
+
+   /* Only the iadds are left, minus the unused last one of each chain. The
+    * entrypoint has no ALU at all.
+    */
+   EXPECT_EQ(count_alus(), 64 * 63);
+
+   num_calls = 0;
+   ASSERT_FALSE(nir_shader_impl_pass_parallel(b->shader, copy_prop_and_dce,
+                                              nir_metadata_none, &num_calls,
+                                              &queue));
+   EXPECT_EQ(num_calls, 65);
+}
+
+TEST_F(nir_parallel_impls_test, no_queue)
+{
+   add_functions(3);
+
+   unsigned num_calls = 0;
+   ASSERT_TRUE(nir_shader_impl_pass_parallel(b->shader, copy_prop_and_dce,
+                                             nir_metadata_block_index,
+                                             &num_calls, NULL));
+   EXPECT_EQ(num_calls, 4);
+
+   nir_validate_shader(b->shader, "after copy-prop");
+   EXPECT_EQ(count_alus(), 3 * 63);
+}
+
+} // namespace
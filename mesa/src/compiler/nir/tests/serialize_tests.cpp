@@ -100,6 +100,7 @@ nir_serialize_test::ASSERT_SWIZZLE_EQ(nir_alu_instr *a, nir_alu_instr *b, unsign
 
 class nir_serialize_all_test : public nir_serialize_test {};
 class nir_serialize_all_but_one_test : public nir_serialize_test {};
+class nir_serialize_types_test : public nir_serialize_test {};
 
 } // namespace
 
@@ -195,3 +196,37 @@ TEST_P(nir_serialize_all_but_one_test, single_channel)
 
    ASSERT_SWIZZLE_EQ(vec_alu, vec_alu_dup, 1, 0);
 }
+
+TEST_F(nir_serialize_types_test, repeated_struct_types)
+{
+   glsl_struct_field fields[] = {
+      glsl_struct_field(glsl_vec4_type(), "color"),
+      glsl_struct_field(glsl_array_type(glsl_float_type(), 4, 0), "weights"),
+   };
+   const glsl_type *strct = glsl_struct_type(fields, ARRAY_SIZE(fields), "s", false);
+   const glsl_type *arr = glsl_array_type(strct, 2, 0);
+
+   /* Alternate the types so that each variable references an earlier one. */
+   const glsl_type *types[] = { strct, arr, strct, glsl_int_type(), arr, strct };
+   for (unsigned i = 0; i < ARRAY_SIZE(types); i++)
+      nir_variable_create(b->shader, nir_var_shader_temp, types[i], "v");
+
+   nir_deref_instr *deref =
+      nir_build_deref_var(b, nir_variable_create(b->shader, nir_var_shader_temp,
+                                                 arr, "v"));
+   nir_build_deref_cast(b, &deref->def, nir_var_shader_temp, strct, 0);
+
+   serialize();
+
+   unsigned i = 0;
+   nir_foreach_variable_in_shader(var, dup) {
+      if (i < ARRAY_SIZE(types))
+         EXPECT_EQ(var->type, types[i]);
+      i++;
+   }
+   EXPECT_EQ(i, ARRAY_SIZE(types) + 1);
+
+   nir_function_impl *impl = nir_shader_get_entrypoint(dup);
+   nir_instr *last = nir_block_last_instr(nir_impl_last_block(impl));
+   EXPECT_EQ(nir_instr_as_deref(last)->type, strct);
+}
@@ -28,6 +28,10 @@
 /* Authors:  Zack Rusin <zackr@vmware.com>
  */
 
+#include "util/hash_table.h"
+#include "util/list.h"
+#include "util/log.h"
+#include "util/simple_mtx.h"
 #include "util/u_debug.h"
 
 #include "util/u_memory.h"
@@ -205,3 +209,289 @@ cso_cache_set_delete_cso_callback(struct cso_cache *sc,
    sc->delete_cso = delete_cso;
    sc->delete_cso_ctx = ctx;
 }
+
+
+/*
+ * Screen-level cache.
+ *
+ * Objects are reference counted by the context caches holding them. When
+ * the last context cache drops one, it is kept on an LRU list instead of
+ * being deleted, so another context or a later eviction in the same
+ * context can pick it up again. Only the least recently released unused
+ * objects beyond max_unused are deleted, with the pipe_context releasing
+ * them.
+ */
+
+DEBUG_GET_ONCE_BOOL_OPTION(cso_cache_stats, "GALLIUM_CSO_CACHE_STATS", false)
+
+struct cso_screen_entry {
+   struct list_head link;  /**< in cso_screen_cache::unused if refcount == 0 */
+   void *state;
+   unsigned hash_key;
+   unsigned refcount;
+   enum cso_cache_type type;
+};
+
+struct cso_screen_cache {
+   simple_mtx_t mutex;
+   struct cso_hash hashes[CSO_CACHE_MAX];  /**< of cso_screen_entry */
+   struct hash_table *entries;             /**< state -> cso_screen_entry */
+   struct list_head unused;                /**< least recently used first */
+   unsigned max_unused;
+   unsigned num_contexts;
+   struct cso_screen_cache_stats stats;
+};
+
+
+struct cso_screen_cache *
+cso_screen_cache_create(unsigned max_unused)
+{
+   struct cso_screen_cache *cache = CALLOC_STRUCT(cso_screen_cache);
+   if (!cache)
+      return NULL;
+
+   cache->entries = _mesa_pointer_hash_table_create(NULL);
+   if (!cache->entries) {
+      FREE(cache);
+      return NULL;
+   }
+
+   simple_mtx_init(&cache->mutex, mtx_plain);
+   for (int i = 0; i < CSO_CACHE_MAX; i++)
+      cso_hash_init(&cache->hashes[i]);
+   list_inithead(&cache->unused);
+   cache->max_unused = max_unused;
+   return cache;
+}
+
+
+void
+cso_screen_cache_destroy(struct cso_screen_cache *cache)
+{
+   if (!cache)
+      return;
+
+   /* the last context to detach deleted everything */
+   assert(!cache->num_contexts && !cache->stats.num_objects);
+
+   if (debug_get_option_cso_cache_stats()) {
+      mesa_logi("cso screen cache: %" PRIu64 " hits, %" PRIu64 " misses, "
+                "%" PRIu64 " evictions",
+                cache->stats.hits, cache->stats.misses,
+                cache->stats.evictions);
+   }
+
+   for (int i = 0; i < CSO_CACHE_MAX; i++)
+      cso_hash_deinit(&cache->hashes[i]);
+   _mesa_hash_table_destroy(cache->entries, NULL);
+   simple_mtx_destroy(&cache->mutex);
+   FREE(cache);
+}
+
+
+void
+cso_screen_cache_get_stats(struct cso_screen_cache *cache,
+                           struct cso_screen_cache_stats *stats)
+{
+   simple_mtx_lock(&cache->mutex);
+   *stats = cache->stats;
+   simple_mtx_unlock(&cache->mutex);
+}
+
+
+void
+cso_screen_cache_attach(struct cso_screen_cache *cache)
+{
+   simple_mtx_lock(&cache->mutex);
+   cache->num_contexts++;
+   simple_mtx_unlock(&cache->mutex);
+}
+
+
+/* Unlink an unused entry and move it to the to_delete list. */
+static void
+screen_cache_evict(struct cso_screen_cache *cache,
+                   struct cso_screen_entry *entry,
+                   struct list_head *to_delete)
+{
+   struct cso_hash *hash = &cache->hashes[entry->type];
+   struct cso_hash_iter iter = cso_hash_find(hash, entry->hash_key);
+
+   while (cso_hash_iter_data(iter) != entry)
+      iter = cso_hash_iter_next(iter);
+   cso_hash_erase(hash, iter);
+   _mesa_hash_table_remove_key(cache->entries, entry->state);
+
+   list_del(&entry->link);
+   list_addtail(&entry->link, to_delete);
+   cache->stats.num_objects--;
+   cache->stats.num_unused--;
+}
+
+
+/* Delete evicted entries, outside of the cache mutex. */
+static void
+screen_cache_delete_list(struct pipe_context *pipe, struct list_head *list)
+{
+   list_for_each_entry_safe(struct cso_screen_entry, entry, list, link) {
+      cso_delete_state(pipe, entry->state, entry->type);
+      FREE(entry);
+   }
+}
+
+
+void
+cso_screen_cache_detach(struct cso_screen_cache *cache,
+                        struct pipe_context *pipe)
+{
+   struct list_head to_delete;
+   list_inithead(&to_delete);
+
+   simple_mtx_lock(&cache->mutex);
+   assert(cache->num_contexts);
+
+   /* Nothing can reference the objects anymore, and the next context might
+    * not be created before the screen is destroyed.
+    */
+   if (--cache->num_contexts == 0) {
+      assert(cache->stats.num_unused == cache->stats.num_objects);
+      list_for_each_entry_safe(struct cso_screen_entry, entry,
+                               &cache->unused, link)
+         screen_cache_evict(cache, entry, &to_delete);
+   }
+   simple_mtx_unlock(&cache->mutex);
+
+   screen_cache_delete_list(pipe, &to_delete);
+}
+
+
+static inline void
+screen_cache_ref(struct cso_screen_cache *cache,
+                 struct cso_screen_entry *entry)
+{
+   if (entry->refcount++ == 0) {
+      list_del(&entry->link);
+      cache->stats.num_unused--;
+   }
+}
+
+
+void *
+cso_screen_cache_find(struct cso_screen_cache *cache,
+                      enum cso_cache_type type, unsigned hash_key,
+                      const void *templ, unsigned key_size)
+{
+   void *state = NULL;
+
+   simple_mtx_lock(&cache->mutex);
+   struct cso_hash_iter iter = cso_hash_find(&cache->hashes[type], hash_key);
+   while (!cso_hash_iter_is_null(iter)) {
+      struct cso_screen_entry *entry = cso_hash_iter_data(iter);
+
+      if (!memcmp(entry->state, templ, key_size)) {
+         screen_cache_ref(cache, entry);
+         cache->stats.hits++;
+         state = entry->state;
+         break;
+      }
+      iter = cso_hash_iter_next(iter);
+   }
+   simple_mtx_unlock(&cache->mutex);
+
+   return state;
+}
+
+
+/**
+ * Add a state the caller just created, with a reference for the caller.
+ *
+ * If another context added the same state in the meantime, the new one is
+ * deleted and the existing one returned instead.
+ */
+void *
+cso_screen_cache_add(struct cso_screen_cache *cache,
+                     struct pipe_context *pipe,
+                     enum cso_cache_type type, unsigned hash_key,
+                     void *state, unsigned key_size)
+{
+   struct cso_screen_entry *entry = NULL;
+   void *dup = NULL;
+
+   simple_mtx_lock(&cache->mutex);
+   struct cso_hash_iter iter = cso_hash_find(&cache->hashes[type], hash_key);
+   while (!cso_hash_iter_is_null(iter)) {
+      struct cso_screen_entry *other = cso_hash_iter_data(iter);
+
+      if (!memcmp(other->state, state, key_size)) {
+         screen_cache_ref(cache, other);
+         dup = state;
+         state = other->state;
+         break;
+      }
+      iter = cso_hash_iter_next(iter);
+   }
+
+   if (!dup) {
+      entry = MALLOC_STRUCT(cso_screen_entry);
+      if (entry) {
+         entry->state = state;
+         entry->hash_key = hash_key;
+         entry->refcount = 1;
+         entry->type = type;
+         list_inithead(&entry->link);
+
+         if (cso_hash_iter_is_null(cso_hash_insert(&cache->hashes[type],
+                                                   hash_key, entry))) {
+            FREE(entry);
+         } else {
+            _mesa_hash_table_insert(cache->entries, state, entry);
+            cache->stats.num_objects++;
+            cache->stats.misses++;
+         }
+      }
+   }
+   simple_mtx_unlock(&cache->mutex);
+
+   /* Out of memory: the state just stays private to the context, which
+    * cso_screen_cache_release handles.
+    */
+   if (dup)
+      cso_delete_state(pipe, dup, type);
+   return state;
+}
+
+
+void
+cso_screen_cache_release(struct cso_screen_cache *cache,
+                         struct pipe_context *pipe,
+                         void *state, enum cso_cache_type type)
+{
+   struct list_head to_delete;
+   list_inithead(&to_delete);
+
+   simple_mtx_lock(&cache->mutex);
+   struct hash_entry *he = _mesa_hash_table_search(cache->entries, state);
+   if (!he) {
+      /* created before the context was attached, or not added */
+      simple_mtx_unlock(&cache->mutex);
+      cso_delete_state(pipe, state, type);
+      return;
+   }
+
+   struct cso_screen_entry *entry = he->data;
+   assert(entry->refcount);
+   if (--entry->refcount == 0) {
+      list_addtail(&entry->link, &cache->unused);
+      cache->stats.num_unused++;
+
+      while (cache->stats.num_unused > cache->max_unused) {
+         struct cso_screen_entry *lru =
+            list_first_entry(&cache->unused, struct cso_screen_entry, link);
+         screen_cache_evict(cache, lru, &to_delete);
+         cache->stats.evictions++;
+      }
+   }
+   simple_mtx_unlock(&cache->mutex);
+
+   screen_cache_delete_list(pipe, &to_delete);
+}
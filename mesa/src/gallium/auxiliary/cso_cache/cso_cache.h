@@ -175,6 +175,55 @@ cso_delete_state(struct pipe_context *pipe, void *state,
                  enum cso_cache_type type);
 
 
+/**
+ * Screen-level cache of the objects above, shared by the cso_contexts of a
+ * screen with pipe_caps.shareable_state_objects. Context caches only fall
+ * back to it on a miss, so it doesn't slow down their lookups.
+ */
+struct cso_screen_cache;
+
+struct cso_screen_cache_stats {
+   uint64_t hits;       /**< context cache misses served by another context */
+   uint64_t misses;     /**< objects created by the driver */
+   uint64_t evictions;  /**< unused objects deleted to respect max_unused */
+   unsigned num_objects;
+   unsigned num_unused;
+};
+
+struct cso_screen_cache *
+cso_screen_cache_create(unsigned max_unused);
+
+void
+cso_screen_cache_destroy(struct cso_screen_cache *cache);
+
+void
+cso_screen_cache_get_stats(struct cso_screen_cache *cache,
+                           struct cso_screen_cache_stats *stats);
+
+void
+cso_screen_cache_attach(struct cso_screen_cache *cache);
+
+void
+cso_screen_cache_detach(struct cso_screen_cache *cache,
+                        struct pipe_context *pipe);
+
+void *
+cso_screen_cache_find(struct cso_screen_cache *cache,
+                      enum cso_cache_type type, unsigned hash_key,
+                      const void *templ, unsigned key_size);
+
+void *
+cso_screen_cache_add(struct cso_screen_cache *cache,
+                     struct pipe_context *pipe,
+                     enum cso_cache_type type, unsigned hash_key,
+                     void *state, unsigned key_size);
+
+void
+cso_screen_cache_release(struct cso_screen_cache *cache,
+                         struct pipe_context *pipe,
+                         void *state, enum cso_cache_type type);
+
+
 static ALWAYS_INLINE unsigned
 cso_construct_key(const void *key, int key_size)
 {
@@ -0,0 +1,183 @@
+/*
+ * Copyright 2025 Mesa3D authors
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "pipe/p_context.h"
+#include "util/u_memory.h"
+#include "cso_cache/cso_cache.h"
+
+/* The driver objects are the indices of the blend states, deleting one
+ * records it.
+ */
+static std::vector<uintptr_t> deleted;
+
+static void
+stub_delete_blend_state(struct pipe_context *pipe, void *state)
+{
+   deleted.push_back((uintptr_t)state);
+}
+
+class cso_screen_cache_test : public ::testing::Test {
+protected:
+   cso_screen_cache_test()
+   {
+      pipe = {};
+      pipe.delete_blend_state = stub_delete_blend_state;
+      deleted.clear();
+
+      cache = cso_screen_cache_create(max_unused);
+      cso_screen_cache_attach(cache);
+   }
+
+   ~cso_screen_cache_test()
+   {
+      cso_screen_cache_detach(cache, &pipe);
+      cso_screen_cache_destroy(cache);
+   }
+
+   /* A blend state as cso_context creates it, the driver object being i. */
+   static struct cso_blend *
+   create_blend(unsigned i)
+   {
+      struct cso_blend *blend = CALLOC_STRUCT(cso_blend);
+
+      blend->state.rt[0].rgb_func = i;
+      blend->data = (void *)(uintptr_t)i;
+      return blend;
+   }
+
+   void *
+   add(unsigned i)
+   {
+      struct cso_blend *blend = create_blend(i);
+
+      return cso_screen_cache_add(cache, &pipe, CSO_BLEND, i, blend,
+                                  sizeof(blend->state));
+   }
+
+   void *
+   find(unsigned i)
+   {
+      struct pipe_blend_state templ = {};
+
+      templ.rt[0].rgb_func = i;
+      return cso_screen_cache_find(cache, CSO_BLEND, i, &templ, sizeof(templ));
+   }
+
+   void
+   release(void *state)
+   {
+      cso_screen_cache_release(cache, &pipe, state, CSO_BLEND);
+   }
+
+   struct cso_screen_cache_stats
+   stats()
+   {
+      struct cso_screen_cache_stats stats;
+
+      cso_screen_cache_get_stats(cache, &stats);
+      return stats;
+   }
+
+   static const unsigned max_unused = 2;
+
+   struct pipe_context pipe;
+   struct cso_screen_cache *cache;
+};
+
+TEST_F(cso_screen_cache_test, share)
+{
+   void *a = add(1);
+   EXPECT_EQ(find(1), a);
+   EXPECT_EQ(find(2), nullptr);
+
+   /* A context creating the same state in a race gets the cached one, and
+    * its own is deleted.
+    */
+   EXPECT_EQ(add(1), a);
+   EXPECT_EQ(deleted, std::vector<uintptr_t>({ 1 }));
+
+   struct cso_screen_cache_stats s = stats();
+   EXPECT_EQ(s.hits, 1);
+   EXPECT_EQ(s.misses, 1);
+   EXPECT_EQ(s.num_objects, 1);
+   EXPECT_EQ(s.num_unused, 0);
+
+   /* Referenced three times, it only becomes unused after the last release. */
+   release(a);
+   release(a);
+   EXPECT_EQ(stats().num_unused, 0);
+   release(a);
+   EXPECT_EQ(stats().num_unused, 1);
+   EXPECT_EQ(stats().num_objects, 1);
+   EXPECT_EQ(deleted.size(), 1);
+
+   /* Finding an unused state takes it back off the unused list. */
+   EXPECT_EQ(find(1), a);
+   EXPECT_EQ(stats().num_unused, 0);
+   release(a);
+}
+
+TEST_F(cso_screen_cache_test, evict_lru)
+{
+   void *states[4];
+   for (unsigned i = 0; i < 4; i++)
+      states[i] = add(i);
+
+   /* Release out of creation order: 2, 0, 3, 1. */
+   release(states[2]);
+   release(states[0]);
+   EXPECT_TRUE(deleted.empty());
+   release(states[3]);
+   EXPECT_EQ(deleted, std::vector<uintptr_t>({ 2 }));
+
+   /* Using 0 again makes 3 the least recently released. */
+   EXPECT_EQ(find(0), states[0]);
+   release(states[0]);
+   EXPECT_EQ(deleted, std::vector<uintptr_t>({ 2 }));
+   release(states[1]);
+   EXPECT_EQ(deleted, std::vector<uintptr_t>({ 2, 3 }));
+
+   struct cso_screen_cache_stats s = stats();
+   EXPECT_EQ(s.evictions, 2);
+   EXPECT_EQ(s.num_objects, 2);
+   EXPECT_EQ(s.num_unused, 2);
+
+   /* Evicted states are created again, pushing 0 out. */
+   EXPECT_EQ(find(2), nullptr);
+   release(add(2));
+   EXPECT_EQ(deleted, std::vector<uintptr_t>({ 2, 3, 0 }));
+   EXPECT_EQ(stats().misses, 5);
+}
+
+TEST_F(cso_screen_cache_test, uncached_release)
+{
+   /* States the cache doesn't know are deleted right away. */
+   struct cso_blend *blend = create_blend(7);
+   release(blend);
+   EXPECT_EQ(deleted, std::vector<uintptr_t>({ 7 }));
+   EXPECT_EQ(stats().num_objects, 0);
+}
+
+TEST_F(cso_screen_cache_test, detach)
+{
+   cso_screen_cache_attach(cache);
+
+   release(add(1));
+   release(add(2));
+
+   /* The unused states stay cached until the last context detaches. */
+   cso_screen_cache_detach(cache, &pipe);
+   EXPECT_TRUE(deleted.empty());
+
+   cso_screen_cache_detach(cache, &pipe);
+   EXPECT_EQ(deleted.size(), 2);
+   EXPECT_EQ(stats().num_objects, 0);
+
+   cso_screen_cache_attach(cache);
+}
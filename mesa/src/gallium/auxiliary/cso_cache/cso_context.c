@@ -70,6 +70,9 @@ struct cso_context_priv {
    bool always_use_vbuf;
    bool sampler_format;
 
+   /* shared with the other contexts of the screen, may be NULL */
+   struct cso_screen_cache *screen_cache;
+
    bool has_geometry_shader;
    bool has_tessellation;
    bool has_compute_shader;
@@ -159,11 +162,46 @@ delete_cso(struct cso_context_priv *ctx,
       assert(0);
    }
 
-   cso_delete_state(ctx->base.pipe, state, type);
+   ctx->cache.delete_cso(ctx->cache.delete_cso_ctx, state, type);
    return true;
 }
 
 
+static void
+release_shared_cso(void *data, void *state, enum cso_cache_type type)
+{
+   struct cso_context_priv *ctx = (struct cso_context_priv *)data;
+
+   cso_screen_cache_release(ctx->screen_cache, ctx->base.pipe, state, type);
+}
+
+
+/* On a miss in the context cache, look for an object another context of
+ * the screen already created before asking the driver for a new one.
+ */
+static inline void *
+find_shared_cso(struct cso_context_priv *ctx, unsigned hash_key,
+                enum cso_cache_type type, const void *templ,
+                unsigned key_size)
+{
+   if (!ctx->screen_cache)
+      return NULL;
+   return cso_screen_cache_find(ctx->screen_cache, type, hash_key, templ,
+                                key_size);
+}
+
+
+static inline void *
+share_cso(struct cso_context_priv *ctx, unsigned hash_key,
+          enum cso_cache_type type, void *state, unsigned key_size)
+{
+   if (!ctx->screen_cache)
+      return state;
+   return cso_screen_cache_add(ctx->screen_cache, ctx->base.pipe, type,
+                               hash_key, state, key_size);
+}
+
+
 static inline void
 sanitize_hash(struct cso_hash *hash, enum cso_cache_type type,
               int max_size, void *user_data)
@@ -351,6 +389,26 @@ cso_create_context(struct pipe_context *pipe, unsigned flags)
 }
 
 
+/**
+ * Share the blend, DSA, rasterizer, sampler and vertex elements objects of
+ * this context with the other contexts using the same screen cache. This
+ * does nothing unless the driver supports pipe_caps.shareable_state_objects.
+ */
+void
+cso_set_screen_cache(struct cso_context *cso, struct cso_screen_cache *cache)
+{
+   struct cso_context_priv *ctx = (struct cso_context_priv *)cso;
+
+   assert(!ctx->screen_cache);
+   if (!cache || !cso->pipe->screen->caps.shareable_state_objects)
+      return;
+
+   cso_screen_cache_attach(cache);
+   ctx->screen_cache = cache;
+   cso_cache_set_delete_cso_callback(&ctx->cache, release_shared_cso, ctx);
+}
+
+
 void
 cso_unbind_context(struct cso_context *cso)
 {
@@ -492,6 +550,8 @@ cso_destroy_context(struct cso_context *cso)
 
    cso_unbind_context(cso);
    cso_cache_delete(&ctx->cache);
+   if (ctx->screen_cache)
+      cso_screen_cache_detach(ctx->screen_cache, ctx->base.pipe);
 
    if (ctx->vbuf)
       u_vbuf_destroy(ctx->vbuf);
@@ -540,17 +600,22 @@ cso_set_blend(struct cso_context *cso,
    }
 
    if (cso_hash_iter_is_null(iter)) {
-      struct cso_blend *cso = MALLOC(sizeof(struct cso_blend));
-      if (!cso)
-         return PIPE_ERROR_OUT_OF_MEMORY;
-
-      memset(&cso->state, 0, sizeof cso->state);
-      memcpy(&cso->state, templ, key_size);
-      cso->data = ctx->base.pipe->create_blend_state(ctx->base.pipe, &cso->state);
+      struct cso_blend *cso = find_shared_cso(ctx, hash_key, CSO_BLEND,
+                                              templ, key_size);
+      if (!cso) {
+         cso = MALLOC(sizeof(struct cso_blend));
+         if (!cso)
+            return PIPE_ERROR_OUT_OF_MEMORY;
+
+         memset(&cso->state, 0, sizeof cso->state);
+         memcpy(&cso->state, templ, key_size);
+         cso->data = ctx->base.pipe->create_blend_state(ctx->base.pipe, &cso->state);
+         cso = share_cso(ctx, hash_key, CSO_BLEND, cso, key_size);
+      }
 
       iter = cso_insert_state(&ctx->cache, hash_key, CSO_BLEND, cso);
       if (cso_hash_iter_is_null(iter)) {
-         FREE(cso);
+         ctx->cache.delete_cso(ctx->cache.delete_cso_ctx, cso, CSO_BLEND);
          return PIPE_ERROR_OUT_OF_MEMORY;
       }
 
@@ -601,18 +666,25 @@ cso_set_depth_stencil_alpha(struct cso_context *cso,
 
    if (cso_hash_iter_is_null(iter)) {
       struct cso_depth_stencil_alpha *cso =
-         MALLOC(sizeof(struct cso_depth_stencil_alpha));
-      if (!cso)
-         return PIPE_ERROR_OUT_OF_MEMORY;
-
-      memcpy(&cso->state, templ, sizeof(*templ));
-      cso->data = ctx->base.pipe->create_depth_stencil_alpha_state(ctx->base.pipe,
-                                                              &cso->state);
+         find_shared_cso(ctx, hash_key, CSO_DEPTH_STENCIL_ALPHA, templ,
+                         key_size);
+      if (!cso) {
+         cso = MALLOC(sizeof(struct cso_depth_stencil_alpha));
+         if (!cso)
+            return PIPE_ERROR_OUT_OF_MEMORY;
+
+         memcpy(&cso->state, templ, sizeof(*templ));
+         cso->data = ctx->base.pipe->create_depth_stencil_alpha_state(ctx->base.pipe,
+                                                                 &cso->state);
+         cso = share_cso(ctx, hash_key, CSO_DEPTH_STENCIL_ALPHA, cso,
+                         key_size);
+      }
 
       iter = cso_insert_state(&ctx->cache, hash_key,
                               CSO_DEPTH_STENCIL_ALPHA, cso);
       if (cso_hash_iter_is_null(iter)) {
-         FREE(cso);
+         ctx->cache.delete_cso(ctx->cache.delete_cso_ctx, cso,
+                               CSO_DEPTH_STENCIL_ALPHA);
          return PIPE_ERROR_OUT_OF_MEMORY;
       }
 
@@ -669,16 +741,22 @@ cso_set_rasterizer(struct cso_context *cso,
    assert(!(templ->point_quad_rasterization && templ->point_smooth));
 
    if (cso_hash_iter_is_null(iter)) {
-      struct cso_rasterizer *cso = MALLOC(sizeof(struct cso_rasterizer));
-      if (!cso)
-         return PIPE_ERROR_OUT_OF_MEMORY;
-
-      memcpy(&cso->state, templ, sizeof(*templ));
-      cso->data = ctx->base.pipe->create_rasterizer_state(ctx->base.pipe, &cso->state);
+      struct cso_rasterizer *cso = find_shared_cso(ctx, hash_key,
+                                                   CSO_RASTERIZER, templ,
+                                                   key_size);
+      if (!cso) {
+         cso = MALLOC(sizeof(struct cso_rasterizer));
+         if (!cso)
+            return PIPE_ERROR_OUT_OF_MEMORY;
+
+         memcpy(&cso->state, templ, sizeof(*templ));
+         cso->data = ctx->base.pipe->create_rasterizer_state(ctx->base.pipe, &cso->state);
+         cso = share_cso(ctx, hash_key, CSO_RASTERIZER, cso, key_size);
+      }
 
       iter = cso_insert_state(&ctx->cache, hash_key, CSO_RASTERIZER, cso);
       if (cso_hash_iter_is_null(iter)) {
-         FREE(cso);
+         ctx->cache.delete_cso(ctx->cache.delete_cso_ctx, cso, CSO_RASTERIZER);
          return PIPE_ERROR_OUT_OF_MEMORY;
       }
 
@@ -1200,24 +1278,30 @@ cso_set_vertex_elements_direct(struct cso_context_priv *ctx,
    void *handle;
 
    if (cso_hash_iter_is_null(iter)) {
-      struct cso_velements *cso = MALLOC(sizeof(struct cso_velements));
-      if (!cso)
-         return;
-
-      memcpy(&cso->state, velems, key_size);
-
-      /* Lower 64-bit vertex attributes. */
-      unsigned new_count = velems->count;
-      const struct pipe_vertex_element *new_elems = velems->velems;
-      struct pipe_vertex_element tmp[PIPE_MAX_ATTRIBS];
-      util_lower_uint64_vertex_elements(&new_elems, &new_count, tmp);
-
-      cso->data = ctx->base.pipe->create_vertex_elements_state(ctx->base.pipe, new_count,
-                                                          new_elems);
+      struct cso_velements *cso = find_shared_cso(ctx, hash_key,
+                                                  CSO_VELEMENTS, velems,
+                                                  key_size);
+      if (!cso) {
+         cso = MALLOC(sizeof(struct cso_velements));
+         if (!cso)
+            return;
+
+         memcpy(&cso->state, velems, key_size);
+
+         /* Lower 64-bit vertex attributes. */
+         unsigned new_count = velems->count;
+         const struct pipe_vertex_element *new_elems = velems->velems;
+         struct pipe_vertex_element tmp[PIPE_MAX_ATTRIBS];
+         util_lower_uint64_vertex_elements(&new_elems, &new_count, tmp);
+
+         cso->data = ctx->base.pipe->create_vertex_elements_state(ctx->base.pipe, new_count,
+                                                             new_elems);
+         cso = share_cso(ctx, hash_key, CSO_VELEMENTS, cso, key_size);
+      }
 
       iter = cso_insert_state(&ctx->cache, hash_key, CSO_VELEMENTS, cso);
       if (cso_hash_iter_is_null(iter)) {
-         FREE(cso);
+         ctx->cache.delete_cso(ctx->cache.delete_cso_ctx, cso, CSO_VELEMENTS);
          return;
       }
 
@@ -1365,17 +1449,21 @@ set_sampler(struct cso_context_priv *ctx, enum pipe_shader_type shader_stage,
                               templ, key_size);
 
    if (cso_hash_iter_is_null(iter)) {
-      cso = MALLOC(sizeof(struct cso_sampler));
-      if (!cso)
-         return false;
-
-      memcpy(&cso->state, templ, sizeof(*templ));
-      cso->data = ctx->base.pipe->create_sampler_state(ctx->base.pipe, &cso->state);
-      cso->hash_key = hash_key;
+      cso = find_shared_cso(ctx, hash_key, CSO_SAMPLER, templ, key_size);
+      if (!cso) {
+         cso = MALLOC(sizeof(struct cso_sampler));
+         if (!cso)
+            return false;
+
+         memcpy(&cso->state, templ, sizeof(*templ));
+         cso->data = ctx->base.pipe->create_sampler_state(ctx->base.pipe, &cso->state);
+         cso->hash_key = hash_key;
+         cso = share_cso(ctx, hash_key, CSO_SAMPLER, cso, key_size);
+      }
 
       iter = cso_insert_state(&ctx->cache, hash_key, CSO_SAMPLER, cso);
       if (cso_hash_iter_is_null(iter)) {
-         FREE(cso);
+         ctx->cache.delete_cso(ctx->cache.delete_cso_ctx, cso, CSO_SAMPLER);
          return false;
       }
    } else {
@@ -59,6 +59,9 @@ cso_unbind_context(struct cso_context *ctx);
 void
 cso_destroy_context(struct cso_context *cso);
 
+void
+cso_set_screen_cache(struct cso_context *cso, struct cso_screen_cache *cache);
+
 enum pipe_error
 cso_set_blend(struct cso_context *cso, const struct pipe_blend_state *blend);
 
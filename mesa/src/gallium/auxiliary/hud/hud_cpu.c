@@ -424,6 +424,10 @@ static unsigned get_counter(struct hud_graph *gr, enum hud_counter counter)
       value = mon->num_batches;
       mon->num_batches = 0;
       return value;
+   case HUD_COUNTER_ELIMINATED:
+      value = mon->num_eliminated_calls;
+      mon->num_eliminated_calls = 0;
+      return value;
    default:
       assert(0);
       return 0;
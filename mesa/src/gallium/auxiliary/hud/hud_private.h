@@ -40,6 +40,7 @@ enum hud_counter {
    HUD_COUNTER_DIRECT,
    HUD_COUNTER_SYNCS,
    HUD_COUNTER_BATCHES,
+   HUD_COUNTER_ELIMINATED,
 };
 
 struct hud_context {
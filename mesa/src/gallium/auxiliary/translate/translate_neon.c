@@ -0,0 +1,714 @@
+/*
+ * Copyright 2025 Mesa3D authors
+ * SPDX-License-Identifier: MIT
+ */
+
+/*
+ * AArch64 NEON implementation of translate.
+ *
+ * Instead of generating code at runtime like translate_sse.c, this uses a
+ * table of prebuilt kernels, one per input format class. Each kernel converts
+ * one attribute for all vertices of a run, so the format dispatch happens once
+ * per attribute instead of once per vertex and attribute like in
+ * translate_generic.c.
+ *
+ * Only conversions to R32[G32[B32[A32]]]_FLOAT and plain copies are handled,
+ * which covers what u_vbuf falls back to. Other keys return NULL and end up
+ * in translate_generic.
+ */
+
+#include "util/detect.h"
+#include "util/compiler.h"
+#include "util/u_memory.h"
+#include "util/u_math.h"
+#include "util/format/u_format.h"
+
+#include "translate.h"
+
+
+#if DETECT_ARCH_AARCH64
+
+#include <arm_neon.h>
+#include <math.h>
+
+enum neon_kind {
+   NEON_COPY,
+   NEON_U8,
+   NEON_S8,
+   NEON_U8_BGRA,
+   NEON_U16,
+   NEON_S16,
+   NEON_U32,
+   NEON_S32,
+   NEON_F16,
+   NEON_F32,
+   NEON_F64,
+   NEON_U10_10_10_2,
+   NEON_S10_10_10_2,
+};
+
+struct translate_neon_attrib;
+
+typedef void (*neon_fetch_func)(const struct translate_neon_attrib *a,
+                                const uint8_t *src, unsigned src_stride,
+                                const void *elts, unsigned index_size,
+                                unsigned count,
+                                uint8_t *dst, unsigned dst_stride);
+
+struct translate_neon_attrib {
+   neon_fetch_func fetch;
+
+   unsigned buffer;
+   unsigned input_offset;
+   unsigned instance_divisor;
+   unsigned output_offset;
+
+   const uint8_t *input_ptr;
+   unsigned input_stride;
+   unsigned max_index;
+
+   /* Bytes read per vertex, or copied for NEON_COPY. */
+   unsigned input_size;
+   unsigned output_channels;
+
+   /* Applied after converting to float: max(v * scale, min). Channels that
+    * are missing from the input format are replaced by (0, 0, 0, 1).
+    */
+   float scale[4];
+   float min[4];
+   uint32_t default_mask[4];
+
+   /* Packed formats: v << lshift >> rshift, rshift being negative. */
+   int32_t lshift[4];
+   int32_t rshift[4];
+};
+
+struct translate_neon {
+   struct translate translate;
+
+   unsigned nr_attrib;
+   struct translate_neon_attrib attrib[TRANSLATE_MAX_ATTRIBS];
+};
+
+static struct translate_neon *
+translate_neon(struct translate *translate)
+{
+   return (struct translate_neon *)translate;
+}
+
+/* Kernel constants, kept in registers for the whole loop. */
+struct neon_consts {
+   float32x4_t scale;
+   float32x4_t min;
+   float32x4_t defaults;
+   uint32x4_t default_mask;
+   int32x4_t lshift;
+   int32x4_t rshift;
+   unsigned input_size;
+};
+
+static ALWAYS_INLINE const uint8_t *
+neon_vertex(const uint8_t *src, unsigned stride, const void *elts,
+            unsigned index_size, unsigned max_index, unsigned i)
+{
+   unsigned index;
+
+   switch (index_size) {
+   case 0:
+      index = i;
+      break;
+   case 1:
+      index = MIN2(((const uint8_t *)elts)[i], max_index);
+      break;
+   case 2:
+      index = MIN2(((const uint16_t *)elts)[i], max_index);
+      break;
+   default:
+      index = MIN2(((const unsigned *)elts)[i], max_index);
+      break;
+   }
+
+   return src + (ptrdiff_t)stride * index;
+}
+
+/* Load the bytes of one vertex without reading past it. */
+static ALWAYS_INLINE uint8x16_t
+neon_load_bytes(const uint8_t *src, unsigned size)
+{
+   uint8_t tmp[16];
+   uint32_t dw;
+
+   switch (size) {
+   case 16:
+      return vld1q_u8(src);
+   case 8:
+      return vcombine_u8(vld1_u8(src), vdup_n_u8(0));
+   case 4:
+      memcpy(&dw, src, 4);
+      return vreinterpretq_u8_u32(vsetq_lane_u32(dw, vdupq_n_u32(0), 0));
+   default:
+      memset(tmp, 0, sizeof(tmp));
+      memcpy(tmp, src, MIN2(size, 16));
+      return vld1q_u8(tmp);
+   }
+}
+
+static ALWAYS_INLINE float32x4_t
+neon_load_u8(const struct neon_consts *c, const uint8_t *src)
+{
+   uint8x16_t b = neon_load_bytes(src, c->input_size);
+   uint16x8_t w = vmovl_u8(vget_low_u8(b));
+
+   return vcvtq_f32_u32(vmovl_u16(vget_low_u16(w)));
+}
+
+static ALWAYS_INLINE float32x4_t
+neon_load_s8(const struct neon_consts *c, const uint8_t *src)
+{
+   int8x16_t b = vreinterpretq_s8_u8(neon_load_bytes(src, c->input_size));
+   int16x8_t w = vmovl_s8(vget_low_s8(b));
+
+   return vcvtq_f32_s32(vmovl_s16(vget_low_s16(w)));
+}
+
+static ALWAYS_INLINE float32x4_t
+neon_load_u8_bgra(const struct neon_consts *c, const uint8_t *src)
+{
+   float32x4_t v = neon_load_u8(c, src);
+
+   return vcopyq_laneq_f32(vcopyq_laneq_f32(v, 0, v, 2), 2, v, 0);
+}
+
+static ALWAYS_INLINE float32x4_t
+neon_load_u16(const struct neon_consts *c, const uint8_t *src)
+{
+   uint16x8_t w = vreinterpretq_u16_u8(neon_load_bytes(src, c->input_size));
+
+   return vcvtq_f32_u32(vmovl_u16(vget_low_u16(w)));
+}
+
+static ALWAYS_INLINE float32x4_t
+neon_load_s16(const struct neon_consts *c, const uint8_t *src)
+{
+   int16x8_t w = vreinterpretq_s16_u8(neon_load_bytes(src, c->input_size));
+
+   return vcvtq_f32_s32(vmovl_s16(vget_low_s16(w)));
+}
+
+static ALWAYS_INLINE float32x4_t
+neon_load_u32(const struct neon_consts *c, const uint8_t *src)
+{
+   return vcvtq_f32_u32(vreinterpretq_u32_u8(neon_load_bytes(src, c->input_size)));
+}
+
+static ALWAYS_INLINE float32x4_t
+neon_load_s32(const struct neon_consts *c, const uint8_t *src)
+{
+   return vcvtq_f32_s32(vreinterpretq_s32_u8(neon_load_bytes(src, c->input_size)));
+}
+
+static ALWAYS_INLINE float32x4_t
+neon_load_f16(const struct neon_consts *c, const uint8_t *src)
+{
+   uint8x16_t b = neon_load_bytes(src, c->input_size);
+
+   return vcvt_f32_f16(vreinterpret_f16_u8(vget_low_u8(b)));
+}
+
+static ALWAYS_INLINE float32x4_t
+neon_load_f32(const struct neon_consts *c, const uint8_t *src)
+{
+   return vreinterpretq_f32_u8(neon_load_bytes(src, c->input_size));
+}
+
+static ALWAYS_INLINE float32x4_t
+neon_load_f64(const struct neon_consts *c, const uint8_t *src)
+{
+   uint8x16_t lo = neon_load_bytes(src, MIN2(c->input_size, 16));
+   uint8x16_t hi = c->input_size > 16 ?
+      neon_load_bytes(src + 16, c->input_size - 16) : vdupq_n_u8(0);
+
+   return vcombine_f32(vcvt_f32_f64(vreinterpretq_f64_u8(lo)),
+                       vcvt_f32_f64(vreinterpretq_f64_u8(hi)));
+}
+
+static ALWAYS_INLINE float32x4_t
+neon_load_u10_10_10_2(const struct neon_consts *c, const uint8_t *src)
+{
+   uint32_t dw;
+
+   memcpy(&dw, src, 4);
+   uint32x4_t v = vshlq_u32(vshlq_u32(vdupq_n_u32(dw), c->lshift), c->rshift);
+   return vcvtq_f32_u32(v);
+}
+
+static ALWAYS_INLINE float32x4_t
+neon_load_s10_10_10_2(const struct neon_consts *c, const uint8_t *src)
+{
+   int32_t dw;
+
+   memcpy(&dw, src, 4);
+   int32x4_t v = vshlq_s32(vshlq_s32(vdupq_n_s32(dw), c->lshift), c->rshift);
+   return vcvtq_f32_s32(v);
+}
+
+static ALWAYS_INLINE void
+neon_store(uint8_t *dst, float32x4_t v, unsigned nr)
+{
+   float *f = (float *)dst;
+
+   switch (nr) {
+   case 4:
+      vst1q_f32(f, v);
+      break;
+   case 3:
+      vst1_f32(f, vget_low_f32(v));
+      vst1q_lane_f32(f + 2, v, 2);
+      break;
+   case 2:
+      vst1_f32(f, vget_low_f32(v));
+      break;
+   default:
+      vst1q_lane_f32(f, v, 0);
+      break;
+   }
+}
+
+#define NEON_FETCH_LOOP(load, index_size)                                    \
+   for (unsigned i = 0; i < count; i++) {                                    \
+      const uint8_t *p = neon_vertex(src, src_stride, elts, index_size,      \
+                                     max_index, i);                          \
+      float32x4_t v = vmaxq_f32(vmulq_f32(load(&c, p), c.scale), c.min);     \
+                                                                             \
+      neon_store(dst, vbslq_f32(c.default_mask, c.defaults, v), nr);         \
+      dst += dst_stride;                                                     \
+   }
+
+#define NEON_FETCH_FUNC(name)                                                \
+static void                                                                  \
+neon_fetch_##name(const struct translate_neon_attrib *a,                     \
+                  const uint8_t *src, unsigned src_stride,                   \
+                  const void *elts, unsigned index_size,                     \
+                  unsigned count,                                            \
+                  uint8_t *dst, unsigned dst_stride)                         \
+{                                                                            \
+   static const float defaults[4] = { 0, 0, 0, 1 };                          \
+   const struct neon_consts c = {                                            \
+      .scale = vld1q_f32(a->scale),                                          \
+      .min = vld1q_f32(a->min),                                              \
+      .defaults = vld1q_f32(defaults),                                       \
+      .default_mask = vld1q_u32(a->default_mask),                            \
+      .lshift = vld1q_s32(a->lshift),                                        \
+      .rshift = vld1q_s32(a->rshift),                                        \
+      .input_size = a->input_size,                                           \
+   };                                                                        \
+   const unsigned max_index = a->max_index;                                  \
+   const unsigned nr = a->output_channels;                                   \
+                                                                             \
+   switch (index_size) {                                                     \
+   case 0: NEON_FETCH_LOOP(neon_load_##name, 0); break;                      \
+   case 1: NEON_FETCH_LOOP(neon_load_##name, 1); break;                      \
+   case 2: NEON_FETCH_LOOP(neon_load_##name, 2); break;                      \
+   default: NEON_FETCH_LOOP(neon_load_##name, 4); break;                     \
+   }                                                                         \
+}
+
+NEON_FETCH_FUNC(u8)
+NEON_FETCH_FUNC(s8)
+NEON_FETCH_FUNC(u8_bgra)
+NEON_FETCH_FUNC(u16)
+NEON_FETCH_FUNC(s16)
+NEON_FETCH_FUNC(u32)
+NEON_FETCH_FUNC(s32)
+NEON_FETCH_FUNC(f16)
+NEON_FETCH_FUNC(f32)
+NEON_FETCH_FUNC(f64)
+NEON_FETCH_FUNC(u10_10_10_2)
+NEON_FETCH_FUNC(s10_10_10_2)
+
+static ALWAYS_INLINE void
+neon_copy_bytes(uint8_t *dst, const uint8_t *src, unsigned size)
+{
+   switch (size) {
+   case 16:
+      vst1q_u8(dst, vld1q_u8(src));
+      break;
+   case 8:
+      vst1_u8(dst, vld1_u8(src));
+      break;
+   case 4:
+      memcpy(dst, src, 4);
+      break;
+   default:
+      memcpy(dst, src, size);
+      break;
+   }
+}
+
+#define NEON_COPY_LOOP(index_size)                                           \
+   for (unsigned i = 0; i < count; i++) {                                    \
+      const uint8_t *p = neon_vertex(src, src_stride, elts, index_size,      \
+                                     max_index, i);                          \
+                                                                             \
+      neon_copy_bytes(dst, p, size);                                         \
+      dst += dst_stride;                                                     \
+   }
+
+static void
+neon_fetch_copy(const struct translate_neon_attrib *a,
+                const uint8_t *src, unsigned src_stride,
+                const void *elts, unsigned index_size,
+                unsigned count,
+                uint8_t *dst, unsigned dst_stride)
+{
+   const unsigned max_index = a->max_index;
+   const unsigned size = a->input_size;
+
+   switch (index_size) {
+   case 0: NEON_COPY_LOOP(0); break;
+   case 1: NEON_COPY_LOOP(1); break;
+   case 2: NEON_COPY_LOOP(2); break;
+   default: NEON_COPY_LOOP(4); break;
+   }
+}
+
+static const neon_fetch_func neon_fetch_funcs[] = {
+   [NEON_COPY] = neon_fetch_copy,
+   [NEON_U8] = neon_fetch_u8,
+   [NEON_S8] = neon_fetch_s8,
+   [NEON_U8_BGRA] = neon_fetch_u8_bgra,
+   [NEON_U16] = neon_fetch_u16,
+   [NEON_S16] = neon_fetch_s16,
+   [NEON_U32] = neon_fetch_u32,
+   [NEON_S32] = neon_fetch_s32,
+   [NEON_F16] = neon_fetch_f16,
+   [NEON_F32] = neon_fetch_f32,
+   [NEON_F64] = neon_fetch_f64,
+   [NEON_U10_10_10_2] = neon_fetch_u10_10_10_2,
+   [NEON_S10_10_10_2] = neon_fetch_s10_10_10_2,
+};
+
+static void
+neon_run(struct translate_neon *tn, const void *elts, unsigned index_size,
+         unsigned start, unsigned count, unsigned start_instance,
+         unsigned instance_id, void *output_buffer)
+{
+   uint8_t *out = output_buffer;
+
+   for (unsigned i = 0; i < tn->nr_attrib; i++) {
+      const struct translate_neon_attrib *a = &tn->attrib[i];
+      const uint8_t *src = a->input_ptr;
+      unsigned src_stride = a->input_stride;
+      unsigned attr_index_size = index_size;
+
+      if (a->instance_divisor) {
+         /* Same vertex for the whole run, not clamped like in
+          * translate_generic.
+          */
+         unsigned index = start_instance + instance_id / a->instance_divisor;
+
+         src += (ptrdiff_t)src_stride * index;
+         src_stride = 0;
+         attr_index_size = 0;
+      } else if (!index_size) {
+         src += (ptrdiff_t)src_stride * start;
+      }
+
+      a->fetch(a, src, src_stride, elts, attr_index_size, count,
+               out + a->output_offset, tn->translate.key.output_stride);
+   }
+}
+
+static void UTIL_CDECL
+neon_run_elts(struct translate *translate,
+              const unsigned *elts,
+              unsigned count,
+              unsigned start_instance,
+              unsigned instance_id,
+              void *output_buffer)
+{
+   neon_run(translate_neon(translate), elts, 4, 0, count, start_instance,
+            instance_id, output_buffer);
+}
+
+static void UTIL_CDECL
+neon_run_elts16(struct translate *translate,
+                const uint16_t *elts,
+                unsigned count,
+                unsigned start_instance,
+                unsigned instance_id,
+                void *output_buffer)
+{
+   neon_run(translate_neon(translate), elts, 2, 0, count, start_instance,
+            instance_id, output_buffer);
+}
+
+static void UTIL_CDECL
+neon_run_elts8(struct translate *translate,
+               const uint8_t *elts,
+               unsigned count,
+               unsigned start_instance,
+               unsigned instance_id,
+               void *output_buffer)
+{
+   neon_run(translate_neon(translate), elts, 1, 0, count, start_instance,
+            instance_id, output_buffer);
+}
+
+static void UTIL_CDECL
+neon_run_linear(struct translate *translate,
+                unsigned start,
+                unsigned count,
+                unsigned start_instance,
+                unsigned instance_id,
+                void *output_buffer)
+{
+   neon_run(translate_neon(translate), NULL, 0, start, count, start_instance,
+            instance_id, output_buffer);
+}
+
+static void
+neon_set_buffer(struct translate *translate,
+                unsigned buf,
+                const void *ptr,
+                unsigned stride,
+                unsigned max_index)
+{
+   struct translate_neon *tn = translate_neon(translate);
+
+   for (unsigned i = 0; i < tn->nr_attrib; i++) {
+      if (tn->attrib[i].buffer == buf) {
+         tn->attrib[i].input_ptr = ((const uint8_t *)ptr +
+                                    tn->attrib[i].input_offset);
+         tn->attrib[i].input_stride = stride;
+         tn->attrib[i].max_index = max_index;
+      }
+   }
+}
+
+static void
+neon_release(struct translate *translate)
+{
+   FREE(translate);
+}
+
+static unsigned
+neon_float_output_channels(enum pipe_format format)
+{
+   switch (format) {
+   case PIPE_FORMAT_R32_FLOAT: return 1;
+   case PIPE_FORMAT_R32G32_FLOAT: return 2;
+   case PIPE_FORMAT_R32G32B32_FLOAT: return 3;
+   case PIPE_FORMAT_R32G32B32A32_FLOAT: return 4;
+   default: return 0;
+   }
+}
+
+static bool
+neon_init_packed(struct translate_neon_attrib *a, enum pipe_format format)
+{
+   /* Bit offset of R, G, B, A. */
+   static const unsigned rgba_offsets[4] = { 0, 10, 20, 30 };
+   static const unsigned bgra_offsets[4] = { 20, 10, 0, 30 };
+   const unsigned *offsets;
+   bool is_signed, is_norm;
+
+   switch (format) {
+   case PIPE_FORMAT_R10G10B10A2_UNORM:
+   case PIPE_FORMAT_R10G10B10A2_SNORM:
+   case PIPE_FORMAT_R10G10B10A2_USCALED:
+   case PIPE_FORMAT_R10G10B10A2_SSCALED:
+      offsets = rgba_offsets;
+      break;
+   case PIPE_FORMAT_B10G10R10A2_UNORM:
+   case PIPE_FORMAT_B10G10R10A2_SNORM:
+   case PIPE_FORMAT_B10G10R10A2_USCALED:
+   case PIPE_FORMAT_B10G10R10A2_SSCALED:
+      offsets = bgra_offsets;
+      break;
+   default:
+      return false;
+   }
+
+   is_signed = util_format_is_snorm(format) ||
+               format == PIPE_FORMAT_R10G10B10A2_SSCALED ||
+               format == PIPE_FORMAT_B10G10R10A2_SSCALED;
+   is_norm = util_format_is_unorm(format) || util_format_is_snorm(format);
+
+   a->fetch = is_signed ? neon_fetch_s10_10_10_2 : neon_fetch_u10_10_10_2;
+   a->input_size = 4;
+
+   for (unsigned c = 0; c < 4; c++) {
+      unsigned bits = c == 3 ? 2 : 10;
+
+      a->lshift[c] = 32 - (offsets[c] + bits);
+      a->rshift[c] = -(int)(32 - bits);
+
+      if (is_norm) {
+         unsigned one = is_signed ? (1u << (bits - 1)) - 1 : (1u << bits) - 1;
+         a->scale[c] = 1.0f / one;
+      }
+      if (is_norm && is_signed)
+         a->min[c] = -1.0f;
+   }
+   return true;
+}
+
+static bool
+neon_init_attrib(struct translate_neon_attrib *a,
+                 const struct translate_element *element)
+{
+   const struct util_format_description *desc =
+      util_format_description(element->input_format);
+   enum neon_kind kind;
+
+   if (element->type != TRANSLATE_ELEMENT_NORMAL || !desc)
+      return false;
+
+   a->buffer = element->input_buffer;
+   a->input_offset = element->input_offset;
+   a->instance_divisor = element->instance_divisor;
+   a->output_offset = element->output_offset;
+
+   if (element->input_format == element->output_format) {
+      if (desc->block.width != 1 || desc->block.height != 1 ||
+          (desc->block.bits & 7))
+         return false;
+
+      a->fetch = neon_fetch_copy;
+      a->input_size = desc->block.bits >> 3;
+      return true;
+   }
+
+   a->output_channels = neon_float_output_channels(element->output_format);
+   if (!a->output_channels)
+      return false;
+
+   for (unsigned c = 0; c < 4; c++) {
+      a->scale[c] = 1.0f;
+      a->min[c] = -INFINITY;
+   }
+
+   if (neon_init_packed(a, element->input_format))
+      return true;
+
+   if (element->input_format == PIPE_FORMAT_B8G8R8A8_UNORM) {
+      a->fetch = neon_fetch_u8_bgra;
+      a->input_size = 4;
+      for (unsigned c = 0; c < 4; c++)
+         a->scale[c] = 1.0f / 255.0f;
+      return true;
+   }
+
+   /* Everything else must be an RGBA-ordered array of equal channels. */
+   if (desc->layout != UTIL_FORMAT_LAYOUT_PLAIN ||
+       desc->colorspace != UTIL_FORMAT_COLORSPACE_RGB ||
+       !desc->is_array || desc->is_mixed ||
+       desc->channel[0].pure_integer)
+      return false;
+
+   for (unsigned c = 0; c < desc->nr_channels; c++) {
+      if (desc->swizzle[c] != PIPE_SWIZZLE_X + c)
+         return false;
+   }
+
+   const struct util_format_channel_description *chan = &desc->channel[0];
+   float one = 1.0f;
+
+   switch (chan->type) {
+   case UTIL_FORMAT_TYPE_UNSIGNED:
+      if (chan->size == 8)
+         kind = NEON_U8;
+      else if (chan->size == 16)
+         kind = NEON_U16;
+      else if (chan->size == 32 && !chan->normalized)
+         kind = NEON_U32;
+      else
+         return false;
+      if (chan->normalized)
+         one = (float)((1u << chan->size) - 1);
+      break;
+   case UTIL_FORMAT_TYPE_SIGNED:
+      if (chan->size == 8)
+         kind = NEON_S8;
+      else if (chan->size == 16)
+         kind = NEON_S16;
+      else if (chan->size == 32 && !chan->normalized)
+         kind = NEON_S32;
+      else
+         return false;
+      if (chan->normalized)
+         one = (float)((1u << (chan->size - 1)) - 1);
+      break;
+   case UTIL_FORMAT_TYPE_FIXED:
+      if (chan->size != 32)
+         return false;
+      kind = NEON_S32;
+      one = 65536.0f;
+      break;
+   case UTIL_FORMAT_TYPE_FLOAT:
+      if (chan->size == 16)
+         kind = NEON_F16;
+      else if (chan->size == 32)
+         kind = NEON_F32;
+      else if (chan->size == 64)
+         kind = NEON_F64;
+      else
+         return false;
+      break;
+   default:
+      return false;
+   }
+
+   a->fetch = neon_fetch_funcs[kind];
+   a->input_size = desc->block.bits >> 3;
+
+   for (unsigned c = 0; c < 4; c++) {
+      a->scale[c] = 1.0f / one;
+      if (chan->type == UTIL_FORMAT_TYPE_SIGNED && chan->normalized)
+         a->min[c] = -1.0f;
+      if (c >= desc->nr_channels)
+         a->default_mask[c] = ~0u;
+   }
+   return true;
+}
+
+struct translate *
+translate_neon_create(const struct translate_key *key)
+{
+   struct translate_neon *tn = CALLOC_STRUCT(translate_neon);
+
+   if (!tn)
+      return NULL;
+
+   assert(key->nr_elements <= TRANSLATE_MAX_ATTRIBS);
+
+   tn->translate.key = *key;
+   tn->translate.release = neon_release;
+   tn->translate.set_buffer = neon_set_buffer;
+   tn->translate.run_elts = neon_run_elts;
+   tn->translate.run_elts16 = neon_run_elts16;
+   tn->translate.run_elts8 = neon_run_elts8;
+   tn->translate.run = neon_run_linear;
+
+   for (unsigned i = 0; i < key->nr_elements; i++) {
+      if (!neon_init_attrib(&tn->attrib[i], &key->element[i])) {
+         FREE(tn);
+         return NULL;
+      }
+   }
+
+   tn->nr_attrib = key->nr_elements;
+
+   return &tn->translate;
+}
+
+#else
+
+struct translate *
+translate_neon_create(const struct translate_key *key)
+{
+   return NULL;
+}
+
+#endif
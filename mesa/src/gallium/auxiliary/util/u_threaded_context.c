@@ -3522,6 +3522,22 @@ tc_call_flush(struct pipe_context *pipe, void *call)
    return call_size(tc_flush_call);
 }
 
+/* Let the index ring reuse the space of the submitted draws once the
+ * flush has completed.
+ */
+static void
+tc_fence_index_uploads(struct threaded_context *tc,
+                       struct pipe_fence_handle **fence,
+                       struct pipe_fence_handle **ring_fence)
+{
+   struct pipe_screen *screen = tc->base.screen;
+
+   if (tc->index_uploader && fence)
+      u_upload_ring_fence(tc->index_uploader, *fence);
+   if (*ring_fence)
+      screen->fence_reference(screen, ring_fence, NULL);
+}
+
 static void
 tc_flush(struct pipe_context *_pipe, struct pipe_fence_handle **fence,
          unsigned flags)
@@ -3531,10 +3547,15 @@ tc_flush(struct pipe_context *_pipe, struct pipe_fence_handle **fence,
    struct pipe_screen *screen = pipe->screen;
    bool async = flags & (PIPE_FLUSH_DEFERRED | PIPE_FLUSH_ASYNC);
    bool deferred = (flags & PIPE_FLUSH_DEFERRED) > 0;
+   struct pipe_fence_handle *ring_fence = NULL;
 
    if (!deferred || !fence)
       tc->in_renderpass = false;
 
+   /* The index ring needs the fence of every submission. */
+   if (tc->index_uploader && !deferred && !fence)
+      fence = &ring_fence;
+
    if (async && tc->options.create_fence) {
       if (fence) {
          struct tc_batch *next = &tc->batch_slots[tc->next];
@@ -3570,6 +3591,7 @@ tc_flush(struct pipe_context *_pipe, struct pipe_fence_handle **fence,
          tc_signal_renderpass_info_ready(tc);
          tc_batch_flush(tc, false);
          tc->seen_fb_state = false;
+         tc_fence_index_uploads(tc, fence, &ring_fence);
       }
 
       return;
@@ -3590,6 +3612,9 @@ out_of_memory:
    pipe->flush(pipe, fence, flags);
    tc_clear_driver_thread(tc);
    tc->flushing = false;
+
+   if (!deferred)
+      tc_fence_index_uploads(tc, fence, &ring_fence);
 }
 
 struct tc_draw_single_drawid {
@@ -3836,6 +3861,12 @@ tc_draw_single_draw_id(struct pipe_context *_pipe,
    simplify_draw_info(&p->info);
 }
 
+static inline struct u_upload_mgr *
+tc_index_uploader(struct threaded_context *tc)
+{
+   return tc->index_uploader ? tc->index_uploader : tc->base.stream_uploader;
+}
+
 /* Single draw with user indices and drawid_offset == 0. */
 static void
 tc_draw_user_indices_single(struct pipe_context *_pipe,
@@ -3858,7 +3889,7 @@ tc_draw_user_indices_single(struct pipe_context *_pipe,
     * e.g. transfer_unmap and flush partially-uninitialized draw_vbo
     * to the driver if it was done afterwards.
     */
-   u_upload_data(tc->base.stream_uploader, 0, size, 4,
+   u_upload_data(tc_index_uploader(tc), 0, size, 4,
                  (uint8_t*)info->index.user + draws[0].start * index_size,
                  &offset, &buffer);
    if (unlikely(!buffer))
@@ -3897,7 +3928,7 @@ tc_draw_user_indices_single_draw_id(struct pipe_context *_pipe,
     * e.g. transfer_unmap and flush partially-uninitialized draw_vbo
     * to the driver if it was done afterwards.
     */
-   u_upload_data(tc->base.stream_uploader, 0, size, 4,
+   u_upload_data(tc_index_uploader(tc), 0, size, 4,
                  (uint8_t*)info->index.user + draws[0].start * index_size,
                  &offset, &buffer);
    if (unlikely(!buffer))
@@ -3994,7 +4025,7 @@ tc_draw_user_indices_multi(struct pipe_context *_pipe,
     * e.g. transfer_unmap and flush partially-uninitialized draw_vbo
     * to the driver if it was done afterwards.
     */
-   u_upload_alloc(tc->base.stream_uploader, 0,
+   u_upload_alloc(tc_index_uploader(tc), 0,
                   total_count << index_size_shift, 4,
                   &buffer_offset, &buffer, (void**)&ptr);
    if (unlikely(!buffer))
@@ -5161,6 +5192,9 @@ tc_destroy(struct pipe_context *_pipe)
    if (tc->base.stream_uploader)
       u_upload_destroy(tc->base.stream_uploader);
 
+   if (tc->index_uploader)
+      u_upload_destroy(tc->index_uploader);
+
    tc_sync(tc);
 
    if (util_queue_is_initialized(&tc->queue)) {
@@ -5447,6 +5481,14 @@ threaded_context_create(struct pipe_context *pipe,
    CTX_INIT(get_intel_perf_query_data);
 #undef CTX_INIT
 
+   if (tc->options.ring_upload_size) {
+      tc->index_uploader =
+         u_upload_create_ring(&tc->base, tc->options.ring_upload_size,
+                              PIPE_BIND_INDEX_BUFFER, PIPE_USAGE_STREAM, 0);
+      if (!tc->index_uploader)
+         goto fail;
+   }
+
    if (out)
       *out = tc;
 
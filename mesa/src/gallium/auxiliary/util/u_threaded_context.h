@@ -558,6 +558,11 @@ struct threaded_context_options {
     */
    void (*dsa_parse)(void *state, struct tc_renderpass_info *info);
    void (*fs_parse)(void *state, struct tc_renderpass_info *info);
+   /* if non-zero, user index buffers are uploaded to a persistently mapped
+    * ring buffer of this size (see u_upload_create_ring), which is reused
+    * once the fence of the flush that submitted the draws has signalled
+    */
+   unsigned ring_upload_size;
 };
 
 struct tc_vertex_buffers {
@@ -666,6 +671,11 @@ struct threaded_context {
    struct tc_renderpass_info *renderpass_info_recording;
    /* accessed by driver thread */
    struct tc_renderpass_info *renderpass_info;
+
+   /* Ring uploader for user index buffers, if options.ring_upload_size is
+    * set.
+    */
+   struct u_upload_mgr *index_uploader;
 };
 
 
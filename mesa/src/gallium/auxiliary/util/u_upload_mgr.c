@@ -34,9 +34,21 @@
 #include "pipe/p_context.h"
 #include "util/u_memory.h"
 #include "util/u_math.h"
+#include "util/os_time.h"
 
 #include "u_upload_mgr.h"
 
+/* Maximum number of fences that a ring uploader tracks at a time. When it
+ * runs out, the newest entry is replaced, which only makes reclamation
+ * coarser.
+ */
+#define U_UPLOAD_RING_MAX_FENCES 32
+
+struct u_upload_ring_fence {
+   struct pipe_fence_handle *fence;
+   uint64_t head; /* Ring head when the fence was recorded. */
+};
+
 
 struct u_upload_mgr {
    struct pipe_context *pipe;
@@ -55,6 +67,30 @@ struct u_upload_mgr {
    unsigned offset; /* Aligned offset to the upload buffer, pointing
                      * at the first unused byte. */
    int buffer_private_refcount;
+
+   struct u_upload_stats stats;
+
+   /* Ring mode. The ring buffer stays persistently mapped for the lifetime
+    * of the uploader. ring_head and ring_tail are monotonic byte counters;
+    * the offset in the buffer is the counter modulo ring_size. Everything
+    * between the tail and the head may still be in use by the GPU.
+    */
+   struct pipe_resource *ring_buffer;
+   struct pipe_transfer *ring_transfer;
+   uint8_t *ring_map;
+   unsigned ring_size;
+   uint64_t ring_head;
+   uint64_t ring_tail;
+   struct u_upload_ring_fence ring_fences[U_UPLOAD_RING_MAX_FENCES];
+   unsigned ring_first_fence;
+   unsigned ring_num_fences;
+
+#ifndef NDEBUG
+   /* Non-zero while the ring is being allocated from or fenced, to catch
+    * use from several threads at once.
+    */
+   unsigned ring_users;
+#endif
 };
 
 
@@ -112,9 +148,54 @@ u_upload_clone(struct pipe_context *pipe, struct u_upload_mgr *upload)
    return result;
 }
 
+struct u_upload_mgr *
+u_upload_create_ring(struct pipe_context *pipe, unsigned size,
+                     unsigned bind, enum pipe_resource_usage usage,
+                     unsigned flags)
+{
+   struct u_upload_mgr *upload = u_upload_create(pipe, size, bind, usage,
+                                                 flags);
+   if (!upload || !upload->map_persistent)
+      return upload;
+
+   struct pipe_screen *screen = pipe->screen;
+   struct pipe_resource buffer;
+
+   size = align(size, 4096);
+
+   memset(&buffer, 0, sizeof buffer);
+   buffer.target = PIPE_BUFFER;
+   buffer.format = PIPE_FORMAT_R8_UNORM;
+   buffer.bind = bind;
+   buffer.usage = usage;
+   buffer.flags = flags | PIPE_RESOURCE_FLAG_MAP_PERSISTENT |
+                  PIPE_RESOURCE_FLAG_MAP_COHERENT;
+   buffer.width0 = size;
+   buffer.height0 = 1;
+   buffer.depth0 = 1;
+   buffer.array_size = 1;
+
+   upload->ring_buffer = screen->resource_create(screen, &buffer);
+   if (!upload->ring_buffer)
+      return upload;
+
+   upload->ring_map = pipe_buffer_map_range(pipe, upload->ring_buffer,
+                                            0, size, upload->map_flags,
+                                            &upload->ring_transfer);
+   if (!upload->ring_map) {
+      pipe_resource_reference(&upload->ring_buffer, NULL);
+      return upload;
+   }
+
+   upload->ring_size = size;
+   return upload;
+}
+
 void
 u_upload_disable_persistent(struct u_upload_mgr *upload)
 {
+   /* The ring relies on the persistent mapping. */
+   assert(!upload->ring_buffer);
    upload->map_persistent = false;
    upload->map_flags &= ~(PIPE_MAP_COHERENT | PIPE_MAP_PERSISTENT);
    upload->map_flags |= PIPE_MAP_FLUSH_EXPLICIT;
@@ -169,6 +250,19 @@ void
 u_upload_destroy(struct u_upload_mgr *upload)
 {
    u_upload_release_buffer(upload);
+
+   if (upload->ring_buffer) {
+      struct pipe_screen *screen = upload->pipe->screen;
+
+      for (unsigned i = 0; i < upload->ring_num_fences; i++) {
+         unsigned idx = (upload->ring_first_fence + i) %
+                        U_UPLOAD_RING_MAX_FENCES;
+         screen->fence_reference(screen, &upload->ring_fences[idx].fence,
+                                 NULL);
+      }
+      pipe_buffer_unmap(upload->pipe, upload->ring_transfer);
+      pipe_resource_reference(&upload->ring_buffer, NULL);
+   }
    FREE(upload);
 }
 
@@ -249,14 +343,14 @@ u_upload_alloc_buffer(struct u_upload_mgr *upload, unsigned min_size)
    return size;
 }
 
-void
-u_upload_alloc(struct u_upload_mgr *upload,
-               unsigned min_out_offset,
-               unsigned size,
-               unsigned alignment,
-               unsigned *out_offset,
-               struct pipe_resource **outbuf,
-               void **ptr)
+static void
+upload_alloc_buffer_range(struct u_upload_mgr *upload,
+                          unsigned min_out_offset,
+                          unsigned size,
+                          unsigned alignment,
+                          unsigned *out_offset,
+                          struct pipe_resource **outbuf,
+                          void **ptr)
 {
    unsigned buffer_size = upload->buffer_size;
    unsigned offset = MAX2(min_out_offset, upload->offset);
@@ -314,6 +408,218 @@ u_upload_alloc(struct u_upload_mgr *upload,
    upload->offset = offset + size;
 }
 
+/* The ring is only used by the thread that owns the uploader: the head
+ * recorded by u_upload_ring_fence must not include allocations of another
+ * thread, which the fence doesn't cover.
+ */
+static inline void
+upload_ring_begin(struct u_upload_mgr *upload)
+{
+#ifndef NDEBUG
+   ASSERTED unsigned users = p_atomic_inc_return(&upload->ring_users);
+   assert(users == 1);
+#endif
+}
+
+static inline void
+upload_ring_end(struct u_upload_mgr *upload)
+{
+#ifndef NDEBUG
+   p_atomic_dec(&upload->ring_users);
+#endif
+}
+
+/* Try to suballocate from the ring. Returns false if the space between the
+ * head and the tail is too small.
+ */
+static bool
+upload_ring_try_alloc(struct u_upload_mgr *upload,
+                      unsigned min_out_offset,
+                      unsigned size,
+                      unsigned alignment,
+                      unsigned *out_offset,
+                      bool *wrapped)
+{
+   unsigned ring_size = upload->ring_size;
+   uint64_t head = upload->ring_head;
+   unsigned offset = head % ring_size;
+   unsigned start = align(MAX2(offset, min_out_offset), alignment);
+   uint64_t new_head;
+
+   *wrapped = start + size > ring_size;
+   if (*wrapped) {
+      /* Skip the rest of the buffer and start over at the beginning. */
+      start = align(min_out_offset, alignment);
+      if (start + size > ring_size)
+         return false;
+
+      new_head = head + (ring_size - offset) + start + size;
+   } else {
+      new_head = head + (start - offset) + size;
+   }
+
+   if (new_head - upload->ring_tail > ring_size)
+      return false;
+
+   upload->ring_head = new_head;
+   *out_offset = start;
+   return true;
+}
+
+/* Advance the tail past all signalled fences. If "wait" is set and nothing
+ * could be reclaimed, wait for the oldest fence. Returns false if there
+ * was no fence to wait for.
+ */
+static bool
+upload_ring_reclaim(struct u_upload_mgr *upload, bool wait)
+{
+   struct pipe_screen *screen = upload->pipe->screen;
+   bool progress = false;
+
+   while (upload->ring_num_fences) {
+      struct u_upload_ring_fence *f =
+         &upload->ring_fences[upload->ring_first_fence];
+
+      if (!screen->fence_finish(screen, NULL, f->fence, 0)) {
+         if (!wait || progress)
+            break;
+
+         upload->stats.stalls++;
+         screen->fence_finish(screen, NULL, f->fence, OS_TIMEOUT_INFINITE);
+      }
+
+      upload->ring_tail = f->head;
+      screen->fence_reference(screen, &f->fence, NULL);
+      upload->ring_first_fence = (upload->ring_first_fence + 1) %
+                                 U_UPLOAD_RING_MAX_FENCES;
+      upload->ring_num_fences--;
+      progress = true;
+   }
+
+   return progress || !wait;
+}
+
+static void
+upload_ring_alloc(struct u_upload_mgr *upload,
+                  unsigned min_out_offset,
+                  unsigned size,
+                  unsigned alignment,
+                  unsigned *out_offset,
+                  struct pipe_resource **outbuf,
+                  void **ptr)
+{
+   unsigned offset;
+   bool wrapped;
+
+   upload_ring_begin(upload);
+
+   if (unlikely(!upload_ring_try_alloc(upload, min_out_offset, size,
+                                       alignment, &offset, &wrapped))) {
+      bool success;
+
+      upload_ring_reclaim(upload, false);
+      while (!(success = upload_ring_try_alloc(upload, min_out_offset, size,
+                                               alignment, &offset,
+                                               &wrapped))) {
+         if (!upload_ring_reclaim(upload, true))
+            break;
+      }
+
+      if (!success) {
+         /* Either the allocation is larger than the ring or everything in
+          * the ring is still unfenced. Use a regular buffer instead.
+          */
+         upload_alloc_buffer_range(upload, min_out_offset, size, alignment,
+                                   out_offset, outbuf, ptr);
+         upload->stats.fallbacks++;
+         upload->stats.num_allocs++;
+         upload->stats.bytes += size;
+         upload_ring_end(upload);
+         return;
+      }
+   }
+
+   *ptr = upload->ring_map + offset;
+   *out_offset = offset;
+   pipe_resource_reference(outbuf, upload->ring_buffer);
+
+   if (wrapped)
+      upload->stats.wraps++;
+   upload->stats.num_allocs++;
+   upload->stats.bytes += size;
+   upload_ring_end(upload);
+}
+
+void
+u_upload_alloc(struct u_upload_mgr *upload,
+               unsigned min_out_offset,
+               unsigned size,
+               unsigned alignment,
+               unsigned *out_offset,
+               struct pipe_resource **outbuf,
+               void **ptr)
+{
+   if (upload->ring_buffer) {
+      upload_ring_alloc(upload, min_out_offset, size, alignment,
+                        out_offset, outbuf, ptr);
+      return;
+   }
+
+   upload_alloc_buffer_range(upload, min_out_offset, size, alignment,
+                             out_offset, outbuf, ptr);
+   upload->stats.num_allocs++;
+   upload->stats.bytes += size;
+}
+
+void
+u_upload_ring_fence(struct u_upload_mgr *upload,
+                    struct pipe_fence_handle *fence)
+{
+   if (!upload->ring_buffer || !fence)
+      return;
+
+   struct pipe_screen *screen = upload->pipe->screen;
+   struct u_upload_ring_fence *f = NULL;
+
+   upload_ring_begin(upload);
+   uint64_t head = upload->ring_head;
+
+   if (upload->ring_num_fences) {
+      unsigned last = (upload->ring_first_fence +
+                       upload->ring_num_fences - 1) %
+                      U_UPLOAD_RING_MAX_FENCES;
+      f = &upload->ring_fences[last];
+
+      /* Nothing was allocated since the last fence. */
+      if (f->head == head)
+         goto out;
+   } else if (head == upload->ring_tail) {
+      goto out;
+   }
+
+   /* Fences signal in order, so when the list is full, the newest entry
+    * can just be replaced by the new fence.
+    */
+   if (upload->ring_num_fences < U_UPLOAD_RING_MAX_FENCES) {
+      f = &upload->ring_fences[(upload->ring_first_fence +
+                                upload->ring_num_fences) %
+                               U_UPLOAD_RING_MAX_FENCES];
+      f->fence = NULL;
+      upload->ring_num_fences++;
+   }
+
+   screen->fence_reference(screen, &f->fence, fence);
+   f->head = head;
+out:
+   upload_ring_end(upload);
+}
+
+void
+u_upload_get_stats(struct u_upload_mgr *upload, struct u_upload_stats *stats)
+{
+   *stats = upload->stats;
+}
+
 void
 u_upload_data(struct u_upload_mgr *upload,
               unsigned min_out_offset,
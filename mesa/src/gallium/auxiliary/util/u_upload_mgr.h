@@ -36,12 +36,21 @@
 #include "pipe/p_defines.h"
 
 struct pipe_context;
+struct pipe_fence_handle;
 struct pipe_resource;
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+struct u_upload_stats {
+   uint64_t num_allocs;
+   uint64_t bytes;      /* Bytes suballocated, not counting padding. */
+   uint64_t wraps;      /* Ring mode: times the ring wrapped around. */
+   uint64_t stalls;     /* Ring mode: waits for ring space to be released. */
+   uint64_t fallbacks;  /* Ring mode: allocations that didn't fit in the ring. */
+};
+
 /**
  * Create the upload manager.
  *
@@ -62,6 +71,27 @@ u_upload_create(struct pipe_context *pipe, unsigned default_size,
 struct u_upload_mgr *
 u_upload_create_default(struct pipe_context *pipe);
 
+/**
+ * Create an uploader that suballocates from a single persistently mapped
+ * ring buffer of \p size bytes.
+ *
+ * Ring space is reused once a fence passed to u_upload_ring_fence has
+ * signalled, so the owner must call u_upload_ring_fence after every flush,
+ * and allocations must only be used by commands submitted before the next
+ * one. If the ring is full, the allocation waits for the oldest fence, or if
+ * there is none, falls back to a regular upload buffer.
+ *
+ * Like other uploaders, a ring uploader must only be used by one thread at
+ * a time, including the calls to u_upload_ring_fence: a fence only covers
+ * the allocations of the thread that submitted it.
+ *
+ * Without persistent mapping support, this returns a regular uploader.
+ */
+struct u_upload_mgr *
+u_upload_create_ring(struct pipe_context *pipe, unsigned size,
+                     unsigned bind, enum pipe_resource_usage usage,
+                     unsigned flags);
+
 /**
  * Create an uploader with identical parameters as another one, but using
  * the given pipe_context instead.
@@ -110,6 +140,20 @@ void u_upload_alloc(struct u_upload_mgr *upload,
                     void **ptr);
 
 
+/**
+ * Tell a ring uploader that everything allocated so far is only in use
+ * until \p fence signals. The fence must cover all commands that use those
+ * allocations. This is a no-op for regular uploaders.
+ */
+void u_upload_ring_fence(struct u_upload_mgr *upload,
+                         struct pipe_fence_handle *fence);
+
+/**
+ * Return the allocation statistics of the uploader.
+ */
+void u_upload_get_stats(struct u_upload_mgr *upload,
+                        struct u_upload_stats *stats);
+
 /**
  * Allocate and write data to the upload buffer.
  *
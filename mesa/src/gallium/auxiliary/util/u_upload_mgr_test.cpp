@@ -0,0 +1,299 @@
+/*
+ * Copyright 2025 Mesa3D authors
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <gtest/gtest.h>
+
+#include "pipe/p_context.h"
+#include "pipe/p_screen.h"
+#include "util/os_time.h"
+#include "util/u_inlines.h"
+#include "util/u_memory.h"
+#include "util/u_upload_mgr.h"
+
+/* Buffers backed by malloc'ed memory and fences signalled by the test. */
+struct stub_buffer {
+   struct pipe_resource b;
+   uint8_t *data;
+};
+
+struct stub_fence {
+   struct pipe_reference reference;
+   bool signalled;
+};
+
+static unsigned num_fence_waits;
+
+static struct pipe_resource *
+stub_resource_create(struct pipe_screen *screen,
+                     const struct pipe_resource *templ)
+{
+   struct stub_buffer *buf = CALLOC_STRUCT(stub_buffer);
+
+   buf->b = *templ;
+   buf->b.screen = screen;
+   pipe_reference_init(&buf->b.reference, 1);
+   buf->data = (uint8_t *)CALLOC(1, templ->width0);
+   return &buf->b;
+}
+
+static void
+stub_resource_destroy(struct pipe_screen *screen, struct pipe_resource *res)
+{
+   struct stub_buffer *buf = (struct stub_buffer *)res;
+
+   FREE(buf->data);
+   FREE(buf);
+}
+
+static void
+stub_fence_reference(struct pipe_screen *screen,
+                     struct pipe_fence_handle **ptr,
+                     struct pipe_fence_handle *fence)
+{
+   struct stub_fence *old = (struct stub_fence *)*ptr;
+
+   if (pipe_reference(old ? &old->reference : NULL,
+                      fence ? &((struct stub_fence *)fence)->reference : NULL))
+      FREE(old);
+   *ptr = fence;
+}
+
+static bool
+stub_fence_finish(struct pipe_screen *screen, struct pipe_context *ctx,
+                  struct pipe_fence_handle *fence, uint64_t timeout)
+{
+   struct stub_fence *f = (struct stub_fence *)fence;
+
+   /* Waiting forever on an unsignalled fence is where the GPU would
+    * catch up.
+    */
+   if (!f->signalled && timeout == OS_TIMEOUT_INFINITE) {
+      num_fence_waits++;
+      f->signalled = true;
+   }
+   return f->signalled;
+}
+
+static void *
+stub_buffer_map(struct pipe_context *pipe, struct pipe_resource *res,
+                unsigned level, unsigned usage, const struct pipe_box *box,
+                struct pipe_transfer **transfer)
+{
+   struct pipe_transfer *xfer = CALLOC_STRUCT(pipe_transfer);
+
+   pipe_resource_reference(&xfer->resource, res);
+   xfer->usage = (enum pipe_map_flags)usage;
+   xfer->box = *box;
+   *transfer = xfer;
+   return ((struct stub_buffer *)res)->data + box->x;
+}
+
+static void
+stub_buffer_unmap(struct pipe_context *pipe, struct pipe_transfer *transfer)
+{
+   pipe_resource_reference(&transfer->resource, NULL);
+   FREE(transfer);
+}
+
+class u_upload_ring_test : public ::testing::Test {
+protected:
+   u_upload_ring_test()
+   {
+      screen = CALLOC_STRUCT(pipe_screen);
+      ((struct pipe_caps *)&screen->caps)->buffer_map_persistent_coherent = true;
+      screen->resource_create = stub_resource_create;
+      screen->resource_destroy = stub_resource_destroy;
+      screen->fence_reference = stub_fence_reference;
+      screen->fence_finish = stub_fence_finish;
+
+      pipe = {};
+      pipe.screen = screen;
+      pipe.buffer_map = stub_buffer_map;
+      pipe.buffer_unmap = stub_buffer_unmap;
+
+      upload = u_upload_create_ring(&pipe, ring_size, PIPE_BIND_INDEX_BUFFER,
+                                    PIPE_USAGE_STREAM, 0);
+      num_fence_waits = 0;
+   }
+
+   ~u_upload_ring_test()
+   {
+      u_upload_destroy(upload);
+      FREE(screen);
+   }
+
+   /* Allocate, write the byte pattern and return the offset. */
+   unsigned
+   alloc(unsigned size, struct pipe_resource **buffer, uint8_t value)
+   {
+      unsigned offset;
+      uint8_t *ptr;
+
+      u_upload_alloc(upload, 0, size, 4, &offset, buffer, (void **)&ptr);
+      EXPECT_NE(ptr, nullptr);
+      if (ptr) {
+         EXPECT_EQ(ptr, ((struct stub_buffer *)*buffer)->data + offset);
+         memset(ptr, value, size);
+      }
+      return offset;
+   }
+
+   struct stub_fence *
+   create_fence()
+   {
+      struct stub_fence *fence = CALLOC_STRUCT(stub_fence);
+
+      pipe_reference_init(&fence->reference, 1);
+      return fence;
+   }
+
+   void
+   fence(struct stub_fence *fence)
+   {
+      u_upload_ring_fence(upload, (struct pipe_fence_handle *)fence);
+   }
+
+   void
+   unref(struct stub_fence *fence)
+   {
+      struct pipe_fence_handle *handle = (struct pipe_fence_handle *)fence;
+
+      stub_fence_reference(screen, &handle, NULL);
+   }
+
+   struct u_upload_stats
+   stats()
+   {
+      struct u_upload_stats stats;
+
+      u_upload_get_stats(upload, &stats);
+      return stats;
+   }
+
+   static const unsigned ring_size = 4096;
+
+   struct pipe_screen *screen;
+   struct pipe_context pipe;
+   struct u_upload_mgr *upload;
+};
+
+TEST_F(u_upload_ring_test, wraparound)
+{
+   struct pipe_resource *ring = NULL, *buffer = NULL;
+
+   EXPECT_EQ(alloc(1000, &ring, 1), 0);
+   EXPECT_EQ(alloc(1000, &buffer, 2), 1000);
+   EXPECT_EQ(buffer, ring);
+
+   struct stub_fence *f1 = create_fence();
+   fence(f1);
+   EXPECT_EQ(alloc(2000, &buffer, 3), 2000);
+
+   /* 1000 bytes don't fit at the end: the allocation skips them and reuses
+    * the space fenced by f1 once it signals.
+    */
+   f1->signalled = true;
+   EXPECT_EQ(alloc(1000, &buffer, 4), 0);
+   EXPECT_EQ(buffer, ring);
+
+   /* Only the reused space was overwritten. */
+   uint8_t *data = ((struct stub_buffer *)ring)->data;
+   EXPECT_EQ(data[1000], 2);
+   EXPECT_EQ(data[1999], 2);
+   EXPECT_EQ(data[2000], 3);
+   EXPECT_EQ(data[3999], 3);
+   EXPECT_EQ(data[999], 4);
+
+   struct u_upload_stats s = stats();
+   EXPECT_EQ(s.num_allocs, 4);
+   EXPECT_EQ(s.bytes, 5000);
+   EXPECT_EQ(s.wraps, 1);
+   EXPECT_EQ(s.stalls, 0);
+   EXPECT_EQ(s.fallbacks, 0);
+   EXPECT_EQ(num_fence_waits, 0);
+
+   /* The ring dropped the reference of the reclaimed fence. */
+   EXPECT_EQ(f1->reference.count, 1);
+   unref(f1);
+   pipe_resource_reference(&ring, NULL);
+   pipe_resource_reference(&buffer, NULL);
+}
+
+TEST_F(u_upload_ring_test, stall)
+{
+   struct pipe_resource *ring = NULL, *buffer = NULL;
+
+   alloc(3000, &ring, 1);
+   struct stub_fence *f1 = create_fence();
+   fence(f1);
+   alloc(1000, &buffer, 2);
+   struct stub_fence *f2 = create_fence();
+   fence(f2);
+
+   /* Only the oldest fence is waited for. */
+   EXPECT_EQ(alloc(2000, &buffer, 3), 0);
+   EXPECT_EQ(buffer, ring);
+   EXPECT_EQ(num_fence_waits, 1);
+   EXPECT_TRUE(f1->signalled);
+   EXPECT_FALSE(f2->signalled);
+   EXPECT_EQ(stats().stalls, 1);
+
+   EXPECT_EQ(f1->reference.count, 1);
+   EXPECT_EQ(f2->reference.count, 2);
+   unref(f1);
+   unref(f2);
+   pipe_resource_reference(&ring, NULL);
+   pipe_resource_reference(&buffer, NULL);
+}
+
+TEST_F(u_upload_ring_test, fallback)
+{
+   struct pipe_resource *ring = NULL, *buffer = NULL;
+
+   /* Without a fence, full rings and large allocations use other buffers. */
+   alloc(4000, &ring, 1);
+   alloc(1000, &buffer, 2);
+   EXPECT_NE(buffer, ring);
+   alloc(2 * ring_size, &buffer, 3);
+   EXPECT_NE(buffer, ring);
+
+   struct u_upload_stats s = stats();
+   EXPECT_EQ(s.num_allocs, 3);
+   EXPECT_EQ(s.fallbacks, 2);
+   EXPECT_EQ(num_fence_waits, 0);
+
+   pipe_resource_reference(&ring, NULL);
+   pipe_resource_reference(&buffer, NULL);
+}
+
+TEST_F(u_upload_ring_test, redundant_fences)
+{
+   struct stub_fence *f1 = create_fence();
+   struct stub_fence *f2 = create_fence();
+   struct pipe_resource *buffer = NULL;
+
+   /* Nothing to fence yet. */
+   fence(f1);
+   EXPECT_EQ(f1->reference.count, 1);
+
+   alloc(16, &buffer, 1);
+   fence(f1);
+   EXPECT_EQ(f1->reference.count, 2);
+
+   /* Nothing was allocated since f1. */
+   fence(f2);
+   EXPECT_EQ(f2->reference.count, 1);
+
+   /* Destroying the uploader releases the pending fences. */
+   u_upload_destroy(upload);
+   upload = NULL;
+   EXPECT_EQ(f1->reference.count, 1);
+   unref(f1);
+   unref(f2);
+   pipe_resource_reference(&buffer, NULL);
+
+   upload = u_upload_create_ring(&pipe, ring_size, PIPE_BIND_INDEX_BUFFER,
+                                 PIPE_USAGE_STREAM, 0);
+}
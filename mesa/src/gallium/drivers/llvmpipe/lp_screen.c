@@ -402,6 +402,8 @@ llvmpipe_init_screen_caps(struct pipe_screen *screen)
    caps->tgsi_div = true;
    caps->vendor_id = 0xFFFFFFFF;
    caps->device_id = 0xFFFFFFFF;
+   /* state objects are plain copies of the templates */
+   caps->shareable_state_objects = true;
 
    /* XXX: Do we want to return the full amount fo system memory ? */
    uint64_t system_memory;
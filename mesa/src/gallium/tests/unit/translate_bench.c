@@ -0,0 +1,171 @@
+/*
+ * Copyright 2025 Mesa3D authors
+ * SPDX-License-Identifier: MIT
+ */
+
+/*
+ * Throughput of translate_create() against translate_generic for the
+ * conversions u_vbuf falls back to most often. The outputs of both are
+ * compared first, so this also catches mismatches of the optimized paths.
+ *
+ * Usage: ./translate_bench [iterations]
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "translate/translate.h"
+#include "util/os_time.h"
+#include "util/u_memory.h"
+#include "util/format/u_format.h"
+
+#define NUM_VERTS 4096
+
+static const struct {
+   enum pipe_format input, output;
+} formats[] = {
+   { PIPE_FORMAT_R8G8B8A8_USCALED,     PIPE_FORMAT_R32G32B32A32_FLOAT },
+   { PIPE_FORMAT_R8G8B8A8_SSCALED,     PIPE_FORMAT_R32G32B32A32_FLOAT },
+   { PIPE_FORMAT_R8G8B8A8_UNORM,       PIPE_FORMAT_R32G32B32A32_FLOAT },
+   { PIPE_FORMAT_R8G8B8A8_SNORM,       PIPE_FORMAT_R32G32B32A32_FLOAT },
+   { PIPE_FORMAT_B8G8R8A8_UNORM,       PIPE_FORMAT_R32G32B32A32_FLOAT },
+   { PIPE_FORMAT_R8G8B8_SNORM,         PIPE_FORMAT_R32G32B32_FLOAT },
+   { PIPE_FORMAT_R16G16_SNORM,         PIPE_FORMAT_R32G32_FLOAT },
+   { PIPE_FORMAT_R16G16B16_SSCALED,    PIPE_FORMAT_R32G32B32_FLOAT },
+   { PIPE_FORMAT_R16G16B16A16_UNORM,   PIPE_FORMAT_R32G32B32A32_FLOAT },
+   { PIPE_FORMAT_R16G16B16_FLOAT,      PIPE_FORMAT_R32G32B32_FLOAT },
+   { PIPE_FORMAT_R16G16B16A16_FLOAT,   PIPE_FORMAT_R32G32B32A32_FLOAT },
+   { PIPE_FORMAT_R32G32B32_FIXED,      PIPE_FORMAT_R32G32B32_FLOAT },
+   { PIPE_FORMAT_R32G32B32A32_SSCALED, PIPE_FORMAT_R32G32B32A32_FLOAT },
+   { PIPE_FORMAT_R64G64B64_FLOAT,      PIPE_FORMAT_R32G32B32_FLOAT },
+   { PIPE_FORMAT_R10G10B10A2_SNORM,    PIPE_FORMAT_R32G32B32A32_FLOAT },
+   { PIPE_FORMAT_B10G10R10A2_UNORM,    PIPE_FORMAT_R32G32B32A32_FLOAT },
+   { PIPE_FORMAT_R32G32B32_FLOAT,      PIPE_FORMAT_R32G32B32_FLOAT },
+};
+
+static bool
+same_float(const uint8_t *a, const uint8_t *b)
+{
+   float fa, fb;
+
+   memcpy(&fa, a, 4);
+   memcpy(&fb, b, 4);
+   return !memcmp(a, b, 4) || (isnan(fa) && isnan(fb));
+}
+
+/* Returns the time per run in nanoseconds. */
+static double
+bench(struct translate *translate, const unsigned *elts, unsigned iterations,
+      void *output)
+{
+   int64_t start = os_time_get_nano();
+
+   for (unsigned i = 0; i < iterations; i++) {
+      if (elts)
+         translate->run_elts(translate, elts, NUM_VERTS, 0, 0, output);
+      else
+         translate->run(translate, 0, NUM_VERTS, 0, 0, output);
+   }
+
+   return (double)(os_time_get_nano() - start) / iterations;
+}
+
+int main(int argc, char** argv)
+{
+   unsigned iterations = argc > 1 ? atoi(argv[1]) : 1000;
+   unsigned input_size = NUM_VERTS * 32;
+   unsigned output_size = NUM_VERTS * 16;
+   uint8_t *input = align_malloc(input_size, 64);
+   uint8_t *output[2];
+   unsigned *elts = align_malloc(NUM_VERTS * sizeof(*elts), 64);
+   unsigned failed = 0;
+   unsigned i, j;
+
+   output[0] = align_malloc(output_size, 64);
+   output[1] = align_malloc(output_size, 64);
+
+   srand(4359025);
+
+   /* Use small values so that float inputs aren't mostly NaN or Inf. */
+   for (i = 0; i < input_size; i++)
+      input[i] = rand() & 0x3f;
+
+   /* Shuffled indices like a typical indexed mesh. */
+   for (i = 0; i < NUM_VERTS; i++)
+      elts[i] = i;
+   for (i = NUM_VERTS - 1; i > 0; i--) {
+      unsigned k = rand() % (i + 1);
+      unsigned tmp = elts[i];
+      elts[i] = elts[k];
+      elts[k] = tmp;
+   }
+
+   printf("%-36s %12s %12s %12s %12s\n", "format", "generic", "default",
+          "generic/elt", "default/elt");
+
+   for (i = 0; i < ARRAY_SIZE(formats); i++) {
+      struct translate_key key;
+      struct translate *translate[2];
+      unsigned stride = util_format_get_blocksize(formats[i].input);
+      unsigned output_stride = util_format_get_blocksize(formats[i].output);
+      double ns[4];
+
+      memset(&key, 0, sizeof(key));
+      key.output_stride = output_stride;
+      key.nr_elements = 1;
+      key.element[0].type = TRANSLATE_ELEMENT_NORMAL;
+      key.element[0].input_format = formats[i].input;
+      key.element[0].output_format = formats[i].output;
+
+      translate[0] = translate_generic_create(&key);
+      translate[1] = translate_create(&key);
+      if (!translate[0] || !translate[1]) {
+         printf("%-36s unsupported\n",
+                util_format_short_name(formats[i].input));
+         if (translate[0])
+            translate[0]->release(translate[0]);
+         if (translate[1])
+            translate[1]->release(translate[1]);
+         continue;
+      }
+
+      for (j = 0; j < 2; j++) {
+         translate[j]->set_buffer(translate[j], 0, input, stride,
+                                  NUM_VERTS - 1);
+         memset(output[j], 0xcd, output_size);
+         translate[j]->run_elts(translate[j], elts, NUM_VERTS, 0, 0,
+                                output[j]);
+      }
+
+      for (j = 0; j < NUM_VERTS * output_stride; j += 4) {
+         if (!same_float(output[0] + j, output[1] + j)) {
+            printf("FAIL: %s -> %s mismatch at vertex %u\n",
+                   util_format_short_name(formats[i].input),
+                   util_format_short_name(formats[i].output),
+                   j / output_stride);
+            failed++;
+            break;
+         }
+      }
+
+      for (j = 0; j < 2; j++) {
+         ns[j] = bench(translate[j], NULL, iterations, output[j]);
+         ns[2 + j] = bench(translate[j], elts, iterations, output[j]);
+      }
+
+      /* Report millions of vertices per second. */
+      printf("%-36s %12.1f %12.1f %12.1f %12.1f\n",
+             util_format_short_name(formats[i].input),
+             NUM_VERTS * 1000.0 / ns[0], NUM_VERTS * 1000.0 / ns[1],
+             NUM_VERTS * 1000.0 / ns[2], NUM_VERTS * 1000.0 / ns[3]);
+
+      translate[0]->release(translate[0]);
+      translate[1]->release(translate[1]);
+   }
+
+   align_free(input);
+   align_free(output[0]);
+   align_free(output[1]);
+   align_free(elts);
+   return failed != 0;
+}
@@ -160,6 +160,40 @@ class PrintCode(gl_XML.gl_print_base):
         if not is_packed and func.packed_fixed_params:
             self.print_unmarshal_func(func, is_packed=True)
 
+    def print_marshal_coalesce_code(self, func, struct, dispatch_cmd):
+        # If the previous call in the batch is the same function setting
+        # the same state, overwrite its parameters instead of adding a new
+        # call, because the new call would override it anyway.
+        out('{0} *cmd = ({0} *)ctx->GLThread.LastStateCall;'.format(struct))
+        conditions = ['ctx->Const.GLThreadCoalesceStateCalls',
+                      '_mesa_glthread_call_is_last(&ctx->GLThread, &cmd->cmd_base, align(cmd_size, 8) / 8)',
+                      'cmd->cmd_base.cmd_id == {0}'.format(dispatch_cmd)]
+        for p in func.fixed_params:
+            if p.name not in func.marshal_coalesce_params:
+                continue
+
+            type = func.get_marshal_type(p)
+            if type == 'GLenum8':
+                conditions.append('cmd->{0} == MIN2({0}, 0xff)'.format(p.name))
+            elif type == 'GLenum16':
+                conditions.append('cmd->{0} == MIN2({0}, 0xffff)'.format(p.name))
+            else:
+                assert type == p.get_base_type_string()
+                conditions.append('cmd->{0} == {0}'.format(p.name))
+
+        out('if ({0} &&'.format(conditions[0]))
+        for i, condition in enumerate(conditions[1:], 1):
+            out('    {0}{1}'.format(condition,
+                                   ') {' if i == len(conditions) - 1 else ' &&'))
+        with indent():
+            out('p_atomic_inc(&ctx->GLThread.stats.num_eliminated_calls);')
+        out('} else {')
+        with indent():
+            out('cmd = _mesa_glthread_allocate_command(ctx, {0}, cmd_size);'
+                .format(dispatch_cmd))
+            out('ctx->GLThread.LastStateCall = &cmd->cmd_base;')
+        out('}')
+
     def print_marshal_async_code(self, func, is_packed=False):
         struct = func.get_marshal_struct_name(is_packed)
 
@@ -212,7 +246,9 @@ class PrintCode(gl_XML.gl_print_base):
 
         # Add the call into the batch.
         dispatch_cmd = 'DISPATCH_CMD_{0}{1}'.format(func.name, '_packed' if is_packed else '')
-        if func.get_fixed_params(is_packed) or func.variable_params:
+        if func.marshal_coalesce:
+            self.print_marshal_coalesce_code(func, struct, dispatch_cmd)
+        elif func.get_fixed_params(is_packed) or func.variable_params:
             out('{0} *cmd = _mesa_glthread_allocate_command(ctx, {1}, cmd_size);'
                 .format(struct, dispatch_cmd))
         else:
@@ -146,6 +146,7 @@ class marshal_function(gl_XML.gl_function):
         self.marshal_call_after = element.get('marshal_call_after')
         self.marshal_struct = element.get('marshal_struct')
         self.marshal_no_error = gl_XML.is_attr_true(element, 'marshal_no_error')
+        self.marshal_coalesce = element.get('marshal_coalesce')
         self.is_vertex_pointer_call = (self.name == 'InterleavedArrays' or
                                        self.name.endswith('VertexBuffer') or
                                        self.name.endswith('VertexBufferEXT') or
@@ -232,6 +233,21 @@ class marshal_function(gl_XML.gl_function):
         # Sort the parameters by size to move the truncated type into the hole.
         self.packed_fixed_params = sorted(self.packed_fixed_params, key=lambda p: self.get_type_size(p))
 
+        # Parameters that must be equal for a call to overwrite the previous
+        # call in the batch. "true" means that the function doesn't have any.
+        self.marshal_coalesce_params = []
+        if self.marshal_coalesce:
+            if self.marshal_coalesce != 'true':
+                self.marshal_coalesce_params = self.marshal_coalesce.split(',')
+
+            assert self.fixed_params
+            assert not self.variable_params
+            assert not self.marshal_sync
+            for pname in self.marshal_coalesce_params:
+                assert pname in [p.name for p in self.fixed_params
+                                 if not p.count]
+                assert pname != self.packed_param_name
+
 
     def get_fixed_params(self, is_packed):
         return self.packed_fixed_params if is_packed else self.fixed_params
@@ -0,0 +1,102 @@
+/*
+ * Copyright 2025 Mesa3D authors
+ * SPDX-License-Identifier: MIT
+ */
+
+/* Built with -mavx2, only called when the CPU supports AVX2. */
+
+#include "main/sse_minmax.h"
+#include "util/macros.h"
+#include <immintrin.h>
+#include <stdint.h>
+
+/* Restart indices are replaced by ~0 for the min and by 0 for the max, so
+ * that they never affect the result.
+ */
+#define AVX2_MINMAX(name, type, lanes, bits)                                 \
+static void                                                                  \
+name(const type *indices, unsigned count, bool restart,                      \
+     unsigned restart_index, unsigned *min_index, unsigned *max_index)       \
+{                                                                            \
+   type min = (type)~0u;                                                     \
+   type max = 0;                                                             \
+   unsigned i = 0;                                                           \
+                                                                             \
+   /* No index can be equal to a restart index that doesn't fit. */          \
+   if (restart_index > (type)~0u)                                            \
+      restart = false;                                                       \
+                                                                             \
+   if (count >= 2 * lanes) {                                                 \
+      alignas(32) type max_arr[lanes];                                       \
+      alignas(32) type min_arr[lanes];                                       \
+      __m256i max8 = _mm256_setzero_si256();                                 \
+      __m256i min8 = _mm256_set1_epi32(~0);                                  \
+      __m256i restart8 = _mm256_set1_epi##bits((type)restart_index);         \
+                                                                             \
+      if (restart) {                                                         \
+         for (; i + lanes <= count; i += lanes) {                            \
+            __m256i v = _mm256_loadu_si256((const __m256i *)&indices[i]);    \
+            __m256i mask = _mm256_cmpeq_epi##bits(v, restart8);              \
+            min8 = _mm256_min_epu##bits(min8, _mm256_or_si256(v, mask));     \
+            max8 = _mm256_max_epu##bits(max8, _mm256_andnot_si256(mask, v)); \
+         }                                                                   \
+      } else {                                                               \
+         for (; i + lanes <= count; i += lanes) {                            \
+            __m256i v = _mm256_loadu_si256((const __m256i *)&indices[i]);    \
+            min8 = _mm256_min_epu##bits(min8, v);                            \
+            max8 = _mm256_max_epu##bits(max8, v);                            \
+         }                                                                   \
+      }                                                                      \
+                                                                             \
+      _mm256_store_si256((__m256i *)max_arr, max8);                          \
+      _mm256_store_si256((__m256i *)min_arr, min8);                          \
+                                                                             \
+      for (unsigned j = 0; j < lanes; j++) {                                 \
+         if (max_arr[j] > max)                                               \
+            max = max_arr[j];                                                \
+         if (min_arr[j] < min)                                               \
+            min = min_arr[j];                                                \
+      }                                                                      \
+   }                                                                         \
+                                                                             \
+   for (; i < count; i++) {                                                  \
+      if (restart && indices[i] == restart_index)                            \
+         continue;                                                           \
+      if (indices[i] > max)                                                  \
+         max = indices[i];                                                   \
+      if (indices[i] < min)                                                  \
+         min = indices[i];                                                   \
+   }                                                                         \
+                                                                             \
+   /* Only restart indices leave min > max, return ~0 and 0 for that. */     \
+   *min_index = min <= max ? min : ~0u;                                      \
+   *max_index = max;                                                         \
+}
+
+AVX2_MINMAX(ubyte_min_max, uint8_t, 32, 8)
+AVX2_MINMAX(ushort_min_max, uint16_t, 16, 16)
+AVX2_MINMAX(uint_min_max, uint32_t, 8, 32)
+
+void
+_mesa_index_array_min_max_avx2(const void *indices, unsigned index_size,
+                               unsigned count, bool restart,
+                               unsigned restart_index,
+                               unsigned *min_index, unsigned *max_index)
+{
+   switch (index_size) {
+   case 4:
+      uint_min_max(indices, count, restart, restart_index,
+                   min_index, max_index);
+      break;
+   case 2:
+      ushort_min_max(indices, count, restart, restart_index,
+                     min_index, max_index);
+      break;
+   case 1:
+      ubyte_min_max(indices, count, restart, restart_index,
+                    min_index, max_index);
+      break;
+   default:
+      unreachable("bad index size");
+   }
+}
@@ -989,6 +989,13 @@ struct gl_constants
     */
    bool GLThreadNopCheckFramebufferStatus;
 
+   /**
+    * Let glthread overwrite the previous state call in a batch if the next
+    * call sets the same state, instead of queuing both. GL errors generated
+    * by the overwritten call are lost.
+    */
+   bool GLThreadCoalesceStateCalls;
+
    /** GL_ARB_sparse_texture */
    GLuint MaxSparseTextureSize;
    GLuint MaxSparse3DTextureSize;
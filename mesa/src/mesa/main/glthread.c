@@ -37,7 +37,9 @@
 #include "main/glthread_marshal.h"
 #include "main/hash.h"
 #include "main/pixelstore.h"
+#include "util/hash_table.h"
 #include "util/u_atomic.h"
+#include "util/u_debug.h"
 #include "util/u_thread.h"
 #include "util/u_cpu_detect.h"
 #include "util/thread_sched.h"
@@ -248,6 +250,12 @@ _mesa_glthread_init(struct gl_context *ctx)
    _mesa_glthread_init_call_fence(&glthread->LastProgramChangeBatch);
    _mesa_glthread_init_call_fence(&glthread->LastDListChangeBatchIndex);
 
+   if (debug_get_bool_option("MESA_GLTHREAD_SYNC_STATS", false)) {
+      glthread->sync_counts =
+         _mesa_hash_table_create(NULL, _mesa_hash_string,
+                                 _mesa_key_string_equal);
+   }
+
    _mesa_glthread_enable(ctx);
 
    /* Execute the thread initialization function in the thread. */
@@ -270,6 +278,42 @@ free_vao(void *data, UNUSED void *userData)
    free(data);
 }
 
+static int
+compare_sync_counts(const void *a, const void *b)
+{
+   const struct hash_entry *ea = *(const struct hash_entry **)a;
+   const struct hash_entry *eb = *(const struct hash_entry **)b;
+   uintptr_t ca = (uintptr_t)ea->data;
+   uintptr_t cb = (uintptr_t)eb->data;
+
+   return ca < cb ? 1 : ca > cb ? -1 : strcmp(ea->key, eb->key);
+}
+
+static void
+print_sync_counts(struct glthread_state *glthread)
+{
+   struct hash_table *ht = glthread->sync_counts;
+   struct hash_entry **entries =
+      malloc(MAX2(ht->entries, 1) * sizeof(*entries));
+   unsigned num = 0;
+
+   if (!entries)
+      return;
+
+   hash_table_foreach(ht, entry)
+      entries[num++] = entry;
+
+   qsort(entries, num, sizeof(*entries), compare_sync_counts);
+
+   fprintf(stderr, "glthread: syncs by entry point (total %u):\n",
+           glthread->stats.num_syncs);
+   for (unsigned i = 0; i < num; i++) {
+      fprintf(stderr, "   %10" PRIuPTR "  %s\n",
+              (uintptr_t)entries[i]->data, (const char *)entries[i]->key);
+   }
+   free(entries);
+}
+
 void
 _mesa_glthread_destroy(struct gl_context *ctx)
 {
@@ -286,6 +330,12 @@ _mesa_glthread_destroy(struct gl_context *ctx)
       _mesa_DeinitHashTable(&glthread->VAOs, free_vao, NULL);
       _mesa_glthread_release_upload_buffer(ctx);
    }
+
+   if (glthread->sync_counts) {
+      print_sync_counts(glthread);
+      _mesa_hash_table_destroy(glthread->sync_counts, NULL);
+      glthread->sync_counts = NULL;
+   }
 }
 
 void _mesa_glthread_enable(struct gl_context *ctx)
@@ -351,6 +401,7 @@ glthread_finalize_batch(struct glthread_state *glthread,
    glthread->LastCallList = NULL;
    glthread->LastBindBuffer1 = NULL;
    glthread->LastBindBuffer2 = NULL;
+   glthread->LastStateCall = NULL;
 }
 
 void
@@ -435,10 +486,22 @@ _mesa_glthread_finish(struct gl_context *ctx)
 void
 _mesa_glthread_finish_before(struct gl_context *ctx, const char *func)
 {
+   struct glthread_state *glthread = &ctx->GLThread;
+
    _mesa_glthread_finish(ctx);
 
-   /* Uncomment this if you want to know where glthread syncs. */
-   /*printf("fallback to sync: %s\n", func);*/
+   /* Set MESA_GLTHREAD_SYNC_STATS=true to know where glthread syncs. The counts
+    * are printed when the context is destroyed.
+    */
+   if (unlikely(glthread->sync_counts) && glthread->enabled) {
+      struct hash_entry *entry =
+         _mesa_hash_table_search(glthread->sync_counts, func);
+
+      if (entry)
+         entry->data = (void *)((uintptr_t)entry->data + 1);
+      else
+         _mesa_hash_table_insert(glthread->sync_counts, func, (void *)1);
+   }
 }
 
 void
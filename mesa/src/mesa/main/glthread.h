@@ -66,6 +66,7 @@ extern "C" {
 struct gl_context;
 struct gl_buffer_object;
 struct _glapi_table;
+struct hash_table;
 
 /**
  * Client pixel packing/unpacking attributes
@@ -213,6 +214,12 @@ struct glthread_state
    unsigned ListBase;
    unsigned ListCallDepth;
 
+   /**
+    * Number of syncs per entry point (const char * -> count), or NULL if
+    * MESA_GLTHREAD_SYNC_STATS is not set. Only accessed by the app thread.
+    */
+   struct hash_table *sync_counts;
+
    /** For L3 cache pinning. */
    unsigned pin_thread_counter;
    unsigned thread_sched_state;
@@ -297,6 +304,8 @@ struct glthread_state
    struct marshal_cmd_CallList *LastCallList;
    struct marshal_cmd_BindBuffer *LastBindBuffer1;
    struct marshal_cmd_BindBuffer *LastBindBuffer2;
+   /** The last call that can be coalesced, see marshal_coalesce. */
+   struct marshal_cmd_base *LastStateCall;
 
    /** Global mutex update info. */
    unsigned GlobalLockUpdateBatchCounter;
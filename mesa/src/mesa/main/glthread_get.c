@@ -24,22 +24,17 @@
 #include "main/glthread_marshal.h"
 #include "main/dispatch.h"
 
-uint32_t
-_mesa_unmarshal_GetIntegerv(struct gl_context *ctx,
-                            const struct marshal_cmd_GetIntegerv *restrict cmd)
-{
-   unreachable("never executed");
-   return 0;
-}
-
-void GLAPIENTRY
-_mesa_marshal_GetIntegerv(GLenum pname, GLint *p)
+/**
+ * Return the value of pname from the state tracked by glthread if it's
+ * known without syncing. All values returned this way are integers, enums,
+ * or booleans, so they can be converted to any glGet type.
+ */
+static bool
+get_shadow_integer(struct gl_context *ctx, GLenum pname, GLint *p)
 {
-   GET_CURRENT_CONTEXT(ctx);
-
    /* This will generate GL_INVALID_OPERATION, as it should. */
    if (ctx->GLThread.inside_begin_end)
-      goto sync;
+      return false;
 
    /* TODO: Use get_hash_params.py to return values for items containing:
     * - CONST(
@@ -49,90 +44,169 @@ _mesa_marshal_GetIntegerv(GLenum pname, GLint *p)
    switch (pname) {
    case GL_ACTIVE_TEXTURE:
       *p = GL_TEXTURE0 + ctx->GLThread.ActiveTexture;
-      return;
+      return true;
    case GL_ARRAY_BUFFER_BINDING:
       *p = ctx->GLThread.CurrentArrayBufferName;
-      return;
+      return true;
    case GL_ATTRIB_STACK_DEPTH:
       *p = ctx->GLThread.AttribStackDepth;
-      return;
+      return true;
    case GL_CLIENT_ACTIVE_TEXTURE:
       *p = GL_TEXTURE0 + ctx->GLThread.ClientActiveTexture;
-      return;
+      return true;
    case GL_CLIENT_ATTRIB_STACK_DEPTH:
       *p = ctx->GLThread.ClientAttribStackTop;
-      return;
+      return true;
    case GL_CURRENT_PROGRAM:
       *p = ctx->GLThread.CurrentProgram;
-      return;
+      return true;
    case GL_DRAW_INDIRECT_BUFFER_BINDING:
       *p = ctx->GLThread.CurrentDrawIndirectBufferName;
-      return;
+      return true;
    case GL_DRAW_FRAMEBUFFER_BINDING:
       *p = ctx->GLThread.CurrentDrawFramebuffer;
-      return;
+      return true;
    case GL_READ_FRAMEBUFFER_BINDING:
       *p = ctx->GLThread.CurrentReadFramebuffer;
-      return;
+      return true;
    case GL_PIXEL_PACK_BUFFER_BINDING:
       *p = ctx->GLThread.CurrentPixelPackBufferName;
-      return;
+      return true;
    case GL_PIXEL_UNPACK_BUFFER_BINDING:
       *p = ctx->GLThread.CurrentPixelUnpackBufferName;
-      return;
+      return true;
    case GL_QUERY_BUFFER_BINDING:
       *p = ctx->GLThread.CurrentQueryBufferName;
-      return;
+      return true;
 
    case GL_MATRIX_MODE:
       *p = ctx->GLThread.MatrixMode;
-      return;
+      return true;
    case GL_CURRENT_MATRIX_STACK_DEPTH_ARB:
       *p = ctx->GLThread.MatrixStackDepth[ctx->GLThread.MatrixIndex] + 1;
-      return;
+      return true;
    case GL_MODELVIEW_STACK_DEPTH:
       *p = ctx->GLThread.MatrixStackDepth[M_MODELVIEW] + 1;
-      return;
+      return true;
    case GL_PROJECTION_STACK_DEPTH:
       *p = ctx->GLThread.MatrixStackDepth[M_PROJECTION] + 1;
-      return;
+      return true;
    case GL_TEXTURE_STACK_DEPTH:
       *p = ctx->GLThread.MatrixStackDepth[M_TEXTURE0 + ctx->GLThread.ActiveTexture] + 1;
-      return;
+      return true;
 
    case GL_VERTEX_ARRAY:
       *p = (ctx->GLThread.CurrentVAO->UserEnabled & (1 << VERT_ATTRIB_POS)) != 0;
-      return;
+      return true;
    case GL_NORMAL_ARRAY:
       *p = (ctx->GLThread.CurrentVAO->UserEnabled & (1 << VERT_ATTRIB_NORMAL)) != 0;
-      return;
+      return true;
    case GL_COLOR_ARRAY:
       *p = (ctx->GLThread.CurrentVAO->UserEnabled & (1 << VERT_ATTRIB_COLOR0)) != 0;
-      return;
+      return true;
    case GL_SECONDARY_COLOR_ARRAY:
       *p = (ctx->GLThread.CurrentVAO->UserEnabled & (1 << VERT_ATTRIB_COLOR1)) != 0;
-      return;
+      return true;
    case GL_FOG_COORD_ARRAY:
       *p = (ctx->GLThread.CurrentVAO->UserEnabled & (1 << VERT_ATTRIB_FOG)) != 0;
-      return;
+      return true;
    case GL_INDEX_ARRAY:
       *p = (ctx->GLThread.CurrentVAO->UserEnabled & (1 << VERT_ATTRIB_COLOR_INDEX)) != 0;
-      return;
+      return true;
    case GL_EDGE_FLAG_ARRAY:
       *p = (ctx->GLThread.CurrentVAO->UserEnabled & (1 << VERT_ATTRIB_EDGEFLAG)) != 0;
-      return;
+      return true;
    case GL_TEXTURE_COORD_ARRAY:
       *p = (ctx->GLThread.CurrentVAO->UserEnabled &
             (1 << (VERT_ATTRIB_TEX0 + ctx->GLThread.ClientActiveTexture))) != 0;
-      return;
+      return true;
    case GL_POINT_SIZE_ARRAY_OES:
       *p = (ctx->GLThread.CurrentVAO->UserEnabled & (1 << VERT_ATTRIB_POINT_SIZE)) != 0;
-      return;
+      return true;
+
+   case GL_VERTEX_ARRAY_BINDING:
+      *p = ctx->GLThread.CurrentVAO->Name;
+      return true;
+   case GL_ELEMENT_ARRAY_BUFFER_BINDING:
+      *p = ctx->GLThread.CurrentVAO->CurrentElementBufferName;
+      return true;
+   case GL_PRIMITIVE_RESTART_INDEX:
+      *p = ctx->GLThread.RestartIndex;
+      return true;
+   }
+
+   /* Enables that are also valid glGet parameters. */
+   int enabled = _mesa_glthread_IsEnabled(ctx, pname);
+   if (enabled >= 0) {
+      *p = enabled;
+      return true;
    }
 
-sync:
+   return false;
+}
+
+uint32_t
+_mesa_unmarshal_GetIntegerv(struct gl_context *ctx,
+                            const struct marshal_cmd_GetIntegerv *restrict cmd)
+{
+   unreachable("never executed");
+   return 0;
+}
+
+void GLAPIENTRY
+_mesa_marshal_GetIntegerv(GLenum pname, GLint *p)
+{
+   GET_CURRENT_CONTEXT(ctx);
+
+   if (get_shadow_integer(ctx, pname, p))
+      return;
+
    _mesa_glthread_finish_before(ctx, "GetIntegerv");
    CALL_GetIntegerv(ctx->Dispatch.Current, (pname, p));
 }
 
-/* TODO: Implement glGetBooleanv, glGetFloatv, etc. if needed */
+uint32_t
+_mesa_unmarshal_GetBooleanv(struct gl_context *ctx,
+                            const struct marshal_cmd_GetBooleanv *restrict cmd)
+{
+   unreachable("never executed");
+   return 0;
+}
+
+void GLAPIENTRY
+_mesa_marshal_GetBooleanv(GLenum pname, GLboolean *p)
+{
+   GET_CURRENT_CONTEXT(ctx);
+   GLint value;
+
+   if (get_shadow_integer(ctx, pname, &value)) {
+      *p = value ? GL_TRUE : GL_FALSE;
+      return;
+   }
+
+   _mesa_glthread_finish_before(ctx, "GetBooleanv");
+   CALL_GetBooleanv(ctx->Dispatch.Current, (pname, p));
+}
+
+uint32_t
+_mesa_unmarshal_GetFloatv(struct gl_context *ctx,
+                          const struct marshal_cmd_GetFloatv *restrict cmd)
+{
+   unreachable("never executed");
+   return 0;
+}
+
+void GLAPIENTRY
+_mesa_marshal_GetFloatv(GLenum pname, GLfloat *p)
+{
+   GET_CURRENT_CONTEXT(ctx);
+   GLint value;
+
+   if (get_shadow_integer(ctx, pname, &value)) {
+      *p = (GLfloat)value;
+      return;
+   }
+
+   _mesa_glthread_finish_before(ctx, "GetFloatv");
+   CALL_GetFloatv(ctx->Dispatch.Current, (pname, p));
+}
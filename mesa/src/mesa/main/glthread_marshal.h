@@ -571,6 +571,20 @@ _mesa_glthread_IsEnabled(struct gl_context *ctx, GLenum cap)
    case GL_TEXTURE_COORD_ARRAY:
       return !!(ctx->GLThread.CurrentVAO->UserEnabled &
                 (1 << VERT_ATTRIB_TEX(ctx->GLThread.ClientActiveTexture)));
+   case GL_INDEX_ARRAY:
+      return !!(ctx->GLThread.CurrentVAO->UserEnabled & VERT_BIT_COLOR_INDEX);
+   case GL_EDGE_FLAG_ARRAY:
+      return !!(ctx->GLThread.CurrentVAO->UserEnabled & VERT_BIT_EDGEFLAG);
+   case GL_FOG_COORDINATE_ARRAY:
+      return !!(ctx->GLThread.CurrentVAO->UserEnabled & VERT_BIT_FOG);
+   case GL_SECONDARY_COLOR_ARRAY:
+      return !!(ctx->GLThread.CurrentVAO->UserEnabled & VERT_BIT_COLOR1);
+   case GL_POINT_SIZE_ARRAY_OES:
+      return !!(ctx->GLThread.CurrentVAO->UserEnabled & VERT_BIT_POINT_SIZE);
+   case GL_PRIMITIVE_RESTART:
+      return ctx->GLThread.PrimitiveRestart;
+   case GL_PRIMITIVE_RESTART_FIXED_INDEX:
+      return ctx->GLThread.PrimitiveRestartFixedIndex;
    default:
       return -1; /* sync and call _mesa_IsEnabled. */
    }
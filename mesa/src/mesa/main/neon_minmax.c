@@ -0,0 +1,97 @@
+/*
+ * Copyright 2025 Mesa3D authors
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "main/sse_minmax.h"
+#include "util/detect.h"
+#include "util/macros.h"
+
+#if DETECT_ARCH_AARCH64
+
+#include <arm_neon.h>
+#include <stdint.h>
+
+/* Restart indices are replaced by ~0 for the min and by 0 for the max, so
+ * that they never affect the result. NEON is always available on AArch64.
+ */
+#define NEON_MINMAX(name, type, vec, lanes, sfx)                             \
+static void                                                                  \
+name(const type *indices, unsigned count, bool restart,                      \
+     unsigned restart_index, unsigned *min_index, unsigned *max_index)       \
+{                                                                            \
+   type min = (type)~0u;                                                     \
+   type max = 0;                                                             \
+   unsigned i = 0;                                                           \
+                                                                             \
+   /* No index can be equal to a restart index that doesn't fit. */          \
+   if (restart_index > (type)~0u)                                            \
+      restart = false;                                                       \
+                                                                             \
+   if (count >= 2 * lanes) {                                                 \
+      vec max_v = vdupq_n_##sfx(0);                                          \
+      vec min_v = vdupq_n_##sfx((type)~0u);                                  \
+      vec restart_v = vdupq_n_##sfx((type)restart_index);                    \
+                                                                             \
+      if (restart) {                                                         \
+         for (; i + lanes <= count; i += lanes) {                            \
+            vec v = vld1q_##sfx(&indices[i]);                                \
+            vec mask = vceqq_##sfx(v, restart_v);                            \
+            min_v = vminq_##sfx(min_v, vorrq_##sfx(v, mask));                \
+            max_v = vmaxq_##sfx(max_v, vbicq_##sfx(v, mask));                \
+         }                                                                   \
+      } else {                                                               \
+         for (; i + lanes <= count; i += lanes) {                            \
+            vec v = vld1q_##sfx(&indices[i]);                                \
+            min_v = vminq_##sfx(min_v, v);                                   \
+            max_v = vmaxq_##sfx(max_v, v);                                   \
+         }                                                                   \
+      }                                                                      \
+                                                                             \
+      min = vminvq_##sfx(min_v);                                             \
+      max = vmaxvq_##sfx(max_v);                                             \
+   }                                                                         \
+                                                                             \
+   for (; i < count; i++) {                                                  \
+      if (restart && indices[i] == restart_index)                            \
+         continue;                                                           \
+      if (indices[i] > max)                                                  \
+         max = indices[i];                                                   \
+      if (indices[i] < min)                                                  \
+         min = indices[i];                                                   \
+   }                                                                         \
+                                                                             \
+   /* Only restart indices leave min > max, return ~0 and 0 for that. */     \
+   *min_index = min <= max ? min : ~0u;                                      \
+   *max_index = max;                                                         \
+}
+
+NEON_MINMAX(ubyte_min_max, uint8_t, uint8x16_t, 16, u8)
+NEON_MINMAX(ushort_min_max, uint16_t, uint16x8_t, 8, u16)
+NEON_MINMAX(uint_min_max, uint32_t, uint32x4_t, 4, u32)
+
+void
+_mesa_index_array_min_max_neon(const void *indices, unsigned index_size,
+                               unsigned count, bool restart,
+                               unsigned restart_index,
+                               unsigned *min_index, unsigned *max_index)
+{
+   switch (index_size) {
+   case 4:
+      uint_min_max(indices, count, restart, restart_index,
+                   min_index, max_index);
+      break;
+   case 2:
+      ushort_min_max(indices, count, restart, restart_index,
+                     min_index, max_index);
+      break;
+   case 1:
+      ubyte_min_max(indices, count, restart, restart_index,
+                    min_index, max_index);
+      break;
+   default:
+      unreachable("bad index size");
+   }
+}
+
+#endif /* DETECT_ARCH_AARCH64 */
@@ -30,66 +30,93 @@
 #include <smmintrin.h>
 #include <stdint.h>
 
-void
-_mesa_uint_array_min_max(const unsigned *ui_indices, unsigned *min_index,
-                         unsigned *max_index, const unsigned count)
-{
-   unsigned max_ui = 0;
-   unsigned min_ui = ~0U;
-   unsigned i = 0;
-   unsigned aligned_count = count;
-
-   /* handle the first few values without SSE until the pointer is aligned */
-   while (((uintptr_t)ui_indices & 15) && aligned_count) {
-      if (*ui_indices > max_ui)
-         max_ui = *ui_indices;
-      if (*ui_indices < min_ui)
-         min_ui = *ui_indices;
-
-      aligned_count--;
-      ui_indices++;
-   }
-
-   /* TODO: The actual threshold for SSE begin useful may be higher than 8.
-    * Some careful microbenchmarks and measurement are required to
-    * find the actual tipping point.
-    */
-   if (aligned_count >= 8) {
-      alignas(16) unsigned max_arr[4];
-      alignas(16) unsigned min_arr[4];
-      unsigned vec_count;
-      __m128i max_ui4 = _mm_setzero_si128();
-      __m128i min_ui4 = _mm_set1_epi32(~0U);
-      __m128i ui_indices4;
-      __m128i *ui_indices_ptr;
-
-      vec_count = aligned_count & ~0x3;
-      ui_indices_ptr = (__m128i *)ui_indices;
-      for (i = 0; i < vec_count / 4; i++) {
-         ui_indices4 = _mm_load_si128(&ui_indices_ptr[i]);
-         max_ui4 = _mm_max_epu32(ui_indices4, max_ui4);
-         min_ui4 = _mm_min_epu32(ui_indices4, min_ui4);
-      }
-
-      _mm_store_si128((__m128i *)max_arr, max_ui4);
-      _mm_store_si128((__m128i *)min_arr, min_ui4);
+/* Restart indices are replaced by ~0 for the min and by 0 for the max, so
+ * that they never affect the result.
+ */
+#define SSE_MINMAX(name, type, lanes, bits)                                  \
+static void                                                                  \
+name(const type *indices, unsigned count, bool restart,                      \
+     unsigned restart_index, unsigned *min_index, unsigned *max_index)       \
+{                                                                            \
+   type min = (type)~0u;                                                     \
+   type max = 0;                                                             \
+   unsigned i = 0;                                                           \
+                                                                             \
+   /* No index can be equal to a restart index that doesn't fit. */          \
+   if (restart_index > (type)~0u)                                            \
+      restart = false;                                                       \
+                                                                             \
+   if (count >= 2 * lanes) {                                                 \
+      alignas(16) type max_arr[lanes];                                       \
+      alignas(16) type min_arr[lanes];                                       \
+      __m128i max4 = _mm_setzero_si128();                                    \
+      __m128i min4 = _mm_set1_epi32(~0);                                     \
+      __m128i restart4 = _mm_set1_epi##bits((type)restart_index);            \
+                                                                             \
+      if (restart) {                                                         \
+         for (; i + lanes <= count; i += lanes) {                            \
+            __m128i v = _mm_loadu_si128((const __m128i *)&indices[i]);       \
+            __m128i mask = _mm_cmpeq_epi##bits(v, restart4);                 \
+            min4 = _mm_min_epu##bits(min4, _mm_or_si128(v, mask));           \
+            max4 = _mm_max_epu##bits(max4, _mm_andnot_si128(mask, v));       \
+         }                                                                   \
+      } else {                                                               \
+         for (; i + lanes <= count; i += lanes) {                            \
+            __m128i v = _mm_loadu_si128((const __m128i *)&indices[i]);       \
+            min4 = _mm_min_epu##bits(min4, v);                               \
+            max4 = _mm_max_epu##bits(max4, v);                               \
+         }                                                                   \
+      }                                                                      \
+                                                                             \
+      _mm_store_si128((__m128i *)max_arr, max4);                             \
+      _mm_store_si128((__m128i *)min_arr, min4);                             \
+                                                                             \
+      for (unsigned j = 0; j < lanes; j++) {                                 \
+         if (max_arr[j] > max)                                               \
+            max = max_arr[j];                                                \
+         if (min_arr[j] < min)                                               \
+            min = min_arr[j];                                                \
+      }                                                                      \
+   }                                                                         \
+                                                                             \
+   for (; i < count; i++) {                                                  \
+      if (restart && indices[i] == restart_index)                            \
+         continue;                                                           \
+      if (indices[i] > max)                                                  \
+         max = indices[i];                                                   \
+      if (indices[i] < min)                                                  \
+         min = indices[i];                                                   \
+   }                                                                         \
+                                                                             \
+   /* Only restart indices leave min > max, return ~0 and 0 for that. */     \
+   *min_index = min <= max ? min : ~0u;                                      \
+   *max_index = max;                                                         \
+}
 
-      for (i = 0; i < 4; i++) {
-         if (max_arr[i] > max_ui)
-            max_ui = max_arr[i];
-         if (min_arr[i] < min_ui)
-            min_ui = min_arr[i];
-      }
-      i = vec_count;
-   }
+SSE_MINMAX(ubyte_min_max, uint8_t, 16, 8)
+SSE_MINMAX(ushort_min_max, uint16_t, 8, 16)
+SSE_MINMAX(uint_min_max, uint32_t, 4, 32)
 
-   for (; i < aligned_count; i++) {
-      if (ui_indices[i] > max_ui)
-         max_ui = ui_indices[i];
-      if (ui_indices[i] < min_ui)
-         min_ui = ui_indices[i];
+void
+_mesa_index_array_min_max_sse41(const void *indices, unsigned index_size,
+                                unsigned count, bool restart,
+                                unsigned restart_index,
+                                unsigned *min_index, unsigned *max_index)
+{
+   switch (index_size) {
+   case 4:
+      uint_min_max(indices, count, restart, restart_index,
+                   min_index, max_index);
+      break;
+   case 2:
+      ushort_min_max(indices, count, restart, restart_index,
+                     min_index, max_index);
+      break;
+   case 1:
+      ubyte_min_max(indices, count, restart, restart_index,
+                    min_index, max_index);
+      break;
+   default:
+      unreachable("bad index size");
    }
-
-   *min_index = min_ui;
-   *max_index = max_ui;
 }
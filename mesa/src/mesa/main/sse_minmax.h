@@ -28,8 +28,38 @@
 #ifndef SSE_MINMAX_H
 #define SSE_MINMAX_H
 
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Vectorized min/max of an index array of 1, 2 or 4 byte indices, which
+ * ignores restart_index if restart is true. An array without any other index
+ * returns ~0 as the minimum and 0 as the maximum. The sse41 and avx2 variants
+ * must only be called when the CPU supports them.
+ */
+void
+_mesa_index_array_min_max_sse41(const void *indices, unsigned index_size,
+                                unsigned count, bool restart,
+                                unsigned restart_index,
+                                unsigned *min_index, unsigned *max_index);
+
+void
+_mesa_index_array_min_max_avx2(const void *indices, unsigned index_size,
+                               unsigned count, bool restart,
+                               unsigned restart_index,
+                               unsigned *min_index, unsigned *max_index);
+
 void
-_mesa_uint_array_min_max(const unsigned *ui_indices, unsigned *min_index,
-                         unsigned *max_index, const unsigned count);
+_mesa_index_array_min_max_neon(const void *indices, unsigned index_size,
+                               unsigned count, bool restart,
+                               unsigned restart_index,
+                               unsigned *min_index, unsigned *max_index);
+
+#ifdef __cplusplus
+}
+#endif
 
 #endif /* SSE_MINMAX_H */
@@ -0,0 +1,150 @@
+/*
+ * Copyright 2025 Mesa3D authors
+ * SPDX-License-Identifier: MIT
+ */
+
+/*
+ * Throughput of vbo_get_minmax_index_mapped() against a scalar loop for all
+ * index sizes, with and without primitive restart. The results are compared
+ * first, for all counts up to 100 and unaligned starts, so this also catches
+ * mismatches of the vectorized paths.
+ *
+ * Usage: ./minmax_bench [iterations]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "util/os_time.h"
+#include "util/u_memory.h"
+#include "main/mtypes.h"
+#include "pipe/p_state.h"
+#include "vbo/vbo.h"
+
+#define NUM_INDICES (1 << 16)
+
+static void
+scalar_min_max(unsigned count, unsigned index_size, unsigned restart_index,
+               bool restart, const void *indices,
+               unsigned *min_index, unsigned *max_index)
+{
+   unsigned min = ~0u, max = 0;
+
+   for (unsigned i = 0; i < count; i++) {
+      unsigned index = index_size == 4 ? ((const uint32_t *)indices)[i] :
+                       index_size == 2 ? ((const uint16_t *)indices)[i] :
+                                         ((const uint8_t *)indices)[i];
+
+      if (restart && index == restart_index)
+         continue;
+      max = MAX2(max, index);
+      min = MIN2(min, index);
+   }
+
+   *min_index = min;
+   *max_index = max;
+}
+
+static void
+fill(uint8_t *data, unsigned index_size, unsigned restart_index, bool restart)
+{
+   for (unsigned i = 0; i < NUM_INDICES; i++) {
+      /* Keep most indices in a window like a typical mesh, with a few
+       * outliers and restarts.
+       */
+      unsigned index = 1000 + rand() % 2000;
+
+      if (rand() % 64 == 0)
+         index = rand();
+      if (restart && rand() % 16 == 0)
+         index = restart_index;
+
+      if (index_size == 4)
+         ((uint32_t *)data)[i] = index;
+      else if (index_size == 2)
+         ((uint16_t *)data)[i] = index;
+      else
+         data[i] = index;
+   }
+}
+
+/* Returns the time per run in nanoseconds. */
+static double
+bench(bool scalar, unsigned index_size, unsigned restart_index, bool restart,
+      const void *indices, unsigned iterations)
+{
+   unsigned min, max, sum = 0;
+   int64_t start = os_time_get_nano();
+
+   for (unsigned i = 0; i < iterations; i++) {
+      if (scalar) {
+         scalar_min_max(NUM_INDICES, index_size, restart_index, restart,
+                        indices, &min, &max);
+      } else {
+         vbo_get_minmax_index_mapped(NUM_INDICES, index_size, restart_index,
+                                     restart, indices, &min, &max);
+      }
+      sum += min + max;
+   }
+
+   int64_t ns = os_time_get_nano() - start;
+
+   /* Keep the results alive. */
+   if (sum == 1)
+      printf(" ");
+   return (double)ns / iterations;
+}
+
+int main(int argc, char** argv)
+{
+   unsigned iterations = argc > 1 ? atoi(argv[1]) : 1000;
+   uint8_t *data = align_malloc(NUM_INDICES * 4 + 16, 64);
+   unsigned failed = 0;
+
+   srand(2209347);
+
+   printf("%-20s %12s %12s\n", "indices", "scalar", "vbo");
+
+   for (unsigned index_size = 1; index_size <= 4; index_size *= 2) {
+      for (unsigned r = 0; r < 3; r++) {
+         /* Test the usual restart index, one that doesn't fit and none. */
+         bool restart = r < 2;
+         unsigned restart_index = r == 0 ? (1ull << (index_size * 8)) - 1 :
+                                  r == 1 ? ~0u : 0;
+         char name[32];
+
+         fill(data, index_size, restart_index, restart);
+
+         for (unsigned offset = 0; offset < 4; offset++) {
+            for (unsigned count = 0; count <= 100; count++) {
+               const void *indices = data + offset * index_size;
+               unsigned min[2], max[2];
+
+               scalar_min_max(count, index_size, restart_index, restart,
+                              indices, &min[0], &max[0]);
+               vbo_get_minmax_index_mapped(count, index_size, restart_index,
+                                           restart, indices, &min[1], &max[1]);
+               if (min[0] != min[1] || max[0] != max[1]) {
+                  printf("FAIL: size %u restart %u count %u offset %u: "
+                         "%u..%u instead of %u..%u\n", index_size, r, count,
+                         offset, min[1], max[1], min[0], max[0]);
+                  failed++;
+               }
+            }
+         }
+
+         double ns[2] = {
+            bench(true, index_size, restart_index, restart, data, iterations),
+            bench(false, index_size, restart_index, restart, data, iterations),
+         };
+
+         /* Report millions of indices per second. */
+         snprintf(name, sizeof(name), "%ubit%s", index_size * 8,
+                  r == 0 ? " restart" : r == 1 ? " restart ~0" : "");
+         printf("%-20s %12.1f %12.1f\n", name,
+                NUM_INDICES * 1000.0 / ns[0], NUM_INDICES * 1000.0 / ns[1]);
+      }
+   }
+
+   align_free(data);
+   return failed != 0;
+}
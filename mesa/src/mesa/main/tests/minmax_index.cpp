@@ -0,0 +1,105 @@
+/*
+ * Copyright 2025 Mesa3D authors
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * \name minmax_index.cpp
+ *
+ * Compare vbo_get_minmax_index_mapped(), which uses SIMD paths when the CPU
+ * has them, against a scalar loop for all index sizes, short counts and
+ * unaligned starts.
+ */
+
+#include <gtest/gtest.h>
+
+#include <stdlib.h>
+
+#include "vbo/vbo.h"
+
+#define NUM_INDICES 128
+
+static void
+scalar_min_max(unsigned count, unsigned index_size, unsigned restart_index,
+               bool restart, const void *indices,
+               unsigned *min_index, unsigned *max_index)
+{
+   unsigned min = ~0u, max = 0;
+
+   for (unsigned i = 0; i < count; i++) {
+      unsigned index;
+
+      if (index_size == 4)
+         index = ((const uint32_t *)indices)[i];
+      else if (index_size == 2)
+         index = ((const uint16_t *)indices)[i];
+      else
+         index = ((const uint8_t *)indices)[i];
+
+      if (restart && index == restart_index)
+         continue;
+
+      max = MAX2(max, index);
+      min = MIN2(min, index);
+   }
+
+   *min_index = min;
+   *max_index = max;
+}
+
+static void
+fill(uint8_t *data, unsigned index_size, unsigned restart_index, bool restart)
+{
+   for (unsigned i = 0; i < NUM_INDICES; i++) {
+      unsigned index = 1000 + rand() % 2000;
+
+      if (rand() % 8 == 0)
+         index = rand();
+      if (restart && rand() % 4 == 0)
+         index = restart_index;
+
+      if (index_size == 4)
+         ((uint32_t *)data)[i] = index;
+      else if (index_size == 2)
+         ((uint16_t *)data)[i] = index;
+      else
+         data[i] = index;
+   }
+}
+
+TEST(MinMaxIndex, MatchesScalar)
+{
+   /* Room for the largest index size plus an unaligned start. */
+   alignas(64) uint8_t data[NUM_INDICES * 4 + 16];
+
+   srand(2209347);
+
+   for (unsigned index_size = 1; index_size <= 4; index_size *= 2) {
+      for (unsigned r = 0; r < 3; r++) {
+         /* The usual restart index, one that doesn't fit and none. */
+         bool restart = r < 2;
+         unsigned restart_index = r == 0 ? (1ull << (index_size * 8)) - 1 :
+                                  r == 1 ? ~0u : 0;
+
+         fill(data, index_size, restart_index, restart);
+
+         for (unsigned offset = 0; offset < 4; offset++) {
+            for (unsigned count = 0; count <= 100; count++) {
+               const void *indices = data + offset * index_size;
+               unsigned min[2], max[2];
+
+               scalar_min_max(count, index_size, restart_index, restart,
+                              indices, &min[0], &max[0]);
+               vbo_get_minmax_index_mapped(count, index_size, restart_index,
+                                           restart, indices, &min[1], &max[1]);
+               EXPECT_EQ(min[1], min[0]) << "size " << index_size
+                  << " restart " << r << " count " << count
+                  << " offset " << offset;
+               EXPECT_EQ(max[1], max[0]) << "size " << index_size
+                  << " restart " << r << " count " << count
+                  << " offset " << offset;
+            }
+         }
+      }
+   }
+}
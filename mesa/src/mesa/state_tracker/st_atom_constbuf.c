@@ -59,9 +59,42 @@ st_unbind_unused_cb0(struct st_context *st, enum pipe_shader_type shader_type)
 
       pipe->set_constant_buffer(pipe, shader_type, 0, false, NULL);
       st->state.constbuf0_enabled_shader_mask &= ~(1 << shader_type);
+      st->bound[shader_type].valid &= ~ST_BOUND_CONSTBUF0;
    }
 }
 
+/**
+ * Return whether the atoms already bound the same constants to CB0, and
+ * remember them as bound otherwise. A copy is compared instead of a hash,
+ * so that a collision can never skip a real change.
+ */
+static bool
+st_constants_bound(struct st_context *st, enum pipe_shader_type shader_type,
+                   const void *data, unsigned size)
+{
+   struct st_context_bound *bound = &st->bound[shader_type];
+
+   if (bound->valid & ST_BOUND_CONSTBUF0 && bound->constants_size == size &&
+       !memcmp(bound->constants, data, size))
+      return true;
+
+   if (size > bound->constants_alloc) {
+      void *constants = realloc(bound->constants, size);
+
+      if (!constants) {
+         bound->valid &= ~ST_BOUND_CONSTBUF0;
+         return false;
+      }
+      bound->constants = constants;
+      bound->constants_alloc = size;
+   }
+
+   memcpy(bound->constants, data, size);
+   bound->constants_size = size;
+   bound->valid |= ST_BOUND_CONSTBUF0;
+   return false;
+}
+
 /**
  * Pass the given program parameters to the graphics pipe as a
  * constant buffer.
@@ -123,6 +156,19 @@ st_upload_constants(struct st_context *st, struct gl_program *prog, gl_shader_st
          struct pipe_context *pipe = st->pipe;
          uint32_t *ptr;
 
+         /* State parameters are written to the buffer directly, so only
+          * constants without them can be compared. Inlinable uniforms depend
+          * on the program too.
+          */
+         if (params->StateFlags || params->UniformBytes != paramBytes ||
+             prog->info.num_inlinable_uniforms) {
+            st->bound[shader_type].valid &= ~ST_BOUND_CONSTBUF0;
+         } else if (st_constants_bound(st, shader_type, params->ParameterValues,
+                                       paramBytes)) {
+            st->state.constbuf0_enabled_shader_mask |= 1 << shader_type;
+            return;
+         }
+
          const unsigned alignment = MAX2(
             st->ctx->Const.UniformBufferOffsetAlignment, 64);
 
@@ -183,6 +229,14 @@ st_upload_constants(struct st_context *st, struct gl_program *prog, gl_shader_st
          if (params->StateFlags)
             _mesa_load_state_parameters(st->ctx, params);
 
+         if (prog->info.num_inlinable_uniforms) {
+            st->bound[shader_type].valid &= ~ST_BOUND_CONSTBUF0;
+         } else if (st_constants_bound(st, shader_type, params->ParameterValues,
+                                       paramBytes)) {
+            st->state.constbuf0_enabled_shader_mask |= 1 << shader_type;
+            return;
+         }
+
          pipe->set_constant_buffer(pipe, shader_type, 0, false, &cb);
 
          /* Set inlinable constants. */
@@ -207,6 +207,42 @@ st_convert_sampler_from_unit(const struct st_context *st,
 }
 
 
+/**
+ * Return whether the atoms already bound the same sampler states, and
+ * remember them as bound otherwise.
+ */
+static bool
+samplers_bound(struct st_context_bound *bound, unsigned num_samplers,
+               const struct pipe_sampler_state **states)
+{
+   uint32_t null_samplers = 0;
+   bool same = bound->valid & ST_BOUND_SAMPLERS &&
+               bound->num_samplers == num_samplers;
+
+   for (unsigned i = 0; i < num_samplers; i++) {
+      if (!states[i]) {
+         null_samplers |= BITFIELD_BIT(i);
+         continue;
+      }
+
+      if (same && !(bound->null_samplers & BITFIELD_BIT(i)) &&
+          !memcmp(&bound->samplers[i], states[i], sizeof(*states[i])))
+         continue;
+
+      same = false;
+      bound->samplers[i] = *states[i];
+   }
+
+   if (same && bound->null_samplers == null_samplers)
+      return true;
+
+   bound->null_samplers = null_samplers;
+   bound->num_samplers = num_samplers;
+   bound->valid |= ST_BOUND_SAMPLERS;
+   return false;
+}
+
+
 /**
  * Update the gallium driver's sampler state for fragment, vertex or
  * geometry shader stage.
@@ -330,7 +366,8 @@ update_shader_samplers(struct st_context *st,
       num_samplers = MAX2(num_samplers, extra + 1);
    }
 
-   cso_set_samplers(st->cso_context, shader_stage, num_samplers, states);
+   if (!samplers_bound(&st->bound[shader_stage], num_samplers, states))
+      cso_set_samplers(st->cso_context, shader_stage, num_samplers, states);
 
    if (out_num_samplers)
       *out_num_samplers = num_samplers;
@@ -300,6 +300,24 @@ update_textures(struct st_context *st,
    unsigned old_num_textures = st->state.num_sampler_views[shader_stage];
    unsigned num_unbind = old_num_textures > num_textures ?
                             old_num_textures - num_textures : 0;
+   struct st_context_bound *bound = &st->bound[shader_stage];
+
+   /* Skip binding the same views again. The references that
+    * st_get_sampler_views returned must be dropped in that case.
+    */
+   if (bound->valid & ST_BOUND_SAMPLER_VIEWS &&
+       bound->num_views == num_textures &&
+       !memcmp(bound->views, sampler_views,
+               num_textures * sizeof(sampler_views[0]))) {
+      for (unsigned i = 0; i < num_textures; i++)
+         pipe_sampler_view_reference(&sampler_views[i], NULL);
+      return;
+   }
+
+   memcpy(bound->views, sampler_views,
+          num_textures * sizeof(sampler_views[0]));
+   bound->num_views = num_textures;
+   bound->valid |= ST_BOUND_SAMPLER_VIEWS;
 
    pipe->set_sampler_views(pipe, shader_stage, 0, num_textures, num_unbind,
                            true, sampler_views);
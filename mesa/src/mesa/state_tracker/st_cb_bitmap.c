@@ -227,6 +227,7 @@ setup_render_state(struct gl_context *ctx,
    cso_set_tesseval_shader_handle(cso, NULL);
    cso_set_geometry_shader_handle(cso, NULL);
 
+   st_invalidate_bound_state(st, PIPE_SHADER_FRAGMENT);
    /* user samplers, plus our bitmap sampler */
    {
       struct pipe_sampler_state *samplers[PIPE_MAX_SAMPLERS];
@@ -112,6 +112,7 @@ set_clearcolor_fs(struct st_context *st, union pipe_color_union *color)
       .user_buffer = color->f,
       .buffer_size = 4 * sizeof(float),
    };
+   st_invalidate_bound_state(st, PIPE_SHADER_FRAGMENT);
    st->pipe->set_constant_buffer(st->pipe, PIPE_SHADER_FRAGMENT, 0,
                                 false, &cb);
 
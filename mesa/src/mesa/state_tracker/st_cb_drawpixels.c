@@ -844,6 +844,7 @@ draw_textured_quad(struct gl_context *ctx, GLint x, GLint y, GLfloat z,
    unsigned tex_width = sv[0]->texture->width0;
    unsigned tex_height = sv[0]->texture->height0;
 
+   st_invalidate_bound_state(st, PIPE_SHADER_FRAGMENT);
    /* user textures, plus the drawpix textures */
    if (fpv) {
       /* drawing a color image */
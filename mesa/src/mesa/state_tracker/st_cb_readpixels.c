@@ -188,6 +188,7 @@ try_pbo_readpixels(struct st_context *st, struct gl_renderbuffer *rb,
       if (sampler_view == NULL)
          goto fail;
 
+      st_invalidate_bound_state(st, PIPE_SHADER_FRAGMENT);
       pipe->set_sampler_views(pipe, PIPE_SHADER_FRAGMENT, 0, 1, 0,
                               false, &sampler_view);
       st->state.num_sampler_views[PIPE_SHADER_FRAGMENT] =
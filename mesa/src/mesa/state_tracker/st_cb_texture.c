@@ -1769,6 +1769,7 @@ try_pbo_upload_common(struct gl_context *ctx,
       if (sampler_view == NULL)
          goto fail;
 
+      st_invalidate_bound_state(st, PIPE_SHADER_FRAGMENT);
       pipe->set_sampler_views(pipe, PIPE_SHADER_FRAGMENT, 0, 1, 0,
                               false, &sampler_view);
       st->state.num_sampler_views[PIPE_SHADER_FRAGMENT] =
@@ -2039,6 +2040,7 @@ try_pbo_download(struct st_context *st,
       if (sampler_view == NULL)
          goto fail;
 
+      st_invalidate_bound_state(st, PIPE_SHADER_FRAGMENT);
       pipe->set_sampler_views(pipe, PIPE_SHADER_FRAGMENT, 0, 1, 0, true, &sampler_view);
       sampler_view = NULL;
 
@@ -2389,6 +2391,12 @@ fallback:
       util_throttle_memory_usage(pipe, &st->throttle,
                                  (uint64_t) width * height * depth *
                                  _mesa_get_format_bytes(texImage->TexFormat));
+
+      /* Convert on the GPU instead of in _mesa_texstore if allowed. */
+      if (st_TexSubImage_shader(ctx, dims, texImage, xoffset, yoffset, zoffset,
+                                width, height, depth, format, type, pixels,
+                                unpack))
+         return;
    }
    _mesa_store_texsubimage(ctx, dims, texImage, xoffset, yoffset, zoffset,
                            width, height, depth, format, type, pixels,
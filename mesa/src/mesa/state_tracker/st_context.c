@@ -352,6 +352,13 @@ st_destroy_context_priv(struct st_context *st, bool destroy_pipe)
    st_invalidate_readpix_cache(st);
    util_throttle_deinit(st->screen, &st->throttle);
 
+   if (st->atom_stats) {
+      st_print_atom_profile(st);
+      FREE(st->atom_stats);
+   }
+   for (unsigned i = 0; i < PIPE_SHADER_TYPES; i++)
+      free(st->bound[i].constants);
+
    cso_destroy_context(st->cso_context);
 
    if (st->pipe && destroy_pipe)
@@ -478,6 +485,9 @@ st_create_context_priv(struct gl_context *ctx, struct pipe_context *pipe,
 #include "st_atom_list.h"
 #undef ST_STATE
 
+   if (ST_DEBUG & DEBUG_ATOMS)
+      st_init_atom_profiling(st);
+
    st_init_clear(st);
    {
       enum pipe_texture_transfer_mode val = screen->caps.texture_transfer_modes;
@@ -123,6 +123,10 @@ struct st_zombie_shader_node
 
 typedef void (*st_update_func_t)(struct st_context *st);
 
+#define ST_BOUND_SAMPLER_VIEWS   BITFIELD_BIT(0)
+#define ST_BOUND_SAMPLERS        BITFIELD_BIT(1)
+#define ST_BOUND_CONSTBUF0       BITFIELD_BIT(2)
+
 struct st_context
 {
    struct gl_context *ctx;
@@ -256,6 +260,28 @@ struct st_context
          PIPE_MAX_SAMPLE_LOCATION_GRID_SIZE * 32];
    } state;
 
+   /* What the state atoms last bound per shader stage, so that binding
+    * identical state again can be skipped. Code that binds any of these
+    * behind the atoms' back must call st_invalidate_bound_state.
+    *
+    * The sampler views aren't referenced. That's fine because the driver
+    * holds references to them for as long as they stay bound.
+    */
+   struct st_context_bound {
+      struct pipe_sampler_view *views[PIPE_MAX_SAMPLERS];
+      struct pipe_sampler_state samplers[PIPE_MAX_SAMPLERS];
+      uint32_t null_samplers;
+      uint8_t num_views;
+      uint8_t num_samplers;
+      uint8_t valid; /**< ST_BOUND_* */
+      void *constants;
+      unsigned constants_size;
+      unsigned constants_alloc;
+   } bound[PIPE_SHADER_TYPES];
+
+   /** Per-atom statistics with ST_DEBUG=atoms, otherwise NULL. */
+   struct st_atom_stats *atom_stats;
+
    /** This masks out unused shader resources. Only valid in draw calls. */
    uint64_t active_states;
 
@@ -339,6 +365,8 @@ struct st_context
        */
       void *download_fs[5][PIPE_MAX_TEXTURE_TYPES][2];
       struct hash_table *shaders;
+      /* compute upload shaders keyed by client layout, see st_pbo_compute.c */
+      struct hash_table *upload_shaders;
       bool upload_enabled;
       bool download_enabled;
       bool rgba_only;
@@ -443,6 +471,17 @@ st_context(struct gl_context *ctx)
    return ctx->st;
 }
 
+/*
+ * Forget what the state atoms bound for the given shader stage. This must
+ * be called after binding sampler views, samplers or constant buffer 0 for
+ * it outside of the atoms.
+ */
+static inline void
+st_invalidate_bound_state(struct st_context *st, enum pipe_shader_type shader)
+{
+   st->bound[shader].valid = 0;
+}
+
 
 extern struct st_context *
 st_create_context(gl_api api, struct pipe_context *pipe,
@@ -28,6 +28,8 @@
 
 #include "main/context.h"
 #include "main/debug_output.h"
+#include "util/os_time.h"
+#include "util/perf/cpu_trace.h"
 #include "program/prog_print.h"
 
 #include "pipe/p_state.h"
@@ -35,6 +37,7 @@
 
 #include "cso_cache/cso_cache.h"
 
+#include "st_atom.h"
 #include "st_context.h"
 #include "st_debug.h"
 #include "st_program.h"
@@ -53,6 +56,7 @@ static const struct debug_named_value st_debug_flags[] = {
    { "gremedy",  DEBUG_GREMEDY, "Enable GREMEDY debug extensions" },
    { "noreadpixcache", DEBUG_NOREADPIXCACHE, NULL },
    { "xfb",      DEBUG_PRINT_XFB, NULL },
+   { "atoms",    DEBUG_ATOMS, "Profile state atoms, print the results at context destruction" },
    DEBUG_NAMED_VALUE_END
 };
 
@@ -64,3 +68,81 @@ st_debug_init(void)
 {
    ST_DEBUG = debug_get_option_st_debug();
 }
+
+
+/* Update functions that record how often and how long each atom runs.
+ * They replace the regular ones with ST_DEBUG=atoms, so profiling has no
+ * cost otherwise.
+ */
+#define ST_STATE(FLAG, st_update)                                    \
+static void                                                          \
+profile_##FLAG(struct st_context *st)                                \
+{                                                                    \
+   MESA_TRACE_SCOPE(#st_update);                                     \
+   int64_t start = os_time_get_nano();                               \
+                                                                     \
+   st_update(st);                                                    \
+   st->atom_stats[FLAG##_INDEX].count++;                             \
+   st->atom_stats[FLAG##_INDEX].ns += os_time_get_nano() - start;    \
+}
+#include "st_atom_list.h"
+#undef ST_STATE
+
+static const char *atom_names[] = {
+#define ST_STATE(FLAG, st_update) #st_update,
+#include "st_atom_list.h"
+#undef ST_STATE
+};
+
+
+void
+st_init_atom_profiling(struct st_context *st)
+{
+   st->atom_stats = CALLOC(ST_NUM_ATOMS, sizeof(*st->atom_stats));
+   if (!st->atom_stats)
+      return;
+
+#define ST_STATE(FLAG, st_update) \
+   st->update_functions[FLAG##_INDEX] = profile_##FLAG;
+#include "st_atom_list.h"
+#undef ST_STATE
+}
+
+
+/**
+ * Print the atom statistics, the most expensive atoms first.
+ */
+void
+st_print_atom_profile(struct st_context *st)
+{
+   const struct st_atom_stats *stats = st->atom_stats;
+   unsigned order[ST_NUM_ATOMS];
+   uint64_t total_ns = 0;
+
+   if (!stats)
+      return;
+
+   for (unsigned i = 0; i < ST_NUM_ATOMS; i++) {
+      unsigned j = i;
+
+      /* Insertion sort by decreasing time. */
+      for (; j > 0 && stats[order[j - 1]].ns < stats[i].ns; j--)
+         order[j] = order[j - 1];
+      order[j] = i;
+      total_ns += stats[i].ns;
+   }
+
+   debug_printf("st: state atoms, %.3f ms total\n", total_ns / 1000000.0);
+   debug_printf("   %-36s %12s %12s %10s\n", "atom", "count", "ms", "ns/call");
+
+   for (unsigned i = 0; i < ST_NUM_ATOMS; i++) {
+      const struct st_atom_stats *s = &stats[order[i]];
+
+      if (!s->count)
+         continue;
+
+      debug_printf("   %-36s %12"PRIu64" %12.3f %10"PRIu64"\n",
+                   atom_names[order[i]], s->count, s->ns / 1000000.0,
+                   s->ns / s->count);
+   }
+}
@@ -42,11 +42,20 @@ struct st_context;
 #define DEBUG_GREMEDY         BITFIELD_BIT(5)
 #define DEBUG_NOREADPIXCACHE  BITFIELD_BIT(6)
 #define DEBUG_PRINT_XFB       BITFIELD_BIT(7)
+#define DEBUG_ATOMS           BITFIELD_BIT(8)
 
 extern int ST_DEBUG;
 
 void st_debug_init( void );
 
+struct st_atom_stats {
+   uint64_t count;   /**< number of times the atom was updated */
+   uint64_t ns;      /**< total time spent in the update function */
+};
+
+void st_init_atom_profiling(struct st_context *st);
+void st_print_atom_profile(struct st_context *st);
+
 static inline void
 ST_DBG( unsigned flag, const char *fmt, ... )
 {
@@ -691,6 +691,7 @@ st_draw_hw_select_prepare_common(struct gl_context *ctx)
    cb.buffer_size = sizeof(consts) - (MAX_CLIP_PLANES - num_planes) * 4 * sizeof(float);
 
    struct pipe_context *pipe = st->pipe;
+   st_invalidate_bound_state(st, PIPE_SHADER_GEOMETRY);
    pipe->set_constant_buffer(pipe, PIPE_SHADER_GEOMETRY, 0, false, &cb);
 
    struct pipe_shader_buffer buffer;
@@ -1847,6 +1847,7 @@ void st_init_extensions(struct pipe_screen *screen,
       options->allow_draw_out_of_order &&
       screen->caps.allow_draw_out_of_order;
    consts->GLThreadNopCheckFramebufferStatus = options->glthread_nop_check_framebuffer_status;
+   consts->GLThreadCoalesceStateCalls = options->glthread_coalesce_state_calls;
 
    const struct nir_shader_compiler_options *nir_options =
       consts->ShaderCompilerOptions[MESA_SHADER_FRAGMENT].NirOptions;
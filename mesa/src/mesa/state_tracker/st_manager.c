@@ -54,6 +54,7 @@
 
 #include "pipe/p_context.h"
 #include "pipe/p_screen.h"
+#include "cso_cache/cso_context.h"
 #include "util/format/u_format.h"
 #include "util/u_helpers.h"
 #include "util/u_pointer.h"
@@ -70,6 +71,8 @@ struct st_screen
 {
    struct hash_table *drawable_ht; /* pipe_frontend_drawable objects hash table */
    simple_mtx_t st_mutex;
+   /* state objects shared by all contexts, NULL if the driver can't */
+   struct cso_screen_cache *cso_cache;
 };
 
 /**
@@ -902,6 +905,11 @@ st_context_invalidate_state(struct st_context *st, unsigned flags)
 {
    struct gl_context *ctx = st->ctx;
 
+   if (flags & (ST_INVALIDATE_FS_SAMPLER_VIEWS | ST_INVALIDATE_FS_CONSTBUF0))
+      st_invalidate_bound_state(st, PIPE_SHADER_FRAGMENT);
+   if (flags & ST_INVALIDATE_VS_CONSTBUF0)
+      st_invalidate_bound_state(st, PIPE_SHADER_VERTEX);
+
    if (flags & ST_INVALIDATE_FS_SAMPLER_VIEWS)
       ctx->NewDriverState |= ST_NEW_FS_SAMPLER_VIEWS;
    if (flags & ST_INVALIDATE_FS_CONSTBUF0)
@@ -924,6 +932,7 @@ st_screen_destroy(struct pipe_frontend_screen *fscreen)
 
    if (screen && screen->drawable_ht) {
       _mesa_hash_table_destroy(screen->drawable_ht, NULL);
+      cso_screen_cache_destroy(screen->cso_cache);
       simple_mtx_destroy(&screen->st_mutex);
       FREE(screen);
       fscreen->st_screen = NULL;
@@ -964,6 +973,8 @@ st_api_create_context(struct pipe_frontend_screen *fscreen,
       screen->drawable_ht = _mesa_hash_table_create(NULL,
                                                     NULL,
                                                     _mesa_key_pointer_equal);
+      if (fscreen->screen->caps.shareable_state_objects)
+         screen->cso_cache = cso_screen_cache_create(1024);
       fscreen->st_screen = screen;
    }
 
@@ -997,6 +1008,9 @@ st_api_create_context(struct pipe_frontend_screen *fscreen,
       return NULL;
    }
 
+   cso_set_screen_cache(st->cso_context,
+                        ((struct st_screen *)fscreen->st_screen)->cso_cache);
+
    if (attribs->flags & ST_CONTEXT_FLAG_DEBUG) {
       if (!_mesa_set_debug_state_int(st->ctx, GL_DEBUG_OUTPUT, GL_TRUE)) {
          *error = ST_CONTEXT_ERROR_NO_MEMORY;
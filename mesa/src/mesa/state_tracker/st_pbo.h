@@ -117,6 +117,14 @@ st_GetTexSubImage_shader(struct gl_context * ctx,
                          GLenum format, GLenum type, void * pixels,
                          struct gl_texture_image *texImage);
 
+bool
+st_TexSubImage_shader(struct gl_context *ctx, GLuint dims,
+                      struct gl_texture_image *texImage,
+                      GLint xoffset, GLint yoffset, GLint zoffset,
+                      GLsizei width, GLsizei height, GLsizei depth,
+                      GLenum format, GLenum type, const void *pixels,
+                      const struct gl_pixelstore_attrib *unpack);
+
 enum pipe_format
 st_pbo_get_dst_format(struct gl_context *ctx, enum pipe_texture_target target,
                       enum pipe_format src_format, bool is_compressed,
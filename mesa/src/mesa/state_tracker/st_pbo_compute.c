@@ -25,8 +25,10 @@
  */
 
 #include <stdbool.h>
+#include "main/bufferobj.h"
 #include "main/image.h"
 #include "main/pbo.h"
+#include "main/texstore.h"
 
 #include "nir/pipe_nir.h"
 #include "state_tracker/st_nir.h"
@@ -38,6 +40,7 @@
 #include "compiler/nir/nir_format_convert.h"
 #include "compiler/glsl/gl_nir.h"
 #include "compiler/glsl/gl_nir_linker.h"
+#include "util/u_memory.h"
 #include "util/u_sampler.h"
 #include "util/streaming-load-memcpy.h"
 
@@ -1003,6 +1006,7 @@ download_texture_compute(struct st_context *st,
    assert(cs);
    struct cso_context *cso = st->cso_context;
 
+   st_invalidate_bound_state(st, PIPE_SHADER_COMPUTE);
    pipe->set_constant_buffer(pipe, PIPE_SHADER_COMPUTE, 0, false, &cb);
 
    cso_save_compute_state(cso, CSO_BIT_COMPUTE_SHADER | CSO_BIT_COMPUTE_SAMPLERS);
@@ -1334,10 +1338,569 @@ st_GetTexSubImage_shader(struct gl_context * ctx,
    return true;
 }
 
+/* Texture uploads: the client data is copied verbatim into a buffer and a
+ * compute shader unpacks each texel and stores it through an image, so the
+ * format conversion _mesa_texstore would do on the CPU happens on the GPU.
+ */
+enum pbo_upload_type {
+   PBO_UPLOAD_UNORM,
+   PBO_UPLOAD_SNORM,
+   PBO_UPLOAD_FLOAT,
+   PBO_UPLOAD_HALF,
+};
+
+/* client component that is replicated to red, green and blue */
+#define PBO_UPLOAD_LUMINANCE 4
+
+struct pbo_upload_key {
+   uint8_t target;
+   uint8_t num_components;
+   uint8_t pixel_bytes;
+   /* bytes loaded per component: the whole pixel for packed types */
+   uint8_t word_bytes;
+   uint8_t type;
+   bool packed;
+   bool swap;
+   /* rgba channel each client component is unpacked to */
+   uint8_t dst[4];
+   uint8_t shift[4];
+   uint8_t bits[4];
+   /* PIPE_SWIZZLE_x of the unpacked rgba for each image component */
+   uint8_t store_swizzle[4];
+   uint16_t image_format;
+};
+
+static const struct {
+   GLenum format;
+   uint8_t num_components;
+   uint8_t dst[4];
+} upload_formats[] = {
+   { GL_RED,             1, { 0 } },
+   { GL_GREEN,           1, { 1 } },
+   { GL_BLUE,            1, { 2 } },
+   { GL_ALPHA,           1, { 3 } },
+   { GL_RG,              2, { 0, 1 } },
+   { GL_RGB,             3, { 0, 1, 2 } },
+   { GL_BGR,             3, { 2, 1, 0 } },
+   { GL_RGBA,            4, { 0, 1, 2, 3 } },
+   { GL_BGRA,            4, { 2, 1, 0, 3 } },
+   { GL_ABGR_EXT,        4, { 3, 2, 1, 0 } },
+   { GL_LUMINANCE,       1, { PBO_UPLOAD_LUMINANCE } },
+   { GL_LUMINANCE_ALPHA, 2, { PBO_UPLOAD_LUMINANCE, 3 } },
+};
+
+static const struct {
+   GLenum type;
+   uint8_t bytes;
+   uint8_t upload_type;
+} upload_array_types[] = {
+   { GL_UNSIGNED_BYTE,  1, PBO_UPLOAD_UNORM },
+   { GL_BYTE,           1, PBO_UPLOAD_SNORM },
+   { GL_UNSIGNED_SHORT, 2, PBO_UPLOAD_UNORM },
+   { GL_SHORT,          2, PBO_UPLOAD_SNORM },
+   { GL_UNSIGNED_INT,   4, PBO_UPLOAD_UNORM },
+   { GL_INT,            4, PBO_UPLOAD_SNORM },
+   { GL_HALF_FLOAT,     2, PBO_UPLOAD_HALF },
+   { GL_HALF_FLOAT_OES, 2, PBO_UPLOAD_HALF },
+   { GL_FLOAT,          4, PBO_UPLOAD_FLOAT },
+};
+
+/* bit sizes are listed in component order; the first component is in the
+ * most significant bits unless the type is _REV
+ */
+static const struct {
+   GLenum type;
+   uint8_t bytes;
+   bool rev;
+   uint8_t num_components;
+   uint8_t bits[4];
+} upload_packed_types[] = {
+   { GL_UNSIGNED_BYTE_3_3_2,          1, false, 3, { 3, 3, 2 } },
+   { GL_UNSIGNED_BYTE_2_3_3_REV,      1, true,  3, { 3, 3, 2 } },
+   { GL_UNSIGNED_SHORT_5_6_5,         2, false, 3, { 5, 6, 5 } },
+   { GL_UNSIGNED_SHORT_5_6_5_REV,     2, true,  3, { 5, 6, 5 } },
+   { GL_UNSIGNED_SHORT_4_4_4_4,       2, false, 4, { 4, 4, 4, 4 } },
+   { GL_UNSIGNED_SHORT_4_4_4_4_REV,   2, true,  4, { 4, 4, 4, 4 } },
+   { GL_UNSIGNED_SHORT_5_5_5_1,       2, false, 4, { 5, 5, 5, 1 } },
+   { GL_UNSIGNED_SHORT_1_5_5_5_REV,   2, true,  4, { 5, 5, 5, 1 } },
+   { GL_UNSIGNED_INT_8_8_8_8,         4, false, 4, { 8, 8, 8, 8 } },
+   { GL_UNSIGNED_INT_8_8_8_8_REV,     4, true,  4, { 8, 8, 8, 8 } },
+   { GL_UNSIGNED_INT_10_10_10_2,      4, false, 4, { 10, 10, 10, 2 } },
+   { GL_UNSIGNED_INT_2_10_10_10_REV,  4, true,  4, { 10, 10, 10, 2 } },
+};
+
+static bool
+fill_upload_layout(struct pbo_upload_key *key, GLenum format, GLenum type,
+                   bool swap_bytes)
+{
+   unsigned i, f;
+
+   for (f = 0; f < ARRAY_SIZE(upload_formats); f++) {
+      if (upload_formats[f].format == format)
+         break;
+   }
+   if (f == ARRAY_SIZE(upload_formats))
+      return false;
+
+   key->num_components = upload_formats[f].num_components;
+   memcpy(key->dst, upload_formats[f].dst, sizeof(key->dst));
+
+   for (i = 0; i < ARRAY_SIZE(upload_array_types); i++) {
+      if (upload_array_types[i].type == type) {
+         key->type = upload_array_types[i].upload_type;
+         key->word_bytes = upload_array_types[i].bytes;
+         key->pixel_bytes = key->word_bytes * key->num_components;
+         for (unsigned c = 0; c < key->num_components; c++)
+            key->bits[c] = key->word_bytes * 8;
+         key->swap = swap_bytes && key->word_bytes > 1;
+         return true;
+      }
+   }
+
+   for (i = 0; i < ARRAY_SIZE(upload_packed_types); i++) {
+      if (upload_packed_types[i].type == type) {
+         unsigned total = upload_packed_types[i].bytes * 8;
+         unsigned shift = 0;
+
+         if (upload_packed_types[i].num_components != key->num_components)
+            return false;
+
+         key->type = PBO_UPLOAD_UNORM;
+         key->packed = true;
+         key->word_bytes = key->pixel_bytes = upload_packed_types[i].bytes;
+         for (unsigned c = 0; c < key->num_components; c++) {
+            key->bits[c] = upload_packed_types[i].bits[c];
+            shift += key->bits[c];
+            key->shift[c] = upload_packed_types[i].rev ?
+                            shift - key->bits[c] : total - shift;
+         }
+         key->swap = swap_bytes && key->word_bytes > 1;
+         return true;
+      }
+   }
+
+   return false;
+}
+
+/* Compute the swizzle taking the unpacked client rgba to the components of
+ * the image view. The base format decides which of the client components
+ * reach the texture at all, tex_format maps those to its channels and the
+ * image view stores the channels as its own rgba.
+ */
+static bool
+fill_upload_store_swizzle(struct pbo_upload_key *key, GLenum base_format,
+                          enum pipe_format tex_format,
+                          enum pipe_format view_format)
+{
+   const struct util_format_description *tex_desc =
+      util_format_description(tex_format);
+   const struct util_format_description *view_desc =
+      util_format_description(view_format);
+   const uint8_t *base;
+
+#define SWZ(r, g, b, a) (const uint8_t[]){ PIPE_SWIZZLE_##r, PIPE_SWIZZLE_##g, \
+                                           PIPE_SWIZZLE_##b, PIPE_SWIZZLE_##a }
+   switch (base_format) {
+   case GL_RGBA:            base = SWZ(X, Y, Z, W); break;
+   case GL_RGB:             base = SWZ(X, Y, Z, 1); break;
+   case GL_RG:              base = SWZ(X, Y, 0, 1); break;
+   case GL_RED:             base = SWZ(X, 0, 0, 1); break;
+   case GL_ALPHA:           base = SWZ(0, 0, 0, W); break;
+   case GL_LUMINANCE:       base = SWZ(X, X, X, 1); break;
+   case GL_LUMINANCE_ALPHA: base = SWZ(X, X, X, W); break;
+   case GL_INTENSITY:       base = SWZ(X, X, X, X); break;
+   default:
+      return false;
+   }
+#undef SWZ
+
+   for (unsigned k = 0; k < 4; k++) {
+      unsigned channel = view_desc->swizzle[k];
+
+      key->store_swizzle[k] = PIPE_SWIZZLE_0;
+      if (channel > PIPE_SWIZZLE_W)
+         continue;
+
+      /* padding channels the texture never exposes */
+      key->store_swizzle[k] = PIPE_SWIZZLE_1;
+      for (unsigned j = 0; j < 4; j++) {
+         if (tex_desc->swizzle[j] == channel) {
+            key->store_swizzle[k] = base[j];
+            break;
+         }
+      }
+   }
+
+   return true;
+}
+
+/* load 1, 2 or 4 bytes at any byte offset of the ssbo */
+static nir_def *
+load_unaligned(nir_builder *b, nir_def *addr, unsigned bytes,
+               nir_def *last_dword, bool swap)
+{
+   nir_def *dword = nir_ushr_imm(b, addr, 2);
+   nir_def *next = nir_umin(b, nir_iadd_imm(b, dword, 1), last_dword);
+   nir_def *lo = nir_load_ssbo(b, 1, 32, nir_imm_zero(b, 1, 32),
+                               nir_ishl_imm(b, dword, 2), .align_mul = 4);
+   nir_def *hi = nir_load_ssbo(b, 1, 32, nir_imm_zero(b, 1, 32),
+                               nir_ishl_imm(b, next, 2), .align_mul = 4);
+   nir_def *shift = nir_ishl_imm(b, nir_iand_imm(b, addr, 3), 3);
+
+   /* shifts only use the low 5 bits, so an aligned address needs lo as is */
+   nir_def *val = nir_bcsel(b, nir_ieq_imm(b, shift, 0), lo,
+                            nir_ior(b, nir_ushr(b, lo, shift),
+                                    nir_ishl(b, hi, nir_isub_imm(b, 32, shift))));
+   if (bytes < 4)
+      val = nir_iand_imm(b, val, BITFIELD_MASK(bytes * 8));
+   if (swap)
+      val = bytes == 2 ? swap2(b, val) : swap4(b, val);
+   return val;
+}
+
+static nir_def *
+unpack_upload_component(nir_builder *b, nir_def *val, unsigned bits,
+                        enum pbo_upload_type type)
+{
+   switch (type) {
+   case PBO_UPLOAD_UNORM:
+      return nir_fmul_imm(b, nir_u2f32(b, val),
+                          1.0 / (double)BITFIELD64_MASK(bits));
+   case PBO_UPLOAD_SNORM:
+      if (bits < 32)
+         val = nir_ibfe_imm(b, val, 0, bits);
+      return nir_fmax(b, nir_fmul_imm(b, nir_i2f32(b, val),
+                                      1.0 / (double)BITFIELD64_MASK(bits - 1)),
+                      nir_imm_float(b, -1.0));
+   case PBO_UPLOAD_HALF:
+      return nir_unpack_half_2x16_split_x(b, val);
+   case PBO_UPLOAD_FLOAT:
+   default:
+      return val;
+   }
+}
+
+static void *
+create_upload_shader(struct st_context *st, const struct pbo_upload_key *key)
+{
+   const nir_shader_compiler_options *options = st_get_nir_compiler_options(st, MESA_SHADER_COMPUTE);
+   nir_builder b = nir_builder_init_simple_shader(MESA_SHADER_COMPUTE, options, "%s", "upload");
+   enum pipe_texture_target target = key->target;
+   bool is_1d = target == PIPE_TEXTURE_1D || target == PIPE_TEXTURE_1D_ARRAY;
+   bool is_array = target == PIPE_TEXTURE_1D_ARRAY || target == PIPE_TEXTURE_2D_ARRAY;
+   enum glsl_sampler_dim dim = is_1d ? GLSL_SAMPLER_DIM_1D :
+                               target == PIPE_TEXTURE_3D ? GLSL_SAMPLER_DIM_3D :
+                               GLSL_SAMPLER_DIM_2D;
+
+   b.shader->info.workgroup_size[0] = is_1d ? 64 : 8;
+   b.shader->info.workgroup_size[1] = is_1d ? 1 : 8;
+   b.shader->info.workgroup_size[2] = 1;
+   b.shader->info.num_ssbos = 1;
+   b.shader->num_uniforms = 12;
+   nir_variable_create(b.shader, nir_var_mem_ssbo, glsl_array_type(glsl_float_type(), 0, 4), "ssbo");
+
+   /* params[0]: image offset, byte offset of the first texel in the ssbo
+    * params[1]: size of the upload, last dword of the ssbo
+    * params[2]: row stride, image stride
+    */
+   nir_variable *ubo = nir_variable_create(b.shader, nir_var_uniform,
+                                           glsl_array_type(glsl_uvec4_type(), 3, 0),
+                                           "params");
+   nir_deref_instr *ubo_deref = nir_build_deref_var(&b, ubo);
+   nir_def *params[3];
+   for (unsigned i = 0; i < 3; i++)
+      params[i] = nir_load_deref(&b, nir_build_deref_array_imm(&b, ubo_deref, i));
+
+   nir_variable *img_var =
+      nir_variable_create(b.shader, nir_var_image,
+                          glsl_image_type(dim, is_array, GLSL_TYPE_FLOAT), "img");
+   img_var->data.access = ACCESS_NON_READABLE;
+   img_var->data.explicit_binding = true;
+   img_var->data.binding = 0;
+   img_var->data.image.format = key->image_format;
+
+   nir_def *bsize = nir_imm_ivec3(&b,
+                                  b.shader->info.workgroup_size[0],
+                                  b.shader->info.workgroup_size[1],
+                                  b.shader->info.workgroup_size[2]);
+   nir_def *wid = nir_load_workgroup_id(&b);
+   nir_def *iid = nir_load_local_invocation_id(&b);
+   nir_def *global_id = nir_iadd(&b, nir_imul(&b, wid, bsize), iid);
+
+   nir_push_if(&b, nir_ball(&b, nir_ult(&b, global_id, nir_trim_vector(&b, params[1], 3))));
+
+   /* from _mesa_image_offset(), with the skip offsets folded into params[0].w */
+   nir_def *addr = nir_iadd(&b, nir_channel(&b, params[0], 3),
+                            nir_iadd(&b, nir_imul_imm(&b, nir_channel(&b, global_id, 0), key->pixel_bytes),
+                                     nir_iadd(&b, nir_imul(&b, nir_channel(&b, global_id, 1),
+                                                           nir_channel(&b, params[2], 0)),
+                                              nir_imul(&b, nir_channel(&b, global_id, 2),
+                                                       nir_channel(&b, params[2], 1)))));
+   nir_def *last_dword = nir_channel(&b, params[1], 3);
+
+   nir_def *zero = nir_imm_float(&b, 0.0);
+   nir_def *one = nir_imm_float(&b, 1.0);
+   nir_def *rgba[4] = { zero, zero, zero, one };
+   nir_def *word = NULL;
+   for (unsigned i = 0; i < key->num_components; i++) {
+      nir_def *val;
+      if (key->packed) {
+         if (!word)
+            word = load_unaligned(&b, addr, key->word_bytes, last_dword, key->swap);
+         val = nir_ubfe_imm(&b, word, key->shift[i], key->bits[i]);
+      } else {
+         val = load_unaligned(&b, nir_iadd_imm(&b, addr, i * key->word_bytes),
+                              key->word_bytes, last_dword, key->swap);
+      }
+      val = unpack_upload_component(&b, val, key->bits[i], key->type);
+
+      if (key->dst[i] == PBO_UPLOAD_LUMINANCE)
+         rgba[0] = rgba[1] = rgba[2] = val;
+      else
+         rgba[key->dst[i]] = val;
+   }
+
+   nir_def *out[4];
+   for (unsigned k = 0; k < 4; k++) {
+      unsigned swz = key->store_swizzle[k];
+      out[k] = swz <= PIPE_SWIZZLE_W ? rgba[swz] :
+               swz == PIPE_SWIZZLE_1 ? one : zero;
+   }
+
+   /* 1D arrays keep the layer in the second coordinate */
+   nir_def *coord = nir_iadd(&b, global_id, nir_trim_vector(&b, params[0], 3));
+   nir_def *izero = nir_imm_int(&b, 0);
+   if (target == PIPE_TEXTURE_1D)
+      coord = nir_vec4(&b, nir_channel(&b, coord, 0), izero, izero, izero);
+   else if (target == PIPE_TEXTURE_1D_ARRAY)
+      coord = nir_vec4(&b, nir_channel(&b, coord, 0), nir_channel(&b, coord, 2), izero, izero);
+   else if (dim == GLSL_SAMPLER_DIM_2D && !is_array)
+      coord = nir_vec4(&b, nir_channel(&b, coord, 0), nir_channel(&b, coord, 1), izero, izero);
+   else
+      coord = nir_pad_vector_imm_int(&b, coord, 0, 4);
+
+   nir_deref_instr *img_deref = nir_build_deref_var(&b, img_var);
+   nir_image_deref_store(&b, &img_deref->def, coord, nir_undef(&b, 1, 32),
+                         nir_vec(&b, out, 4), izero,
+                         .src_type = nir_type_float32,
+                         .image_dim = dim,
+                         .image_array = is_array,
+                         .access = ACCESS_NON_READABLE);
+
+   nir_pop_if(&b, NULL);
+
+   return st_nir_finish_builtin_shader(st, b.shader);
+}
+
+static uint32_t
+hash_upload_key(const void *key)
+{
+   return _mesa_hash_data(key, sizeof(struct pbo_upload_key));
+}
+
+static bool
+equals_upload_key(const void *a, const void *b)
+{
+   return !memcmp(a, b, sizeof(struct pbo_upload_key));
+}
+
+bool
+st_TexSubImage_shader(struct gl_context *ctx, GLuint dims,
+                      struct gl_texture_image *texImage,
+                      GLint xoffset, GLint yoffset, GLint zoffset,
+                      GLsizei width, GLsizei height, GLsizei depth,
+                      GLenum format, GLenum type, const void *pixels,
+                      const struct gl_pixelstore_attrib *unpack)
+{
+   struct st_context *st = st_context(ctx);
+   struct pipe_context *pipe = st->pipe;
+   struct pipe_screen *screen = st->screen;
+   struct gl_texture_object *stObj = texImage->TexObject;
+   struct pipe_resource *dst = texImage->pt;
+   struct pipe_resource *src = NULL;
+   unsigned dstz = texImage->Face + stObj->Attrib.MinLayer;
+   unsigned level = 0;
+   struct pbo_upload_key key;
+
+   /* only set up when compute transfers are allowed */
+   if (!st->pbo.shaders || !dst || dst->nr_samples > 1)
+      return false;
+
+   if (stObj->pt == dst)
+      level = stObj->Attrib.MinLevel + texImage->Level;
+
+   /* memcpy is faster than any conversion */
+   if (_mesa_format_matches_format_and_type(texImage->TexFormat, format,
+                                            type, unpack->SwapBytes, NULL))
+      return false;
+
+   /* integer formats need clamping rules the shader doesn't implement */
+   if (util_format_is_compressed(dst->format) ||
+       util_format_is_depth_or_stencil(dst->format) ||
+       util_format_is_pure_integer(dst->format) ||
+       st_compressed_format_fallback(st, texImage->TexFormat) ||
+       _mesa_texstore_needs_transfer_ops(ctx, texImage->_BaseFormat,
+                                         texImage->TexFormat))
+      return false;
+
+   if (unpack->BufferObj ? _mesa_check_disallowed_mapping(unpack->BufferObj) : !pixels)
+      return false;
+
+   /* luminance and intensity are stored in the red channel */
+   enum pipe_format tex_format = util_format_linear(dst->format);
+   enum pipe_format view_format = util_format_luminance_to_red(tex_format);
+   view_format = util_format_intensity_to_red(view_format);
+   if (!screen->is_format_supported(screen, view_format, dst->target,
+                                    0, 0, PIPE_BIND_SHADER_IMAGE))
+      return false;
+
+   memset(&key, 0, sizeof(key));
+   key.target = get_target_from_texture(dst);
+   key.image_format = screen->caps.image_store_formatted ? PIPE_FORMAT_NONE : view_format;
+   if (!fill_upload_layout(&key, format, type, unpack->SwapBytes) ||
+       !fill_upload_store_swizzle(&key, texImage->_BaseFormat, tex_format, view_format))
+      return false;
+
+   /* check with the driver to see if converting on the cpu is likely to be faster */
+   if (!st->force_compute_based_texture_transfer &&
+       !screen->is_compute_copy_faster(screen, view_format, view_format, width, height, depth, true))
+      return false;
+
+   intptr_t row_stride = _mesa_image_row_stride(unpack, width, format, type);
+   intptr_t image_stride = dims == 3 ?
+                           _mesa_image_image_stride(unpack, width, height, format, type) : 0;
+   if (row_stride <= 0 || image_stride < 0)
+      return false;
+
+   const GLubyte *start = _mesa_image_address(dims, unpack, pixels, width, height,
+                                              format, type, 0, 0, 0);
+   intptr_t size = (depth - 1) * image_stride + (height - 1) * row_stride +
+                   width * key.pixel_bytes;
+   if (size > UINT32_MAX - 8)
+      return false;
+
+   /* From now on, we need the gallium representation of dimensions. */
+   if (stObj->Target == GL_TEXTURE_1D_ARRAY) {
+      depth = height;
+      height = 1;
+      zoffset = yoffset;
+      yoffset = 0;
+      image_stride = row_stride;
+   }
+
+   struct hash_entry *he = NULL;
+   if (!st->pbo.upload_shaders)
+      st->pbo.upload_shaders = _mesa_hash_table_create(NULL, hash_upload_key, equals_upload_key);
+   else
+      he = _mesa_hash_table_search(st->pbo.upload_shaders, &key);
+
+   void *cs;
+   if (he) {
+      cs = he->data;
+   } else {
+      cs = create_upload_shader(st, &key);
+      if (!cs)
+         return false;
+      _mesa_hash_table_insert(st->pbo.upload_shaders, mem_dup(&key, sizeof(key)), cs);
+   }
+
+   /* The ssbo is either the pbo, bound at the nearest aligned offset, or a
+    * verbatim copy of the client data.
+    */
+   struct pipe_shader_buffer buffer;
+   unsigned base;
+   memset(&buffer, 0, sizeof(buffer));
+   if (unpack->BufferObj) {
+      unsigned alignment = MAX2(screen->caps.shader_buffer_offset_alignment, 4);
+      uintptr_t offset = (uintptr_t)start;
+
+      buffer.buffer = unpack->BufferObj->buffer;
+      buffer.buffer_offset = offset - offset % alignment;
+      base = offset - buffer.buffer_offset;
+   } else {
+      src = pipe_buffer_create(screen, PIPE_BIND_SHADER_BUFFER, PIPE_USAGE_STREAM,
+                               align(size, 4));
+      if (!src)
+         return false;
+      pipe_buffer_write(pipe, src, 0, size, start);
+      buffer.buffer = src;
+      base = 0;
+   }
+   buffer.buffer_size = MIN2(align(base + size, 4),
+                             buffer.buffer->width0 - buffer.buffer_offset);
+
+   uint32_t params[3][4] = {
+      { xoffset, yoffset, zoffset + dstz, base },
+      { width, height, depth, DIV_ROUND_UP(buffer.buffer_size, 4) - 1 },
+      { row_stride, image_stride, 0, 0 },
+   };
+   struct pipe_constant_buffer cb = {
+      .user_buffer = params,
+      .buffer_size = sizeof(params),
+   };
+
+   struct pipe_image_view image;
+   memset(&image, 0, sizeof(image));
+   image.resource = dst;
+   image.format = view_format;
+   image.access = PIPE_IMAGE_ACCESS_WRITE;
+   image.shader_access = PIPE_IMAGE_ACCESS_WRITE;
+   image.u.tex.level = level;
+   image.u.tex.first_layer = 0;
+   image.u.tex.last_layer = util_num_layers(dst, level) - 1;
+
+   struct cso_context *cso = st->cso_context;
+   cso_save_compute_state(cso, CSO_BIT_COMPUTE_SHADER);
+   cso_set_compute_shader_handle(cso, cs);
+
+   st_invalidate_bound_state(st, PIPE_SHADER_COMPUTE);
+   pipe->set_constant_buffer(pipe, PIPE_SHADER_COMPUTE, 0, false, &cb);
+   pipe->set_shader_buffers(pipe, PIPE_SHADER_COMPUTE, 0, 1, &buffer, 0);
+   pipe->set_shader_images(pipe, PIPE_SHADER_COMPUTE, 0, 1, 0, &image);
+
+   bool is_1d = key.target == PIPE_TEXTURE_1D || key.target == PIPE_TEXTURE_1D_ARRAY;
+   struct pipe_grid_info info = { 0 };
+   info.block[0] = is_1d ? 64 : 8;
+   info.block[1] = is_1d ? 1 : 8;
+   info.block[2] = 1;
+   info.grid[0] = DIV_ROUND_UP(width, info.block[0]);
+   info.grid[1] = DIV_ROUND_UP(height, info.block[1]);
+   info.grid[2] = depth;
+
+   pipe->launch_grid(pipe, &info);
+
+   cso_restore_compute_state(cso);
+
+   /* Unbind all because st/mesa won't do it if the current shader doesn't
+    * use them.
+    */
+   pipe->set_shader_images(pipe, PIPE_SHADER_COMPUTE, 0, 0, 1, NULL);
+   pipe->set_shader_buffers(pipe, PIPE_SHADER_COMPUTE, 0, 1, NULL, 0);
+   pipe_resource_reference(&src, NULL);
+
+   /* the texture is sampled or rendered to next */
+   pipe->memory_barrier(pipe, PIPE_BARRIER_TEXTURE |
+                              PIPE_BARRIER_IMAGE |
+                              PIPE_BARRIER_FRAMEBUFFER);
+
+   st->ctx->NewDriverState |= ST_NEW_CS_CONSTANTS |
+                              ST_NEW_CS_SSBOS |
+                              ST_NEW_CS_IMAGES;
+
+   return true;
+}
+
 void
 st_pbo_compute_deinit(struct st_context *st)
 {
    struct pipe_screen *screen = st->screen;
+   if (st->pbo.upload_shaders) {
+      hash_table_foreach(st->pbo.upload_shaders, entry) {
+         st->pipe->delete_compute_state(st->pipe, entry->data);
+         free((void *)entry->key);
+      }
+      _mesa_hash_table_destroy(st->pbo.upload_shaders, NULL);
+   }
    if (!st->pbo.shaders)
       return;
    hash_table_foreach(st->pbo.shaders, entry) {
@@ -161,6 +161,7 @@ bind_compute_state(struct st_context *st,
                                  prog->variants->driver_shader : NULL);
 
    if (prog->affected_states & ST_NEW_CS_SAMPLER_VIEWS) {
+      st_invalidate_bound_state(st, prog->info.stage);
       st->pipe->set_sampler_views(st->pipe, prog->info.stage, 0,
                                   prog->info.num_textures, 0, false,
                                   sampler_views);
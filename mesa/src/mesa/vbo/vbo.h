@@ -176,6 +176,19 @@ struct vbo_save_context {
    GLboolean dangling_attr_ref;
    GLboolean out_of_memory;  /**< True if last VBO allocation failed */
    bool no_current_update;
+
+   /* Draws of executed display list nodes that haven't been submitted yet,
+    * so that following nodes with the same vertex state can be merged into
+    * the same draw_vertex_state call. Flushed like stored vertices.
+    */
+   struct {
+      struct pipe_vertex_state *state; /**< one reference, for the driver */
+      struct pipe_draw_vertex_state_info info;
+      uint32_t velem_mask;
+      struct pipe_draw_start_count_bias *draws;
+      unsigned num_draws;
+      unsigned max_draws;
+   } pending;
 };
 
 GLboolean
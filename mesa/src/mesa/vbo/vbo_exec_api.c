@@ -685,6 +685,8 @@ vbo_exec_FlushVertices_internal(struct vbo_exec_context *exec, unsigned flags)
    struct gl_context *ctx = gl_context_from_vbo_exec(exec);
 
    if (flags & FLUSH_STORED_VERTICES) {
+      vbo_save_flush_draws(ctx);
+
       if (exec->vtx.vert_count) {
          vbo_exec_vtx_flush(exec);
       }
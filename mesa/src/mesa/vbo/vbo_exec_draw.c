@@ -341,6 +341,9 @@ vbo_exec_vtx_flush(struct vbo_exec_context *exec)
             printf("%s %d %d\n", __func__, exec->vtx.prim_count,
                    exec->vtx.vert_count);
 
+         /* Display list draws queued before these vertices go first. */
+         vbo_save_flush_draws(ctx);
+
          st_prepare_draw(ctx, ST_PIPELINE_RENDER_STATE_MASK);
 
          ctx->Driver.DrawGalliumMultiMode(ctx, &exec->vtx.info,
@@ -27,6 +27,7 @@
  */
 
 #include "util/glheader.h"
+#include "util/detect.h"
 #include "util/u_cpu_detect.h"
 #include "main/context.h"
 #include "main/varray.h"
@@ -234,6 +235,26 @@ vbo_get_minmax_index_mapped(unsigned count, unsigned index_size,
                             const void *indices,
                             unsigned *min_index, unsigned *max_index)
 {
+#if DETECT_ARCH_AARCH64
+   _mesa_index_array_min_max_neon(indices, index_size, count, restart,
+                                  restartIndex, min_index, max_index);
+   return;
+#else
+#if defined(USE_AVX2)
+   if (util_get_cpu_caps()->has_avx2) {
+      _mesa_index_array_min_max_avx2(indices, index_size, count, restart,
+                                     restartIndex, min_index, max_index);
+      return;
+   }
+#endif
+#if defined(USE_SSE41)
+   if (util_get_cpu_caps()->has_sse4_1) {
+      _mesa_index_array_min_max_sse41(indices, index_size, count, restart,
+                                      restartIndex, min_index, max_index);
+      return;
+   }
+#endif
+
    switch (index_size) {
    case 4: {
       const GLuint *ui_indices = (const GLuint *)indices;
@@ -248,16 +269,10 @@ vbo_get_minmax_index_mapped(unsigned count, unsigned index_size,
          }
       }
       else {
-#if defined(USE_SSE41)
-         if (util_get_cpu_caps()->has_sse4_1) {
-            _mesa_uint_array_min_max(ui_indices, &min_ui, &max_ui, count);
+         for (unsigned i = 0; i < count; i++) {
+            if (ui_indices[i] > max_ui) max_ui = ui_indices[i];
+            if (ui_indices[i] < min_ui) min_ui = ui_indices[i];
          }
-         else
-#endif
-            for (unsigned i = 0; i < count; i++) {
-               if (ui_indices[i] > max_ui) max_ui = ui_indices[i];
-               if (ui_indices[i] < min_ui) min_ui = ui_indices[i];
-            }
       }
       *min_index = min_ui;
       *max_index = max_ui;
@@ -310,6 +325,7 @@ vbo_get_minmax_index_mapped(unsigned count, unsigned index_size,
    default:
       unreachable("not reached");
    }
+#endif
 }
 
 
@@ -29,6 +29,7 @@
 #include "main/arrayobj.h"
 #include "main/bufferobj.h"
 
+#include "util/u_inlines.h"
 #include "util/u_memory.h"
 
 #include "vbo_private.h"
@@ -75,5 +76,8 @@ void vbo_save_destroy( struct gl_context *ctx )
    if (save->copied.buffer)
       free(save->copied.buffer);
 
+   pipe_vertex_state_reference(&save->pending.state, NULL);
+   free(save->pending.draws);
+
    _mesa_reference_buffer_object(ctx, &save->current_bo, NULL);
 }
@@ -152,4 +152,7 @@ vbo_save_playback_vertex_list_loopback(struct gl_context *ctx, void *data);
 void
 vbo_save_api_init(struct vbo_save_context *save);
 
+void
+vbo_save_flush_draws(struct gl_context *ctx);
+
 #endif /* VBO_SAVE_H */
@@ -38,8 +38,10 @@
 #include "main/state.h"
 #include "main/varray.h"
 #include "util/bitscan.h"
+#include "state_tracker/st_context.h"
 #include "state_tracker/st_draw.h"
 #include "pipe/p_context.h"
+#include "util/u_inlines.h"
 
 #include "vbo_private.h"
 
@@ -192,6 +194,66 @@ enum vbo_save_status {
    USE_SLOW_PATH,
 };
 
+static void
+queue_draws(struct gl_context *ctx, const struct vbo_save_vertex_list *node)
+{
+   struct vbo_save_context *save = &vbo_context(ctx)->save;
+   const struct pipe_draw_start_count_bias *draws =
+      node->num_draws > 1 ? node->start_counts : &node->start_count;
+   unsigned num_draws = save->pending.num_draws + node->num_draws;
+
+   if (num_draws > save->pending.max_draws) {
+      unsigned max_draws = MAX2(num_draws, save->pending.max_draws * 2);
+      struct pipe_draw_start_count_bias *tmp =
+         realloc(save->pending.draws, max_draws * sizeof(*tmp));
+
+      if (!tmp) {
+         /* Submit everything without merging. */
+         struct pipe_vertex_state *state = save->pending.state;
+         struct pipe_draw_vertex_state_info info = save->pending.info;
+         uint32_t velem_mask = save->pending.velem_mask;
+
+         p_atomic_inc(&state->reference.count);
+         vbo_save_flush_draws(ctx);
+         ctx->pipe->draw_vertex_state(ctx->pipe, state, velem_mask, info,
+                                      draws, node->num_draws);
+         return;
+      }
+      save->pending.draws = tmp;
+      save->pending.max_draws = max_draws;
+   }
+
+   memcpy(&save->pending.draws[save->pending.num_draws], draws,
+          node->num_draws * sizeof(*draws));
+   save->pending.num_draws = num_draws;
+}
+
+/**
+ * Submit the draws of display list nodes queued for merging. This is called
+ * when stored vertices are flushed, i.e. before any state change.
+ */
+void
+vbo_save_flush_draws(struct gl_context *ctx)
+{
+   struct vbo_save_context *save = &vbo_context(ctx)->save;
+
+   if (!save->pending.state)
+      return;
+
+   struct pipe_context *pipe = ctx->pipe;
+
+   if (save->pending.num_draws) {
+      /* The driver takes over the reference of the queue. */
+      pipe->draw_vertex_state(pipe, save->pending.state,
+                              save->pending.velem_mask, save->pending.info,
+                              save->pending.draws, save->pending.num_draws);
+      save->pending.state = NULL;
+   } else {
+      pipe_vertex_state_reference(&save->pending.state, NULL);
+   }
+   save->pending.num_draws = 0;
+}
+
 static enum vbo_save_status
 vbo_save_playback_vertex_list_gallium(struct gl_context *ctx,
                                       const struct vbo_save_vertex_list *node,
@@ -236,6 +298,33 @@ vbo_save_playback_vertex_list_gallium(struct gl_context *ctx,
 
    struct pipe_vertex_state *state = node->state[mode];
    struct pipe_draw_vertex_state_info info;
+   struct vbo_save_context *save = &vbo_context(ctx)->save;
+   uint32_t velem_mask = vp->info.inputs_read;
+
+   /* Set edge flags. */
+   _mesa_update_edgeflag_state_explicit(ctx, enabled & VERT_BIT_EDGEFLAG);
+
+   if (save->pending.state) {
+      /* Append the draws to the ones queued by the previous node if they
+       * use the same vertex state and nothing else changed in between.
+       * Any GL state change would have flushed them already, so only
+       * the state derived above has to be checked.
+       */
+      if (save->pending.state == state && !node->modes &&
+          save->pending.info.mode == node->mode &&
+          save->pending.velem_mask == velem_mask &&
+          !(ctx->NewDriverState & ctx->st->active_states &
+            ST_PIPELINE_RENDER_STATE_MASK_NO_VARRAYS)) {
+         queue_draws(ctx, node);
+
+         _mesa_update_edgeflag_state_vao(ctx);
+         if (copy_to_current)
+            playback_copy_to_current(ctx, node);
+         return DONE;
+      }
+
+      vbo_save_flush_draws(ctx);
+   }
 
    info.mode = node->mode;
    info.take_vertex_state_ownership = false;
@@ -278,44 +367,48 @@ vbo_save_playback_vertex_list_gallium(struct gl_context *ctx,
       info.take_vertex_state_ownership = true;
    }
 
-   /* Set edge flags. */
-   _mesa_update_edgeflag_state_explicit(ctx, enabled & VERT_BIT_EDGEFLAG);
-
    st_prepare_draw(ctx, ST_PIPELINE_RENDER_STATE_MASK_NO_VARRAYS);
 
    struct pipe_context *pipe = ctx->pipe;
-   uint32_t velem_mask = ctx->VertexProgram._Current->info.inputs_read;
 
    /* Fast path using a pre-built gallium vertex buffer state. */
-   if (node->modes || node->num_draws > 1) {
+   if (!node->modes && node->num_draws) {
+      /* Defer the draws, so that the next node can be merged into them.
+       * The queue always owns one reference, which is passed to the driver.
+       */
+      if (!info.take_vertex_state_ownership) {
+         p_atomic_inc(&state->reference.count);
+         info.take_vertex_state_ownership = true;
+      }
+
+      save->pending.state = state;
+      save->pending.info = info;
+      save->pending.velem_mask = velem_mask;
+      save->pending.num_draws = 0;
+      queue_draws(ctx, node);
+      ctx->Driver.NeedFlush |= FLUSH_STORED_VERTICES;
+   } else if (node->modes) {
       const struct pipe_draw_start_count_bias *draws = node->start_counts;
       const uint8_t *mode = node->modes;
       unsigned num_draws = node->num_draws;
 
-      if (!mode) {
-         pipe->draw_vertex_state(pipe, state, velem_mask, info, draws, num_draws);
-      } else {
-         /* Find consecutive draws where mode doesn't vary. */
-         for (unsigned i = 0, first = 0; i <= num_draws; i++) {
-            if (i == num_draws || mode[i] != mode[first]) {
-               unsigned current_num_draws = i - first;
-
-               /* Increase refcount to be able to use take_vertex_state_ownership
-                * with all draws.
-                */
-               if (i != num_draws && info.take_vertex_state_ownership)
-                  p_atomic_inc(&state->reference.count);
-
-               info.mode = mode[first];
-               pipe->draw_vertex_state(pipe, state, velem_mask, info, &draws[first],
-                                       current_num_draws);
-               first = i;
-            }
+      /* Find consecutive draws where mode doesn't vary. */
+      for (unsigned i = 0, first = 0; i <= num_draws; i++) {
+         if (i == num_draws || mode[i] != mode[first]) {
+            unsigned current_num_draws = i - first;
+
+            /* Increase refcount to be able to use take_vertex_state_ownership
+             * with all draws.
+             */
+            if (i != num_draws && info.take_vertex_state_ownership)
+               p_atomic_inc(&state->reference.count);
+
+            info.mode = mode[first];
+            pipe->draw_vertex_state(pipe, state, velem_mask, info, &draws[first],
+                                    current_num_draws);
+            first = i;
          }
       }
-   } else if (node->num_draws) {
-      pipe->draw_vertex_state(pipe, state, velem_mask, info,
-                              &node->start_count, 1);
    }
 
    /* Restore edge flag state and ctx->VertexProgram._VaryingInputs. */
@@ -336,8 +429,13 @@ vbo_save_playback_vertex_list(struct gl_context *ctx, void *data, bool copy_to_c
 {
    const struct vbo_save_vertex_list *node =
       (const struct vbo_save_vertex_list *) data;
+   struct vbo_context *vbo = vbo_context(ctx);
 
-   FLUSH_FOR_DRAW(ctx);
+   /* Keep the draws queued by previous nodes, so that this node can be
+    * merged into them, unless there are also vertices to flush.
+    */
+   if (!vbo->save.pending.state || vbo->exec.vtx.vertex_size)
+      FLUSH_FOR_DRAW(ctx);
 
    if (_mesa_inside_begin_end(ctx) && node->draw_begins) {
       /* Error: we're about to begin a new primitive but we're already
@@ -351,6 +449,8 @@ vbo_save_playback_vertex_list(struct gl_context *ctx, void *data, bool copy_to_c
    if (vbo_save_playback_vertex_list_gallium(ctx, node, copy_to_current) == DONE)
       return;
 
+   vbo_save_flush_draws(ctx);
+
    /* Save the Draw VAO before we override it. */
    const gl_vertex_processing_mode mode = ctx->VertexProgram._VPMode;
    GLbitfield vao_filter = _vbo_get_vao_filter(mode);
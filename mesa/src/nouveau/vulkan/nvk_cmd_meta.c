@@ -49,6 +49,8 @@ nvk_device_init_meta(struct nvk_device *dev)
    dev->meta.cmd_bind_map_buffer = nvk_cmd_bind_map_buffer;
    dev->meta.max_bind_map_buffer_size_B = 64 * 1024; /* TODO */
 
+   vk_meta_device_enable_persistence(&dev->vk, &dev->meta);
+
    return VK_SUCCESS;
 }
 
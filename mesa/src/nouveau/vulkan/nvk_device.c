@@ -258,6 +258,8 @@ nvk_CreateDevice(VkPhysicalDevice physicalDevice,
    if (result != VK_SUCCESS)
       goto fail_mem_cache;
 
+   vk_meta_device_start_warm_up(&dev->vk, &dev->meta);
+
    *pDevice = nvk_device_to_handle(dev);
 
    return VK_SUCCESS;
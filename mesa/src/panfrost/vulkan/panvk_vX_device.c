@@ -145,6 +145,8 @@ panvk_meta_init(struct panvk_device *device)
          MIN2(1024 >> i, pdev->properties.maxComputeWorkGroupSize[0]);
    }
 
+   vk_meta_device_enable_persistence(&device->vk, &device->meta);
+
    return VK_SUCCESS;
 }
 
@@ -365,6 +367,8 @@ panvk_per_arch(create_device)(struct panvk_physical_device *physical_device,
    panvk_utrace_perfetto_init(device, 2);
 #endif
 
+   vk_meta_device_start_warm_up(&device->vk, &device->meta);
+
    *pDevice = panvk_device_to_handle(device);
    return VK_SUCCESS;
 
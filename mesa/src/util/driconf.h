@@ -239,6 +239,10 @@
    DRI_CONF_OPT_B(glthread_nop_check_framebuffer_status, def, \
                   "glthread always returns GL_FRAMEBUFFER_COMPLETE to prevent synchronization.")
 
+#define DRI_CONF_GLTHREAD_COALESCE_STATE_CALLS(def) \
+   DRI_CONF_OPT_B(glthread_coalesce_state_calls, def, \
+                  "glthread drops state calls overridden by the next call. Errors of the dropped calls are not reported.")
+
 #define DRI_CONF_FORCE_GL_VENDOR() \
    DRI_CONF_OPT_S_NODEF(force_gl_vendor, "Override GPU vendor string.")
 
@@ -30,6 +30,7 @@
 
 #include "util/list.h"
 #include "util/macros.h"
+#include "util/simple_mtx.h"
 #include "util/u_math.h"
 #include "util/u_printf.h"
 
@@ -642,6 +643,16 @@ typedef struct gc_slab {
    unsigned num_free;
 } gc_slab;
 
+/* This structure precedes the block header of allocations that are too large
+ * for the slabs. The ralloc parent of those is the gc_ctx, except during a
+ * sweep where it is the rubbish context until they are marked live.
+ */
+typedef struct {
+   alignas(HEADER_ALIGN)
+
+   gc_ctx *ctx;
+} gc_large_header;
+
 struct gc_ctx {
 #ifndef NDEBUG
    unsigned canary;
@@ -664,6 +675,13 @@ struct gc_ctx {
 
    uint8_t current_gen;
    void *rubbish;
+
+   /* Number of live allocations that bypassed the slabs. */
+   unsigned num_large_objects;
+
+   /* Protects the slabs while gc_set_thread_safe() is enabled. */
+   bool thread_safe;
+   simple_mtx_t lock;
 };
 
 static gc_block_header *
@@ -705,6 +723,12 @@ get_gc_slab(gc_block_header *header)
    return (gc_slab *)((char *)header - header->slab_offset);
 }
 
+static gc_large_header *
+get_gc_large_header(gc_block_header *header)
+{
+   return (gc_large_header *)header - 1;
+}
+
 gc_ctx *
 gc_context(const void *parent)
 {
@@ -839,6 +863,33 @@ create_slab(gc_ctx *ctx, unsigned bucket)
    return slab;
 }
 
+static inline void
+gc_lock(gc_ctx *ctx)
+{
+   if (unlikely(ctx->thread_safe))
+      simple_mtx_lock(&ctx->lock);
+}
+
+static inline void
+gc_unlock(gc_ctx *ctx)
+{
+   if (unlikely(ctx->thread_safe))
+      simple_mtx_unlock(&ctx->lock);
+}
+
+void
+gc_set_thread_safe(gc_ctx *ctx, bool thread_safe)
+{
+   assert(ctx->thread_safe != thread_safe);
+
+   if (thread_safe)
+      simple_mtx_init(&ctx->lock, mtx_plain);
+   else
+      simple_mtx_destroy(&ctx->lock);
+
+   ctx->thread_safe = thread_safe;
+}
+
 void *
 gc_alloc_size(gc_ctx *ctx, size_t size, size_t alignment)
 {
@@ -860,19 +911,28 @@ gc_alloc_size(gc_ctx *ctx, size_t size, size_t alignment)
    size += header_size;
 
    gc_block_header *header = NULL;
+   gc_lock(ctx);
    if (size <= MAX_FREELIST_SIZE) {
       uint32_t bucket = gc_bucket_for_size((uint32_t)size);
-      if (list_is_empty(&ctx->slabs[bucket].free_slabs) && !create_slab(ctx, bucket))
+      if (list_is_empty(&ctx->slabs[bucket].free_slabs) && !create_slab(ctx, bucket)) {
+         gc_unlock(ctx);
          return NULL;
+      }
       gc_slab *slab = list_first_entry(&ctx->slabs[bucket].free_slabs, gc_slab, free_link);
       header = alloc_from_slab(slab, bucket);
    } else {
-      header = ralloc_size(ctx, size);
-      if (unlikely(!header))
+      gc_large_header *large = ralloc_size(ctx, sizeof(gc_large_header) + size);
+      if (unlikely(!large)) {
+         gc_unlock(ctx);
          return NULL;
+      }
+      large->ctx = ctx;
+      header = (gc_block_header *)(large + 1);
       /* Mark the header as allocated directly, so we know to actually free it. */
       header->bucket = NUM_FREELIST_BUCKETS;
+      ctx->num_large_objects++;
    }
+   gc_unlock(ctx);
 
    header->flags = ctx->current_gen | IS_USED;
 #ifndef NDEBUG
@@ -907,10 +967,23 @@ gc_free(void *ptr)
    gc_block_header *header = get_gc_header(ptr);
    header->flags &= ~IS_USED;
 
-   if (header->bucket < NUM_FREELIST_BUCKETS)
+   if (header->bucket < NUM_FREELIST_BUCKETS) {
+      gc_ctx *ctx = get_gc_slab(header)->ctx;
+      gc_lock(ctx);
       free_from_slab(header, true);
-   else
-      ralloc_free(header);
+      gc_unlock(ctx);
+   } else {
+      gc_large_header *large = get_gc_large_header(header);
+      gc_ctx *ctx = large->ctx;
+      gc_lock(ctx);
+      /* During a sweep, only the objects already marked live are counted. */
+      if (ralloc_parent(large) == ctx) {
+         assert(ctx->num_large_objects > 0);
+         ctx->num_large_objects--;
+      }
+      ralloc_free(large);
+      gc_unlock(ctx);
+   }
 }
 
 gc_ctx *gc_get_context(void *ptr)
@@ -920,7 +993,7 @@ gc_ctx *gc_get_context(void *ptr)
    if (header->bucket < NUM_FREELIST_BUCKETS)
       return get_gc_slab(header)->ctx;
    else
-      return ralloc_parent(header);
+      return get_gc_large_header(header)->ctx;
 }
 
 void
@@ -930,16 +1003,24 @@ gc_sweep_start(gc_ctx *ctx)
 
    ctx->rubbish = ralloc_context(NULL);
    ralloc_adopt(ctx->rubbish, ctx);
+
+   /* Large objects are counted again as they are marked live. */
+   ctx->num_large_objects = 0;
 }
 
 void
 gc_mark_live(gc_ctx *ctx, const void *mem)
 {
    gc_block_header *header = get_gc_header(mem);
-   if (header->bucket < NUM_FREELIST_BUCKETS)
+   if (header->bucket < NUM_FREELIST_BUCKETS) {
       header->flags ^= CURRENT_GENERATION;
-   else
-      ralloc_steal(ctx, header);
+   } else {
+      gc_large_header *large = get_gc_large_header(header);
+      if (ralloc_parent(large) != ctx) {
+         ralloc_steal(ctx, large);
+         ctx->num_large_objects++;
+      }
+   }
 }
 
 void
@@ -984,6 +1065,23 @@ gc_sweep_end(gc_ctx *ctx)
    ctx->rubbish = NULL;
 }
 
+void
+gc_get_stats(const gc_ctx *ctx, struct gc_stats *stats)
+{
+   memset(stats, 0, sizeof(*stats));
+
+   for (unsigned i = 0; i < NUM_FREELIST_BUCKETS; i++) {
+      list_for_each_entry(gc_slab, slab, &ctx->slabs[i].slabs, link) {
+         stats->num_slabs++;
+         stats->slab_bytes += get_slab_size(i);
+         stats->num_objects += slab->num_allocated;
+         stats->object_bytes += (size_t)slab->num_allocated * gc_bucket_obj_size(i);
+      }
+   }
+
+   stats->num_large_objects = ctx->num_large_objects;
+}
+
 /***************************************************************************
  * Linear allocator for short-lived allocations.
  ***************************************************************************
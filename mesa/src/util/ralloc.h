@@ -522,6 +522,34 @@ void gc_sweep_start(gc_ctx *ctx);
 void gc_mark_live(gc_ctx *ctx, const void *mem);
 void gc_sweep_end(gc_ctx *ctx);
 
+/**
+ * Serialize gc_alloc/gc_free on the context with a lock, so that several
+ * threads can allocate and free objects from it at the same time. Sweeping
+ * is not covered and must still happen from a single thread. Calls must be
+ * balanced, and thread safety should only be enabled while it is needed.
+ */
+void gc_set_thread_safe(gc_ctx *ctx, bool thread_safe);
+
+/**
+ * Memory usage of a GC context, as returned by gc_get_stats().
+ *
+ * Slab memory is reported both as reserved (whole slabs) and used (live
+ * objects, rounded up to their size class), so the difference is the
+ * fragmentation left behind by freed objects.
+ */
+struct gc_stats {
+   unsigned num_slabs;
+   size_t slab_bytes;
+
+   unsigned num_objects;
+   size_t object_bytes;
+
+   /* Allocations too large for a slab, which are ralloc'd individually. */
+   unsigned num_large_objects;
+};
+
+void gc_get_stats(const gc_ctx *ctx, struct gc_stats *stats);
+
 /**
  * Declare C++ new and delete operators which use ralloc.
  *
@@ -23,6 +23,7 @@
  */
 
 #include <gtest/gtest.h>
+#include "util/macros.h"
 #include "util/ralloc.h"
 
 #if defined(__LP64__) || defined(_WIN64)
@@ -46,3 +47,80 @@ TEST(gc_alloc, align)
       }
    }
 }
+
+TEST(gc_alloc, stats)
+{
+   gc_ctx *ctx = gc_context(NULL);
+   struct gc_stats stats;
+
+   gc_get_stats(ctx, &stats);
+   EXPECT_EQ(stats.num_slabs, 0);
+   EXPECT_EQ(stats.num_objects, 0);
+   EXPECT_EQ(stats.num_large_objects, 0);
+
+   void *small[64];
+   for (unsigned i = 0; i < ARRAY_SIZE(small); i++)
+      small[i] = gc_alloc_size(ctx, 16, 8);
+   void *large = gc_alloc_size(ctx, 64 * 1024, 8);
+
+   gc_get_stats(ctx, &stats);
+   EXPECT_EQ(stats.num_slabs, 1);
+   EXPECT_EQ(stats.num_objects, ARRAY_SIZE(small));
+   EXPECT_GE(stats.object_bytes, ARRAY_SIZE(small) * 16);
+   EXPECT_GE(stats.slab_bytes, stats.object_bytes);
+   EXPECT_EQ(stats.num_large_objects, 1);
+
+   gc_free(large);
+   gc_free(small[0]);
+
+   gc_get_stats(ctx, &stats);
+   EXPECT_EQ(stats.num_objects, ARRAY_SIZE(small) - 1);
+   EXPECT_EQ(stats.num_large_objects, 0);
+
+   /* Only keep every other object and a new large one alive. */
+   large = gc_alloc_size(ctx, 64 * 1024, 8);
+   gc_sweep_start(ctx);
+   for (unsigned i = 2; i < ARRAY_SIZE(small); i += 2)
+      gc_mark_live(ctx, small[i]);
+   gc_mark_live(ctx, large);
+   gc_sweep_end(ctx);
+
+   gc_get_stats(ctx, &stats);
+   EXPECT_EQ(stats.num_objects, ARRAY_SIZE(small) / 2 - 1);
+   EXPECT_EQ(stats.num_large_objects, 1);
+
+   /* Sweeping with nothing live should release every slab. */
+   gc_sweep_start(ctx);
+   gc_sweep_end(ctx);
+
+   gc_get_stats(ctx, &stats);
+   EXPECT_EQ(stats.num_slabs, 0);
+   EXPECT_EQ(stats.num_objects, 0);
+   EXPECT_EQ(stats.num_large_objects, 0);
+
+   ralloc_free(ctx);
+}
+
+TEST(gc_alloc, free_large_during_sweep)
+{
+   gc_ctx *ctx = gc_context(NULL);
+   struct gc_stats stats;
+
+   void *marked = gc_alloc_size(ctx, 64 * 1024, 8);
+   void *unmarked = gc_alloc_size(ctx, 64 * 1024, 8);
+   void *kept = gc_alloc_size(ctx, 64 * 1024, 8);
+
+   gc_sweep_start(ctx);
+   gc_mark_live(ctx, marked);
+   gc_mark_live(ctx, kept);
+   EXPECT_EQ(gc_get_context(unmarked), ctx);
+   gc_free(marked);
+   gc_free(unmarked);
+   gc_sweep_end(ctx);
+
+   gc_get_stats(ctx, &stats);
+   EXPECT_EQ(stats.num_large_objects, 1);
+   EXPECT_EQ(gc_get_context(kept), ctx);
+
+   ralloc_free(ctx);
+}
@@ -293,6 +293,7 @@ struct util_queue_monitoring
    unsigned num_direct_items;
    unsigned num_syncs;
    unsigned num_batches;
+   unsigned num_eliminated_calls;
 };
 
 #ifdef __cplusplus
@@ -0,0 +1,107 @@
+#!/usr/bin/env python3
+# Copyright 2025 Mesa3D authors
+# SPDX-License-Identifier: MIT
+
+# Decodes the per frame records written by the overlay layer with
+# VK_LAYER_MESA_OVERLAY_CONFIG=timing_file=/path/to/timing.bin
+import argparse
+import json
+import math
+import struct
+import sys
+
+MAGIC = b'MESATIME'
+HEADER = struct.Struct('=8sII')
+RECORD = struct.Struct('=QQQIIIIIIII')
+
+FIELDS = [
+    'frame',
+    'timestamp_us',
+    'gpu_time_ns',
+    'swapchain_id',
+    'frame_time_us',
+    'submit_time_us',
+    'submit_count',
+    'acquire_time_us',
+    'present_time_us',
+    'pipeline_time_us',
+]
+
+SUMMARY_FIELDS = [
+    'frame_time_us',
+    'gpu_time_ns',
+    'submit_time_us',
+    'submit_count',
+    'acquire_time_us',
+    'present_time_us',
+    'pipeline_time_us',
+]
+
+def read_records(f):
+    header = f.read(HEADER.size)
+    if len(header) < HEADER.size:
+        sys.exit('truncated header')
+
+    magic, version, record_size = HEADER.unpack(header)
+    if magic != MAGIC:
+        sys.exit('not an overlay timing file')
+    if version != 1 or record_size < RECORD.size:
+        sys.exit('unsupported timing file version %u' % version)
+
+    while True:
+        data = f.read(record_size)
+        if len(data) < record_size:
+            # A truncated record is expected if the application was killed.
+            break
+        yield dict(zip(FIELDS, RECORD.unpack_from(data)))
+
+def percentile(values, p):
+    return values[min(len(values) - 1, int(math.ceil(p / 100.0 * len(values))) - 1)]
+
+def summarize(records):
+    summary = {}
+    for swapchain_id in sorted(set(r['swapchain_id'] for r in records)):
+        frames = [r for r in records if r['swapchain_id'] == swapchain_id]
+        # The first frame has no previous present to measure from.
+        timed = [r for r in frames if r['frame'] > 0] or frames
+
+        stats = {}
+        for field in SUMMARY_FIELDS:
+            values = sorted(r[field] for r in timed)
+            stats[field] = {
+                'min': values[0],
+                'avg': sum(values) / len(values),
+                'p50': percentile(values, 50),
+                'p99': percentile(values, 99),
+                'max': values[-1],
+            }
+
+        elapsed = frames[-1]['timestamp_us'] - frames[0]['timestamp_us']
+        summary[str(swapchain_id)] = {
+            'frames': len(frames),
+            'fps': (len(frames) - 1) * 1e6 / elapsed if elapsed else 0.0,
+            'pipeline_stall_frames': sum(1 for r in frames if r['pipeline_time_us']),
+            'stats': stats,
+        }
+    return summary
+
+def main():
+    parser = argparse.ArgumentParser(description='Mesa overlay timing file decoder')
+    parser.add_argument('file', help='timing file written by the overlay layer, - for stdin')
+    parser.add_argument('--format', choices=['csv', 'json'], default='csv',
+                        help='csv prints one row per frame, json a summary per swapchain')
+    args = parser.parse_args()
+
+    f = sys.stdin.buffer if args.file == '-' else open(args.file, 'rb')
+    records = list(read_records(f))
+
+    if args.format == 'csv':
+        print(', '.join(FIELDS))
+        for r in records:
+            print(', '.join(str(r[field]) for field in FIELDS))
+    else:
+        json.dump(summarize(records), sys.stdout, indent=2)
+        print()
+
+if __name__ == '__main__':
+    main()
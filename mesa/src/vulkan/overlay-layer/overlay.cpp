@@ -33,6 +33,7 @@
 #include "imgui.h"
 
 #include "overlay_params.h"
+#include "overlay_timing.h"
 
 #include "util/u_debug.h"
 #include "util/hash_table.h"
@@ -41,6 +42,7 @@
 #include "util/os_time.h"
 #include "util/os_socket.h"
 #include "util/simple_mtx.h"
+#include "util/u_atomic.h"
 #include "util/u_math.h"
 
 #include "vk_enum_to_str.h"
@@ -67,6 +69,12 @@ struct instance_data {
    int socket;
 
    FILE *output_file_fd;
+
+   /* Per frame binary records, see overlay_timing.h. */
+   bool timing_enabled;
+   struct overlay_timing_writer timing_writer;
+
+   uint32_t n_swapchains;
 };
 
 struct frame_stat {
@@ -93,6 +101,11 @@ struct device_data {
 
    bool pipeline_statistics_enabled;
 
+   /* Time spent creating pipelines (us). Pipelines are created from any
+    * thread, this is folded into frame_stats at present.
+    */
+   uint64_t pipeline_time;
+
    /* For a single frame */
    struct frame_stat frame_stats;
 };
@@ -151,6 +164,7 @@ struct swapchain_data {
    struct device_data *device;
 
    VkSwapchainKHR swapchain;
+   uint32_t id;
    unsigned width, height;
    VkFormat format;
 
@@ -351,6 +365,12 @@ static void destroy_instance_data(struct instance_data *data)
       free((void*)data->params.output_file);
       data->params.output_file = NULL;
    }
+   if (data->timing_enabled)
+      overlay_timing_writer_finish(&data->timing_writer);
+   if (data->params.timing_file) {
+      free((void*)data->params.timing_file);
+      data->params.timing_file = NULL;
+   }
    if (data->params.control) {
       free((void*)data->params.control);
       data->params.control = NULL;
@@ -484,6 +504,8 @@ static const char *param_unit(enum overlay_param_enabled param)
    case OVERLAY_PARAM_ENABLED_frame_timing:
    case OVERLAY_PARAM_ENABLED_acquire_timing:
    case OVERLAY_PARAM_ENABLED_present_timing:
+   case OVERLAY_PARAM_ENABLED_submit_timing:
+   case OVERLAY_PARAM_ENABLED_pipeline_timing:
       return "(us)";
    case OVERLAY_PARAM_ENABLED_gpu_timing:
       return "(ns)";
@@ -527,6 +549,7 @@ static struct swapchain_data *new_swapchain_data(VkSwapchainKHR swapchain,
    struct swapchain_data *data = rzalloc(NULL, struct swapchain_data);
    data->device = device_data;
    data->swapchain = swapchain;
+   data->id = p_atomic_inc_return(&instance_data->n_swapchains);
    data->window_size = ImVec2(instance_data->params.width, instance_data->params.height);
    list_inithead(&data->draws);
    map_object(HKEY(data->swapchain), data);
@@ -836,12 +859,32 @@ static void snapshot_swapchain_frame(struct swapchain_data *data)
          now - data->last_present_time;
    }
 
+   device_data->frame_stats.stats[OVERLAY_PARAM_ENABLED_pipeline_timing] +=
+      p_atomic_xchg(&device_data->pipeline_time, 0);
+
    memset(&data->frames_stats[f_idx], 0, sizeof(data->frames_stats[f_idx]));
    for (int s = 0; s < OVERLAY_PARAM_ENABLED_MAX; s++) {
       data->frames_stats[f_idx].stats[s] += device_data->frame_stats.stats[s] + data->frame_stats.stats[s];
       data->accumulated_stats.stats[s] += device_data->frame_stats.stats[s] + data->frame_stats.stats[s];
    }
 
+   if (instance_data->timing_enabled) {
+      const uint64_t *stats = data->frames_stats[f_idx].stats;
+      const struct overlay_timing_record record = {
+         .frame = data->n_frames,
+         .timestamp_us = now,
+         .gpu_time_ns = stats[OVERLAY_PARAM_ENABLED_gpu_timing],
+         .swapchain_id = data->id,
+         .frame_time_us = (uint32_t)stats[OVERLAY_PARAM_ENABLED_frame_timing],
+         .submit_time_us = (uint32_t)stats[OVERLAY_PARAM_ENABLED_submit_timing],
+         .submit_count = (uint32_t)stats[OVERLAY_PARAM_ENABLED_submit],
+         .acquire_time_us = (uint32_t)stats[OVERLAY_PARAM_ENABLED_acquire_timing],
+         .present_time_us = (uint32_t)stats[OVERLAY_PARAM_ENABLED_present_timing],
+         .pipeline_time_us = (uint32_t)stats[OVERLAY_PARAM_ENABLED_pipeline_timing],
+      };
+      overlay_timing_writer_push(&instance_data->timing_writer, &record);
+   }
+
    /* If capture has been enabled but it hasn't started yet, it means we are on
     * the first snapshot after it has been enabled. At this point we want to
     * use the stats captured so far to update the display, but we don't want
@@ -1010,6 +1053,8 @@ static void compute_swapchain_display(struct swapchain_data *data)
       if (s == OVERLAY_PARAM_ENABLED_frame_timing ||
           s == OVERLAY_PARAM_ENABLED_acquire_timing ||
           s == OVERLAY_PARAM_ENABLED_present_timing ||
+          s == OVERLAY_PARAM_ENABLED_submit_timing ||
+          s == OVERLAY_PARAM_ENABLED_pipeline_timing ||
           s == OVERLAY_PARAM_ENABLED_gpu_timing) {
          double min_time = data->stats_min.stats[s] / data->time_dividor;
          double max_time = data->stats_max.stats[s] / data->time_dividor;
@@ -2496,7 +2541,12 @@ static VkResult overlay_QueueSubmit(
       }
    }
 
-   return device_data->vtable.QueueSubmit(queue, submitCount, pSubmits, fence);
+   uint64_t ts0 = os_time_get();
+   VkResult result = device_data->vtable.QueueSubmit(queue, submitCount, pSubmits, fence);
+   uint64_t ts1 = os_time_get();
+   device_data->frame_stats.stats[OVERLAY_PARAM_ENABLED_submit_timing] += ts1 - ts0;
+
+   return result;
 }
 
 static VkResult overlay_QueueSubmit2(
@@ -2536,7 +2586,52 @@ static VkResult overlay_QueueSubmit2(
       }
    }
 
-   return device_data->vtable.QueueSubmit2(queue, submitCount, pSubmits, fence);
+   uint64_t ts0 = os_time_get();
+   VkResult result = device_data->vtable.QueueSubmit2(queue, submitCount, pSubmits, fence);
+   uint64_t ts1 = os_time_get();
+   device_data->frame_stats.stats[OVERLAY_PARAM_ENABLED_submit_timing] += ts1 - ts0;
+
+   return result;
+}
+
+static VkResult overlay_CreateGraphicsPipelines(
+    VkDevice                                    device,
+    VkPipelineCache                             pipelineCache,
+    uint32_t                                    createInfoCount,
+    const VkGraphicsPipelineCreateInfo*         pCreateInfos,
+    const VkAllocationCallbacks*                pAllocator,
+    VkPipeline*                                 pPipelines)
+{
+   struct device_data *device_data = FIND(struct device_data, device);
+
+   uint64_t ts0 = os_time_get();
+   VkResult result = device_data->vtable.CreateGraphicsPipelines(device, pipelineCache,
+                                                                 createInfoCount, pCreateInfos,
+                                                                 pAllocator, pPipelines);
+   uint64_t ts1 = os_time_get();
+   p_atomic_add(&device_data->pipeline_time, ts1 - ts0);
+
+   return result;
+}
+
+static VkResult overlay_CreateComputePipelines(
+    VkDevice                                    device,
+    VkPipelineCache                             pipelineCache,
+    uint32_t                                    createInfoCount,
+    const VkComputePipelineCreateInfo*          pCreateInfos,
+    const VkAllocationCallbacks*                pAllocator,
+    VkPipeline*                                 pPipelines)
+{
+   struct device_data *device_data = FIND(struct device_data, device);
+
+   uint64_t ts0 = os_time_get();
+   VkResult result = device_data->vtable.CreateComputePipelines(device, pipelineCache,
+                                                                createInfoCount, pCreateInfos,
+                                                                pAllocator, pPipelines);
+   uint64_t ts1 = os_time_get();
+   p_atomic_add(&device_data->pipeline_time, ts1 - ts0);
+
+   return result;
 }
 
 static VkResult overlay_CreateDevice(
@@ -2658,6 +2753,12 @@ static VkResult overlay_CreateInstance(
 
    parse_overlay_env(&instance_data->params, getenv("VK_LAYER_MESA_OVERLAY_CONFIG"));
 
+   if (instance_data->params.timing_file) {
+      instance_data->timing_enabled =
+         overlay_timing_writer_init(&instance_data->timing_writer,
+                                    instance_data->params.timing_file);
+   }
+
    /* If there's no control file, and an output_file was specified, start
     * capturing fps data right away.
     */
@@ -2723,6 +2824,9 @@ static const struct {
    ADD_HOOK(QueueSubmit),
    ADD_HOOK(QueueSubmit2),
 
+   ADD_HOOK(CreateGraphicsPipelines),
+   ADD_HOOK(CreateComputePipelines),
+
    ADD_HOOK(CreateDevice),
    ADD_HOOK(DestroyDevice),
 
@@ -51,6 +51,12 @@ parse_output_file(const char *str)
    return strdup(str);
 }
 
+static const char *
+parse_timing_file(const char *str)
+{
+   return strdup(str);
+}
+
 static const char *
 parse_control(const char *str)
 {
@@ -92,6 +98,7 @@ parse_help(const char *str)
    fprintf(stderr, "\tfps_sampling_period=number-of-milliseconds\n");
    fprintf(stderr, "\tno_display=0|1\n");
    fprintf(stderr, "\toutput_file=/path/to/output.txt\n");
+   fprintf(stderr, "\ttiming_file=/path/to/timing.bin\n");
    fprintf(stderr, "\twidth=width-in-pixels\n");
    fprintf(stderr, "\theight=height-in-pixels\n");
 
@@ -53,6 +53,8 @@ extern "C" {
    OVERLAY_PARAM_BOOL(acquire)                       \
    OVERLAY_PARAM_BOOL(acquire_timing)                \
    OVERLAY_PARAM_BOOL(present_timing)                \
+   OVERLAY_PARAM_BOOL(submit_timing)                 \
+   OVERLAY_PARAM_BOOL(pipeline_timing)               \
    OVERLAY_PARAM_BOOL(vertices)                      \
    OVERLAY_PARAM_BOOL(primitives)                    \
    OVERLAY_PARAM_BOOL(vert_invocations)              \
@@ -67,6 +69,7 @@ extern "C" {
    OVERLAY_PARAM_BOOL(gpu_timing)                    \
    OVERLAY_PARAM_CUSTOM(fps_sampling_period)         \
    OVERLAY_PARAM_CUSTOM(output_file)                 \
+   OVERLAY_PARAM_CUSTOM(timing_file)                 \
    OVERLAY_PARAM_CUSTOM(position)                    \
    OVERLAY_PARAM_CUSTOM(width)                       \
    OVERLAY_PARAM_CUSTOM(height)                      \
@@ -94,6 +97,7 @@ struct overlay_params {
    bool enabled[OVERLAY_PARAM_ENABLED_MAX];
    enum overlay_param_position position;
    const char *output_file;
+   const char *timing_file;
    const char *control;
    uint32_t fps_sampling_period; /* us */
    bool help;
@@ -0,0 +1,71 @@
+/*
+ * Copyright 2025 Mesa3D authors
+ * SPDX-License-Identifier: MIT
+ */
+
+
+#include <errno.h>
+#include <string.h>
+
+#include "overlay_timing.h"
+
+static void
+overlay_timing_writer_flush(struct overlay_timing_writer *writer)
+{
+   if (writer->record_count == 0)
+      return;
+
+   if (fwrite(writer->records, sizeof(writer->records[0]),
+              writer->record_count, writer->file) != writer->record_count)
+      fprintf(stderr, "ERROR writing timing file: %s\n", strerror(errno));
+
+   writer->record_count = 0;
+}
+
+bool
+overlay_timing_writer_init(struct overlay_timing_writer *writer,
+                           const char *path)
+{
+   memset(writer, 0, sizeof(*writer));
+
+   writer->file = fopen(path, "wb");
+   if (!writer->file) {
+      fprintf(stderr, "ERROR opening timing file: %s\n", strerror(errno));
+      return false;
+   }
+
+   /* Records are already batched, don't copy them again in stdio. */
+   setvbuf(writer->file, NULL, _IONBF, 0);
+
+   struct overlay_timing_header header = {
+      .version = OVERLAY_TIMING_VERSION,
+      .record_size = sizeof(struct overlay_timing_record),
+   };
+   memcpy(header.magic, OVERLAY_TIMING_MAGIC, sizeof(header.magic));
+   fwrite(&header, sizeof(header), 1, writer->file);
+
+   simple_mtx_init(&writer->mutex, mtx_plain);
+
+   return true;
+}
+
+void
+overlay_timing_writer_push(struct overlay_timing_writer *writer,
+                           const struct overlay_timing_record *record)
+{
+   simple_mtx_lock(&writer->mutex);
+
+   writer->records[writer->record_count++] = *record;
+   if (writer->record_count == ARRAY_SIZE(writer->records))
+      overlay_timing_writer_flush(writer);
+
+   simple_mtx_unlock(&writer->mutex);
+}
+
+void
+overlay_timing_writer_finish(struct overlay_timing_writer *writer)
+{
+   overlay_timing_writer_flush(writer);
+   fclose(writer->file);
+   simple_mtx_destroy(&writer->mutex);
+}
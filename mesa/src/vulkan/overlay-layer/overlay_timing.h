@@ -0,0 +1,83 @@
+/*
+ * Copyright 2025 Mesa3D authors
+ * SPDX-License-Identifier: MIT
+ */
+
+
+#ifndef OVERLAY_TIMING_H
+#define OVERLAY_TIMING_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "util/macros.h"
+#include "util/simple_mtx.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Binary per-frame timing export, enabled with timing_file=.
+ *
+ * The file starts with a struct overlay_timing_header followed by one
+ * struct overlay_timing_record per presented frame, in native byte order.
+ * mesa-overlay-timing.py decodes it.  Records are buffered and written
+ * OVERLAY_TIMING_BATCH_SIZE at a time so a frame costs a copy, not a
+ * write.
+ */
+#define OVERLAY_TIMING_MAGIC "MESATIME"
+#define OVERLAY_TIMING_VERSION 1
+#define OVERLAY_TIMING_BATCH_SIZE 64
+
+struct overlay_timing_header {
+   char magic[8];
+   uint32_t version;
+   uint32_t record_size;
+};
+
+struct overlay_timing_record {
+   uint64_t frame;
+   /* os_time_get() when the frame was presented */
+   uint64_t timestamp_us;
+   /* GPU time of the command buffers submitted for the frame, 0 unless
+    * gpu_timing is enabled
+    */
+   uint64_t gpu_time_ns;
+   uint32_t swapchain_id;
+   /* CPU time since the previous present */
+   uint32_t frame_time_us;
+   /* CPU time spent in vkQueueSubmit* and the number of calls */
+   uint32_t submit_time_us;
+   uint32_t submit_count;
+   /* CPU time spent in vkAcquireNextImage* and vkQueuePresentKHR */
+   uint32_t acquire_time_us;
+   uint32_t present_time_us;
+   /* CPU time spent in vkCreate*Pipelines, on any thread */
+   uint32_t pipeline_time_us;
+   uint32_t reserved;
+};
+
+static_assert(sizeof(struct overlay_timing_record) == 56,
+              "overlay_timing_record layout is part of the file format");
+
+struct overlay_timing_writer {
+   simple_mtx_t mutex;
+   FILE *file;
+   uint32_t record_count;
+   struct overlay_timing_record records[OVERLAY_TIMING_BATCH_SIZE];
+};
+
+bool overlay_timing_writer_init(struct overlay_timing_writer *writer,
+                                const char *path);
+
+void overlay_timing_writer_push(struct overlay_timing_writer *writer,
+                                const struct overlay_timing_record *record);
+
+void overlay_timing_writer_finish(struct overlay_timing_writer *writer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OVERLAY_TIMING_H */
@@ -0,0 +1,121 @@
+/*
+ * Copyright 2025 Mesa3D authors
+ * SPDX-License-Identifier: MIT
+ */
+
+/*
+ * Record/replay throughput of vk_cmd_queue for a draw-heavy command buffer:
+ * per draw, a viewport, a vertex buffer binding, push constants and a draw
+ * are recorded, the queue is replayed into a counting dispatch table and then
+ * reset, recycling its blocks like a command buffer of a vk_command_pool
+ * does.
+ *
+ * Usage: ./vk_cmd_queue_bench [iterations] [draws]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "vk_alloc.h"
+#include "vk_cmd_queue.h"
+#include "vk_dispatch_table.h"
+
+#include "util/os_time.h"
+
+static VKAPI_ATTR void VKAPI_CALL
+stub_CmdDraw(VkCommandBuffer commandBuffer, uint32_t vertexCount,
+             uint32_t instanceCount, uint32_t firstVertex,
+             uint32_t firstInstance)
+{
+}
+
+static VKAPI_ATTR void VKAPI_CALL
+stub_CmdSetViewport(VkCommandBuffer commandBuffer, uint32_t firstViewport,
+                    uint32_t viewportCount, const VkViewport *pViewports)
+{
+}
+
+static VKAPI_ATTR void VKAPI_CALL
+stub_CmdBindVertexBuffers(VkCommandBuffer commandBuffer,
+                          uint32_t firstBinding, uint32_t bindingCount,
+                          const VkBuffer *pBuffers,
+                          const VkDeviceSize *pOffsets)
+{
+}
+
+static VKAPI_ATTR void VKAPI_CALL
+stub_CmdPushConstants(VkCommandBuffer commandBuffer, VkPipelineLayout layout,
+                      VkShaderStageFlags stageFlags, uint32_t offset,
+                      uint32_t size, const void *pValues)
+{
+}
+
+static void
+record(struct vk_cmd_queue *queue, unsigned draws)
+{
+   const VkViewport viewport = { .width = 64.0f, .height = 64.0f };
+   const VkBuffer buffers[2] = { VK_NULL_HANDLE, VK_NULL_HANDLE };
+   const VkDeviceSize offsets[2] = { 0, 256 };
+   uint32_t constants[16];
+
+   for (unsigned i = 0; i < ARRAY_SIZE(constants); i++)
+      constants[i] = i;
+
+   for (unsigned i = 0; i < draws; i++) {
+      vk_enqueue_cmd_set_viewport(queue, 0, 1, &viewport);
+      vk_enqueue_cmd_bind_vertex_buffers(queue, 0, 2, buffers, offsets);
+      vk_enqueue_cmd_push_constants(queue, VK_NULL_HANDLE,
+                                    VK_SHADER_STAGE_VERTEX_BIT, 0,
+                                    sizeof(constants), constants);
+      vk_enqueue_cmd_draw(queue, i % 64 + 3, 1, (i % 64 + 3) * 3, 0);
+   }
+}
+
+int
+main(int argc, char **argv)
+{
+   unsigned iterations = argc > 1 ? atoi(argv[1]) : 1000;
+   unsigned draws = argc > 2 ? atoi(argv[2]) : 1000;
+   VkAllocationCallbacks alloc = *vk_default_allocator();
+   struct vk_device_dispatch_table disp = {
+      .CmdDraw = stub_CmdDraw,
+      .CmdSetViewport = stub_CmdSetViewport,
+      .CmdBindVertexBuffers = stub_CmdBindVertexBuffers,
+      .CmdPushConstants = stub_CmdPushConstants,
+   };
+   struct list_head free_blocks;
+   struct vk_cmd_queue queue;
+   int64_t record_ns = 0, replay_ns = 0, reset_ns = 0;
+
+   list_inithead(&free_blocks);
+   vk_cmd_queue_init(&queue, &alloc);
+   queue.free_blocks = &free_blocks;
+
+   for (unsigned it = 0; it < iterations; it++) {
+      int64_t t0 = os_time_get_nano();
+      record(&queue, draws);
+      int64_t t1 = os_time_get_nano();
+
+      vk_cmd_queue_execute(&queue, VK_NULL_HANDLE, &disp);
+      int64_t t2 = os_time_get_nano();
+
+      vk_cmd_queue_reset(&queue);
+      int64_t t3 = os_time_get_nano();
+
+      record_ns += t1 - t0;
+      replay_ns += t2 - t1;
+      reset_ns += t3 - t2;
+   }
+
+   vk_cmd_queue_finish(&queue);
+   vk_cmd_queue_free_blocks(&alloc, &free_blocks);
+
+   if (iterations) {
+      double cmds = (double)iterations * draws * 4;
+      printf("record: %8.2f ns/cmd\n", record_ns / cmds);
+      printf("replay: %8.2f ns/cmd\n", replay_ns / cmds);
+      printf("reset:  %8.2f ns/cmd\n", reset_ns / cmds);
+   }
+
+   return 0;
+}
@@ -0,0 +1,173 @@
+/*
+ * Copyright 2025 Mesa3D authors
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "vk_device_test.h"
+
+#include "vk_cmd_queue.h"
+#include "vk_dispatch_table.h"
+
+/* What the replayed commands were called with. */
+static struct {
+   uint64_t draws;
+   uint64_t vertex_sum;
+   uint64_t viewports;
+   uint64_t vertex_buffers;
+   uint64_t push_constants;
+   bool mismatch;
+} replayed;
+
+static VKAPI_ATTR void VKAPI_CALL
+stub_CmdDraw(VkCommandBuffer commandBuffer, uint32_t vertexCount,
+             uint32_t instanceCount, uint32_t firstVertex,
+             uint32_t firstInstance)
+{
+   replayed.draws++;
+   replayed.vertex_sum += vertexCount;
+   if (firstVertex != vertexCount * 3 || instanceCount != 1)
+      replayed.mismatch = true;
+}
+
+static VKAPI_ATTR void VKAPI_CALL
+stub_CmdSetViewport(VkCommandBuffer commandBuffer, uint32_t firstViewport,
+                    uint32_t viewportCount, const VkViewport *pViewports)
+{
+   replayed.viewports++;
+   if (viewportCount != 1 || pViewports[0].width != 64.0f)
+      replayed.mismatch = true;
+}
+
+static VKAPI_ATTR void VKAPI_CALL
+stub_CmdBindVertexBuffers(VkCommandBuffer commandBuffer,
+                          uint32_t firstBinding, uint32_t bindingCount,
+                          const VkBuffer *pBuffers,
+                          const VkDeviceSize *pOffsets)
+{
+   replayed.vertex_buffers++;
+   for (uint32_t i = 0; i < bindingCount; i++) {
+      if (pOffsets[i] != (firstBinding + i) * 256)
+         replayed.mismatch = true;
+   }
+}
+
+static VKAPI_ATTR void VKAPI_CALL
+stub_CmdPushConstants(VkCommandBuffer commandBuffer, VkPipelineLayout layout,
+                      VkShaderStageFlags stageFlags, uint32_t offset,
+                      uint32_t size, const void *pValues)
+{
+   const uint32_t *values = (const uint32_t *)pValues;
+
+   replayed.push_constants++;
+   for (uint32_t i = 0; i < size / 4; i++) {
+      if (values[i] != i)
+         replayed.mismatch = true;
+   }
+}
+
+class vk_cmd_queue_test : public vk_device_test {
+protected:
+   vk_cmd_queue_test()
+   {
+      disp = {};
+      disp.CmdDraw = stub_CmdDraw;
+      disp.CmdSetViewport = stub_CmdSetViewport;
+      disp.CmdBindVertexBuffers = stub_CmdBindVertexBuffers;
+      disp.CmdPushConstants = stub_CmdPushConstants;
+
+      list_inithead(&free_blocks);
+      vk_cmd_queue_init(&queue, &device->alloc);
+      queue.free_blocks = &free_blocks;
+   }
+
+   ~vk_cmd_queue_test()
+   {
+      vk_cmd_queue_finish(&queue);
+      vk_cmd_queue_free_blocks(&device->alloc, &free_blocks);
+   }
+
+   /* Per draw, a viewport, two vertex buffers, push constants and the
+    * draw.  Returns the sum of the vertex counts.
+    */
+   uint64_t
+   record(unsigned draws)
+   {
+      const VkViewport viewport = { 0.0f, 0.0f, 64.0f, 64.0f, 0.0f, 0.0f };
+      const VkBuffer buffers[2] = { VK_NULL_HANDLE, VK_NULL_HANDLE };
+      const VkDeviceSize offsets[2] = { 0, 256 };
+      uint32_t constants[16];
+      uint64_t vertex_sum = 0;
+
+      for (unsigned i = 0; i < ARRAY_SIZE(constants); i++)
+         constants[i] = i;
+
+      for (unsigned i = 0; i < draws; i++) {
+         const uint32_t vertex_count = i % 64 + 3;
+
+         EXPECT_EQ(vk_enqueue_cmd_set_viewport(&queue, 0, 1, &viewport),
+                   VK_SUCCESS);
+         EXPECT_EQ(vk_enqueue_cmd_bind_vertex_buffers(&queue, 0, 2, buffers,
+                                                      offsets),
+                   VK_SUCCESS);
+         EXPECT_EQ(vk_enqueue_cmd_push_constants(&queue, VK_NULL_HANDLE,
+                                                 VK_SHADER_STAGE_VERTEX_BIT,
+                                                 0, sizeof(constants),
+                                                 constants),
+                   VK_SUCCESS);
+         EXPECT_EQ(vk_enqueue_cmd_draw(&queue, vertex_count, 1,
+                                       vertex_count * 3, 0),
+                   VK_SUCCESS);
+         vertex_sum += vertex_count;
+      }
+
+      return vertex_sum;
+   }
+
+   void
+   execute()
+   {
+      memset(&replayed, 0, sizeof(replayed));
+      vk_cmd_queue_execute(&queue, VK_NULL_HANDLE, &disp);
+   }
+
+   struct vk_device_dispatch_table disp;
+   struct list_head free_blocks;
+   struct vk_cmd_queue queue;
+};
+
+TEST_F(vk_cmd_queue_test, replay)
+{
+   const unsigned draws = 1000;
+   const uint64_t vertex_sum = record(draws);
+
+   execute();
+   EXPECT_FALSE(replayed.mismatch);
+   EXPECT_EQ(replayed.draws, draws);
+   EXPECT_EQ(replayed.viewports, draws);
+   EXPECT_EQ(replayed.vertex_buffers, draws);
+   EXPECT_EQ(replayed.push_constants, draws);
+   EXPECT_EQ(replayed.vertex_sum, vertex_sum);
+
+   /* A queue can be replayed more than once. */
+   execute();
+   EXPECT_FALSE(replayed.mismatch);
+   EXPECT_EQ(replayed.draws, draws);
+}
+
+TEST_F(vk_cmd_queue_test, reset_recycles_blocks)
+{
+   const unsigned draws = 1000;
+
+   record(draws);
+   vk_cmd_queue_reset(&queue);
+   EXPECT_TRUE(list_is_empty(&queue.cmds));
+   EXPECT_FALSE(list_is_empty(&free_blocks));
+
+   /* Commands recorded into recycled blocks replay the same. */
+   const uint64_t vertex_sum = record(draws);
+   execute();
+   EXPECT_FALSE(replayed.mismatch);
+   EXPECT_EQ(replayed.draws, draws);
+   EXPECT_EQ(replayed.push_constants, draws);
+   EXPECT_EQ(replayed.vertex_sum, vertex_sum);
+}
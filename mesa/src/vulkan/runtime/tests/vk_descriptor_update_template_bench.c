@@ -0,0 +1,182 @@
+/*
+ * Copyright 2025 Mesa3D authors
+ * SPDX-License-Identifier: MIT
+ */
+
+/*
+ * Cost of enqueuing push descriptor updates with a template, like command
+ * buffers of vk_cmd_enqueue based drivers record them once per draw.  The
+ * template has one entry per descriptor, as many engines build them, which
+ * vk_descriptor_update_template merges into one entry per binding and a
+ * single copy range.
+ *
+ * Usage: ./vk_descriptor_update_template_bench [pushes]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "vk_cmd_enqueue_entrypoints.h"
+#include "vk_command_buffer.h"
+#include "vk_common_entrypoints.h"
+#include "vk_descriptor_update_template.h"
+#include "vk_pipeline_layout.h"
+#include "vk_test_device.h"
+
+#include "util/os_time.h"
+
+#define NUM_UBOS 4
+#define NUM_IMAGES 8
+#define NUM_TEXEL_BUFFERS 2
+#define INLINE_DATA_SIZE 64
+#define INLINE_CHUNK_SIZE 16
+
+#define NUM_ENTRIES (NUM_UBOS + NUM_IMAGES + NUM_TEXEL_BUFFERS + \
+                     INLINE_DATA_SIZE / INLINE_CHUNK_SIZE)
+
+struct push_data {
+   VkDescriptorBufferInfo ubos[NUM_UBOS];
+   VkDescriptorImageInfo images[NUM_IMAGES];
+   VkBufferView texel_buffers[NUM_TEXEL_BUFFERS];
+   uint8_t inline_data[INLINE_DATA_SIZE];
+};
+
+static void
+init_entries(VkDescriptorUpdateTemplateEntry *entries)
+{
+   unsigned e = 0;
+
+   for (unsigned i = 0; i < NUM_UBOS; i++) {
+      entries[e++] = (VkDescriptorUpdateTemplateEntry) {
+         .dstBinding = 0,
+         .dstArrayElement = i,
+         .descriptorCount = 1,
+         .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+         .offset = offsetof(struct push_data, ubos[i]),
+         .stride = sizeof(VkDescriptorBufferInfo),
+      };
+   }
+
+   for (unsigned i = 0; i < NUM_IMAGES; i++) {
+      entries[e++] = (VkDescriptorUpdateTemplateEntry) {
+         .dstBinding = 1,
+         .dstArrayElement = i,
+         .descriptorCount = 1,
+         .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+         .offset = offsetof(struct push_data, images[i]),
+         .stride = sizeof(VkDescriptorImageInfo),
+      };
+   }
+
+   for (unsigned i = 0; i < NUM_TEXEL_BUFFERS; i++) {
+      entries[e++] = (VkDescriptorUpdateTemplateEntry) {
+         .dstBinding = 2,
+         .dstArrayElement = i,
+         .descriptorCount = 1,
+         .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER,
+         .offset = offsetof(struct push_data, texel_buffers[i]),
+         .stride = sizeof(VkBufferView),
+      };
+   }
+
+   for (unsigned i = 0; i < INLINE_DATA_SIZE; i += INLINE_CHUNK_SIZE) {
+      entries[e++] = (VkDescriptorUpdateTemplateEntry) {
+         .dstBinding = 3,
+         .dstArrayElement = i,
+         .descriptorCount = INLINE_CHUNK_SIZE,
+         .descriptorType = VK_DESCRIPTOR_TYPE_INLINE_UNIFORM_BLOCK,
+         .offset = offsetof(struct push_data, inline_data[i]),
+      };
+   }
+
+   assert(e == NUM_ENTRIES);
+}
+
+static void
+pipeline_layout_destroy(struct vk_device *device,
+                        struct vk_pipeline_layout *layout)
+{
+   unreachable("the bench holds a reference");
+}
+
+int
+main(int argc, char **argv)
+{
+   unsigned pushes = argc > 1 ? atoi(argv[1]) : 1000000;
+   struct vk_test_device test_device;
+   struct vk_device *device = &test_device.device;
+
+   vk_test_device_init(&test_device);
+   VkDevice _device = vk_device_to_handle(device);
+   struct vk_pipeline_layout layout = {
+      .base.type = VK_OBJECT_TYPE_PIPELINE_LAYOUT,
+      .ref_cnt = 1,
+      .destroy = pipeline_layout_destroy,
+   };
+   struct vk_command_buffer cmd_buffer = {
+      .base.type = VK_OBJECT_TYPE_COMMAND_BUFFER,
+      .base.device = device,
+   };
+   struct list_head free_blocks;
+
+   list_inithead(&free_blocks);
+   vk_cmd_queue_init(&cmd_buffer.cmd_queue, &device->alloc);
+   cmd_buffer.cmd_queue.free_blocks = &free_blocks;
+
+   VkDescriptorUpdateTemplateEntry entries[NUM_ENTRIES];
+   init_entries(entries);
+
+   const VkDescriptorUpdateTemplateCreateInfo create_info = {
+      .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO,
+      .descriptorUpdateEntryCount = NUM_ENTRIES,
+      .pDescriptorUpdateEntries = entries,
+      .templateType = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_PUSH_DESCRIPTORS,
+      .pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS,
+   };
+   VkDescriptorUpdateTemplate _templ;
+   if (vk_common_CreateDescriptorUpdateTemplate(_device, &create_info, NULL,
+                                                &_templ) != VK_SUCCESS)
+      return 1;
+
+   VK_FROM_HANDLE(vk_descriptor_update_template, templ, _templ);
+   printf("%u entries merged into %u, %u copy ranges, %zu bytes\n",
+          NUM_ENTRIES, templ->entry_count, templ->copy_range_count,
+          templ->data_size);
+
+   struct push_data data;
+   for (unsigned i = 0; i < sizeof(data); i++)
+      ((uint8_t *)&data)[i] = i * 7;
+
+   const VkPushDescriptorSetWithTemplateInfoKHR push_info = {
+      .sType = VK_STRUCTURE_TYPE_PUSH_DESCRIPTOR_SET_WITH_TEMPLATE_INFO_KHR,
+      .descriptorUpdateTemplate = _templ,
+      .layout = vk_pipeline_layout_to_handle(&layout),
+      .set = 0,
+      .pData = &data,
+   };
+
+   int64_t enqueue_ns = 0;
+   for (unsigned i = 0; i < pushes; i++) {
+      int64_t start = os_time_get_nano();
+      vk_cmd_enqueue_CmdPushDescriptorSetWithTemplate2(
+         vk_command_buffer_to_handle(&cmd_buffer), &push_info);
+      enqueue_ns += os_time_get_nano() - start;
+
+      /* Reset like a command buffer recorded once per frame. */
+      if (i % 1000 == 999) {
+         if (cmd_buffer.record_result != VK_SUCCESS)
+            return 1;
+
+         vk_cmd_queue_reset(&cmd_buffer.cmd_queue);
+      }
+   }
+
+   if (pushes)
+      printf("enqueue: %8.2f ns/push\n", (double)enqueue_ns / pushes);
+
+   vk_cmd_queue_finish(&cmd_buffer.cmd_queue);
+   vk_cmd_queue_free_blocks(&device->alloc, &free_blocks);
+   vk_common_DestroyDescriptorUpdateTemplate(_device, _templ, NULL);
+
+   return 0;
+}
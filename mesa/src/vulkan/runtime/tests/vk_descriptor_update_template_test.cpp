@@ -0,0 +1,258 @@
+/*
+ * Copyright 2025 Mesa3D authors
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "vk_device_test.h"
+
+#include "vk_cmd_enqueue_entrypoints.h"
+#include "vk_command_buffer.h"
+#include "vk_common_entrypoints.h"
+#include "vk_descriptor_update_template.h"
+#include "vk_pipeline_layout.h"
+
+#define NUM_UBOS 4
+#define NUM_IMAGES 8
+#define NUM_TEXEL_BUFFERS 2
+#define INLINE_DATA_SIZE 64
+#define INLINE_CHUNK_SIZE 16
+
+#define NUM_ENTRIES (NUM_UBOS + NUM_IMAGES + NUM_TEXEL_BUFFERS + \
+                     INLINE_DATA_SIZE / INLINE_CHUNK_SIZE)
+
+struct push_data {
+   VkDescriptorBufferInfo ubos[NUM_UBOS];
+   VkDescriptorImageInfo images[NUM_IMAGES];
+   VkBufferView texel_buffers[NUM_TEXEL_BUFFERS];
+   uint8_t inline_data[INLINE_DATA_SIZE];
+};
+
+static VkDescriptorUpdateTemplateEntry
+template_entry(uint32_t binding, uint32_t array_element, uint32_t count,
+               VkDescriptorType type, size_t offset, size_t stride)
+{
+   VkDescriptorUpdateTemplateEntry entry = {};
+   entry.dstBinding = binding;
+   entry.dstArrayElement = array_element;
+   entry.descriptorCount = count;
+   entry.descriptorType = type;
+   entry.offset = offset;
+   entry.stride = stride;
+   return entry;
+}
+
+/* One entry per descriptor, as many engines build their templates. */
+static void
+init_entries(VkDescriptorUpdateTemplateEntry *entries)
+{
+   unsigned e = 0;
+
+   for (unsigned i = 0; i < NUM_UBOS; i++) {
+      entries[e++] =
+         template_entry(0, i, 1, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+                        offsetof(struct push_data, ubos) +
+                        i * sizeof(VkDescriptorBufferInfo),
+                        sizeof(VkDescriptorBufferInfo));
+   }
+
+   for (unsigned i = 0; i < NUM_IMAGES; i++) {
+      entries[e++] =
+         template_entry(1, i, 1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                        offsetof(struct push_data, images) +
+                        i * sizeof(VkDescriptorImageInfo),
+                        sizeof(VkDescriptorImageInfo));
+   }
+
+   for (unsigned i = 0; i < NUM_TEXEL_BUFFERS; i++) {
+      entries[e++] =
+         template_entry(2, i, 1, VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER,
+                        offsetof(struct push_data, texel_buffers) +
+                        i * sizeof(VkBufferView),
+                        sizeof(VkBufferView));
+   }
+
+   for (unsigned i = 0; i < INLINE_DATA_SIZE; i += INLINE_CHUNK_SIZE) {
+      entries[e++] =
+         template_entry(3, i, INLINE_CHUNK_SIZE,
+                        VK_DESCRIPTOR_TYPE_INLINE_UNIFORM_BLOCK,
+                        offsetof(struct push_data, inline_data) + i, 0);
+   }
+
+   assert(e == NUM_ENTRIES);
+}
+
+static void
+pipeline_layout_destroy(struct vk_device *device,
+                        struct vk_pipeline_layout *layout)
+{
+   ADD_FAILURE() << "the test holds a reference to the layout";
+}
+
+class vk_descriptor_update_template_test : public vk_device_test {
+protected:
+   vk_descriptor_update_template_test()
+   {
+      layout = {};
+      layout.base.type = VK_OBJECT_TYPE_PIPELINE_LAYOUT;
+      layout.ref_cnt = 1;
+      layout.destroy = pipeline_layout_destroy;
+
+      cmd_buffer = {};
+      cmd_buffer.base.type = VK_OBJECT_TYPE_COMMAND_BUFFER;
+      cmd_buffer.base.device = device;
+
+      list_inithead(&free_blocks);
+      vk_cmd_queue_init(&cmd_buffer.cmd_queue, &device->alloc);
+      cmd_buffer.cmd_queue.free_blocks = &free_blocks;
+
+      for (unsigned i = 0; i < sizeof(data); i++)
+         ((uint8_t *)&data)[i] = i * 7;
+   }
+
+   ~vk_descriptor_update_template_test()
+   {
+      vk_cmd_queue_finish(&cmd_buffer.cmd_queue);
+      vk_cmd_queue_free_blocks(&device->alloc, &free_blocks);
+      EXPECT_EQ(layout.ref_cnt, 1);
+   }
+
+   struct vk_descriptor_update_template *
+   create_template(const VkDescriptorUpdateTemplateEntry *entries,
+                   uint32_t entry_count)
+   {
+      VkDescriptorUpdateTemplateCreateInfo create_info = {};
+      create_info.sType =
+         VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO;
+      create_info.descriptorUpdateEntryCount = entry_count;
+      create_info.pDescriptorUpdateEntries = entries;
+      create_info.templateType =
+         VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_PUSH_DESCRIPTORS;
+      create_info.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+
+      VkDescriptorUpdateTemplate templ;
+      EXPECT_EQ(vk_common_CreateDescriptorUpdateTemplate(
+                   vk_device_to_handle(device), &create_info, NULL, &templ),
+                VK_SUCCESS);
+      return vk_descriptor_update_template_from_handle(templ);
+   }
+
+   void
+   destroy_template(struct vk_descriptor_update_template *templ)
+   {
+      vk_common_DestroyDescriptorUpdateTemplate(
+         vk_device_to_handle(device),
+         vk_descriptor_update_template_to_handle(templ), NULL);
+   }
+
+   /* Returns the data of the enqueued push. */
+   const struct push_data *
+   push(struct vk_descriptor_update_template *templ)
+   {
+      VkPushDescriptorSetWithTemplateInfoKHR push_info = {};
+      push_info.sType =
+         VK_STRUCTURE_TYPE_PUSH_DESCRIPTOR_SET_WITH_TEMPLATE_INFO_KHR;
+      push_info.descriptorUpdateTemplate =
+         vk_descriptor_update_template_to_handle(templ);
+      push_info.layout = vk_pipeline_layout_to_handle(&layout);
+      push_info.set = 0;
+      push_info.pData = &data;
+
+      vk_cmd_enqueue_CmdPushDescriptorSetWithTemplate2(
+         vk_command_buffer_to_handle(&cmd_buffer), &push_info);
+      EXPECT_EQ(cmd_buffer.record_result, VK_SUCCESS);
+
+      struct vk_cmd_queue_entry *cmd =
+         list_last_entry(&cmd_buffer.cmd_queue.cmds,
+                         struct vk_cmd_queue_entry, cmd_link);
+      EXPECT_EQ(cmd->type, VK_CMD_PUSH_DESCRIPTOR_SET_WITH_TEMPLATE2);
+      return (const struct push_data *)
+         cmd->u.push_descriptor_set_with_template2
+            .push_descriptor_set_with_template_info->pData;
+   }
+
+   struct vk_pipeline_layout layout;
+   struct vk_command_buffer cmd_buffer;
+   struct list_head free_blocks;
+   struct push_data data;
+};
+
+TEST_F(vk_descriptor_update_template_test, merge)
+{
+   VkDescriptorUpdateTemplateEntry entries[NUM_ENTRIES];
+   init_entries(entries);
+
+   /* One entry per binding, reading a single range. */
+   struct vk_descriptor_update_template *templ =
+      create_template(entries, NUM_ENTRIES);
+   EXPECT_EQ(templ->entry_count, 4);
+   EXPECT_EQ(templ->entries[0].array_count, NUM_UBOS);
+   EXPECT_EQ(templ->entries[1].array_count, NUM_IMAGES);
+   EXPECT_EQ(templ->entries[2].array_count, NUM_TEXEL_BUFFERS);
+   EXPECT_EQ(templ->entries[3].array_count, INLINE_DATA_SIZE);
+   EXPECT_EQ(templ->copy_range_count, 1);
+   EXPECT_EQ(templ->copy_ranges[0].offset, 0);
+   EXPECT_EQ(templ->copy_ranges[0].size, sizeof(struct push_data));
+   EXPECT_EQ(templ->data_size, sizeof(struct push_data));
+
+   destroy_template(templ);
+}
+
+TEST_F(vk_descriptor_update_template_test, sparse)
+{
+   const size_t image_offset =
+      offsetof(struct push_data, images) + 2 * sizeof(VkDescriptorImageInfo);
+   const VkDescriptorUpdateTemplateEntry entries[] = {
+      template_entry(1, 2, 1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                     image_offset, sizeof(VkDescriptorImageInfo)),
+      template_entry(0, 0, 1, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+                     offsetof(struct push_data, ubos),
+                     sizeof(VkDescriptorBufferInfo)),
+   };
+
+   /* The ranges are sorted by offset, and only they are enqueued. */
+   struct vk_descriptor_update_template *templ =
+      create_template(entries, ARRAY_SIZE(entries));
+   EXPECT_EQ(templ->entry_count, 2);
+   ASSERT_EQ(templ->copy_range_count, 2);
+   EXPECT_EQ(templ->copy_ranges[0].offset, offsetof(struct push_data, ubos));
+   EXPECT_EQ(templ->copy_ranges[0].size, sizeof(VkDescriptorBufferInfo));
+   EXPECT_EQ(templ->copy_ranges[1].offset, image_offset);
+   EXPECT_EQ(templ->copy_ranges[1].size, sizeof(VkDescriptorImageInfo));
+   EXPECT_EQ(templ->data_size, image_offset + sizeof(VkDescriptorImageInfo));
+
+   const struct push_data *pushed = push(templ);
+   EXPECT_EQ(memcmp(&pushed->ubos[0], &data.ubos[0],
+                    sizeof(data.ubos[0])), 0);
+   EXPECT_EQ(memcmp(&pushed->images[2], &data.images[2],
+                    sizeof(data.images[2])), 0);
+
+   const VkDescriptorBufferInfo zero = {};
+   EXPECT_EQ(memcmp(&pushed->ubos[1], &zero, sizeof(zero)), 0);
+
+   vk_cmd_queue_reset(&cmd_buffer.cmd_queue);
+   destroy_template(templ);
+}
+
+TEST_F(vk_descriptor_update_template_test, push)
+{
+   VkDescriptorUpdateTemplateEntry entries[NUM_ENTRIES];
+   init_entries(entries);
+   struct vk_descriptor_update_template *templ =
+      create_template(entries, NUM_ENTRIES);
+
+   /* Pushes outlive the template and the layout, until the queue is reset
+    * like a command buffer recorded once per frame.
+    */
+   for (unsigned frame = 0; frame < 10; frame++) {
+      for (unsigned i = 0; i < 100; i++) {
+         const struct push_data *pushed = push(templ);
+         EXPECT_EQ(memcmp(pushed, &data, sizeof(data)), 0);
+      }
+      EXPECT_EQ(layout.ref_cnt, 101);
+
+      vk_cmd_queue_reset(&cmd_buffer.cmd_queue);
+      EXPECT_EQ(layout.ref_cnt, 1);
+   }
+
+   destroy_template(templ);
+}
@@ -0,0 +1,28 @@
+/*
+ * Copyright 2025 Mesa3D authors
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef VK_DEVICE_TEST_H
+#define VK_DEVICE_TEST_H
+
+#include <gtest/gtest.h>
+
+#include "vk_test_device.h"
+
+/* Fixture for the tests of the runtime pieces which need a device. */
+class vk_device_test : public ::testing::Test {
+protected:
+   vk_device_test()
+   {
+      vk_test_device_init(&test_device);
+      physical = &test_device.physical;
+      device = &test_device.device;
+   }
+
+   struct vk_test_device test_device;
+   struct vk_physical_device *physical;
+   struct vk_device *device;
+};
+
+#endif /* VK_DEVICE_TEST_H */
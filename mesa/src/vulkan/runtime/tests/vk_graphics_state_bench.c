@@ -0,0 +1,111 @@
+/*
+ * Copyright 2025 Mesa3D authors
+ * SPDX-License-Identifier: MIT
+ */
+
+
+/*
+ * Dynamic state set per draw, like engines that set everything again before
+ * every draw instead of tracking what changed themselves.  Only the viewport
+ * actually changes, every 16 draws, so that is all the driver should see
+ * dirty after the first draw.
+ *
+ * Usage: ./vk_graphics_state_bench [draws]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "vk_command_buffer.h"
+#include "vk_common_entrypoints.h"
+#include "vk_graphics_state.h"
+
+#include "util/os_time.h"
+
+#define NUM_BINDINGS 2
+#define NUM_ATTRIBUTES 4
+
+static void
+set_state(VkCommandBuffer cmd, unsigned draw)
+{
+   const VkViewport viewport = {
+      .x = draw / 16,
+      .width = 1920.0f,
+      .height = 1080.0f,
+      .maxDepth = 1.0f,
+   };
+   const VkRect2D scissor = {
+      .extent = { 1920, 1080 },
+   };
+   const float blend_constants[4] = { 0.0f, 0.25f, 0.5f, 1.0f };
+
+   VkVertexInputBindingDescription2EXT bindings[NUM_BINDINGS];
+   for (unsigned b = 0; b < NUM_BINDINGS; b++) {
+      bindings[b] = (VkVertexInputBindingDescription2EXT) {
+         .sType = VK_STRUCTURE_TYPE_VERTEX_INPUT_BINDING_DESCRIPTION_2_EXT,
+         .binding = b,
+         .stride = 16 * (b + 1),
+         .inputRate = VK_VERTEX_INPUT_RATE_VERTEX,
+         .divisor = 1,
+      };
+   }
+
+   VkVertexInputAttributeDescription2EXT attributes[NUM_ATTRIBUTES];
+   for (unsigned a = 0; a < NUM_ATTRIBUTES; a++) {
+      attributes[a] = (VkVertexInputAttributeDescription2EXT) {
+         .sType = VK_STRUCTURE_TYPE_VERTEX_INPUT_ATTRIBUTE_DESCRIPTION_2_EXT,
+         .location = a,
+         .binding = a % NUM_BINDINGS,
+         .format = VK_FORMAT_R32G32B32A32_SFLOAT,
+         .offset = 16 * (a / NUM_BINDINGS),
+      };
+   }
+
+   vk_common_CmdSetVertexInputEXT(cmd, NUM_BINDINGS, bindings,
+                                  NUM_ATTRIBUTES, attributes);
+   vk_common_CmdSetPrimitiveTopology(cmd, VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST);
+   vk_common_CmdSetViewport(cmd, 0, 1, &viewport);
+   vk_common_CmdSetScissor(cmd, 0, 1, &scissor);
+   vk_common_CmdSetCullMode(cmd, VK_CULL_MODE_BACK_BIT);
+   vk_common_CmdSetFrontFace(cmd, VK_FRONT_FACE_COUNTER_CLOCKWISE);
+   vk_common_CmdSetLineWidth(cmd, 1.0f);
+   vk_common_CmdSetDepthTestEnable(cmd, VK_TRUE);
+   vk_common_CmdSetDepthCompareOp(cmd, VK_COMPARE_OP_LESS_OR_EQUAL);
+   vk_common_CmdSetBlendConstants(cmd, blend_constants);
+}
+
+int
+main(int argc, char **argv)
+{
+   unsigned draws = argc > 1 ? atoi(argv[1]) : 1000000;
+   struct vk_command_buffer cmd_buffer = {
+      .base.type = VK_OBJECT_TYPE_COMMAND_BUFFER,
+   };
+   struct vk_dynamic_graphics_state *dyn = &cmd_buffer.dynamic_graphics_state;
+   VkCommandBuffer cmd = vk_command_buffer_to_handle(&cmd_buffer);
+   struct vk_vertex_input_state vi = { 0 };
+   uint64_t dirty_count = 0;
+   int64_t set_ns = 0;
+
+   vk_dynamic_graphics_state_init(dyn);
+   dyn->vi = &vi;
+
+   for (unsigned i = 0; i < draws; i++) {
+      int64_t start = os_time_get_nano();
+      set_state(cmd, i);
+      set_ns += os_time_get_nano() - start;
+
+      /* What the driver would have to emit for this draw. */
+      dirty_count += BITSET_COUNT(dyn->dirty);
+      BITSET_ZERO(dyn->dirty);
+   }
+
+   if (draws) {
+      printf("set: %8.2f ns/draw, %6.3f dirty states/draw, "
+             "%6.2f redundant sets/draw\n",
+             (double)set_ns / draws, (double)dirty_count / draws,
+             (double)dyn->redundant_set_count / draws);
+   }
+
+   return 0;
+}
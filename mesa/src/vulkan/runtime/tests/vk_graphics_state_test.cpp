@@ -0,0 +1,133 @@
+/*
+ * Copyright 2025 Mesa3D authors
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "vk_device_test.h"
+
+#include "vk_command_buffer.h"
+#include "vk_common_entrypoints.h"
+#include "vk_graphics_state.h"
+
+#define NUM_BINDINGS 2
+#define NUM_ATTRIBUTES 4
+#define NUM_STATE_SETS 10
+
+class vk_graphics_state_test : public vk_device_test {
+protected:
+   vk_graphics_state_test()
+   {
+      cmd_buffer = {};
+      cmd_buffer.base.type = VK_OBJECT_TYPE_COMMAND_BUFFER;
+      cmd_buffer.base.device = device;
+      cmd = vk_command_buffer_to_handle(&cmd_buffer);
+
+      dyn = &cmd_buffer.dynamic_graphics_state;
+      vk_dynamic_graphics_state_init(dyn);
+      vi = {};
+      dyn->vi = &vi;
+   }
+
+   /* Sets everything again, like engines which don't track what changed
+    * themselves do before every draw.  Only the viewport changes, every 16
+    * draws.
+    */
+   void
+   set_state(unsigned draw)
+   {
+      const VkViewport viewport = {
+         (float)(draw / 16), 0.0f, 1920.0f, 1080.0f, 0.0f, 1.0f,
+      };
+      const VkRect2D scissor = { { 0, 0 }, { 1920, 1080 } };
+      const float blend_constants[4] = { 0.0f, 0.25f, 0.5f, 1.0f };
+
+      VkVertexInputBindingDescription2EXT bindings[NUM_BINDINGS] = {};
+      for (unsigned b = 0; b < NUM_BINDINGS; b++) {
+         bindings[b].sType =
+            VK_STRUCTURE_TYPE_VERTEX_INPUT_BINDING_DESCRIPTION_2_EXT;
+         bindings[b].binding = b;
+         bindings[b].stride = 16 * (b + 1);
+         bindings[b].inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+         bindings[b].divisor = 1;
+      }
+
+      VkVertexInputAttributeDescription2EXT attributes[NUM_ATTRIBUTES] = {};
+      for (unsigned a = 0; a < NUM_ATTRIBUTES; a++) {
+         attributes[a].sType =
+            VK_STRUCTURE_TYPE_VERTEX_INPUT_ATTRIBUTE_DESCRIPTION_2_EXT;
+         attributes[a].location = a;
+         attributes[a].binding = a % NUM_BINDINGS;
+         attributes[a].format = VK_FORMAT_R32G32B32A32_SFLOAT;
+         attributes[a].offset = 16 * (a / NUM_BINDINGS);
+      }
+
+      vk_common_CmdSetVertexInputEXT(cmd, NUM_BINDINGS, bindings,
+                                     NUM_ATTRIBUTES, attributes);
+      vk_common_CmdSetPrimitiveTopology(cmd,
+                                        VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST);
+      vk_common_CmdSetViewport(cmd, 0, 1, &viewport);
+      vk_common_CmdSetScissor(cmd, 0, 1, &scissor);
+      vk_common_CmdSetCullMode(cmd, VK_CULL_MODE_BACK_BIT);
+      vk_common_CmdSetFrontFace(cmd, VK_FRONT_FACE_COUNTER_CLOCKWISE);
+      vk_common_CmdSetLineWidth(cmd, 1.0f);
+      vk_common_CmdSetDepthTestEnable(cmd, VK_TRUE);
+      vk_common_CmdSetDepthCompareOp(cmd, VK_COMPARE_OP_LESS_OR_EQUAL);
+      vk_common_CmdSetBlendConstants(cmd, blend_constants);
+   }
+
+   struct vk_command_buffer cmd_buffer;
+   VkCommandBuffer cmd;
+   struct vk_dynamic_graphics_state *dyn;
+   struct vk_vertex_input_state vi;
+};
+
+TEST_F(vk_graphics_state_test, redundant_sets)
+{
+   set_state(0);
+   EXPECT_TRUE(BITSET_TEST(dyn->dirty, MESA_VK_DYNAMIC_VI));
+   EXPECT_TRUE(BITSET_TEST(dyn->dirty, MESA_VK_DYNAMIC_VP_VIEWPORTS));
+   BITSET_ZERO(dyn->dirty);
+
+   /* After the first draw, only the viewport is ever dirty, and every other
+    * vkCmdSet* call is counted once as redundant.
+    */
+   for (unsigned i = 1; i < 64; i++) {
+      const bool viewport_changed = i % 16 == 0;
+      const uint32_t redundant_set_count = dyn->redundant_set_count;
+
+      set_state(i);
+      EXPECT_EQ(BITSET_COUNT(dyn->dirty), viewport_changed) << "draw " << i;
+      EXPECT_EQ(BITSET_TEST(dyn->dirty, MESA_VK_DYNAMIC_VP_VIEWPORTS),
+                viewport_changed) << "draw " << i;
+      EXPECT_EQ(dyn->redundant_set_count - redundant_set_count,
+                NUM_STATE_SETS - viewport_changed) << "draw " << i;
+
+      BITSET_ZERO(dyn->dirty);
+   }
+}
+
+TEST_F(vk_graphics_state_test, redundant_sets_keep_dirty)
+{
+   /* A redundant set doesn't clear what is still dirty from the previous
+    * one.
+    */
+   set_state(0);
+   set_state(0);
+   EXPECT_TRUE(BITSET_TEST(dyn->dirty, MESA_VK_DYNAMIC_VI));
+   EXPECT_TRUE(BITSET_TEST(dyn->dirty, MESA_VK_DYNAMIC_VI_BINDING_STRIDES));
+   EXPECT_TRUE(BITSET_TEST(dyn->dirty, MESA_VK_DYNAMIC_VP_VIEWPORTS));
+   EXPECT_TRUE(BITSET_TEST(dyn->dirty, MESA_VK_DYNAMIC_CB_BLEND_CONSTANTS));
+}
+
+TEST_F(vk_graphics_state_test, vertex_input)
+{
+   set_state(0);
+
+   EXPECT_EQ(vi.bindings_valid, BITFIELD_MASK(NUM_BINDINGS));
+   EXPECT_EQ(vi.attributes_valid, BITFIELD_MASK(NUM_ATTRIBUTES));
+   EXPECT_EQ(vi.bindings[1].stride, 32);
+   EXPECT_EQ(vi.attributes[3].binding, 1);
+   EXPECT_EQ(vi.attributes[3].offset, 16);
+   EXPECT_EQ(dyn->vi_binding_strides[0], 16);
+   EXPECT_EQ(dyn->vi_binding_strides[1], 32);
+}
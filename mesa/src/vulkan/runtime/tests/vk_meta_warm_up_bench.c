@@ -0,0 +1,218 @@
+/*
+ * Copyright 2025 Mesa3D authors
+ * SPDX-License-Identifier: MIT
+ */
+
+/*
+ * First-use cost of the vk_meta buffer fill and copy pipelines, on a first
+ * run and on a second run warmed up from the keys persisted by the first
+ * one.  Pipeline creation is stubbed out with a busy loop standing in for
+ * the driver's shader compile.
+ *
+ * Usage: ./vk_meta_warm_up_bench [compile time in us]
+ */
+
+#include <ftw.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "vk_meta.h"
+#include "vk_meta_private.h"
+#include "vk_test_device.h"
+
+#include "util/disk_cache.h"
+#include "util/os_time.h"
+#include "util/u_atomic.h"
+
+static int64_t compile_ns;
+static uint32_t pipelines_created;
+
+static VKAPI_ATTR VkResult VKAPI_CALL
+stub_CreateDescriptorSetLayout(VkDevice _device,
+                               const VkDescriptorSetLayoutCreateInfo *pCreateInfo,
+                               const VkAllocationCallbacks *pAllocator,
+                               VkDescriptorSetLayout *pSetLayout)
+{
+   VK_FROM_HANDLE(vk_device, device, _device);
+   struct vk_object_base *obj =
+      vk_object_alloc(device, pAllocator, sizeof(*obj),
+                      VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT);
+   if (obj == NULL)
+      return VK_ERROR_OUT_OF_HOST_MEMORY;
+
+   *pSetLayout = (VkDescriptorSetLayout)(uintptr_t)obj;
+   return VK_SUCCESS;
+}
+
+static VKAPI_ATTR void VKAPI_CALL
+stub_DestroyDescriptorSetLayout(VkDevice _device,
+                                VkDescriptorSetLayout setLayout,
+                                const VkAllocationCallbacks *pAllocator)
+{
+   VK_FROM_HANDLE(vk_device, device, _device);
+   vk_object_free(device, pAllocator, (void *)(uintptr_t)setLayout);
+}
+
+static VKAPI_ATTR VkResult VKAPI_CALL
+stub_CreatePipelineLayout(VkDevice _device,
+                          const VkPipelineLayoutCreateInfo *pCreateInfo,
+                          const VkAllocationCallbacks *pAllocator,
+                          VkPipelineLayout *pPipelineLayout)
+{
+   VK_FROM_HANDLE(vk_device, device, _device);
+   struct vk_object_base *obj =
+      vk_object_alloc(device, pAllocator, sizeof(*obj),
+                      VK_OBJECT_TYPE_PIPELINE_LAYOUT);
+   if (obj == NULL)
+      return VK_ERROR_OUT_OF_HOST_MEMORY;
+
+   *pPipelineLayout = (VkPipelineLayout)(uintptr_t)obj;
+   return VK_SUCCESS;
+}
+
+static VKAPI_ATTR void VKAPI_CALL
+stub_DestroyPipelineLayout(VkDevice _device, VkPipelineLayout pipelineLayout,
+                           const VkAllocationCallbacks *pAllocator)
+{
+   VK_FROM_HANDLE(vk_device, device, _device);
+   vk_object_free(device, pAllocator, (void *)(uintptr_t)pipelineLayout);
+}
+
+static VKAPI_ATTR VkResult VKAPI_CALL
+stub_CreateComputePipelines(VkDevice _device, VkPipelineCache pipelineCache,
+                            uint32_t createInfoCount,
+                            const VkComputePipelineCreateInfo *pCreateInfos,
+                            const VkAllocationCallbacks *pAllocator,
+                            VkPipeline *pPipelines)
+{
+   VK_FROM_HANDLE(vk_device, device, _device);
+
+   for (uint32_t i = 0; i < createInfoCount; i++) {
+      const int64_t end = os_time_get_nano() + compile_ns;
+      while (os_time_get_nano() < end);
+
+      struct vk_object_base *obj =
+         vk_object_alloc(device, pAllocator, sizeof(*obj),
+                         VK_OBJECT_TYPE_PIPELINE);
+      if (obj == NULL)
+         return VK_ERROR_OUT_OF_HOST_MEMORY;
+
+      pPipelines[i] = (VkPipeline)(uintptr_t)obj;
+      p_atomic_inc(&pipelines_created);
+   }
+
+   return VK_SUCCESS;
+}
+
+static VKAPI_ATTR void VKAPI_CALL
+stub_DestroyPipeline(VkDevice _device, VkPipeline pipeline,
+                     const VkAllocationCallbacks *pAllocator)
+{
+   VK_FROM_HANDLE(vk_device, device, _device);
+   vk_object_free(device, pAllocator, (void *)(uintptr_t)pipeline);
+}
+
+static VkResult
+run(struct vk_device *device, const char *name)
+{
+   struct vk_meta_device meta;
+
+   VkResult result = vk_meta_device_init(device, &meta);
+   if (result != VK_SUCCESS)
+      return result;
+
+   for (unsigned i = 0; i < VK_META_BUFFER_CHUNK_SIZE_COUNT; i++)
+      meta.buffer_access.optimal_wg_size[i] = 64;
+
+   vk_meta_device_enable_persistence(device, &meta);
+   vk_meta_device_start_warm_up(device, &meta);
+
+   /* Leave the warm-up thread some time, like the rest of the application
+    * startup would.
+    */
+   os_time_sleep(compile_ns / 1000 * (VK_META_BUFFER_CHUNK_SIZE_COUNT + 1) *
+                 2);
+
+   const uint32_t created = p_atomic_read(&pipelines_created);
+   const int64_t start = os_time_get_nano();
+
+   const enum vk_meta_object_key_type fill_key =
+      VK_META_OBJECT_KEY_FILL_BUFFER_PIPELINE;
+   result = vk_meta_fill_buffer_build_pipeline(device, &meta, &fill_key,
+                                               sizeof(fill_key));
+
+   for (uint32_t chunk_size = 1;
+        chunk_size <= 16 && result == VK_SUCCESS; chunk_size *= 2) {
+      const struct {
+         enum vk_meta_object_key_type key_type;
+         uint32_t chunk_size;
+      } copy_key = {
+         .key_type = VK_META_OBJECT_KEY_COPY_BUFFER_PIPELINE,
+         .chunk_size = chunk_size,
+      };
+      result = vk_meta_copy_buffer_build_pipeline(device, &meta, &copy_key,
+                                                  sizeof(copy_key));
+   }
+
+   const int64_t elapsed = os_time_get_nano() - start;
+   const uint32_t created_on_use =
+      p_atomic_read(&pipelines_created) - created;
+
+   vk_meta_device_finish(device, &meta);
+   disk_cache_wait_for_idle(device->physical->disk_cache);
+
+   printf("%s: first use of %u pipelines %8.3f ms, %u created\n",
+          name, VK_META_BUFFER_CHUNK_SIZE_COUNT + 1, elapsed / 1e6,
+          created_on_use);
+
+   return result;
+}
+
+static int
+remove_file(const char *path, const struct stat *sb, int type,
+            struct FTW *ftw)
+{
+   return remove(path);
+}
+
+int
+main(int argc, char **argv)
+{
+   compile_ns = (argc > 1 ? atoi(argv[1]) : 2000) * 1000ll;
+
+   char cache_dir[] = "/tmp/vk_meta_warm_up_bench.XXXXXX";
+   if (mkdtemp(cache_dir) == NULL)
+      return 1;
+
+   setenv("MESA_SHADER_CACHE_DIR", cache_dir, 1);
+   setenv("MESA_SHADER_CACHE_DISABLE", "false", 1);
+
+   struct vk_test_device test_device;
+   struct vk_device *device = &test_device.device;
+   struct vk_device_dispatch_table *disp = &device->dispatch_table;
+
+   vk_test_device_init(&test_device);
+   test_device.physical.disk_cache =
+      disk_cache_create("vk_meta_warm_up_bench", "bench", 0);
+   disp->CreateDescriptorSetLayout = stub_CreateDescriptorSetLayout;
+   disp->DestroyDescriptorSetLayout = stub_DestroyDescriptorSetLayout;
+   disp->CreatePipelineLayout = stub_CreatePipelineLayout;
+   disp->DestroyPipelineLayout = stub_DestroyPipelineLayout;
+   disp->CreateComputePipelines = stub_CreateComputePipelines;
+   disp->DestroyPipeline = stub_DestroyPipeline;
+
+   int ret = 0;
+   if (test_device.physical.disk_cache == NULL) {
+      fprintf(stderr, "disk cache not available\n");
+      ret = 1;
+   } else {
+      if (run(device, "first run ") != VK_SUCCESS ||
+          run(device, "warmed run") != VK_SUCCESS)
+         ret = 1;
+      disk_cache_destroy(test_device.physical.disk_cache);
+   }
+
+   nftw(cache_dir, remove_file, 16, FTW_DEPTH | FTW_PHYS);
+
+   return ret;
+}
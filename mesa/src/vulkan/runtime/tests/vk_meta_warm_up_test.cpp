@@ -0,0 +1,272 @@
+/*
+ * Copyright 2025 Mesa3D authors
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <ftw.h>
+#include <stdlib.h>
+
+#include "vk_device_test.h"
+
+#include "vk_meta.h"
+#include "vk_meta_private.h"
+
+#include "util/disk_cache.h"
+#include "util/os_time.h"
+#include "util/u_atomic.h"
+
+#define NUM_BUFFER_PIPELINES (VK_META_BUFFER_CHUNK_SIZE_COUNT + 1)
+
+static uint32_t pipelines_created;
+
+static VKAPI_ATTR VkResult VKAPI_CALL
+stub_CreateDescriptorSetLayout(VkDevice _device,
+                               const VkDescriptorSetLayoutCreateInfo *pCreateInfo,
+                               const VkAllocationCallbacks *pAllocator,
+                               VkDescriptorSetLayout *pSetLayout)
+{
+   VK_FROM_HANDLE(vk_device, device, _device);
+   struct vk_object_base *obj = (struct vk_object_base *)
+      vk_object_alloc(device, pAllocator, sizeof(*obj),
+                      VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT);
+   if (obj == NULL)
+      return VK_ERROR_OUT_OF_HOST_MEMORY;
+
+   *pSetLayout = (VkDescriptorSetLayout)(uintptr_t)obj;
+   return VK_SUCCESS;
+}
+
+static VKAPI_ATTR void VKAPI_CALL
+stub_DestroyDescriptorSetLayout(VkDevice _device,
+                                VkDescriptorSetLayout setLayout,
+                                const VkAllocationCallbacks *pAllocator)
+{
+   VK_FROM_HANDLE(vk_device, device, _device);
+   vk_object_free(device, pAllocator, (void *)(uintptr_t)setLayout);
+}
+
+static VKAPI_ATTR VkResult VKAPI_CALL
+stub_CreatePipelineLayout(VkDevice _device,
+                          const VkPipelineLayoutCreateInfo *pCreateInfo,
+                          const VkAllocationCallbacks *pAllocator,
+                          VkPipelineLayout *pPipelineLayout)
+{
+   VK_FROM_HANDLE(vk_device, device, _device);
+   struct vk_object_base *obj = (struct vk_object_base *)
+      vk_object_alloc(device, pAllocator, sizeof(*obj),
+                      VK_OBJECT_TYPE_PIPELINE_LAYOUT);
+   if (obj == NULL)
+      return VK_ERROR_OUT_OF_HOST_MEMORY;
+
+   *pPipelineLayout = (VkPipelineLayout)(uintptr_t)obj;
+   return VK_SUCCESS;
+}
+
+static VKAPI_ATTR void VKAPI_CALL
+stub_DestroyPipelineLayout(VkDevice _device, VkPipelineLayout pipelineLayout,
+                           const VkAllocationCallbacks *pAllocator)
+{
+   VK_FROM_HANDLE(vk_device, device, _device);
+   vk_object_free(device, pAllocator, (void *)(uintptr_t)pipelineLayout);
+}
+
+static VKAPI_ATTR VkResult VKAPI_CALL
+stub_CreateComputePipelines(VkDevice _device, VkPipelineCache pipelineCache,
+                            uint32_t createInfoCount,
+                            const VkComputePipelineCreateInfo *pCreateInfos,
+                            const VkAllocationCallbacks *pAllocator,
+                            VkPipeline *pPipelines)
+{
+   VK_FROM_HANDLE(vk_device, device, _device);
+
+   for (uint32_t i = 0; i < createInfoCount; i++) {
+      struct vk_object_base *obj = (struct vk_object_base *)
+         vk_object_alloc(device, pAllocator, sizeof(*obj),
+                         VK_OBJECT_TYPE_PIPELINE);
+      if (obj == NULL)
+         return VK_ERROR_OUT_OF_HOST_MEMORY;
+
+      pPipelines[i] = (VkPipeline)(uintptr_t)obj;
+      p_atomic_inc(&pipelines_created);
+   }
+
+   return VK_SUCCESS;
+}
+
+static VKAPI_ATTR void VKAPI_CALL
+stub_DestroyPipeline(VkDevice _device, VkPipeline pipeline,
+                     const VkAllocationCallbacks *pAllocator)
+{
+   VK_FROM_HANDLE(vk_device, device, _device);
+   vk_object_free(device, pAllocator, (void *)(uintptr_t)pipeline);
+}
+
+static int
+remove_file(const char *path, const struct stat *sb, int type,
+            struct FTW *ftw)
+{
+   return remove(path);
+}
+
+/* Each test runs the device twice with a disk cache of its own. */
+class vk_meta_warm_up_test : public vk_device_test {
+protected:
+   vk_meta_warm_up_test()
+   {
+      strcpy(cache_dir, "/tmp/vk_meta_warm_up_test.XXXXXX");
+      EXPECT_NE(mkdtemp(cache_dir), nullptr);
+      setenv("MESA_SHADER_CACHE_DIR", cache_dir, 1);
+      setenv("MESA_SHADER_CACHE_DISABLE", "false", 1);
+      physical->disk_cache = disk_cache_create("vk_meta_warm_up_test",
+                                               "test", 0);
+
+      struct vk_device_dispatch_table *disp = &device->dispatch_table;
+      disp->CreateDescriptorSetLayout = stub_CreateDescriptorSetLayout;
+      disp->DestroyDescriptorSetLayout = stub_DestroyDescriptorSetLayout;
+      disp->CreatePipelineLayout = stub_CreatePipelineLayout;
+      disp->DestroyPipelineLayout = stub_DestroyPipelineLayout;
+      disp->CreateComputePipelines = stub_CreateComputePipelines;
+      disp->DestroyPipeline = stub_DestroyPipeline;
+
+      for (unsigned i = 0; i < ARRAY_SIZE(copy_keys); i++) {
+         memset(&copy_keys[i], 0, sizeof(copy_keys[i]));
+         copy_keys[i].key_type = VK_META_OBJECT_KEY_COPY_BUFFER_PIPELINE;
+         copy_keys[i].chunk_size = 1 << i;
+      }
+
+      pipelines_created = 0;
+   }
+
+   ~vk_meta_warm_up_test()
+   {
+      if (physical->disk_cache)
+         disk_cache_destroy(physical->disk_cache);
+      nftw(cache_dir, remove_file, 16, FTW_DEPTH | FTW_PHYS);
+   }
+
+   void
+   SetUp() override
+   {
+      if (physical->disk_cache == NULL)
+         GTEST_SKIP() << "disk cache not available";
+   }
+
+   void
+   init_meta(bool warm_up = true)
+   {
+      ASSERT_EQ(vk_meta_device_init(device, &meta), VK_SUCCESS);
+
+      for (unsigned i = 0; i < VK_META_BUFFER_CHUNK_SIZE_COUNT; i++)
+         meta.buffer_access.optimal_wg_size[i] = 64;
+
+      vk_meta_device_enable_persistence(device, &meta);
+      if (warm_up)
+         vk_meta_device_start_warm_up(device, &meta);
+   }
+
+   void
+   finish_meta()
+   {
+      vk_meta_device_finish(device, &meta);
+      disk_cache_wait_for_idle(physical->disk_cache);
+   }
+
+   /* Uses the buffer fill and copy pipelines, returns how many of them
+    * were created on first use.
+    */
+   uint32_t
+   use_buffer_pipelines()
+   {
+      const uint32_t created = p_atomic_read(&pipelines_created);
+
+      EXPECT_EQ(vk_meta_fill_buffer_build_pipeline(device, &meta, &fill_key,
+                                                   sizeof(fill_key)),
+                VK_SUCCESS);
+
+      for (unsigned i = 0; i < ARRAY_SIZE(copy_keys); i++) {
+         EXPECT_EQ(vk_meta_copy_buffer_build_pipeline(device, &meta,
+                                                      &copy_keys[i],
+                                                      sizeof(copy_keys[i])),
+                   VK_SUCCESS);
+      }
+
+      return p_atomic_read(&pipelines_created) - created;
+   }
+
+   unsigned
+   num_cached_buffer_pipelines()
+   {
+      unsigned count = 0;
+
+      if (vk_meta_lookup_pipeline(&meta, &fill_key, sizeof(fill_key)))
+         count++;
+
+      for (unsigned i = 0; i < ARRAY_SIZE(copy_keys); i++) {
+         if (vk_meta_lookup_pipeline(&meta, &copy_keys[i],
+                                     sizeof(copy_keys[i])))
+            count++;
+      }
+
+      return count;
+   }
+
+   /* Waits for the warm-up thread to create all the buffer pipelines. */
+   bool
+   wait_for_warm_up()
+   {
+      const int64_t timeout = os_time_get_absolute_timeout(10000000000ll);
+
+      while (num_cached_buffer_pipelines() < NUM_BUFFER_PIPELINES) {
+         if (os_time_get_nano() > timeout)
+            return false;
+         os_time_sleep(1000);
+      }
+
+      return true;
+   }
+
+   enum vk_meta_object_key_type fill_key =
+      VK_META_OBJECT_KEY_FILL_BUFFER_PIPELINE;
+   struct {
+      enum vk_meta_object_key_type key_type;
+      uint32_t chunk_size;
+   } copy_keys[VK_META_BUFFER_CHUNK_SIZE_COUNT];
+
+   char cache_dir[64];
+   struct vk_meta_device meta;
+};
+
+TEST_F(vk_meta_warm_up_test, warm_up)
+{
+   /* Nothing to warm up on the first run. */
+   init_meta();
+   EXPECT_EQ(use_buffer_pipelines(), NUM_BUFFER_PIPELINES);
+   finish_meta();
+
+   /* The second run creates the pipelines of the first one right away, so
+    * none is created on first use.
+    */
+   pipelines_created = 0;
+   init_meta();
+   EXPECT_TRUE(wait_for_warm_up());
+   EXPECT_EQ(pipelines_created, NUM_BUFFER_PIPELINES);
+   EXPECT_EQ(use_buffer_pipelines(), 0);
+   finish_meta();
+}
+
+TEST_F(vk_meta_warm_up_test, unused_pipelines_stay_stored)
+{
+   init_meta();
+   use_buffer_pipelines();
+   finish_meta();
+
+   /* A run using none of them doesn't forget them. */
+   pipelines_created = 0;
+   init_meta(false);
+   finish_meta();
+   EXPECT_EQ(pipelines_created, 0);
+
+   init_meta();
+   EXPECT_TRUE(wait_for_warm_up());
+   finish_meta();
+}
@@ -0,0 +1,142 @@
+/*
+ * Copyright 2025 Mesa3D authors
+ * SPDX-License-Identifier: MIT
+ */
+
+/*
+ * Contention of vk_pipeline_cache lookups and inserts from several threads
+ * sharing one cache, like drivers compiling pipelines in parallel do.
+ * Every thread looks up synthetic raw data objects, most of which are in
+ * the cache, and adds the missing ones.
+ *
+ * Usage: ./vk_pipeline_cache_bench [iterations] [max threads]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "vk_pipeline_cache.h"
+#include "vk_test_device.h"
+
+#include "util/os_time.h"
+#include "util/u_thread.h"
+
+#define NUM_KEYS 4096
+
+struct bench_thread {
+   thrd_t thread;
+   struct vk_pipeline_cache *cache;
+   unsigned iterations;
+   unsigned seed;
+   unsigned hits;
+   bool failed;
+};
+
+static int
+bench_thread_func(void *data)
+{
+   struct bench_thread *t = data;
+   struct vk_device *device = t->cache->base.device;
+
+   for (unsigned i = 0; i < t->iterations; i++) {
+      /* Simple LCG, we only need the keys to be spread out. */
+      t->seed = t->seed * 1103515245 + 12345;
+      uint32_t key = (t->seed >> 8) % NUM_KEYS;
+
+      bool cache_hit;
+      struct vk_pipeline_cache_object *object =
+         vk_pipeline_cache_lookup_object(t->cache, &key, sizeof(key),
+                                         &vk_raw_data_cache_object_ops,
+                                         &cache_hit);
+      if (object == NULL) {
+         struct vk_raw_data_cache_object *data_obj =
+            vk_raw_data_cache_object_create(device, &key, sizeof(key),
+                                            &key, sizeof(key));
+         if (data_obj == NULL) {
+            t->failed = true;
+            return 0;
+         }
+
+         object = vk_pipeline_cache_add_object(t->cache, &data_obj->base);
+      } else {
+         t->hits++;
+      }
+
+      vk_pipeline_cache_object_unref(device, object);
+   }
+
+   return 0;
+}
+
+int
+main(int argc, char **argv)
+{
+   unsigned iterations = argc > 1 ? atoi(argv[1]) : 1000000;
+   unsigned max_threads = argc > 2 ? atoi(argv[2]) : 8;
+   struct vk_test_device test_device;
+   struct vk_device *device = &test_device.device;
+   int ret = 0;
+
+   vk_test_device_init(&test_device);
+
+   for (unsigned num_threads = 1; num_threads <= max_threads;
+        num_threads *= 2) {
+      struct vk_pipeline_cache_create_info info = {
+         .force_enable = true,
+         .skip_disk_cache = true,
+      };
+      struct vk_pipeline_cache *cache =
+         vk_pipeline_cache_create(device, &info, NULL);
+      if (cache == NULL)
+         return 1;
+
+      /* Start with 3/4 of the keys in the cache. */
+      for (uint32_t key = 0; key < NUM_KEYS * 3 / 4; key++) {
+         struct vk_raw_data_cache_object *data_obj =
+            vk_raw_data_cache_object_create(device, &key, sizeof(key),
+                                            &key, sizeof(key));
+         if (data_obj == NULL)
+            return 1;
+
+         vk_pipeline_cache_object_unref(device,
+            vk_pipeline_cache_add_object(cache, &data_obj->base));
+      }
+
+      struct bench_thread threads[64];
+      num_threads = MIN2(num_threads, ARRAY_SIZE(threads));
+
+      int64_t start = os_time_get_nano();
+      for (unsigned i = 0; i < num_threads; i++) {
+         threads[i] = (struct bench_thread) {
+            .cache = cache,
+            .iterations = iterations / num_threads,
+            .seed = i + 1,
+         };
+         if (u_thread_create(&threads[i].thread, bench_thread_func,
+                             &threads[i]) != thrd_success)
+            return 1;
+      }
+
+      unsigned hits = 0;
+      for (unsigned i = 0; i < num_threads; i++) {
+         thrd_join(threads[i].thread, NULL);
+         hits += threads[i].hits;
+         if (threads[i].failed)
+            ret = 1;
+      }
+      int64_t elapsed = os_time_get_nano() - start;
+
+      uint32_t count = vk_pipeline_cache_object_count(cache);
+
+      unsigned ops = iterations / num_threads * num_threads;
+      printf("%2u threads: %8.2f ns/op, %5.1f%% hits, %u objects\n",
+             num_threads, (double)elapsed / ops, 100.0 * hits / ops, count);
+
+      vk_pipeline_cache_destroy(cache, NULL);
+   }
+
+   if (ret)
+      fprintf(stderr, "failed to create cache objects\n");
+
+   return ret;
+}
@@ -0,0 +1,227 @@
+/*
+ * Copyright 2025 Mesa3D authors
+ * SPDX-License-Identifier: MIT
+ */
+
+/*
+ * Startup cost of creating a vk_pipeline_cache from large initial data, and
+ * the cost moved into the first lookup of each entry, which happens in the
+ * pipeline compile path.  The entries are synthetic objects with their
+ * own ops, whose deserialization copies and checksums the data like a
+ * driver shader object would.
+ *
+ * Usage: ./vk_pipeline_cache_import_bench [entries] [entry size]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "vk_common_entrypoints.h"
+#include "vk_pipeline_cache.h"
+#include "vk_test_device.h"
+
+#include "util/blob.h"
+#include "util/os_time.h"
+
+struct bench_object {
+   struct vk_pipeline_cache_object base;
+   uint32_t key;
+   uint32_t checksum;
+   size_t size;
+   uint8_t data[];
+};
+
+static uint32_t
+checksum(const uint8_t *data, size_t size)
+{
+   uint32_t sum = 0;
+   for (size_t i = 0; i < size; i++)
+      sum = sum * 31 + data[i];
+   return sum;
+}
+
+static bool
+bench_object_serialize(struct vk_pipeline_cache_object *object,
+                       struct blob *blob)
+{
+   struct bench_object *obj = container_of(object, struct bench_object, base);
+
+   blob_write_uint32(blob, obj->checksum);
+   blob_write_bytes(blob, obj->data, obj->size);
+   return true;
+}
+
+static struct bench_object *bench_object_create(struct vk_device *device,
+                                                uint32_t key,
+                                                const uint8_t *data,
+                                                size_t size);
+
+static struct vk_pipeline_cache_object *
+bench_object_deserialize(struct vk_pipeline_cache *cache,
+                         const void *key_data, size_t key_size,
+                         struct blob_reader *blob)
+{
+   uint32_t sum = blob_read_uint32(blob);
+   size_t size = blob->end - blob->current;
+   const uint8_t *data = blob_read_bytes(blob, size);
+
+   if (blob->overrun || key_size != sizeof(uint32_t) ||
+       checksum(data, size) != sum)
+      return NULL;
+
+   struct bench_object *obj =
+      bench_object_create(cache->base.device, *(const uint32_t *)key_data,
+                          data, size);
+   return obj ? &obj->base : NULL;
+}
+
+static void
+bench_object_destroy(struct vk_device *device,
+                     struct vk_pipeline_cache_object *object)
+{
+   free(container_of(object, struct bench_object, base));
+}
+
+static const struct vk_pipeline_cache_object_ops bench_object_ops = {
+   .serialize = bench_object_serialize,
+   .deserialize = bench_object_deserialize,
+   .destroy = bench_object_destroy,
+};
+
+static const struct vk_pipeline_cache_object_ops *const bench_import_ops[] = {
+   &bench_object_ops,
+   NULL,
+};
+
+static struct bench_object *
+bench_object_create(struct vk_device *device, uint32_t key,
+                    const uint8_t *data, size_t size)
+{
+   struct bench_object *obj = malloc(sizeof(*obj) + size);
+   if (obj == NULL)
+      return NULL;
+
+   obj->key = key;
+   obj->size = size;
+   memcpy(obj->data, data, size);
+   obj->checksum = checksum(obj->data, size);
+   vk_pipeline_cache_object_init(device, &obj->base, &bench_object_ops,
+                                 &obj->key, sizeof(obj->key));
+   return obj;
+}
+
+/* Looks up every step-th key starting at first. */
+static unsigned
+lookup_range(struct vk_device *device, struct vk_pipeline_cache *cache,
+             uint32_t first, uint32_t count, uint32_t step)
+{
+   unsigned lookups = 0;
+   for (uint32_t key = first; key < count; key += step, lookups++) {
+      bool cache_hit;
+      struct vk_pipeline_cache_object *object =
+         vk_pipeline_cache_lookup_object(cache, &key, sizeof(key),
+                                         &bench_object_ops, &cache_hit);
+      if (object)
+         vk_pipeline_cache_object_unref(device, object);
+   }
+   return lookups;
+}
+
+static void
+fill_entry(uint8_t *data, size_t size, uint32_t key)
+{
+   for (size_t i = 0; i < size; i++)
+      data[i] = (uint8_t)(key * 31 + i);
+}
+
+int
+main(int argc, char **argv)
+{
+   unsigned num_entries = argc > 1 ? atoi(argv[1]) : 20000;
+   unsigned entry_size = argc > 2 ? atoi(argv[2]) : 8192;
+   struct vk_test_device test_device;
+   struct vk_device *device = &test_device.device;
+
+   vk_test_device_init(&test_device);
+   test_device.physical.pipeline_cache_import_ops = bench_import_ops;
+   VkDevice _device = vk_device_to_handle(device);
+
+   /* Build the initial data from a cache filled with bench objects. */
+   struct vk_pipeline_cache_create_info info = {
+      .force_enable = true,
+      .skip_disk_cache = true,
+   };
+   struct vk_pipeline_cache *src = vk_pipeline_cache_create(device, &info,
+                                                            NULL);
+   uint8_t *entry = malloc(entry_size);
+   if (src == NULL || entry == NULL)
+      return 1;
+
+   for (uint32_t key = 0; key < num_entries; key++) {
+      fill_entry(entry, entry_size, key);
+      struct bench_object *obj =
+         bench_object_create(device, key, entry, entry_size);
+      if (obj == NULL)
+         return 1;
+
+      vk_pipeline_cache_object_unref(device,
+         vk_pipeline_cache_add_object(src, &obj->base));
+   }
+   free(entry);
+
+   size_t size;
+   vk_common_GetPipelineCacheData(_device, vk_pipeline_cache_to_handle(src),
+                                  &size, NULL);
+   void *data = malloc(size);
+   if (data == NULL ||
+       vk_common_GetPipelineCacheData(_device,
+                                      vk_pipeline_cache_to_handle(src),
+                                      &size, data) != VK_SUCCESS)
+      return 1;
+   vk_pipeline_cache_destroy(src, NULL);
+
+   printf("%u entries, %.1f MiB of initial data\n", num_entries,
+          size / (1024.0 * 1024.0));
+
+   const VkPipelineCacheCreateInfo create_info = {
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+      .initialDataSize = size,
+      .pInitialData = data,
+   };
+   info.pCreateInfo = &create_info;
+
+   int64_t t0 = os_time_get_nano();
+   struct vk_pipeline_cache *cache =
+      vk_pipeline_cache_create(device, &info, NULL);
+   int64_t t1 = os_time_get_nano();
+   if (cache == NULL)
+      return 1;
+
+   /* Typically only a part of a cache is used in a run.  The first lookup
+    * of an entry deserializes it, which is what a pipeline compile waits
+    * for, later lookups only hit the hash table.
+    */
+   unsigned used = lookup_range(device, cache, 0, num_entries, 4);
+   int64_t t2 = os_time_get_nano();
+   lookup_range(device, cache, 0, num_entries, 4);
+   int64_t t3 = os_time_get_nano();
+
+   /* The rest of the entries, for the cost of a run using all of them. */
+   for (uint32_t first = 1; first < 4; first++)
+      lookup_range(device, cache, first, num_entries, 4);
+   int64_t t4 = os_time_get_nano();
+
+   vk_pipeline_cache_destroy(cache, NULL);
+
+   printf("create:                %8.3f ms\n", (t1 - t0) / 1e6);
+   printf("first lookups:  %6u %8.3f ms (%.2f us each)\n", used,
+          (t2 - t1) / 1e6, (t2 - t1) / 1e3 / MAX2(used, 1));
+   printf("repeat lookups: %6u %8.3f ms (%.2f us each)\n", used,
+          (t3 - t2) / 1e6, (t3 - t2) / 1e3 / MAX2(used, 1));
+   printf("all entries used:      %8.3f ms\n",
+          (t1 - t0 + t2 - t1 + t4 - t3) / 1e6);
+
+   free(data);
+
+   return 0;
+}
@@ -0,0 +1,321 @@
+/*
+ * Copyright 2025 Mesa3D authors
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <thread>
+#include <vector>
+
+#include "vk_device_test.h"
+
+#include "vk_common_entrypoints.h"
+#include "vk_pipeline_cache.h"
+
+#include "util/blob.h"
+
+/* Objects with their own ops, whose deserialization checks the data like a
+ * driver shader object would.
+ */
+struct test_object {
+   struct vk_pipeline_cache_object base;
+   uint32_t key;
+   uint32_t checksum;
+   size_t size;
+   uint8_t *data;
+};
+
+static uint32_t
+checksum(const uint8_t *data, size_t size)
+{
+   uint32_t sum = 0;
+   for (size_t i = 0; i < size; i++)
+      sum = sum * 31 + data[i];
+   return sum;
+}
+
+static struct test_object *test_object_create(struct vk_device *device,
+                                              uint32_t key,
+                                              const uint8_t *data,
+                                              size_t size);
+
+static bool
+test_object_serialize(struct vk_pipeline_cache_object *object,
+                      struct blob *blob)
+{
+   struct test_object *obj = container_of(object, struct test_object, base);
+
+   blob_write_uint32(blob, obj->checksum);
+   blob_write_bytes(blob, obj->data, obj->size);
+   return true;
+}
+
+static struct vk_pipeline_cache_object *
+test_object_deserialize(struct vk_pipeline_cache *cache,
+                        const void *key_data, size_t key_size,
+                        struct blob_reader *blob)
+{
+   uint32_t sum = blob_read_uint32(blob);
+   size_t size = blob->end - blob->current;
+   const uint8_t *data = (const uint8_t *)blob_read_bytes(blob, size);
+
+   if (blob->overrun || key_size != sizeof(uint32_t) ||
+       checksum(data, size) != sum)
+      return NULL;
+
+   struct test_object *obj =
+      test_object_create(cache->base.device, *(const uint32_t *)key_data,
+                         data, size);
+   return obj ? &obj->base : NULL;
+}
+
+static void
+test_object_destroy(struct vk_device *device,
+                    struct vk_pipeline_cache_object *object)
+{
+   free(container_of(object, struct test_object, base));
+}
+
+static const struct vk_pipeline_cache_object_ops test_object_ops = {
+   test_object_serialize,
+   test_object_deserialize,
+   test_object_destroy,
+};
+
+static const struct vk_pipeline_cache_object_ops *const test_import_ops[] = {
+   &test_object_ops,
+   NULL,
+};
+
+static struct test_object *
+test_object_create(struct vk_device *device, uint32_t key,
+                   const uint8_t *data, size_t size)
+{
+   struct test_object *obj =
+      (struct test_object *)malloc(sizeof(*obj) + size);
+   if (obj == NULL)
+      return NULL;
+
+   obj->key = key;
+   obj->size = size;
+   obj->data = (uint8_t *)(obj + 1);
+   memcpy(obj->data, data, size);
+   obj->checksum = checksum(obj->data, size);
+   vk_pipeline_cache_object_init(device, &obj->base, &test_object_ops,
+                                 &obj->key, sizeof(obj->key));
+   return obj;
+}
+
+static void
+fill_entry(uint8_t *data, size_t size, uint32_t key)
+{
+   for (size_t i = 0; i < size; i++)
+      data[i] = (uint8_t)(key * 31 + i);
+}
+
+static bool
+check_entry(const struct test_object *obj, size_t size, uint32_t key)
+{
+   if (obj->key != key || obj->size != size)
+      return false;
+
+   for (size_t i = 0; i < size; i++) {
+      if (obj->data[i] != (uint8_t)(key * 31 + i))
+         return false;
+   }
+
+   return true;
+}
+
+class vk_pipeline_cache_test : public vk_device_test {
+protected:
+   vk_pipeline_cache_test()
+   {
+      physical->pipeline_cache_import_ops = test_import_ops;
+   }
+
+   struct vk_pipeline_cache *
+   create_cache(const VkPipelineCacheCreateInfo *create_info = NULL)
+   {
+      struct vk_pipeline_cache_create_info info = {};
+      info.pCreateInfo = create_info;
+      info.force_enable = true;
+      info.skip_disk_cache = true;
+
+      return vk_pipeline_cache_create(device, &info, NULL);
+   }
+
+   void
+   add_raw_data(struct vk_pipeline_cache *cache, uint32_t key)
+   {
+      struct vk_raw_data_cache_object *data_obj =
+         vk_raw_data_cache_object_create(device, &key, sizeof(key),
+                                         &key, sizeof(key));
+      ASSERT_NE(data_obj, nullptr);
+
+      vk_pipeline_cache_object_unref(device,
+         vk_pipeline_cache_add_object(cache, &data_obj->base));
+   }
+
+   /* Serializes a cache of test objects of entry_size bytes. */
+   std::vector<uint8_t>
+   create_initial_data(uint32_t num_entries, size_t entry_size)
+   {
+      struct vk_pipeline_cache *cache = create_cache();
+      std::vector<uint8_t> entry(entry_size);
+
+      for (uint32_t key = 0; key < num_entries; key++) {
+         fill_entry(entry.data(), entry_size, key);
+         struct test_object *obj =
+            test_object_create(device, key, entry.data(), entry_size);
+         vk_pipeline_cache_object_unref(device,
+            vk_pipeline_cache_add_object(cache, &obj->base));
+      }
+
+      std::vector<uint8_t> data = get_data(cache);
+      vk_pipeline_cache_destroy(cache, NULL);
+      return data;
+   }
+
+   std::vector<uint8_t>
+   get_data(struct vk_pipeline_cache *cache)
+   {
+      VkDevice _device = vk_device_to_handle(device);
+      VkPipelineCache _cache = vk_pipeline_cache_to_handle(cache);
+      size_t size;
+
+      EXPECT_EQ(vk_common_GetPipelineCacheData(_device, _cache, &size, NULL),
+                VK_SUCCESS);
+      std::vector<uint8_t> data(size);
+      EXPECT_EQ(vk_common_GetPipelineCacheData(_device, _cache, &size,
+                                               data.data()),
+                VK_SUCCESS);
+      return data;
+   }
+};
+
+TEST_F(vk_pipeline_cache_test, concurrent_lookups)
+{
+   const uint32_t num_keys = 4096;
+   const unsigned num_threads = 8;
+   const unsigned iterations = 10000;
+   struct vk_pipeline_cache *cache = create_cache();
+   ASSERT_NE(cache, nullptr);
+
+   /* Each shard has a cache line of its own. */
+   EXPECT_EQ(alignof(struct vk_pipeline_cache_shard), 64);
+   EXPECT_EQ((uintptr_t)cache->shards % 64, 0);
+
+   /* Start with 3/4 of the keys in the cache, the threads add the rest. */
+   for (uint32_t key = 0; key < num_keys * 3 / 4; key++)
+      add_raw_data(cache, key);
+
+   std::vector<std::thread> threads;
+   unsigned hits[num_threads] = {};
+   bool failed[num_threads] = {};
+
+   for (unsigned t = 0; t < num_threads; t++) {
+      threads.emplace_back([&, t] {
+         unsigned seed = t + 1;
+
+         for (unsigned i = 0; i < iterations; i++) {
+            /* Simple LCG, we only need the keys to be spread out. */
+            seed = seed * 1103515245 + 12345;
+            uint32_t key = (seed >> 8) % num_keys;
+
+            bool cache_hit;
+            struct vk_pipeline_cache_object *object =
+               vk_pipeline_cache_lookup_object(cache, &key, sizeof(key),
+                                               &vk_raw_data_cache_object_ops,
+                                               &cache_hit);
+            if (object == NULL) {
+               struct vk_raw_data_cache_object *data_obj =
+                  vk_raw_data_cache_object_create(device, &key, sizeof(key),
+                                                  &key, sizeof(key));
+               if (data_obj == NULL) {
+                  failed[t] = true;
+                  return;
+               }
+
+               object = vk_pipeline_cache_add_object(cache, &data_obj->base);
+            } else {
+               hits[t]++;
+            }
+
+            const struct vk_raw_data_cache_object *data_obj =
+               container_of(object, struct vk_raw_data_cache_object, base);
+            if (data_obj->data_size != sizeof(key) ||
+                *(const uint32_t *)data_obj->data != key)
+               failed[t] = true;
+
+            vk_pipeline_cache_object_unref(device, object);
+         }
+      });
+   }
+
+   for (unsigned t = 0; t < num_threads; t++) {
+      threads[t].join();
+      EXPECT_FALSE(failed[t]) << "thread " << t;
+      EXPECT_GT(hits[t], 0) << "thread " << t;
+   }
+
+   /* Keys added by several threads at once are only cached once. */
+   const uint32_t count = vk_pipeline_cache_object_count(cache);
+   EXPECT_GE(count, num_keys * 3 / 4);
+   EXPECT_LE(count, num_keys);
+
+   vk_pipeline_cache_destroy(cache, NULL);
+}
+
+TEST_F(vk_pipeline_cache_test, import)
+{
+   const uint32_t num_entries = 2000;
+   const size_t entry_size = 4096;
+   std::vector<uint8_t> data = create_initial_data(num_entries, entry_size);
+
+   VkPipelineCacheCreateInfo create_info = {};
+   create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+   create_info.initialDataSize = data.size();
+   create_info.pInitialData = data.data();
+   struct vk_pipeline_cache *cache = create_cache(&create_info);
+   ASSERT_NE(cache, nullptr);
+   EXPECT_EQ(vk_pipeline_cache_object_count(cache), num_entries);
+
+   /* Only look up a part of the entries, like a run typically does. */
+   for (uint32_t key = 0; key < num_entries; key += 4) {
+      bool cache_hit;
+      struct vk_pipeline_cache_object *object =
+         vk_pipeline_cache_lookup_object(cache, &key, sizeof(key),
+                                         &test_object_ops, &cache_hit);
+      ASSERT_NE(object, nullptr) << "key " << key;
+      EXPECT_TRUE(cache_hit);
+      EXPECT_TRUE(check_entry(container_of(object, struct test_object, base),
+                              entry_size, key)) << "key " << key;
+      vk_pipeline_cache_object_unref(device, object);
+   }
+
+   /* Entries which were never looked up are serialized back as they were
+    * imported.
+    */
+   std::vector<uint8_t> out = get_data(cache);
+   EXPECT_EQ(out.size(), data.size());
+   vk_pipeline_cache_destroy(cache, NULL);
+
+   create_info.initialDataSize = out.size();
+   create_info.pInitialData = out.data();
+   cache = create_cache(&create_info);
+   ASSERT_NE(cache, nullptr);
+   EXPECT_EQ(vk_pipeline_cache_object_count(cache), num_entries);
+
+   for (uint32_t key = 0; key < num_entries; key++) {
+      bool cache_hit;
+      struct vk_pipeline_cache_object *object =
+         vk_pipeline_cache_lookup_object(cache, &key, sizeof(key),
+                                         &test_object_ops, &cache_hit);
+      ASSERT_NE(object, nullptr) << "key " << key;
+      EXPECT_TRUE(check_entry(container_of(object, struct test_object, base),
+                              entry_size, key)) << "key " << key;
+      vk_pipeline_cache_object_unref(device, object);
+   }
+
+   vk_pipeline_cache_destroy(cache, NULL);
+}
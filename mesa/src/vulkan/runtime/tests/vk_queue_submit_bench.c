@@ -0,0 +1,122 @@
+/*
+ * Copyright 2025 Mesa3D authors
+ * SPDX-License-Identifier: MIT
+ */
+
+
+/*
+ * Submit thread throughput for applications doing many small vkQueueSubmit2
+ * calls per frame.  The driver submit is stubbed out with a busy loop
+ * standing in for the kernel submit ioctl.
+ *
+ * Usage: ./vk_queue_submit_bench [frames] [submits per frame] [submit time in us]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "vk_command_buffer.h"
+#include "vk_command_pool.h"
+#include "vk_common_entrypoints.h"
+#include "vk_queue.h"
+#include "vk_test_device.h"
+
+#include "util/os_time.h"
+
+#define MAX_SUBMITS_PER_FRAME 256
+
+static int64_t driver_submit_ns;
+
+static VkResult
+stub_driver_submit(struct vk_queue *queue, struct vk_queue_submit *submit)
+{
+   const int64_t end = os_time_get_nano() + driver_submit_ns;
+   while (os_time_get_nano() < end);
+
+   return VK_SUCCESS;
+}
+
+/* Like vk_queue_drain(), which is what vkQueueWaitIdle() does first */
+static void
+wait_for_submits(struct vk_queue *queue)
+{
+   mtx_lock(&queue->submit.mutex);
+   while (!list_is_empty(&queue->submit.submits))
+      cnd_wait(&queue->submit.pop, &queue->submit.mutex);
+   mtx_unlock(&queue->submit.mutex);
+}
+
+int
+main(int argc, char **argv)
+{
+   unsigned frames = argc > 1 ? atoi(argv[1]) : 1000;
+   unsigned submits = argc > 2 ? atoi(argv[2]) : 32;
+   driver_submit_ns = (argc > 3 ? atoi(argv[3]) : 20) * 1000ll;
+
+   submits = CLAMP(submits, 1, MAX_SUBMITS_PER_FRAME);
+
+   struct vk_test_device test_device;
+   struct vk_device *device = &test_device.device;
+
+   vk_test_device_init(&test_device);
+   device->timeline_mode = VK_DEVICE_TIMELINE_MODE_NATIVE;
+   device->submit_mode = VK_QUEUE_SUBMIT_MODE_THREADED;
+
+   const VkDeviceQueueCreateInfo queue_info = {
+      .sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
+      .queueCount = 1,
+   };
+   struct vk_queue queue;
+   if (vk_queue_init(&queue, device, &queue_info, 0) != VK_SUCCESS)
+      return 1;
+   queue.driver_submit = stub_driver_submit;
+
+   struct vk_command_pool pool = {
+      .queue_family_index = 0,
+   };
+   struct vk_command_buffer cmd_buffers[MAX_SUBMITS_PER_FRAME];
+   for (unsigned i = 0; i < submits; i++) {
+      cmd_buffers[i] = (struct vk_command_buffer) {
+         .base.type = VK_OBJECT_TYPE_COMMAND_BUFFER,
+         .base.device = device,
+         .pool = &pool,
+         .state = MESA_VK_COMMAND_BUFFER_STATE_EXECUTABLE,
+      };
+   }
+
+   int64_t frame_ns = 0;
+   for (unsigned f = 0; f < frames; f++) {
+      const int64_t start = os_time_get_nano();
+      for (unsigned i = 0; i < submits; i++) {
+         const VkCommandBufferSubmitInfo cmd_buffer_info = {
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO,
+            .commandBuffer = vk_command_buffer_to_handle(&cmd_buffers[i]),
+         };
+         const VkSubmitInfo2 submit_info = {
+            .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2,
+            .commandBufferInfoCount = 1,
+            .pCommandBufferInfos = &cmd_buffer_info,
+         };
+         if (vk_common_QueueSubmit2(vk_queue_to_handle(&queue), 1,
+                                    &submit_info, VK_NULL_HANDLE) !=
+             VK_SUCCESS)
+            return 1;
+      }
+      wait_for_submits(&queue);
+      frame_ns += os_time_get_nano() - start;
+   }
+
+   vk_queue_finish(&queue);
+
+   const uint64_t submit_count = queue.submit.stats.submit_count;
+   const uint64_t driver_submit_count = queue.submit.stats.driver_submit_count;
+
+   if (frames) {
+      printf("%u submits/frame: %8.2f us/frame, %6.2f driver submits/frame, "
+             "%8.2f us latency/submit\n", submits, frame_ns / 1000.0 / frames,
+             (double)driver_submit_count / frames,
+             queue.submit.stats.latency_ns / 1000.0 / MAX2(submit_count, 1));
+   }
+
+   return 0;
+}
@@ -0,0 +1,131 @@
+/*
+ * Copyright 2025 Mesa3D authors
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "vk_device_test.h"
+
+#include "vk_command_buffer.h"
+#include "vk_command_pool.h"
+#include "vk_common_entrypoints.h"
+#include "vk_queue.h"
+
+#include "util/os_time.h"
+
+#define NUM_CMD_BUFFERS 32
+
+/* The driver submit takes about as long as a kernel submit ioctl, so that
+ * submits pile up behind it and can be merged.
+ */
+static const int64_t driver_submit_ns = 20000;
+static struct vk_command_buffer *expected_cmd_buffer;
+static bool out_of_order;
+
+static VkResult
+stub_driver_submit(struct vk_queue *queue, struct vk_queue_submit *submit)
+{
+   const int64_t end = os_time_get_nano() + driver_submit_ns;
+   while (os_time_get_nano() < end);
+
+   for (uint32_t i = 0; i < submit->command_buffer_count; i++) {
+      if (submit->command_buffers[i] != expected_cmd_buffer)
+         out_of_order = true;
+      expected_cmd_buffer++;
+   }
+
+   return VK_SUCCESS;
+}
+
+class vk_queue_submit_test : public vk_device_test {
+protected:
+   vk_queue_submit_test()
+   {
+      device->timeline_mode = vk_device::VK_DEVICE_TIMELINE_MODE_NATIVE;
+      device->submit_mode = VK_QUEUE_SUBMIT_MODE_THREADED;
+
+      VkDeviceQueueCreateInfo queue_info = {};
+      queue_info.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+      queue_info.queueCount = 1;
+      EXPECT_EQ(vk_queue_init(&queue, device, &queue_info, 0), VK_SUCCESS);
+      queue.driver_submit = stub_driver_submit;
+
+      pool = {};
+      for (unsigned i = 0; i < NUM_CMD_BUFFERS; i++) {
+         cmd_buffers[i] = {};
+         cmd_buffers[i].base.type = VK_OBJECT_TYPE_COMMAND_BUFFER;
+         cmd_buffers[i].base.device = device;
+         cmd_buffers[i].pool = &pool;
+         cmd_buffers[i].state = MESA_VK_COMMAND_BUFFER_STATE_EXECUTABLE;
+      }
+
+      expected_cmd_buffer = cmd_buffers;
+      out_of_order = false;
+   }
+
+   ~vk_queue_submit_test()
+   {
+      vk_queue_finish(&queue);
+   }
+
+   /* One vkQueueSubmit2 per command buffer, like applications doing many
+    * small submits per frame.
+    */
+   void
+   submit_frame()
+   {
+      for (unsigned i = 0; i < NUM_CMD_BUFFERS; i++) {
+         VkCommandBufferSubmitInfo cmd_buffer_info = {};
+         cmd_buffer_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO;
+         cmd_buffer_info.commandBuffer =
+            vk_command_buffer_to_handle(&cmd_buffers[i]);
+
+         VkSubmitInfo2 submit_info = {};
+         submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2;
+         submit_info.commandBufferInfoCount = 1;
+         submit_info.pCommandBufferInfos = &cmd_buffer_info;
+
+         ASSERT_EQ(vk_common_QueueSubmit2(vk_queue_to_handle(&queue), 1,
+                                          &submit_info, VK_NULL_HANDLE),
+                   VK_SUCCESS);
+      }
+   }
+
+   /* Like vk_queue_drain(), which is what vkQueueWaitIdle() does first */
+   void
+   wait_for_submits()
+   {
+      mtx_lock(&queue.submit.mutex);
+      while (!list_is_empty(&queue.submit.submits))
+         cnd_wait(&queue.submit.pop, &queue.submit.mutex);
+      mtx_unlock(&queue.submit.mutex);
+   }
+
+   struct vk_queue queue;
+   struct vk_command_pool pool;
+   struct vk_command_buffer cmd_buffers[NUM_CMD_BUFFERS];
+};
+
+TEST_F(vk_queue_submit_test, merge_in_order)
+{
+   const unsigned frames = 20;
+
+   for (unsigned f = 0; f < frames; f++) {
+      expected_cmd_buffer = cmd_buffers;
+      submit_frame();
+      wait_for_submits();
+
+      EXPECT_EQ(expected_cmd_buffer, &cmd_buffers[NUM_CMD_BUFFERS])
+         << "frame " << f;
+   }
+   EXPECT_FALSE(out_of_order);
+
+   /* Every submit reached the driver, some of them merged with the
+    * previous ones.
+    */
+   const uint64_t submit_count = queue.submit.stats.submit_count;
+   const uint64_t merged_count = queue.submit.stats.merged_count;
+   const uint64_t driver_submit_count = queue.submit.stats.driver_submit_count;
+   EXPECT_EQ(submit_count, frames * NUM_CMD_BUFFERS);
+   EXPECT_EQ(driver_submit_count + merged_count, submit_count);
+   EXPECT_GT(merged_count, 0);
+}
@@ -0,0 +1,258 @@
+/*
+ * Copyright 2025 Mesa3D authors
+ * SPDX-License-Identifier: MIT
+ */
+
+
+/*
+ * Many CPU threads waiting on an emulated timeline, like frame pacing code
+ * does, while a queue thread installs time points and a GPU thread signals
+ * their binary syncs in order.  The waits time out rather than hang on a
+ * lost wake-up.
+ *
+ * Usage: ./vk_sync_timeline_stress [points] [waiters] [GPU time per point in us]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "vk_sync.h"
+#include "vk_sync_timeline.h"
+#include "vk_test_device.h"
+
+#include "util/cnd_monotonic.h"
+#include "util/os_time.h"
+#include "util/timespec.h"
+#include "util/u_atomic.h"
+
+#define MAX_WAITERS 64
+#define MAX_IN_FLIGHT 16
+
+/* Binary sync standing in for a driver fence, signaled by the GPU thread */
+struct stub_sync {
+   struct vk_sync sync;
+   bool signaled;
+};
+
+static mtx_t stub_mutex;
+static struct u_cnd_monotonic stub_cond;
+static uint32_t stub_wait_count;
+
+static VkResult
+stub_init(struct vk_device *device, struct vk_sync *sync,
+          uint64_t initial_value)
+{
+   container_of(sync, struct stub_sync, sync)->signaled = false;
+   return VK_SUCCESS;
+}
+
+static void
+stub_finish(struct vk_device *device, struct vk_sync *sync)
+{
+}
+
+static VkResult
+stub_signal(struct vk_device *device, struct vk_sync *sync, uint64_t value)
+{
+   mtx_lock(&stub_mutex);
+   container_of(sync, struct stub_sync, sync)->signaled = true;
+   u_cnd_monotonic_broadcast(&stub_cond);
+   mtx_unlock(&stub_mutex);
+   return VK_SUCCESS;
+}
+
+static VkResult
+stub_reset(struct vk_device *device, struct vk_sync *sync)
+{
+   mtx_lock(&stub_mutex);
+   container_of(sync, struct stub_sync, sync)->signaled = false;
+   mtx_unlock(&stub_mutex);
+   return VK_SUCCESS;
+}
+
+static VkResult
+stub_wait(struct vk_device *device, struct vk_sync *sync, uint64_t wait_value,
+          enum vk_sync_wait_flags wait_flags, uint64_t abs_timeout_ns)
+{
+   struct stub_sync *stub = container_of(sync, struct stub_sync, sync);
+   struct timespec abs_timeout_ts;
+   VkResult result = VK_SUCCESS;
+
+   timespec_from_nsec(&abs_timeout_ts, abs_timeout_ns);
+
+   mtx_lock(&stub_mutex);
+   if (!stub->signaled && abs_timeout_ns > os_time_get_nano())
+      p_atomic_inc(&stub_wait_count);
+   while (!stub->signaled) {
+      if (u_cnd_monotonic_timedwait(&stub_cond, &stub_mutex,
+                                    &abs_timeout_ts) == thrd_timedout) {
+         result = VK_TIMEOUT;
+         break;
+      }
+   }
+   mtx_unlock(&stub_mutex);
+
+   return result;
+}
+
+static const struct vk_sync_type stub_sync_type = {
+   .size = sizeof(struct stub_sync),
+   .features = VK_SYNC_FEATURE_BINARY |
+               VK_SYNC_FEATURE_GPU_WAIT |
+               VK_SYNC_FEATURE_GPU_MULTI_WAIT |
+               VK_SYNC_FEATURE_CPU_WAIT |
+               VK_SYNC_FEATURE_CPU_RESET |
+               VK_SYNC_FEATURE_CPU_SIGNAL,
+   .init = stub_init,
+   .finish = stub_finish,
+   .signal = stub_signal,
+   .reset = stub_reset,
+   .wait = stub_wait,
+};
+
+static struct vk_test_device test_device;
+static struct vk_device *device = &test_device.device;
+static struct vk_sync *timeline_sync;
+static unsigned point_count;
+static int64_t gpu_ns;
+
+/* Points submitted to the GPU thread, in order */
+static mtx_t gpu_mutex;
+static cnd_t gpu_cond;
+static struct vk_sync_timeline_point *gpu_points[MAX_IN_FLIGHT];
+static unsigned gpu_head, gpu_tail;
+
+static uint32_t failed;
+static uint32_t wait_count;
+
+static int
+queue_thread(void *data)
+{
+   struct vk_sync_timeline *timeline = vk_sync_as_timeline(timeline_sync);
+
+   for (uint64_t value = 1; value <= point_count; value++) {
+      struct vk_sync_timeline_point *point;
+      if (vk_sync_timeline_alloc_point(device, timeline, value,
+                                       &point) != VK_SUCCESS) {
+         p_atomic_set(&failed, true);
+         return 1;
+      }
+
+      mtx_lock(&gpu_mutex);
+      while (gpu_tail - gpu_head == MAX_IN_FLIGHT)
+         cnd_wait(&gpu_cond, &gpu_mutex);
+      gpu_points[gpu_tail++ % MAX_IN_FLIGHT] = point;
+      cnd_broadcast(&gpu_cond);
+      mtx_unlock(&gpu_mutex);
+
+      vk_sync_timeline_point_install(device, point);
+   }
+
+   return 0;
+}
+
+static int
+gpu_thread(void *data)
+{
+   for (unsigned i = 0; i < point_count; i++) {
+      mtx_lock(&gpu_mutex);
+      while (gpu_tail == gpu_head)
+         cnd_wait(&gpu_cond, &gpu_mutex);
+      struct vk_sync_timeline_point *point =
+         gpu_points[gpu_head % MAX_IN_FLIGHT];
+      mtx_unlock(&gpu_mutex);
+
+      const int64_t end = os_time_get_nano() + gpu_ns;
+      while (os_time_get_nano() < end);
+
+      stub_signal(device, &point->sync, 0);
+
+      mtx_lock(&gpu_mutex);
+      gpu_head++;
+      cnd_broadcast(&gpu_cond);
+      mtx_unlock(&gpu_mutex);
+   }
+
+   return 0;
+}
+
+static int
+waiter_thread(void *data)
+{
+   unsigned seed = (uintptr_t)data;
+   uint64_t value = 0;
+
+   while (value < point_count && !p_atomic_read(&failed)) {
+      /* Mostly wait for the next few frames, sometimes only for them to be
+       * submitted.
+       */
+      const uint64_t wait_value = MIN2(value + 1 + rand_r(&seed) % 4,
+                                       point_count);
+      const enum vk_sync_wait_flags wait_flags =
+         rand_r(&seed) % 4 == 0 ? VK_SYNC_WAIT_PENDING : VK_SYNC_WAIT_COMPLETE;
+
+      VkResult result =
+         vk_sync_wait(device, timeline_sync, wait_value, wait_flags,
+                      os_time_get_absolute_timeout(10000000000ull));
+      if (result == VK_SUCCESS)
+         result = vk_sync_get_value(device, timeline_sync, &value);
+
+      if (result != VK_SUCCESS) {
+         fprintf(stderr, "wait for %"PRIu64" failed: %d\n",
+                 wait_value, result);
+         p_atomic_set(&failed, true);
+         return 1;
+      }
+
+      p_atomic_inc(&wait_count);
+   }
+
+   return 0;
+}
+
+int
+main(int argc, char **argv)
+{
+   point_count = argc > 1 ? atoi(argv[1]) : 100000;
+   unsigned waiter_count = argc > 2 ? atoi(argv[2]) : 16;
+   gpu_ns = (argc > 3 ? atoi(argv[3]) : 10) * 1000ll;
+
+   waiter_count = CLAMP(waiter_count, 1, MAX_WAITERS);
+
+   vk_test_device_init(&test_device);
+
+   mtx_init(&stub_mutex, mtx_plain);
+   u_cnd_monotonic_init(&stub_cond);
+   mtx_init(&gpu_mutex, mtx_plain);
+   cnd_init(&gpu_cond);
+
+   const struct vk_sync_timeline_type timeline_type =
+      vk_sync_timeline_get_type(&stub_sync_type);
+   if (vk_sync_create(device, &timeline_type.sync, VK_SYNC_IS_TIMELINE, 0,
+                      &timeline_sync) != VK_SUCCESS)
+      return 1;
+
+   const int64_t start = os_time_get_nano();
+
+   thrd_t queue, gpu, waiters[MAX_WAITERS];
+   thrd_create(&queue, queue_thread, NULL);
+   thrd_create(&gpu, gpu_thread, NULL);
+   for (unsigned i = 0; i < waiter_count; i++)
+      thrd_create(&waiters[i], waiter_thread, (void *)(uintptr_t)(i + 1));
+
+   for (unsigned i = 0; i < waiter_count; i++)
+      thrd_join(waiters[i], NULL);
+   thrd_join(gpu, NULL);
+   thrd_join(queue, NULL);
+
+   const int64_t elapsed = os_time_get_nano() - start;
+
+   vk_sync_destroy(device, timeline_sync);
+
+   printf("%u points, %u waiters: %8.2f us/point, %u waits, "
+          "%5.2f binary waits/point\n", point_count, waiter_count,
+          elapsed / 1000.0 / MAX2(point_count, 1), wait_count,
+          (double)stub_wait_count / MAX2(point_count, 1));
+
+   return failed;
+}
@@ -0,0 +1,285 @@
+/*
+ * Copyright 2025 Mesa3D authors
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <thread>
+#include <vector>
+
+#include "vk_device_test.h"
+
+#include "vk_sync.h"
+#include "vk_sync_timeline.h"
+
+#include "util/cnd_monotonic.h"
+#include "util/os_time.h"
+#include "util/timespec.h"
+#include "util/u_atomic.h"
+
+#define MAX_IN_FLIGHT 16
+
+/* Binary sync standing in for a driver fence, signaled by the GPU thread */
+struct stub_sync {
+   struct vk_sync sync;
+   bool signaled;
+};
+
+static mtx_t stub_mutex;
+static struct u_cnd_monotonic stub_cond;
+
+static VkResult
+stub_init(struct vk_device *device, struct vk_sync *sync,
+          uint64_t initial_value)
+{
+   container_of(sync, struct stub_sync, sync)->signaled = false;
+   return VK_SUCCESS;
+}
+
+static void
+stub_finish(struct vk_device *device, struct vk_sync *sync)
+{
+}
+
+static VkResult
+stub_signal(struct vk_device *device, struct vk_sync *sync, uint64_t value)
+{
+   mtx_lock(&stub_mutex);
+   container_of(sync, struct stub_sync, sync)->signaled = true;
+   u_cnd_monotonic_broadcast(&stub_cond);
+   mtx_unlock(&stub_mutex);
+   return VK_SUCCESS;
+}
+
+static VkResult
+stub_reset(struct vk_device *device, struct vk_sync *sync)
+{
+   mtx_lock(&stub_mutex);
+   container_of(sync, struct stub_sync, sync)->signaled = false;
+   mtx_unlock(&stub_mutex);
+   return VK_SUCCESS;
+}
+
+static VkResult
+stub_wait(struct vk_device *device, struct vk_sync *sync, uint64_t wait_value,
+          enum vk_sync_wait_flags wait_flags, uint64_t abs_timeout_ns)
+{
+   struct stub_sync *stub = container_of(sync, struct stub_sync, sync);
+   struct timespec abs_timeout_ts;
+   VkResult result = VK_SUCCESS;
+
+   timespec_from_nsec(&abs_timeout_ts, abs_timeout_ns);
+
+   mtx_lock(&stub_mutex);
+   while (!stub->signaled) {
+      if (u_cnd_monotonic_timedwait(&stub_cond, &stub_mutex,
+                                    &abs_timeout_ts) == thrd_timedout) {
+         result = VK_TIMEOUT;
+         break;
+      }
+   }
+   mtx_unlock(&stub_mutex);
+
+   return result;
+}
+
+class vk_sync_timeline_test : public vk_device_test {
+protected:
+   vk_sync_timeline_test()
+   {
+      stub_sync_type = {};
+      stub_sync_type.size = sizeof(struct stub_sync);
+      stub_sync_type.features = (enum vk_sync_features)
+         (VK_SYNC_FEATURE_BINARY |
+          VK_SYNC_FEATURE_GPU_WAIT |
+          VK_SYNC_FEATURE_GPU_MULTI_WAIT |
+          VK_SYNC_FEATURE_CPU_WAIT |
+          VK_SYNC_FEATURE_CPU_RESET |
+          VK_SYNC_FEATURE_CPU_SIGNAL);
+      stub_sync_type.init = stub_init;
+      stub_sync_type.finish = stub_finish;
+      stub_sync_type.signal = stub_signal;
+      stub_sync_type.reset = stub_reset;
+      stub_sync_type.wait = stub_wait;
+      timeline_type = vk_sync_timeline_get_type(&stub_sync_type);
+
+      mtx_init(&stub_mutex, mtx_plain);
+      u_cnd_monotonic_init(&stub_cond);
+      mtx_init(&gpu_mutex, mtx_plain);
+      cnd_init(&gpu_cond);
+
+      EXPECT_EQ(vk_sync_create(device, &timeline_type.sync,
+                               VK_SYNC_IS_TIMELINE, 0, &timeline_sync),
+                VK_SUCCESS);
+   }
+
+   ~vk_sync_timeline_test()
+   {
+      vk_sync_destroy(device, timeline_sync);
+
+      cnd_destroy(&gpu_cond);
+      mtx_destroy(&gpu_mutex);
+      u_cnd_monotonic_destroy(&stub_cond);
+      mtx_destroy(&stub_mutex);
+   }
+
+   /* Installs the time points in order, at most MAX_IN_FLIGHT ahead of the
+    * GPU thread.
+    */
+   void
+   queue_thread(uint64_t point_count)
+   {
+      struct vk_sync_timeline *timeline = vk_sync_as_timeline(timeline_sync);
+
+      for (uint64_t value = 1; value <= point_count; value++) {
+         struct vk_sync_timeline_point *point;
+         if (vk_sync_timeline_alloc_point(device, timeline, value,
+                                          &point) != VK_SUCCESS) {
+            p_atomic_set(&failed, true);
+            return;
+         }
+
+         mtx_lock(&gpu_mutex);
+         while (gpu_tail - gpu_head == MAX_IN_FLIGHT)
+            cnd_wait(&gpu_cond, &gpu_mutex);
+         gpu_points[gpu_tail++ % MAX_IN_FLIGHT] = point;
+         cnd_broadcast(&gpu_cond);
+         mtx_unlock(&gpu_mutex);
+
+         vk_sync_timeline_point_install(device, point);
+      }
+   }
+
+   /* Signals the binary syncs of the points in order. */
+   void
+   gpu_thread(uint64_t point_count, int64_t gpu_ns)
+   {
+      for (uint64_t i = 0; i < point_count; i++) {
+         mtx_lock(&gpu_mutex);
+         while (gpu_tail == gpu_head)
+            cnd_wait(&gpu_cond, &gpu_mutex);
+         struct vk_sync_timeline_point *point =
+            gpu_points[gpu_head % MAX_IN_FLIGHT];
+         mtx_unlock(&gpu_mutex);
+
+         const int64_t end = os_time_get_nano() + gpu_ns;
+         while (os_time_get_nano() < end);
+
+         stub_signal(device, &point->sync, 0);
+
+         mtx_lock(&gpu_mutex);
+         gpu_head++;
+         cnd_broadcast(&gpu_cond);
+         mtx_unlock(&gpu_mutex);
+      }
+   }
+
+   /* Waits for the next few values, like frame pacing code does, and
+    * checks the value reached against what was waited for.  The waits time
+    * out to catch lost wake-ups.
+    */
+   void
+   waiter_thread(uint64_t point_count, unsigned seed)
+   {
+      uint64_t value = 0;
+
+      while (value < point_count && !p_atomic_read(&failed)) {
+         /* Simple LCG, mostly wait for the next few points to complete,
+          * sometimes only for them to be submitted.
+          */
+         seed = seed * 1103515245 + 12345;
+         const uint64_t wait_value =
+            MIN2(value + 1 + (seed >> 16) % 4, point_count);
+         const enum vk_sync_wait_flags wait_flags =
+            (seed >> 20) % 4 == 0 ? VK_SYNC_WAIT_PENDING
+                                  : VK_SYNC_WAIT_COMPLETE;
+
+         VkResult result =
+            vk_sync_wait(device, timeline_sync, wait_value, wait_flags,
+                         os_time_get_absolute_timeout(10000000000ull));
+         if (result == VK_SUCCESS)
+            result = vk_sync_get_value(device, timeline_sync, &value);
+
+         if (result != VK_SUCCESS ||
+             (wait_flags == VK_SYNC_WAIT_COMPLETE && value < wait_value)) {
+            ADD_FAILURE() << "wait for " << wait_value << " failed: "
+                          << result << ", value " << value;
+            p_atomic_set(&failed, true);
+            return;
+         }
+
+         p_atomic_inc(&wait_count);
+      }
+   }
+
+   void
+   run(uint64_t point_count, unsigned waiter_count, int64_t gpu_ns)
+   {
+      std::vector<std::thread> waiters;
+
+      std::thread queue(&vk_sync_timeline_test::queue_thread, this,
+                        point_count);
+      std::thread gpu(&vk_sync_timeline_test::gpu_thread, this, point_count,
+                      gpu_ns);
+      for (unsigned i = 0; i < waiter_count; i++) {
+         waiters.emplace_back(&vk_sync_timeline_test::waiter_thread, this,
+                              point_count, i + 1);
+      }
+
+      for (std::thread &waiter : waiters)
+         waiter.join();
+      gpu.join();
+      queue.join();
+   }
+
+   struct vk_sync_type stub_sync_type;
+   struct vk_sync_timeline_type timeline_type;
+   struct vk_sync *timeline_sync;
+
+   /* Points submitted to the GPU thread, in order */
+   mtx_t gpu_mutex;
+   cnd_t gpu_cond;
+   struct vk_sync_timeline_point *gpu_points[MAX_IN_FLIGHT];
+   uint64_t gpu_head = 0, gpu_tail = 0;
+
+   uint32_t failed = false;
+   uint32_t wait_count = 0;
+};
+
+TEST_F(vk_sync_timeline_test, waiters)
+{
+   const uint64_t point_count = 2000;
+
+   run(point_count, 16, 10000);
+   EXPECT_FALSE(failed);
+   EXPECT_GT(wait_count, 0);
+
+   uint64_t value;
+   EXPECT_EQ(vk_sync_get_value(device, timeline_sync, &value), VK_SUCCESS);
+   EXPECT_EQ(value, point_count);
+}
+
+TEST_F(vk_sync_timeline_test, wait_timeout)
+{
+   struct vk_sync_timeline *timeline = vk_sync_as_timeline(timeline_sync);
+   struct vk_sync_timeline_point *point;
+
+   ASSERT_EQ(vk_sync_timeline_alloc_point(device, timeline, 1, &point),
+             VK_SUCCESS);
+   vk_sync_timeline_point_install(device, point);
+
+   /* Submitted but not signaled yet. */
+   EXPECT_EQ(vk_sync_wait(device, timeline_sync, 1, VK_SYNC_WAIT_PENDING,
+                          os_time_get_absolute_timeout(0)),
+             VK_SUCCESS);
+   EXPECT_EQ(vk_sync_wait(device, timeline_sync, 1, VK_SYNC_WAIT_COMPLETE,
+                          os_time_get_absolute_timeout(1000000)),
+             VK_TIMEOUT);
+   EXPECT_EQ(vk_sync_wait(device, timeline_sync, 2, VK_SYNC_WAIT_PENDING,
+                          os_time_get_absolute_timeout(1000000)),
+             VK_TIMEOUT);
+
+   stub_signal(device, &point->sync, 0);
+   EXPECT_EQ(vk_sync_wait(device, timeline_sync, 1, VK_SYNC_WAIT_COMPLETE,
+                          os_time_get_absolute_timeout(1000000000)),
+             VK_SUCCESS);
+}
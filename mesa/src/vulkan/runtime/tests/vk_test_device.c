@@ -0,0 +1,34 @@
+/*
+ * Copyright 2025 Mesa3D authors
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "vk_test_device.h"
+
+#include <string.h>
+
+#include "vk_alloc.h"
+
+static VKAPI_ATTR void VKAPI_CALL
+stub_GetPhysicalDeviceProperties(VkPhysicalDevice physicalDevice,
+                                 VkPhysicalDeviceProperties *pProperties)
+{
+   memset(pProperties, 0, sizeof(*pProperties));
+}
+
+void
+vk_test_device_init(struct vk_test_device *test_device)
+{
+   memset(test_device, 0, sizeof(*test_device));
+
+   struct vk_physical_device *physical = &test_device->physical;
+   physical->base.type = VK_OBJECT_TYPE_PHYSICAL_DEVICE;
+   physical->dispatch_table.GetPhysicalDeviceProperties =
+      stub_GetPhysicalDeviceProperties;
+
+   struct vk_device *device = &test_device->device;
+   device->base.type = VK_OBJECT_TYPE_DEVICE;
+   device->alloc = *vk_default_allocator();
+   device->physical = physical;
+   list_inithead(&device->queues);
+}
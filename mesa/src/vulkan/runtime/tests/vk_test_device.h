@@ -0,0 +1,31 @@
+/*
+ * Copyright 2025 Mesa3D authors
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef VK_TEST_DEVICE_H
+#define VK_TEST_DEVICE_H
+
+#include "vk_device.h"
+#include "vk_physical_device.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* A device without a driver behind it, for the runtime tests and
+ * benchmarks.  The physical device reports zeroed properties, anything else
+ * the runtime calls into has to be filled in by the caller.
+ */
+struct vk_test_device {
+   struct vk_physical_device physical;
+   struct vk_device device;
+};
+
+void vk_test_device_init(struct vk_test_device *test_device);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* VK_TEST_DEVICE_H */
@@ -30,36 +30,6 @@
 #include "vk_pipeline_layout.h"
 #include "vk_util.h"
 
-static inline unsigned
-vk_descriptor_type_update_size(VkDescriptorType type)
-{
-   switch (type) {
-   case VK_DESCRIPTOR_TYPE_INLINE_UNIFORM_BLOCK:
-      unreachable("handled in caller");
-
-   case VK_DESCRIPTOR_TYPE_SAMPLER:
-   case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
-   case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
-   case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
-   case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
-      return sizeof(VkDescriptorImageInfo);
-
-   case VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER:
-   case VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER:
-      return sizeof(VkBufferView);
-
-   case VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR:
-      return sizeof(VkAccelerationStructureKHR);
-
-   case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
-   case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
-   case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC:
-   case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC:
-   default:
-      return sizeof(VkDescriptorBufferInfo);
-   }
-}
-
 static void
 vk_cmd_push_descriptor_set_with_template2_free(
    struct vk_cmd_queue *queue, struct vk_cmd_queue_entry *cmd)
@@ -80,14 +50,6 @@ vk_cmd_push_descriptor_set_with_template2_free(
 
    vk_descriptor_update_template_unref(device, templ);
    vk_pipeline_layout_unref(device, layout);
-
-   if (info->pNext) {
-      VkPipelineLayoutCreateInfo *pnext = (void *)info->pNext;
-
-      vk_free(queue->alloc, (void *)pnext->pSetLayouts);
-      vk_free(queue->alloc, (void *)pnext->pPushConstantRanges);
-      vk_free(queue->alloc, pnext);
-   }
 }
 
 VKAPI_ATTR void VKAPI_CALL
@@ -100,20 +62,18 @@ vk_cmd_enqueue_CmdPushDescriptorSetWithTemplate2(
    struct vk_cmd_queue *queue = &cmd_buffer->cmd_queue;
 
    struct vk_cmd_queue_entry *cmd =
-      vk_zalloc(cmd_buffer->cmd_queue.alloc, sizeof(*cmd), 8,
-                VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
-   if (!cmd)
+      vk_cmd_queue_zalloc(queue, vk_cmd_queue_type_sizes[VK_CMD_PUSH_DESCRIPTOR_SET_WITH_TEMPLATE2]);
+   VkPushDescriptorSetWithTemplateInfoKHR *info =
+      vk_cmd_queue_zalloc(queue, sizeof(VkPushDescriptorSetWithTemplateInfoKHR));
+   if (!cmd || !info) {
+      vk_command_buffer_set_error(cmd_buffer, VK_ERROR_OUT_OF_HOST_MEMORY);
       return;
+   }
 
    cmd->type = VK_CMD_PUSH_DESCRIPTOR_SET_WITH_TEMPLATE2;
    cmd->driver_free_cb = vk_cmd_push_descriptor_set_with_template2_free;
    list_addtail(&cmd->cmd_link, &cmd_buffer->cmd_queue.cmds);
 
-   VkPushDescriptorSetWithTemplateInfoKHR *info =
-      vk_zalloc(cmd_buffer->cmd_queue.alloc,
-                sizeof(VkPushDescriptorSetWithTemplateInfoKHR), 8,
-                VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
-
    cmd->u.push_descriptor_set_with_template2
       .push_descriptor_set_with_template_info = info;
 
@@ -137,48 +97,19 @@ vk_cmd_enqueue_CmdPushDescriptorSetWithTemplate2(
    VK_FROM_HANDLE(vk_pipeline_layout, layout, info->layout);
    vk_pipeline_layout_ref(layout);
 
-   /* What makes this tricky is that the size of pData is implicit. We determine
-    * it by walking the template and determining the ranges read by the driver.
+   /* The size of pData is implicit, the template knows the ranges read by
+    * the driver.
     */
-   size_t data_size = 0;
-   for (unsigned i = 0; i < templ->entry_count; ++i) {
-      struct vk_descriptor_template_entry entry = templ->entries[i];
-      unsigned end = 0;
-
-      /* From the spec:
-       *
-       *    If descriptorType is VK_DESCRIPTOR_TYPE_INLINE_UNIFORM_BLOCK then
-       *    the value of stride is ignored and the stride is assumed to be 1,
-       *    i.e. the descriptor update information for them is always specified
-       *    as a contiguous range.
-       */
-      if (entry.type == VK_DESCRIPTOR_TYPE_INLINE_UNIFORM_BLOCK) {
-         end = entry.offset + entry.array_count;
-      } else if (entry.array_count > 0) {
-         end = entry.offset + ((entry.array_count - 1) * entry.stride) +
-               vk_descriptor_type_update_size(entry.type);
-      }
-
-      data_size = MAX2(data_size, end);
-   }
-
-   uint8_t *out_pData = vk_zalloc(cmd_buffer->cmd_queue.alloc, data_size, 8,
-                                  VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+   uint8_t *out_pData = vk_cmd_queue_zalloc(queue, templ->data_size);
    const uint8_t *pData = pPushDescriptorSetWithTemplateInfo->pData;
+   if (templ->data_size && !out_pData)
+      goto err;
 
-   /* Now walk the template again, copying what we actually need */
-   for (unsigned i = 0; i < templ->entry_count; ++i) {
-      struct vk_descriptor_template_entry entry = templ->entries[i];
-      unsigned size = 0;
+   for (uint32_t i = 0; i < templ->copy_range_count; i++) {
+      const struct vk_descriptor_template_copy_range *range =
+         &templ->copy_ranges[i];
 
-      if (entry.type == VK_DESCRIPTOR_TYPE_INLINE_UNIFORM_BLOCK) {
-         size = entry.array_count;
-      } else if (entry.array_count > 0) {
-         size = ((entry.array_count - 1) * entry.stride) +
-                vk_descriptor_type_update_size(entry.type);
-      }
-
-      memcpy(out_pData + entry.offset, pData + entry.offset, size);
+      memcpy(out_pData + range->offset, pData + range->offset, range->size);
    }
 
    info->pData = out_pData;
@@ -194,8 +125,7 @@ vk_cmd_enqueue_CmdPushDescriptorSetWithTemplate2(
 #if 0
       case VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO:
          info->pNext =
-            vk_zalloc(queue->alloc, sizeof(VkPipelineLayoutCreateInfo), 8,
-                      VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+            vk_cmd_queue_zalloc(queue, sizeof(VkPipelineLayoutCreateInfo));
          if (info->pNext == NULL)
             goto err;
 
@@ -206,10 +136,7 @@ vk_cmd_enqueue_CmdPushDescriptorSetWithTemplate2(
          VkPipelineLayoutCreateInfo *tmp_src2 = (void *)pnext;
 
          if (tmp_src2->pSetLayouts) {
-            tmp_dst2->pSetLayouts = vk_zalloc(
-               queue->alloc,
-               sizeof(*tmp_dst2->pSetLayouts) * tmp_dst2->setLayoutCount, 8,
-               VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+            tmp_dst2->pSetLayouts = vk_cmd_queue_zalloc(queue, sizeof(*tmp_dst2->pSetLayouts) * tmp_dst2->setLayoutCount);
             if (tmp_dst2->pSetLayouts == NULL)
                goto err;
 
@@ -220,10 +147,7 @@ vk_cmd_enqueue_CmdPushDescriptorSetWithTemplate2(
 
          if (tmp_src2->pPushConstantRanges) {
             tmp_dst2->pPushConstantRanges =
-               vk_zalloc(queue->alloc,
-                         sizeof(*tmp_dst2->pPushConstantRanges) *
-                            tmp_dst2->pushConstantRangeCount,
-                         8, VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+               vk_cmd_queue_zalloc(queue, sizeof(*tmp_dst2->pPushConstantRanges) * tmp_dst2->pushConstantRangeCount);
             if (tmp_dst2->pPushConstantRanges == NULL)
                goto err;
 
@@ -243,9 +167,9 @@ vk_cmd_enqueue_CmdPushDescriptorSetWithTemplate2(
    return;
 
 err:
-   if (cmd)
-      vk_cmd_push_descriptor_set_with_template2_free(queue, cmd);
-
+   /* The command is queued already, so the references are dropped when the
+    * queue is reset.
+    */
    vk_command_buffer_set_error(cmd_buffer, VK_ERROR_OUT_OF_HOST_MEMORY);
 }
 
@@ -279,21 +203,20 @@ vk_cmd_enqueue_CmdDrawMultiEXT(VkCommandBuffer commandBuffer,
    VK_FROM_HANDLE(vk_command_buffer, cmd_buffer, commandBuffer);
 
    struct vk_cmd_queue_entry *cmd =
-      vk_zalloc(cmd_buffer->cmd_queue.alloc, sizeof(*cmd), 8,
-                VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+      vk_cmd_queue_zalloc(&cmd_buffer->cmd_queue,
+                          vk_cmd_queue_type_sizes[VK_CMD_DRAW_MULTI_EXT]);
    if (!cmd)
-      return;
+      goto err;
 
    cmd->type = VK_CMD_DRAW_MULTI_EXT;
-   list_addtail(&cmd->cmd_link, &cmd_buffer->cmd_queue.cmds);
 
    cmd->u.draw_multi_ext.draw_count = drawCount;
    if (pVertexInfo) {
       unsigned i = 0;
       cmd->u.draw_multi_ext.vertex_info =
-         vk_zalloc(cmd_buffer->cmd_queue.alloc,
-                   sizeof(*cmd->u.draw_multi_ext.vertex_info) * drawCount, 8,
-                   VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+         vk_cmd_queue_zalloc(&cmd_buffer->cmd_queue, sizeof(*cmd->u.draw_multi_ext.vertex_info) * drawCount);
+      if (!cmd->u.draw_multi_ext.vertex_info)
+         goto err;
 
       vk_foreach_multi_draw(draw, i, pVertexInfo, drawCount, stride) {
          memcpy(&cmd->u.draw_multi_ext.vertex_info[i], draw,
@@ -303,6 +226,13 @@ vk_cmd_enqueue_CmdDrawMultiEXT(VkCommandBuffer commandBuffer,
    cmd->u.draw_multi_ext.instance_count = instanceCount;
    cmd->u.draw_multi_ext.first_instance = firstInstance;
    cmd->u.draw_multi_ext.stride = stride;
+
+   list_addtail(&cmd->cmd_link, &cmd_buffer->cmd_queue.cmds);
+   return;
+
+err:
+   /* The partial copies are released with the queue. */
+   vk_command_buffer_set_error(cmd_buffer, VK_ERROR_OUT_OF_HOST_MEMORY);
 }
 
 VKAPI_ATTR void VKAPI_CALL
@@ -317,22 +247,21 @@ vk_cmd_enqueue_CmdDrawMultiIndexedEXT(VkCommandBuffer commandBuffer,
    VK_FROM_HANDLE(vk_command_buffer, cmd_buffer, commandBuffer);
 
    struct vk_cmd_queue_entry *cmd =
-      vk_zalloc(cmd_buffer->cmd_queue.alloc, sizeof(*cmd), 8,
-                VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+      vk_cmd_queue_zalloc(&cmd_buffer->cmd_queue,
+                          vk_cmd_queue_type_sizes[VK_CMD_DRAW_MULTI_INDEXED_EXT]);
    if (!cmd)
-      return;
+      goto err;
 
    cmd->type = VK_CMD_DRAW_MULTI_INDEXED_EXT;
-   list_addtail(&cmd->cmd_link, &cmd_buffer->cmd_queue.cmds);
 
    cmd->u.draw_multi_indexed_ext.draw_count = drawCount;
 
    if (pIndexInfo) {
       unsigned i = 0;
       cmd->u.draw_multi_indexed_ext.index_info =
-         vk_zalloc(cmd_buffer->cmd_queue.alloc,
-                   sizeof(*cmd->u.draw_multi_indexed_ext.index_info) * drawCount, 8,
-                   VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+         vk_cmd_queue_zalloc(&cmd_buffer->cmd_queue, sizeof(*cmd->u.draw_multi_indexed_ext.index_info) * drawCount);
+      if (!cmd->u.draw_multi_indexed_ext.index_info)
+         goto err;
 
       vk_foreach_multi_draw_indexed(draw, i, pIndexInfo, drawCount, stride) {
          cmd->u.draw_multi_indexed_ext.index_info[i].firstIndex = draw->firstIndex;
@@ -348,13 +277,19 @@ vk_cmd_enqueue_CmdDrawMultiIndexedEXT(VkCommandBuffer commandBuffer,
 
    if (pVertexOffset) {
       cmd->u.draw_multi_indexed_ext.vertex_offset =
-         vk_zalloc(cmd_buffer->cmd_queue.alloc,
-                   sizeof(*cmd->u.draw_multi_indexed_ext.vertex_offset), 8,
-                   VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+         vk_cmd_queue_zalloc(&cmd_buffer->cmd_queue, sizeof(*cmd->u.draw_multi_indexed_ext.vertex_offset));
+      if (!cmd->u.draw_multi_indexed_ext.vertex_offset)
+         goto err;
 
       memcpy(cmd->u.draw_multi_indexed_ext.vertex_offset, pVertexOffset,
              sizeof(*cmd->u.draw_multi_indexed_ext.vertex_offset));
    }
+
+   list_addtail(&cmd->cmd_link, &cmd_buffer->cmd_queue.cmds);
+   return;
+
+err:
+   vk_command_buffer_set_error(cmd_buffer, VK_ERROR_OUT_OF_HOST_MEMORY);
 }
 
 static void
@@ -367,30 +302,6 @@ push_descriptors_set_free(struct vk_cmd_queue *queue,
 
    VK_FROM_HANDLE(vk_pipeline_layout, vk_layout, pds->layout);
    vk_pipeline_layout_unref(cmd_buffer->base.device, vk_layout);
-
-  for (unsigned i = 0; i < pds->descriptor_write_count; i++) {
-    VkWriteDescriptorSet *entry = &pds->descriptor_writes[i];
-    switch (entry->descriptorType) {
-    case VK_DESCRIPTOR_TYPE_SAMPLER:
-    case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
-    case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
-    case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
-    case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
-       vk_free(queue->alloc, (void *)entry->pImageInfo);
-       break;
-    case VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER:
-    case VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER:
-       vk_free(queue->alloc, (void *)entry->pTexelBufferView);
-       break;
-    case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
-    case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
-    case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC:
-    case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC:
-    default:
-       vk_free(queue->alloc, (void *)entry->pBufferInfo);
-       break;
-    }
-  }
 }
 
 VKAPI_ATTR void VKAPI_CALL
@@ -405,8 +316,8 @@ vk_cmd_enqueue_CmdPushDescriptorSet(VkCommandBuffer commandBuffer,
    struct vk_cmd_push_descriptor_set *pds;
 
    struct vk_cmd_queue_entry *cmd =
-      vk_zalloc(cmd_buffer->cmd_queue.alloc, sizeof(*cmd), 8,
-                VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+      vk_cmd_queue_zalloc(&cmd_buffer->cmd_queue,
+                          vk_cmd_queue_type_sizes[VK_CMD_PUSH_DESCRIPTOR_SET]);
    if (!cmd)
       return;
 
@@ -429,9 +340,7 @@ vk_cmd_enqueue_CmdPushDescriptorSet(VkCommandBuffer commandBuffer,
 
    if (pDescriptorWrites) {
       pds->descriptor_writes =
-         vk_zalloc(cmd_buffer->cmd_queue.alloc,
-                   sizeof(*pds->descriptor_writes) * descriptorWriteCount, 8,
-                   VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+         vk_cmd_queue_zalloc(&cmd_buffer->cmd_queue, sizeof(*pds->descriptor_writes) * descriptorWriteCount);
       memcpy(pds->descriptor_writes,
              pDescriptorWrites,
              sizeof(*pds->descriptor_writes) * descriptorWriteCount);
@@ -444,9 +353,7 @@ vk_cmd_enqueue_CmdPushDescriptorSet(VkCommandBuffer commandBuffer,
          case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
          case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
             pds->descriptor_writes[i].pImageInfo =
-               vk_zalloc(cmd_buffer->cmd_queue.alloc,
-                         sizeof(VkDescriptorImageInfo) * pds->descriptor_writes[i].descriptorCount, 8,
-                         VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+               vk_cmd_queue_zalloc(&cmd_buffer->cmd_queue, sizeof(VkDescriptorImageInfo) * pds->descriptor_writes[i].descriptorCount);
             memcpy((VkDescriptorImageInfo *)pds->descriptor_writes[i].pImageInfo,
                    pDescriptorWrites[i].pImageInfo,
                    sizeof(VkDescriptorImageInfo) * pds->descriptor_writes[i].descriptorCount);
@@ -454,9 +361,7 @@ vk_cmd_enqueue_CmdPushDescriptorSet(VkCommandBuffer commandBuffer,
          case VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER:
          case VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER:
             pds->descriptor_writes[i].pTexelBufferView =
-               vk_zalloc(cmd_buffer->cmd_queue.alloc,
-                         sizeof(VkBufferView) * pds->descriptor_writes[i].descriptorCount, 8,
-                         VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+               vk_cmd_queue_zalloc(&cmd_buffer->cmd_queue, sizeof(VkBufferView) * pds->descriptor_writes[i].descriptorCount);
             memcpy((VkBufferView *)pds->descriptor_writes[i].pTexelBufferView,
                    pDescriptorWrites[i].pTexelBufferView,
                    sizeof(VkBufferView) * pds->descriptor_writes[i].descriptorCount);
@@ -467,9 +372,7 @@ vk_cmd_enqueue_CmdPushDescriptorSet(VkCommandBuffer commandBuffer,
          case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC:
          default:
             pds->descriptor_writes[i].pBufferInfo =
-               vk_zalloc(cmd_buffer->cmd_queue.alloc,
-                         sizeof(VkDescriptorBufferInfo) * pds->descriptor_writes[i].descriptorCount, 8,
-                         VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+               vk_cmd_queue_zalloc(&cmd_buffer->cmd_queue, sizeof(VkDescriptorBufferInfo) * pds->descriptor_writes[i].descriptorCount);
             memcpy((VkDescriptorBufferInfo *)pds->descriptor_writes[i].pBufferInfo,
                    pDescriptorWrites[i].pBufferInfo,
                    sizeof(VkDescriptorBufferInfo) * pds->descriptor_writes[i].descriptorCount);
@@ -506,8 +409,8 @@ vk_cmd_enqueue_CmdBindDescriptorSets(VkCommandBuffer commandBuffer,
    VK_FROM_HANDLE(vk_command_buffer, cmd_buffer, commandBuffer);
 
    struct vk_cmd_queue_entry *cmd =
-      vk_zalloc(cmd_buffer->cmd_queue.alloc, sizeof(*cmd), 8,
-                VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+      vk_cmd_queue_zalloc(&cmd_buffer->cmd_queue,
+                          vk_cmd_queue_type_sizes[VK_CMD_BIND_DESCRIPTOR_SETS]);
    if (!cmd)
       return;
 
@@ -527,9 +430,7 @@ vk_cmd_enqueue_CmdBindDescriptorSets(VkCommandBuffer commandBuffer,
    cmd->u.bind_descriptor_sets.descriptor_set_count = descriptorSetCount;
    if (pDescriptorSets) {
       cmd->u.bind_descriptor_sets.descriptor_sets =
-         vk_zalloc(cmd_buffer->cmd_queue.alloc,
-                   sizeof(*cmd->u.bind_descriptor_sets.descriptor_sets) * descriptorSetCount, 8,
-                   VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+         vk_cmd_queue_zalloc(&cmd_buffer->cmd_queue, sizeof(*cmd->u.bind_descriptor_sets.descriptor_sets) * descriptorSetCount);
 
       memcpy(cmd->u.bind_descriptor_sets.descriptor_sets, pDescriptorSets,
              sizeof(*cmd->u.bind_descriptor_sets.descriptor_sets) * descriptorSetCount);
@@ -537,9 +438,7 @@ vk_cmd_enqueue_CmdBindDescriptorSets(VkCommandBuffer commandBuffer,
    cmd->u.bind_descriptor_sets.dynamic_offset_count = dynamicOffsetCount;
    if (pDynamicOffsets) {
       cmd->u.bind_descriptor_sets.dynamic_offsets =
-         vk_zalloc(cmd_buffer->cmd_queue.alloc,
-                   sizeof(*cmd->u.bind_descriptor_sets.dynamic_offsets) * dynamicOffsetCount, 8,
-                   VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+         vk_cmd_queue_zalloc(&cmd_buffer->cmd_queue, sizeof(*cmd->u.bind_descriptor_sets.dynamic_offsets) * dynamicOffsetCount);
 
       memcpy(cmd->u.bind_descriptor_sets.dynamic_offsets, pDynamicOffsets,
              sizeof(*cmd->u.bind_descriptor_sets.dynamic_offsets) * dynamicOffsetCount);
@@ -547,20 +446,6 @@ vk_cmd_enqueue_CmdBindDescriptorSets(VkCommandBuffer commandBuffer,
 }
 
 #ifdef VK_ENABLE_BETA_EXTENSIONS
-static void
-dispatch_graph_amdx_free(struct vk_cmd_queue *queue, struct vk_cmd_queue_entry *cmd)
-{
-   VkDispatchGraphCountInfoAMDX *count_info = cmd->u.dispatch_graph_amdx.count_info;
-   void *infos = (void *)count_info->infos.hostAddress;
-
-   for (uint32_t i = 0; i < count_info->count; i++) {
-      VkDispatchGraphInfoAMDX *info = (void *)((const uint8_t *)infos + i * count_info->stride);
-      vk_free(queue->alloc, (void *)info->payloads.hostAddress);
-   }
-
-   vk_free(queue->alloc, infos);
-}
-
 VKAPI_ATTR void VKAPI_CALL
 vk_cmd_enqueue_CmdDispatchGraphAMDX(VkCommandBuffer commandBuffer, VkDeviceAddress scratch,
                                     VkDeviceSize scratchSize,
@@ -571,24 +456,19 @@ vk_cmd_enqueue_CmdDispatchGraphAMDX(VkCommandBuffer commandBuffer, VkDeviceAddre
    if (vk_command_buffer_has_error(cmd_buffer))
       return;
 
-   VkResult result = VK_SUCCESS;
-   const VkAllocationCallbacks *alloc = cmd_buffer->cmd_queue.alloc;
-
    struct vk_cmd_queue_entry *cmd =
-      vk_zalloc(alloc, sizeof(struct vk_cmd_queue_entry), 8, VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
-   if (!cmd) {
-      result = VK_ERROR_OUT_OF_HOST_MEMORY;
+      vk_cmd_queue_zalloc(&cmd_buffer->cmd_queue,
+                          vk_cmd_queue_type_sizes[VK_CMD_DISPATCH_GRAPH_AMDX]);
+   if (!cmd)
       goto err;
-   }
 
    cmd->type = VK_CMD_DISPATCH_GRAPH_AMDX;
-   cmd->driver_free_cb = dispatch_graph_amdx_free;
 
    cmd->u.dispatch_graph_amdx.scratch = scratch;
    cmd->u.dispatch_graph_amdx.scratch_size = scratchSize;
 
    cmd->u.dispatch_graph_amdx.count_info =
-      vk_zalloc(alloc, sizeof(VkDispatchGraphCountInfoAMDX), 8, VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+      vk_cmd_queue_zalloc(&cmd_buffer->cmd_queue, sizeof(VkDispatchGraphCountInfoAMDX));
    if (cmd->u.dispatch_graph_amdx.count_info == NULL)
       goto err;
 
@@ -596,7 +476,10 @@ vk_cmd_enqueue_CmdDispatchGraphAMDX(VkCommandBuffer commandBuffer, VkDeviceAddre
           sizeof(VkDispatchGraphCountInfoAMDX));
 
    uint32_t infos_size = pCountInfo->count * pCountInfo->stride;
-   void *infos = vk_zalloc(alloc, infos_size, 8, VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+   void *infos = vk_cmd_queue_zalloc(&cmd_buffer->cmd_queue, infos_size);
+   if (infos_size && !infos)
+      goto err;
+
    cmd->u.dispatch_graph_amdx.count_info->infos.hostAddress = infos;
    memcpy(infos, pCountInfo->infos.hostAddress, infos_size);
 
@@ -604,38 +487,23 @@ vk_cmd_enqueue_CmdDispatchGraphAMDX(VkCommandBuffer commandBuffer, VkDeviceAddre
       VkDispatchGraphInfoAMDX *info = (void *)((const uint8_t *)infos + i * pCountInfo->stride);
 
       uint32_t payloads_size = info->payloadCount * info->payloadStride;
-      void *dst_payload = vk_zalloc(alloc, payloads_size, 8, VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+      void *dst_payload = vk_cmd_queue_zalloc(&cmd_buffer->cmd_queue, payloads_size);
+      if (payloads_size && !dst_payload)
+         goto err;
+
       memcpy(dst_payload, info->payloads.hostAddress, payloads_size);
       info->payloads.hostAddress = dst_payload;
    }
 
    list_addtail(&cmd->cmd_link, &cmd_buffer->cmd_queue.cmds);
-   goto finish;
-err:
-   if (cmd) {
-      vk_free(alloc, cmd);
-      dispatch_graph_amdx_free(&cmd_buffer->cmd_queue, cmd);
-   }
+   return;
 
-finish:
-   if (unlikely(result != VK_SUCCESS))
-      vk_command_buffer_set_error(cmd_buffer, result);
+err:
+   /* The partial copies are released with the queue. */
+   vk_command_buffer_set_error(cmd_buffer, VK_ERROR_OUT_OF_HOST_MEMORY);
 }
 #endif
 
-static void
-vk_cmd_build_acceleration_structures_khr_free(struct vk_cmd_queue *queue,
-                                              struct vk_cmd_queue_entry *cmd)
-{
-   struct vk_cmd_build_acceleration_structures_khr *build =
-      &cmd->u.build_acceleration_structures_khr;
-   
-   for (uint32_t i = 0; i < build->info_count; i++) {
-      vk_free(queue->alloc, (void *)build->infos[i].pGeometries);
-      vk_free(queue->alloc, (void *)build->pp_build_range_infos[i]);
-   }
-}
-
 VKAPI_ATTR void VKAPI_CALL
 vk_cmd_enqueue_CmdBuildAccelerationStructuresKHR(
    VkCommandBuffer commandBuffer, uint32_t infoCount,
@@ -650,21 +518,18 @@ vk_cmd_enqueue_CmdBuildAccelerationStructuresKHR(
    struct vk_cmd_queue *queue = &cmd_buffer->cmd_queue;
 
    struct vk_cmd_queue_entry *cmd =
-      vk_zalloc(queue->alloc, vk_cmd_queue_type_sizes[VK_CMD_BUILD_ACCELERATION_STRUCTURES_KHR], 8,
-                VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+      vk_cmd_queue_zalloc(queue, vk_cmd_queue_type_sizes[VK_CMD_BUILD_ACCELERATION_STRUCTURES_KHR]);
    if (!cmd)
       goto err;
 
    cmd->type = VK_CMD_BUILD_ACCELERATION_STRUCTURES_KHR;
-   cmd->driver_free_cb = vk_cmd_build_acceleration_structures_khr_free;
 
    struct vk_cmd_build_acceleration_structures_khr *build =
       &cmd->u.build_acceleration_structures_khr;
 
    build->info_count = infoCount;
    if (pInfos) {
-      build->infos = vk_zalloc(queue->alloc, sizeof(*build->infos) * infoCount, 8,
-                               VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+      build->infos = vk_cmd_queue_zalloc(queue, sizeof(*build->infos) * infoCount);
       if (!build->infos)
          goto err;
 
@@ -675,7 +540,7 @@ vk_cmd_enqueue_CmdBuildAccelerationStructuresKHR(
          uint32_t geometries_size =
             build->infos[i].geometryCount * sizeof(VkAccelerationStructureGeometryKHR);
          VkAccelerationStructureGeometryKHR *geometries =
-            vk_zalloc(queue->alloc, geometries_size, 8, VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+            vk_cmd_queue_zalloc(queue, geometries_size);
          if (!geometries)
             goto err;
 
@@ -691,8 +556,7 @@ vk_cmd_enqueue_CmdBuildAccelerationStructuresKHR(
    }
    if (ppBuildRangeInfos) {
       build->pp_build_range_infos =
-         vk_zalloc(queue->alloc, sizeof(*build->pp_build_range_infos) * infoCount, 8,
-                   VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+         vk_cmd_queue_zalloc(queue, sizeof(*build->pp_build_range_infos) * infoCount);
       if (!build->pp_build_range_infos)
          goto err;
 
@@ -703,7 +567,7 @@ vk_cmd_enqueue_CmdBuildAccelerationStructuresKHR(
          uint32_t build_range_size =
             build->infos[i].geometryCount * sizeof(VkAccelerationStructureBuildRangeInfoKHR);
          VkAccelerationStructureBuildRangeInfoKHR *p_build_range_infos =
-            vk_zalloc(queue->alloc, build_range_size, 8, VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+            vk_cmd_queue_zalloc(queue, build_range_size);
          if (!p_build_range_infos)
             goto err;
 
@@ -717,9 +581,7 @@ vk_cmd_enqueue_CmdBuildAccelerationStructuresKHR(
    return;
 
 err:
-   if (cmd)
-      vk_cmd_build_acceleration_structures_khr_free(queue, cmd);
-
+   /* The partial copies are released with the queue. */
    vk_command_buffer_set_error(cmd_buffer, VK_ERROR_OUT_OF_HOST_MEMORY);
 }
 
@@ -730,17 +592,18 @@ VKAPI_ATTR void VKAPI_CALL vk_cmd_enqueue_CmdPushConstants2(
    VK_FROM_HANDLE(vk_command_buffer, cmd_buffer, commandBuffer);
    struct vk_cmd_queue *queue = &cmd_buffer->cmd_queue;
 
-   struct vk_cmd_queue_entry *cmd = vk_zalloc(queue->alloc, vk_cmd_queue_type_sizes[VK_CMD_PUSH_CONSTANTS2], 8,
-                                              VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+   struct vk_cmd_queue_entry *cmd = vk_cmd_queue_zalloc(queue, vk_cmd_queue_type_sizes[VK_CMD_PUSH_CONSTANTS2]);
    if (!cmd)
       return;
 
    cmd->type = VK_CMD_PUSH_CONSTANTS2;
 
-   VkPushConstantsInfoKHR *info = vk_zalloc(queue->alloc, sizeof(*info), 8,
-                                            VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
-   void *pValues = vk_zalloc(queue->alloc, pPushConstantsInfo->size, 8,
-                             VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+   VkPushConstantsInfoKHR *info = vk_cmd_queue_zalloc(queue, sizeof(*info));
+   void *pValues = vk_cmd_queue_zalloc(queue, pPushConstantsInfo->size);
+   if (!info || !pValues) {
+      vk_command_buffer_set_error(cmd_buffer, VK_ERROR_OUT_OF_HOST_MEMORY);
+      return;
+   }
 
    memcpy(info, pPushConstantsInfo, sizeof(*info));
    memcpy(pValues, pPushConstantsInfo->pValues, pPushConstantsInfo->size);
@@ -751,28 +614,22 @@ VKAPI_ATTR void VKAPI_CALL vk_cmd_enqueue_CmdPushConstants2(
    list_addtail(&cmd->cmd_link, &cmd_buffer->cmd_queue.cmds);
 }
 
-static void
-vk_free_cmd_push_descriptor_set2(struct vk_cmd_queue *queue,
-                                 struct vk_cmd_queue_entry *cmd)
-{
-   ralloc_free(cmd->driver_data);
-}
-
 VKAPI_ATTR void VKAPI_CALL vk_cmd_enqueue_CmdPushDescriptorSet2(
     VkCommandBuffer                             commandBuffer,
     const VkPushDescriptorSetInfoKHR*           pPushDescriptorSetInfo)
 {
    VK_FROM_HANDLE(vk_command_buffer, cmd_buffer, commandBuffer);
-   struct vk_cmd_queue_entry *cmd = vk_zalloc(cmd_buffer->cmd_queue.alloc, vk_cmd_queue_type_sizes[VK_CMD_PUSH_DESCRIPTOR_SET2], 8,
-                                              VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+   struct vk_cmd_queue *queue = &cmd_buffer->cmd_queue;
+   struct vk_cmd_queue_entry *cmd = vk_cmd_queue_zalloc(queue, vk_cmd_queue_type_sizes[VK_CMD_PUSH_DESCRIPTOR_SET2]);
+   if (!cmd) {
+      vk_command_buffer_set_error(cmd_buffer, VK_ERROR_OUT_OF_HOST_MEMORY);
+      return;
+   }
 
    cmd->type = VK_CMD_PUSH_DESCRIPTOR_SET2;
-   cmd->driver_free_cb = vk_free_cmd_push_descriptor_set2;
 
-   void *ctx = cmd->driver_data = ralloc_context(NULL);
    if (pPushDescriptorSetInfo) {
-      cmd->u.push_descriptor_set2.push_descriptor_set_info = vk_zalloc(cmd_buffer->cmd_queue.alloc, sizeof(VkPushDescriptorSetInfoKHR), 8,
-                                                                           VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+      cmd->u.push_descriptor_set2.push_descriptor_set_info = vk_cmd_queue_zalloc(queue, sizeof(VkPushDescriptorSetInfoKHR));
 
       memcpy((void*)cmd->u.push_descriptor_set2.push_descriptor_set_info, pPushDescriptorSetInfo, sizeof(VkPushDescriptorSetInfoKHR));
       VkPushDescriptorSetInfoKHR *tmp_dst1 = (void *) cmd->u.push_descriptor_set2.push_descriptor_set_info; (void) tmp_dst1;
@@ -783,18 +640,18 @@ VKAPI_ATTR void VKAPI_CALL vk_cmd_enqueue_CmdPushDescriptorSet2(
          switch ((int32_t)pnext->sType) {
          case VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO:
             if (pnext) {
-               tmp_dst1->pNext = rzalloc(ctx, VkPipelineLayoutCreateInfo);
+               tmp_dst1->pNext = vk_cmd_queue_zalloc(queue, sizeof(VkPipelineLayoutCreateInfo));
 
                memcpy((void*)tmp_dst1->pNext, pnext, sizeof(VkPipelineLayoutCreateInfo));
                VkPipelineLayoutCreateInfo *tmp_dst2 = (void *) tmp_dst1->pNext; (void) tmp_dst2;
                VkPipelineLayoutCreateInfo *tmp_src2 = (void *) pnext; (void) tmp_src2;
                if (tmp_src2->pSetLayouts) {
-                  tmp_dst2->pSetLayouts = rzalloc_array_size(ctx, sizeof(*tmp_dst2->pSetLayouts), tmp_dst2->setLayoutCount);
+                  tmp_dst2->pSetLayouts = vk_cmd_queue_zalloc(queue, sizeof(*tmp_dst2->pSetLayouts) * tmp_dst2->setLayoutCount);
 
                   memcpy((void*)tmp_dst2->pSetLayouts, tmp_src2->pSetLayouts, sizeof(*tmp_dst2->pSetLayouts) * tmp_dst2->setLayoutCount);
                }
                if (tmp_src2->pPushConstantRanges) {
-                  tmp_dst2->pPushConstantRanges = rzalloc_array_size(ctx, sizeof(*tmp_dst2->pPushConstantRanges), tmp_dst2->pushConstantRangeCount);
+                  tmp_dst2->pPushConstantRanges = vk_cmd_queue_zalloc(queue, sizeof(*tmp_dst2->pPushConstantRanges) * tmp_dst2->pushConstantRangeCount);
 
                   memcpy((void*)tmp_dst2->pPushConstantRanges, tmp_src2->pPushConstantRanges, sizeof(*tmp_dst2->pPushConstantRanges) * tmp_dst2->pushConstantRangeCount);
                }
@@ -806,8 +663,7 @@ VKAPI_ATTR void VKAPI_CALL vk_cmd_enqueue_CmdPushDescriptorSet2(
          }
       }
       if (tmp_src1->pDescriptorWrites) {
-         tmp_dst1->pDescriptorWrites = vk_zalloc(cmd_buffer->cmd_queue.alloc, sizeof(*tmp_dst1->pDescriptorWrites) * tmp_dst1->descriptorWriteCount, 8,
-                                                 VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+         tmp_dst1->pDescriptorWrites = vk_cmd_queue_zalloc(queue, sizeof(*tmp_dst1->pDescriptorWrites) * tmp_dst1->descriptorWriteCount);
 
          memcpy((void*)tmp_dst1->pDescriptorWrites, tmp_src1->pDescriptorWrites, sizeof(*tmp_dst1->pDescriptorWrites) * tmp_dst1->descriptorWriteCount);
          for (unsigned i = 0; i < tmp_src1->descriptorWriteCount; i++) {
@@ -817,9 +673,9 @@ VKAPI_ATTR void VKAPI_CALL vk_cmd_enqueue_CmdPushDescriptorSet2(
             case VK_DESCRIPTOR_TYPE_INLINE_UNIFORM_BLOCK: {
                const VkWriteDescriptorSetInlineUniformBlock *uniform_data = vk_find_struct_const(write->pNext, WRITE_DESCRIPTOR_SET_INLINE_UNIFORM_BLOCK);
                assert(uniform_data);
-               VkWriteDescriptorSetInlineUniformBlock *dst = rzalloc(ctx, VkWriteDescriptorSetInlineUniformBlock);
+               VkWriteDescriptorSetInlineUniformBlock *dst = vk_cmd_queue_zalloc(queue, sizeof(VkWriteDescriptorSetInlineUniformBlock));
                memcpy((void*)dst, uniform_data, sizeof(*uniform_data));
-               dst->pData = ralloc_size(ctx, uniform_data->dataSize);
+               dst->pData = vk_cmd_queue_zalloc(queue, uniform_data->dataSize);
                memcpy((void*)dst->pData, uniform_data->pData, uniform_data->dataSize);
                dstwrite->pNext = dst;
                break;
@@ -830,7 +686,7 @@ VKAPI_ATTR void VKAPI_CALL vk_cmd_enqueue_CmdPushDescriptorSet2(
             case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
             case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
             case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
-               dstwrite->pImageInfo = rzalloc_array(ctx, VkDescriptorImageInfo, write->descriptorCount);
+               dstwrite->pImageInfo = vk_cmd_queue_zalloc(queue, sizeof(VkDescriptorImageInfo) * write->descriptorCount);
                {
                   VkDescriptorImageInfo *arr = (void*)dstwrite->pImageInfo;
                   typed_memcpy(arr, write->pImageInfo, write->descriptorCount);
@@ -839,7 +695,7 @@ VKAPI_ATTR void VKAPI_CALL vk_cmd_enqueue_CmdPushDescriptorSet2(
 
             case VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER:
             case VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER:
-               dstwrite->pTexelBufferView = rzalloc_array(ctx, VkBufferView, write->descriptorCount);
+               dstwrite->pTexelBufferView = vk_cmd_queue_zalloc(queue, sizeof(VkBufferView) * write->descriptorCount);
                {
                   VkBufferView *arr = (void*)dstwrite->pTexelBufferView;
                   typed_memcpy(arr, write->pTexelBufferView, write->descriptorCount);
@@ -850,7 +706,7 @@ VKAPI_ATTR void VKAPI_CALL vk_cmd_enqueue_CmdPushDescriptorSet2(
             case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC:
             case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
             case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC:
-               dstwrite->pBufferInfo = rzalloc_array(ctx, VkDescriptorBufferInfo, write->descriptorCount);
+               dstwrite->pBufferInfo = vk_cmd_queue_zalloc(queue, sizeof(VkDescriptorBufferInfo) * write->descriptorCount);
                {
                   VkDescriptorBufferInfo *arr = (void*)dstwrite->pBufferInfo;
                   typed_memcpy(arr, write->pBufferInfo, write->descriptorCount);
@@ -863,7 +719,7 @@ VKAPI_ATTR void VKAPI_CALL vk_cmd_enqueue_CmdPushDescriptorSet2(
 
                uint32_t accel_structs_size = sizeof(VkAccelerationStructureKHR) * accel_structs->accelerationStructureCount;
                VkWriteDescriptorSetAccelerationStructureKHR *write_accel_structs =
-                  rzalloc_size(ctx, sizeof(VkWriteDescriptorSetAccelerationStructureKHR) + accel_structs_size);
+                  vk_cmd_queue_zalloc(queue, sizeof(VkWriteDescriptorSetAccelerationStructureKHR) + accel_structs_size);
 
                write_accel_structs->sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET_ACCELERATION_STRUCTURE_KHR;
                write_accel_structs->accelerationStructureCount = accel_structs->accelerationStructureCount;
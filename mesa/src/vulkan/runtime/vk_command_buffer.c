@@ -27,6 +27,8 @@
 #include "vk_common_entrypoints.h"
 #include "vk_device.h"
 
+#include "util/perf/cpu_trace.h"
+
 VkResult
 vk_command_buffer_init(struct vk_command_pool *pool,
                        struct vk_command_buffer *command_buffer,
@@ -44,6 +46,7 @@ vk_command_buffer_init(struct vk_command_pool *pool,
    command_buffer->state = MESA_VK_COMMAND_BUFFER_STATE_INITIAL;
    command_buffer->record_result = VK_SUCCESS;
    vk_cmd_queue_init(&command_buffer->cmd_queue, &pool->alloc);
+   command_buffer->cmd_queue.free_blocks = &pool->free_cmd_queue_blocks;
    vk_meta_object_list_init(&command_buffer->meta_objects);
    util_dynarray_init(&command_buffer->labels, NULL);
    command_buffer->region_begin = true;
@@ -83,6 +86,9 @@ vk_command_buffer_end(struct vk_command_buffer *command_buffer)
 {
    assert(command_buffer->state == MESA_VK_COMMAND_BUFFER_STATE_RECORDING);
 
+   MESA_TRACE_SET_COUNTER("vk_dynamic_state_redundant_sets",
+      command_buffer->dynamic_graphics_state.redundant_set_count);
+
    if (vk_command_buffer_has_error(command_buffer))
       command_buffer->state = MESA_VK_COMMAND_BUFFER_STATE_INVALID;
    else
@@ -79,6 +79,8 @@ vk_command_pool_init(struct vk_device *device,
    for (uint32_t i = 0; i < ARRAY_SIZE(pool->free_command_buffers); i++)
       list_inithead(&pool->free_command_buffers[i]);
 
+   list_inithead(&pool->free_cmd_queue_blocks);
+
    return VK_SUCCESS;
 }
 
@@ -92,6 +94,7 @@ vk_command_pool_finish(struct vk_command_pool *pool)
    assert(list_is_empty(&pool->command_buffers));
 
    destroy_free_command_buffers(pool);
+   vk_cmd_queue_free_blocks(&pool->alloc, &pool->free_cmd_queue_blocks);
 
    vk_object_base_finish(&pool->base);
 }
@@ -261,6 +264,7 @@ vk_command_pool_trim(struct vk_command_pool *pool,
                      VkCommandPoolTrimFlags flags)
 {
    destroy_free_command_buffers(pool);
+   vk_cmd_queue_free_blocks(&pool->alloc, &pool->free_cmd_queue_blocks);
 }
 
 VKAPI_ATTR void VKAPI_CALL
@@ -55,6 +55,13 @@ struct vk_command_pool {
 
    /** List of freed command buffers for trimming. */
    struct list_head free_command_buffers[2];
+
+   /** List of vk_cmd_queue blocks returned by reset command buffers
+    *
+    * Command buffers recording through vk_cmd_queue take their blocks from
+    * here first.  Freed by vk_command_pool_trim() and on destruction.
+    */
+   struct list_head free_cmd_queue_blocks;
 };
 
 VK_DEFINE_NONDISP_HANDLE_CASTS(vk_command_pool, base, VkCommandPool,
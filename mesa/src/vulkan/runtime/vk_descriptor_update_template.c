@@ -29,6 +29,127 @@
 #include "vk_device.h"
 #include "vk_log.h"
 
+#include <stdlib.h>
+
+static size_t
+vk_descriptor_type_update_size(VkDescriptorType type)
+{
+   switch (type) {
+   case VK_DESCRIPTOR_TYPE_INLINE_UNIFORM_BLOCK:
+      unreachable("handled in caller");
+
+   case VK_DESCRIPTOR_TYPE_SAMPLER:
+   case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+   case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
+   case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+   case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
+      return sizeof(VkDescriptorImageInfo);
+
+   case VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER:
+   case VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER:
+      return sizeof(VkBufferView);
+
+   case VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR:
+      return sizeof(VkAccelerationStructureKHR);
+
+   case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+   case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+   case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC:
+   case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC:
+   default:
+      return sizeof(VkDescriptorBufferInfo);
+   }
+}
+
+/* Returns the range of the user provided data read by an entry. */
+static struct vk_descriptor_template_copy_range
+vk_descriptor_template_entry_range(const struct vk_descriptor_template_entry *entry)
+{
+   assert(entry->array_count > 0);
+
+   /* From the spec:
+    *
+    *    If descriptorType is VK_DESCRIPTOR_TYPE_INLINE_UNIFORM_BLOCK then
+    *    the value of stride is ignored and the stride is assumed to be 1,
+    *    i.e. the descriptor update information for them is always specified
+    *    as a contiguous range.
+    */
+   if (entry->type == VK_DESCRIPTOR_TYPE_INLINE_UNIFORM_BLOCK) {
+      return (struct vk_descriptor_template_copy_range) {
+         .offset = entry->offset,
+         .size = entry->array_count,
+      };
+   }
+
+   return (struct vk_descriptor_template_copy_range) {
+      .offset = entry->offset,
+      .size = (entry->array_count - 1) * entry->stride +
+              vk_descriptor_type_update_size(entry->type),
+   };
+}
+
+/* Whether next continues prev, i.e. updates the following array elements
+ * of the same binding from the following data.
+ */
+static bool
+vk_descriptor_template_entries_can_merge(const struct vk_descriptor_template_entry *prev,
+                                         const struct vk_descriptor_template_entry *next)
+{
+   if (next->type != prev->type || next->binding != prev->binding ||
+       next->array_element != prev->array_element + prev->array_count)
+      return false;
+
+   /* For inline uniform blocks, array elements and counts are in bytes. */
+   if (next->type == VK_DESCRIPTOR_TYPE_INLINE_UNIFORM_BLOCK)
+      return next->offset == prev->offset + prev->array_count;
+
+   return next->stride == prev->stride &&
+          next->offset == prev->offset + prev->array_count * prev->stride;
+}
+
+static int
+vk_descriptor_template_copy_range_cmp(const void *_a, const void *_b)
+{
+   const struct vk_descriptor_template_copy_range *a = _a, *b = _b;
+
+   if (a->offset != b->offset)
+      return a->offset < b->offset ? -1 : 1;
+
+   return 0;
+}
+
+static void
+vk_descriptor_update_template_build_copy_ranges(struct vk_descriptor_update_template *template)
+{
+   struct vk_descriptor_template_copy_range *ranges = template->copy_ranges;
+
+   if (template->entry_count == 0)
+      return;
+
+   for (uint32_t i = 0; i < template->entry_count; i++)
+      ranges[i] = vk_descriptor_template_entry_range(&template->entries[i]);
+
+   qsort(ranges, template->entry_count, sizeof(*ranges),
+         vk_descriptor_template_copy_range_cmp);
+
+   uint32_t range_count = 1;
+   for (uint32_t i = 1; i < template->entry_count; i++) {
+      struct vk_descriptor_template_copy_range *last = &ranges[range_count - 1];
+      const size_t last_end = last->offset + last->size;
+
+      if (ranges[i].offset <= last_end) {
+         last->size = MAX2(last_end, ranges[i].offset + ranges[i].size) -
+                      last->offset;
+      } else {
+         ranges[range_count++] = ranges[i];
+      }
+   }
+
+   template->copy_range_count = range_count;
+   template->data_size = ranges[range_count - 1].offset +
+                         ranges[range_count - 1].size;
+}
+
 VKAPI_ATTR VkResult VKAPI_CALL
 vk_common_CreateDescriptorUpdateTemplate(VkDevice _device,
    const VkDescriptorUpdateTemplateCreateInfo *pCreateInfo,
@@ -44,7 +165,12 @@ vk_common_CreateDescriptorUpdateTemplate(VkDevice _device,
          entry_count++;
    }
 
-   size_t size = sizeof(*template) + entry_count * sizeof(template->entries[0]);
+   /* Merging entries only makes the count smaller, so this is enough for
+    * both the entries and the copy ranges.
+    */
+   size_t size = sizeof(*template) +
+                 entry_count * sizeof(template->entries[0]) +
+                 entry_count * sizeof(template->copy_ranges[0]);
 
    /* Because we're reference counting and lifetimes may not be what the
     * client expects, these have to be allocated off the device and not as
@@ -61,12 +187,13 @@ vk_common_CreateDescriptorUpdateTemplate(VkDevice _device,
    template->type = pCreateInfo->templateType;
    template->bind_point = pCreateInfo->pipelineBindPoint;
    template->ref_cnt = 1;
+   template->copy_ranges =
+      (struct vk_descriptor_template_copy_range *)&template->entries[entry_count];
 
    if (template->type == VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET)
       template->set = pCreateInfo->set;
 
    uint32_t entry_idx = 0;
-   template->entry_count = entry_count;
    for (uint32_t i = 0; i < pCreateInfo->descriptorUpdateEntryCount; i++) {
       const VkDescriptorUpdateTemplateEntry *pEntry =
          &pCreateInfo->pDescriptorUpdateEntries[i];
@@ -74,7 +201,7 @@ vk_common_CreateDescriptorUpdateTemplate(VkDevice _device,
       if (pEntry->descriptorCount == 0)
          continue;
 
-      template->entries[entry_idx++] = (struct vk_descriptor_template_entry) {
+      const struct vk_descriptor_template_entry entry = {
          .type = pEntry->descriptorType,
          .binding = pEntry->dstBinding,
          .array_element = pEntry->dstArrayElement,
@@ -82,8 +209,23 @@ vk_common_CreateDescriptorUpdateTemplate(VkDevice _device,
          .offset = pEntry->offset,
          .stride = pEntry->stride,
       };
+
+      /* Only merge with the previous entry, so that the order of the
+       * writes doesn't change.
+       */
+      if (entry_idx > 0 &&
+          vk_descriptor_template_entries_can_merge(&template->entries[entry_idx - 1],
+                                                   &entry)) {
+         template->entries[entry_idx - 1].array_count += entry.array_count;
+         continue;
+      }
+
+      template->entries[entry_idx++] = entry;
    }
-   assert(entry_idx == entry_count);
+   assert(entry_idx <= entry_count);
+   template->entry_count = entry_idx;
+
+   vk_descriptor_update_template_build_copy_ranges(template);
 
    *pDescriptorUpdateTemplate =
       vk_descriptor_update_template_to_handle(template);
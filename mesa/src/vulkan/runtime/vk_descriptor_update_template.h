@@ -55,6 +55,14 @@ struct vk_descriptor_template_entry {
    size_t stride;
 };
 
+struct vk_descriptor_template_copy_range {
+   /** Offset into the user provided data */
+   size_t offset;
+
+   /** Size of the range in bytes */
+   size_t size;
+};
+
 struct vk_descriptor_update_template {
    struct vk_object_base base;
 
@@ -72,9 +80,29 @@ struct vk_descriptor_update_template {
     */
    uint8_t set;
 
-   /** VkDescriptorUpdateTemplateCreateInfo::descriptorUpdateEntryCount */
+   /** Number of entries
+    *
+    * This is at most VkDescriptorUpdateTemplateCreateInfo::
+    * descriptorUpdateEntryCount: entries with no descriptors are dropped
+    * and consecutive entries updating consecutive array elements of the
+    * same binding from evenly strided data are merged.
+    */
    uint32_t entry_count;
 
+   /** Size of the user provided data read by the template */
+   size_t data_size;
+
+   /** Number of ranges in copy_ranges */
+   uint32_t copy_range_count;
+
+   /** Ranges of the user provided data read by the template
+    *
+    * Sorted by offset, with overlapping and adjacent ranges merged, so the
+    * data of a deferred update, like an enqueued push descriptor update,
+    * can be copied with a few memcpy() calls.
+    */
+   struct vk_descriptor_template_copy_range *copy_ranges;
+
    /** Reference count.
     *
     * It is legal to enqueue a push template update to a secondary command
@@ -2061,6 +2061,21 @@ vk_dynamic_graphics_state_fill(struct vk_dynamic_graphics_state *dyn,
    }                                                              \
 } while(0)
 
+/* Wrap a vk_common_CmdSet* entrypoint to count the calls that didn't change
+ * anything. The dirty bits are cleared during the call, so that only the
+ * ones it sets remain, and restored afterwards.
+ */
+#define SET_DYN_BEGIN(dst)                                                \
+   BITSET_DECLARE(__prev_dirty, MESA_VK_DYNAMIC_GRAPHICS_STATE_ENUM_MAX); \
+   BITSET_COPY(__prev_dirty, (dst)->dirty);                               \
+   BITSET_ZERO((dst)->dirty)
+
+#define SET_DYN_END(dst) do {                                \
+   if (BITSET_IS_EMPTY((dst)->dirty))                        \
+      (dst)->redundant_set_count++;                          \
+   BITSET_OR((dst)->dirty, (dst)->dirty, __prev_dirty);      \
+} while(0)
+
 void
 vk_dynamic_graphics_state_copy(struct vk_dynamic_graphics_state *dst,
                                const struct vk_dynamic_graphics_state *src)
@@ -2287,7 +2302,12 @@ vk_common_CmdSetVertexInputEXT(VkCommandBuffer commandBuffer,
 {
    VK_FROM_HANDLE(vk_command_buffer, cmd, commandBuffer);
    struct vk_dynamic_graphics_state *dyn = &cmd->dynamic_graphics_state;
+   SET_DYN_BEGIN(dyn);
 
+   /* Applications commonly set the same vertex input for every draw, so
+    * compare everything like vk_dynamic_graphics_state_copy() does and only
+    * dirty VI if something actually changed.
+    */
    uint32_t bindings_valid = 0;
    for (uint32_t i = 0; i < vertexBindingDescriptionCount; i++) {
       const VkVertexInputBindingDescription2EXT *desc =
@@ -2299,15 +2319,16 @@ vk_common_CmdSetVertexInputEXT(VkCommandBuffer commandBuffer,
 
       const uint32_t b = desc->binding;
       bindings_valid |= BITFIELD_BIT(b);
-      dyn->vi->bindings[b].stride = desc->stride;
-      dyn->vi->bindings[b].input_rate = desc->inputRate;
-      dyn->vi->bindings[b].divisor = desc->divisor;
+      SET_DYN_VALUE(dyn, VI, vi->bindings[b].stride, desc->stride);
+      SET_DYN_VALUE(dyn, VI, vi->bindings[b].input_rate, desc->inputRate);
+      SET_DYN_VALUE(dyn, VI, vi->bindings[b].divisor, desc->divisor);
 
       /* Also set bindings_strides in case a driver is keying off that */
-      dyn->vi_binding_strides[b] = desc->stride;
+      SET_DYN_VALUE(dyn, VI_BINDING_STRIDES, vi_binding_strides[b],
+                    desc->stride);
    }
 
-   dyn->vi->bindings_valid = bindings_valid;
+   SET_DYN_VALUE(dyn, VI, vi->bindings_valid, bindings_valid);
    SET_DYN_VALUE(dyn, VI_BINDINGS_VALID, vi_bindings_valid, bindings_valid);
 
    uint32_t attributes_valid = 0;
@@ -2321,16 +2342,19 @@ vk_common_CmdSetVertexInputEXT(VkCommandBuffer commandBuffer,
 
       const uint32_t a = desc->location;
       attributes_valid |= BITFIELD_BIT(a);
-      dyn->vi->attributes[a].binding = desc->binding;
-      dyn->vi->attributes[a].format = desc->format;
-      dyn->vi->attributes[a].offset = desc->offset;
+      SET_DYN_VALUE(dyn, VI, vi->attributes[a].binding, desc->binding);
+      SET_DYN_VALUE(dyn, VI, vi->attributes[a].format, desc->format);
+      SET_DYN_VALUE(dyn, VI, vi->attributes[a].offset, desc->offset);
    }
-   dyn->vi->attributes_valid = attributes_valid;
+   SET_DYN_VALUE(dyn, VI, vi->attributes_valid, attributes_valid);
 
-   BITSET_SET(dyn->set, MESA_VK_DYNAMIC_VI);
-   BITSET_SET(dyn->set, MESA_VK_DYNAMIC_VI_BINDING_STRIDES);
-   BITSET_SET(dyn->dirty, MESA_VK_DYNAMIC_VI);
-   BITSET_SET(dyn->dirty, MESA_VK_DYNAMIC_VI_BINDING_STRIDES);
+   /* With no bindings at all, the strides are still set. */
+   if (!BITSET_TEST(dyn->set, MESA_VK_DYNAMIC_VI_BINDING_STRIDES)) {
+      BITSET_SET(dyn->set, MESA_VK_DYNAMIC_VI_BINDING_STRIDES);
+      BITSET_SET(dyn->dirty, MESA_VK_DYNAMIC_VI_BINDING_STRIDES);
+   }
+
+   SET_DYN_END(dyn);
 }
 
 void
@@ -2353,9 +2377,12 @@ vk_common_CmdSetPrimitiveTopology(VkCommandBuffer commandBuffer,
 {
    VK_FROM_HANDLE(vk_command_buffer, cmd, commandBuffer);
    struct vk_dynamic_graphics_state *dyn = &cmd->dynamic_graphics_state;
+   SET_DYN_BEGIN(dyn);
 
    SET_DYN_VALUE(dyn, IA_PRIMITIVE_TOPOLOGY,
                  ia.primitive_topology, primitiveTopology);
+
+   SET_DYN_END(dyn);
 }
 
 VKAPI_ATTR void VKAPI_CALL
@@ -2364,9 +2391,12 @@ vk_common_CmdSetPrimitiveRestartEnable(VkCommandBuffer commandBuffer,
 {
    VK_FROM_HANDLE(vk_command_buffer, cmd, commandBuffer);
    struct vk_dynamic_graphics_state *dyn = &cmd->dynamic_graphics_state;
+   SET_DYN_BEGIN(dyn);
 
    SET_DYN_BOOL(dyn, IA_PRIMITIVE_RESTART_ENABLE,
                 ia.primitive_restart_enable, primitiveRestartEnable);
+
+   SET_DYN_END(dyn);
 }
 
 VKAPI_ATTR void VKAPI_CALL
@@ -2375,9 +2405,12 @@ vk_common_CmdSetPatchControlPointsEXT(VkCommandBuffer commandBuffer,
 {
    VK_FROM_HANDLE(vk_command_buffer, cmd, commandBuffer);
    struct vk_dynamic_graphics_state *dyn = &cmd->dynamic_graphics_state;
+   SET_DYN_BEGIN(dyn);
 
    SET_DYN_VALUE(dyn, TS_PATCH_CONTROL_POINTS,
                  ts.patch_control_points, patchControlPoints);
+
+   SET_DYN_END(dyn);
 }
 
 VKAPI_ATTR void VKAPI_CALL
@@ -2386,8 +2419,11 @@ vk_common_CmdSetTessellationDomainOriginEXT(VkCommandBuffer commandBuffer,
 {
    VK_FROM_HANDLE(vk_command_buffer, cmd, commandBuffer);
    struct vk_dynamic_graphics_state *dyn = &cmd->dynamic_graphics_state;
+   SET_DYN_BEGIN(dyn);
 
    SET_DYN_VALUE(dyn, TS_DOMAIN_ORIGIN, ts.domain_origin, domainOrigin);
+
+   SET_DYN_END(dyn);
 }
 
 VKAPI_ATTR void VKAPI_CALL
@@ -2398,9 +2434,12 @@ vk_common_CmdSetViewport(VkCommandBuffer commandBuffer,
 {
    VK_FROM_HANDLE(vk_command_buffer, cmd, commandBuffer);
    struct vk_dynamic_graphics_state *dyn = &cmd->dynamic_graphics_state;
+   SET_DYN_BEGIN(dyn);
 
    SET_DYN_ARRAY(dyn, VP_VIEWPORTS, vp.viewports,
                  firstViewport, viewportCount, pViewports);
+
+   SET_DYN_END(dyn);
 }
 
 VKAPI_ATTR void VKAPI_CALL
@@ -2410,9 +2449,12 @@ vk_common_CmdSetViewportWithCount(VkCommandBuffer commandBuffer,
 {
    VK_FROM_HANDLE(vk_command_buffer, cmd, commandBuffer);
    struct vk_dynamic_graphics_state *dyn = &cmd->dynamic_graphics_state;
+   SET_DYN_BEGIN(dyn);
 
    SET_DYN_VALUE(dyn, VP_VIEWPORT_COUNT, vp.viewport_count, viewportCount);
    SET_DYN_ARRAY(dyn, VP_VIEWPORTS, vp.viewports, 0, viewportCount, pViewports);
+
+   SET_DYN_END(dyn);
 }
 
 VKAPI_ATTR void VKAPI_CALL
@@ -2423,9 +2465,12 @@ vk_common_CmdSetScissor(VkCommandBuffer commandBuffer,
 {
    VK_FROM_HANDLE(vk_command_buffer, cmd, commandBuffer);
    struct vk_dynamic_graphics_state *dyn = &cmd->dynamic_graphics_state;
+   SET_DYN_BEGIN(dyn);
 
    SET_DYN_ARRAY(dyn, VP_SCISSORS, vp.scissors,
                  firstScissor, scissorCount, pScissors);
+
+   SET_DYN_END(dyn);
 }
 
 VKAPI_ATTR void VKAPI_CALL
@@ -2435,9 +2480,12 @@ vk_common_CmdSetScissorWithCount(VkCommandBuffer commandBuffer,
 {
    VK_FROM_HANDLE(vk_command_buffer, cmd, commandBuffer);
    struct vk_dynamic_graphics_state *dyn = &cmd->dynamic_graphics_state;
+   SET_DYN_BEGIN(dyn);
 
    SET_DYN_VALUE(dyn, VP_SCISSOR_COUNT, vp.scissor_count, scissorCount);
    SET_DYN_ARRAY(dyn, VP_SCISSORS, vp.scissors, 0, scissorCount, pScissors);
+
+   SET_DYN_END(dyn);
 }
 
 VKAPI_ATTR void VKAPI_CALL
@@ -2446,9 +2494,12 @@ vk_common_CmdSetDepthClipNegativeOneToOneEXT(VkCommandBuffer commandBuffer,
 {
    VK_FROM_HANDLE(vk_command_buffer, cmd, commandBuffer);
    struct vk_dynamic_graphics_state *dyn = &cmd->dynamic_graphics_state;
+   SET_DYN_BEGIN(dyn);
 
    SET_DYN_BOOL(dyn, VP_DEPTH_CLIP_NEGATIVE_ONE_TO_ONE,
                 vp.depth_clip_negative_one_to_one, negativeOneToOne);
+
+   SET_DYN_END(dyn);
 }
 
 VKAPI_ATTR void VKAPI_CALL
@@ -2459,10 +2510,13 @@ vk_common_CmdSetDiscardRectangleEXT(VkCommandBuffer commandBuffer,
 {
    VK_FROM_HANDLE(vk_command_buffer, cmd, commandBuffer);
    struct vk_dynamic_graphics_state *dyn = &cmd->dynamic_graphics_state;
+   SET_DYN_BEGIN(dyn);
 
    SET_DYN_VALUE(dyn, DR_RECTANGLES, dr.rectangle_count, discardRectangleCount);
    SET_DYN_ARRAY(dyn, DR_RECTANGLES, dr.rectangles, firstDiscardRectangle,
                  discardRectangleCount, pDiscardRectangles);
+
+   SET_DYN_END(dyn);
 }
 
 VKAPI_ATTR void VKAPI_CALL
@@ -2471,9 +2525,12 @@ vk_common_CmdSetRasterizerDiscardEnable(VkCommandBuffer commandBuffer,
 {
    VK_FROM_HANDLE(vk_command_buffer, cmd, commandBuffer);
    struct vk_dynamic_graphics_state *dyn = &cmd->dynamic_graphics_state;
+   SET_DYN_BEGIN(dyn);
 
    SET_DYN_BOOL(dyn, RS_RASTERIZER_DISCARD_ENABLE,
                 rs.rasterizer_discard_enable, rasterizerDiscardEnable);
+
+   SET_DYN_END(dyn);
 }
 
 VKAPI_ATTR void VKAPI_CALL
@@ -2482,9 +2539,12 @@ vk_common_CmdSetDepthClampEnableEXT(VkCommandBuffer commandBuffer,
 {
    VK_FROM_HANDLE(vk_command_buffer, cmd, commandBuffer);
    struct vk_dynamic_graphics_state *dyn = &cmd->dynamic_graphics_state;
+   SET_DYN_BEGIN(dyn);
 
    SET_DYN_BOOL(dyn, RS_DEPTH_CLAMP_ENABLE,
                 rs.depth_clamp_enable, depthClampEnable);
+
+   SET_DYN_END(dyn);
 }
 
 VKAPI_ATTR void VKAPI_CALL
@@ -2493,10 +2553,13 @@ vk_common_CmdSetDepthClipEnableEXT(VkCommandBuffer commandBuffer,
 {
    VK_FROM_HANDLE(vk_command_buffer, cmd, commandBuffer);
    struct vk_dynamic_graphics_state *dyn = &cmd->dynamic_graphics_state;
+   SET_DYN_BEGIN(dyn);
 
    SET_DYN_VALUE(dyn, RS_DEPTH_CLIP_ENABLE, rs.depth_clip_enable,
                  depthClipEnable ? VK_MESA_DEPTH_CLIP_ENABLE_TRUE :
                                    VK_MESA_DEPTH_CLIP_ENABLE_FALSE);
+
+   SET_DYN_END(dyn);
 }
 
 VKAPI_ATTR void VKAPI_CALL
@@ -2505,8 +2568,11 @@ vk_common_CmdSetPolygonModeEXT(VkCommandBuffer commandBuffer,
 {
    VK_FROM_HANDLE(vk_command_buffer, cmd, commandBuffer);
    struct vk_dynamic_graphics_state *dyn = &cmd->dynamic_graphics_state;
+   SET_DYN_BEGIN(dyn);
 
    SET_DYN_VALUE(dyn, RS_POLYGON_MODE, rs.polygon_mode, polygonMode);
+
+   SET_DYN_END(dyn);
 }
 
 VKAPI_ATTR void VKAPI_CALL
@@ -2515,8 +2581,11 @@ vk_common_CmdSetCullMode(VkCommandBuffer commandBuffer,
 {
    VK_FROM_HANDLE(vk_command_buffer, cmd, commandBuffer);
    struct vk_dynamic_graphics_state *dyn = &cmd->dynamic_graphics_state;
+   SET_DYN_BEGIN(dyn);
 
    SET_DYN_VALUE(dyn, RS_CULL_MODE, rs.cull_mode, cullMode);
+
+   SET_DYN_END(dyn);
 }
 
 VKAPI_ATTR void VKAPI_CALL
@@ -2525,8 +2594,11 @@ vk_common_CmdSetFrontFace(VkCommandBuffer commandBuffer,
 {
    VK_FROM_HANDLE(vk_command_buffer, cmd, commandBuffer);
    struct vk_dynamic_graphics_state *dyn = &cmd->dynamic_graphics_state;
+   SET_DYN_BEGIN(dyn);
 
    SET_DYN_VALUE(dyn, RS_FRONT_FACE, rs.front_face, frontFace);
+
+   SET_DYN_END(dyn);
 }
 
 VKAPI_ATTR void VKAPI_CALL
@@ -2536,9 +2608,12 @@ vk_common_CmdSetConservativeRasterizationModeEXT(
 {
    VK_FROM_HANDLE(vk_command_buffer, cmd, commandBuffer);
    struct vk_dynamic_graphics_state *dyn = &cmd->dynamic_graphics_state;
+   SET_DYN_BEGIN(dyn);
 
    SET_DYN_VALUE(dyn, RS_CONSERVATIVE_MODE, rs.conservative_mode,
                  conservativeRasterizationMode);
+
+   SET_DYN_END(dyn);
 }
 
 VKAPI_ATTR void VKAPI_CALL
@@ -2548,10 +2623,13 @@ vk_common_CmdSetExtraPrimitiveOverestimationSizeEXT(
 {
    VK_FROM_HANDLE(vk_command_buffer, cmd, commandBuffer);
    struct vk_dynamic_graphics_state *dyn = &cmd->dynamic_graphics_state;
+   SET_DYN_BEGIN(dyn);
 
    SET_DYN_VALUE(dyn, RS_EXTRA_PRIMITIVE_OVERESTIMATION_SIZE,
                  rs.extra_primitive_overestimation_size,
                  extraPrimitiveOverestimationSize);
+
+   SET_DYN_END(dyn);
 }
 
 VKAPI_ATTR void VKAPI_CALL
@@ -2560,9 +2638,12 @@ vk_common_CmdSetProvokingVertexModeEXT(VkCommandBuffer commandBuffer,
 {
    VK_FROM_HANDLE(vk_command_buffer, cmd, commandBuffer);
    struct vk_dynamic_graphics_state *dyn = &cmd->dynamic_graphics_state;
+   SET_DYN_BEGIN(dyn);
 
    SET_DYN_VALUE(dyn, RS_PROVOKING_VERTEX,
                  rs.provoking_vertex, provokingVertexMode);
+
+   SET_DYN_END(dyn);
 }
 
 VKAPI_ATTR void VKAPI_CALL
@@ -2571,9 +2652,12 @@ vk_common_CmdSetAttachmentFeedbackLoopEnableEXT(VkCommandBuffer commandBuffer,
 {
    VK_FROM_HANDLE(vk_command_buffer, cmd, commandBuffer);
    struct vk_dynamic_graphics_state *dyn = &cmd->dynamic_graphics_state;
+   SET_DYN_BEGIN(dyn);
 
    SET_DYN_VALUE(dyn, ATTACHMENT_FEEDBACK_LOOP_ENABLE,
                  feedback_loops, aspectMask);
+
+   SET_DYN_END(dyn);
 }
 
 VKAPI_ATTR void VKAPI_CALL
@@ -2582,9 +2666,12 @@ vk_common_CmdSetRasterizationStreamEXT(VkCommandBuffer commandBuffer,
 {
    VK_FROM_HANDLE(vk_command_buffer, cmd, commandBuffer);
    struct vk_dynamic_graphics_state *dyn = &cmd->dynamic_graphics_state;
+   SET_DYN_BEGIN(dyn);
 
    SET_DYN_VALUE(dyn, RS_RASTERIZATION_STREAM,
                  rs.rasterization_stream, rasterizationStream);
+
+   SET_DYN_END(dyn);
 }
 
 VKAPI_ATTR void VKAPI_CALL
@@ -2593,9 +2680,12 @@ vk_common_CmdSetDepthBiasEnable(VkCommandBuffer commandBuffer,
 {
    VK_FROM_HANDLE(vk_command_buffer, cmd, commandBuffer);
    struct vk_dynamic_graphics_state *dyn = &cmd->dynamic_graphics_state;
+   SET_DYN_BEGIN(dyn);
 
    SET_DYN_BOOL(dyn, RS_DEPTH_BIAS_ENABLE,
                 rs.depth_bias.enable, depthBiasEnable);
+
+   SET_DYN_END(dyn);
 }
 
 VKAPI_ATTR void VKAPI_CALL
@@ -2623,8 +2713,11 @@ vk_common_CmdSetLineWidth(VkCommandBuffer commandBuffer,
 {
    VK_FROM_HANDLE(vk_command_buffer, cmd, commandBuffer);
    struct vk_dynamic_graphics_state *dyn = &cmd->dynamic_graphics_state;
+   SET_DYN_BEGIN(dyn);
 
    SET_DYN_VALUE(dyn, RS_LINE_WIDTH, rs.line.width, lineWidth);
+
+   SET_DYN_END(dyn);
 }
 
 VKAPI_ATTR void VKAPI_CALL
@@ -2633,8 +2726,11 @@ vk_common_CmdSetLineRasterizationModeEXT(VkCommandBuffer commandBuffer,
 {
    VK_FROM_HANDLE(vk_command_buffer, cmd, commandBuffer);
    struct vk_dynamic_graphics_state *dyn = &cmd->dynamic_graphics_state;
+   SET_DYN_BEGIN(dyn);
 
    SET_DYN_VALUE(dyn, RS_LINE_MODE, rs.line.mode, lineRasterizationMode);
+
+   SET_DYN_END(dyn);
 }
 
 VKAPI_ATTR void VKAPI_CALL
@@ -2643,9 +2739,12 @@ vk_common_CmdSetLineStippleEnableEXT(VkCommandBuffer commandBuffer,
 {
    VK_FROM_HANDLE(vk_command_buffer, cmd, commandBuffer);
    struct vk_dynamic_graphics_state *dyn = &cmd->dynamic_graphics_state;
+   SET_DYN_BEGIN(dyn);
 
    SET_DYN_BOOL(dyn, RS_LINE_STIPPLE_ENABLE,
                 rs.line.stipple.enable, stippledLineEnable);
+
+   SET_DYN_END(dyn);
 }
 
 VKAPI_ATTR void VKAPI_CALL
@@ -2655,11 +2754,14 @@ vk_common_CmdSetLineStippleKHR(VkCommandBuffer commandBuffer,
 {
    VK_FROM_HANDLE(vk_command_buffer, cmd, commandBuffer);
    struct vk_dynamic_graphics_state *dyn = &cmd->dynamic_graphics_state;
+   SET_DYN_BEGIN(dyn);
 
    SET_DYN_VALUE(dyn, RS_LINE_STIPPLE,
                  rs.line.stipple.factor, lineStippleFactor);
    SET_DYN_VALUE(dyn, RS_LINE_STIPPLE,
                  rs.line.stipple.pattern, lineStipplePattern);
+
+   SET_DYN_END(dyn);
 }
 
 VKAPI_ATTR void VKAPI_CALL
@@ -2669,11 +2771,14 @@ vk_common_CmdSetFragmentShadingRateKHR(VkCommandBuffer commandBuffer,
 {
    VK_FROM_HANDLE(vk_command_buffer, cmd, commandBuffer);
    struct vk_dynamic_graphics_state *dyn = &cmd->dynamic_graphics_state;
+   SET_DYN_BEGIN(dyn);
 
    SET_DYN_VALUE(dyn, FSR, fsr.fragment_size.width, pFragmentSize->width);
    SET_DYN_VALUE(dyn, FSR, fsr.fragment_size.height, pFragmentSize->height);
    SET_DYN_VALUE(dyn, FSR, fsr.combiner_ops[0], combinerOps[0]);
    SET_DYN_VALUE(dyn, FSR, fsr.combiner_ops[1], combinerOps[1]);
+
+   SET_DYN_END(dyn);
 }
 
 VKAPI_ATTR void VKAPI_CALL
@@ -2682,11 +2787,14 @@ vk_common_CmdSetRasterizationSamplesEXT(VkCommandBuffer commandBuffer,
 {
    VK_FROM_HANDLE(vk_command_buffer, cmd, commandBuffer);
    struct vk_dynamic_graphics_state *dyn = &cmd->dynamic_graphics_state;
+   SET_DYN_BEGIN(dyn);
 
    assert(rasterizationSamples <= MESA_VK_MAX_SAMPLES);
 
    SET_DYN_VALUE(dyn, MS_RASTERIZATION_SAMPLES,
                  ms.rasterization_samples, rasterizationSamples);
+
+   SET_DYN_END(dyn);
 }
 
 VKAPI_ATTR void VKAPI_CALL
@@ -2696,10 +2804,13 @@ vk_common_CmdSetSampleMaskEXT(VkCommandBuffer commandBuffer,
 {
    VK_FROM_HANDLE(vk_command_buffer, cmd, commandBuffer);
    struct vk_dynamic_graphics_state *dyn = &cmd->dynamic_graphics_state;
+   SET_DYN_BEGIN(dyn);
 
    VkSampleMask sample_mask = *pSampleMask & BITFIELD_MASK(MESA_VK_MAX_SAMPLES);
 
    SET_DYN_VALUE(dyn, MS_SAMPLE_MASK, ms.sample_mask, sample_mask);
+
+   SET_DYN_END(dyn);
 }
 
 VKAPI_ATTR void VKAPI_CALL
@@ -2708,9 +2819,12 @@ vk_common_CmdSetAlphaToCoverageEnableEXT(VkCommandBuffer commandBuffer,
 {
    VK_FROM_HANDLE(vk_command_buffer, cmd, commandBuffer);
    struct vk_dynamic_graphics_state *dyn = &cmd->dynamic_graphics_state;
+   SET_DYN_BEGIN(dyn);
 
    SET_DYN_VALUE(dyn, MS_ALPHA_TO_COVERAGE_ENABLE,
                  ms.alpha_to_coverage_enable, alphaToCoverageEnable);
+
+   SET_DYN_END(dyn);
 }
 
 VKAPI_ATTR void VKAPI_CALL
@@ -2719,9 +2833,12 @@ vk_common_CmdSetAlphaToOneEnableEXT(VkCommandBuffer commandBuffer,
 {
    VK_FROM_HANDLE(vk_command_buffer, cmd, commandBuffer);
    struct vk_dynamic_graphics_state *dyn = &cmd->dynamic_graphics_state;
+   SET_DYN_BEGIN(dyn);
 
    SET_DYN_VALUE(dyn, MS_ALPHA_TO_ONE_ENABLE,
                  ms.alpha_to_one_enable, alphaToOneEnable);
+
+   SET_DYN_END(dyn);
 }
 
 VKAPI_ATTR void VKAPI_CALL
@@ -2730,6 +2847,7 @@ vk_common_CmdSetSampleLocationsEXT(VkCommandBuffer commandBuffer,
 {
    VK_FROM_HANDLE(vk_command_buffer, cmd, commandBuffer);
    struct vk_dynamic_graphics_state *dyn = &cmd->dynamic_graphics_state;
+   SET_DYN_BEGIN(dyn);
 
    SET_DYN_VALUE(dyn, MS_SAMPLE_LOCATIONS,
                  ms.sample_locations->per_pixel,
@@ -2753,6 +2871,8 @@ vk_common_CmdSetSampleLocationsEXT(VkCommandBuffer commandBuffer,
                  ms.sample_locations->locations,
                  0, pSampleLocationsInfo->sampleLocationsCount,
                  pSampleLocationsInfo->pSampleLocations);
+
+   SET_DYN_END(dyn);
 }
 
 VKAPI_ATTR void VKAPI_CALL
@@ -2761,9 +2881,12 @@ vk_common_CmdSetSampleLocationsEnableEXT(VkCommandBuffer commandBuffer,
 {
    VK_FROM_HANDLE(vk_command_buffer, cmd, commandBuffer);
    struct vk_dynamic_graphics_state *dyn = &cmd->dynamic_graphics_state;
+   SET_DYN_BEGIN(dyn);
 
    SET_DYN_BOOL(dyn, MS_SAMPLE_LOCATIONS_ENABLE,
                 ms.sample_locations_enable, sampleLocationsEnable);
+
+   SET_DYN_END(dyn);
 }
 
 VKAPI_ATTR void VKAPI_CALL
@@ -2772,9 +2895,12 @@ vk_common_CmdSetDepthTestEnable(VkCommandBuffer commandBuffer,
 {
    VK_FROM_HANDLE(vk_command_buffer, cmd, commandBuffer);
    struct vk_dynamic_graphics_state *dyn = &cmd->dynamic_graphics_state;
+   SET_DYN_BEGIN(dyn);
 
    SET_DYN_BOOL(dyn, DS_DEPTH_TEST_ENABLE,
                 ds.depth.test_enable, depthTestEnable);
+
+   SET_DYN_END(dyn);
 }
 
 VKAPI_ATTR void VKAPI_CALL
@@ -2783,9 +2909,12 @@ vk_common_CmdSetDepthWriteEnable(VkCommandBuffer commandBuffer,
 {
    VK_FROM_HANDLE(vk_command_buffer, cmd, commandBuffer);
    struct vk_dynamic_graphics_state *dyn = &cmd->dynamic_graphics_state;
+   SET_DYN_BEGIN(dyn);
 
    SET_DYN_BOOL(dyn, DS_DEPTH_WRITE_ENABLE,
                 ds.depth.write_enable, depthWriteEnable);
+
+   SET_DYN_END(dyn);
 }
 
 VKAPI_ATTR void VKAPI_CALL
@@ -2794,9 +2923,12 @@ vk_common_CmdSetDepthCompareOp(VkCommandBuffer commandBuffer,
 {
    VK_FROM_HANDLE(vk_command_buffer, cmd, commandBuffer);
    struct vk_dynamic_graphics_state *dyn = &cmd->dynamic_graphics_state;
+   SET_DYN_BEGIN(dyn);
 
    SET_DYN_VALUE(dyn, DS_DEPTH_COMPARE_OP, ds.depth.compare_op,
                  depthCompareOp);
+
+   SET_DYN_END(dyn);
 }
 
 VKAPI_ATTR void VKAPI_CALL
@@ -2805,9 +2937,12 @@ vk_common_CmdSetDepthBoundsTestEnable(VkCommandBuffer commandBuffer,
 {
    VK_FROM_HANDLE(vk_command_buffer, cmd, commandBuffer);
    struct vk_dynamic_graphics_state *dyn = &cmd->dynamic_graphics_state;
+   SET_DYN_BEGIN(dyn);
 
    SET_DYN_BOOL(dyn, DS_DEPTH_BOUNDS_TEST_ENABLE,
                 ds.depth.bounds_test.enable, depthBoundsTestEnable);
+
+   SET_DYN_END(dyn);
 }
 
 VKAPI_ATTR void VKAPI_CALL
@@ -2817,11 +2952,14 @@ vk_common_CmdSetDepthBounds(VkCommandBuffer commandBuffer,
 {
    VK_FROM_HANDLE(vk_command_buffer, cmd, commandBuffer);
    struct vk_dynamic_graphics_state *dyn = &cmd->dynamic_graphics_state;
+   SET_DYN_BEGIN(dyn);
 
    SET_DYN_VALUE(dyn, DS_DEPTH_BOUNDS_TEST_BOUNDS,
                  ds.depth.bounds_test.min, minDepthBounds);
    SET_DYN_VALUE(dyn, DS_DEPTH_BOUNDS_TEST_BOUNDS,
                  ds.depth.bounds_test.max, maxDepthBounds);
+
+   SET_DYN_END(dyn);
 }
 
 VKAPI_ATTR void VKAPI_CALL
@@ -2830,9 +2968,12 @@ vk_common_CmdSetStencilTestEnable(VkCommandBuffer commandBuffer,
 {
    VK_FROM_HANDLE(vk_command_buffer, cmd, commandBuffer);
    struct vk_dynamic_graphics_state *dyn = &cmd->dynamic_graphics_state;
+   SET_DYN_BEGIN(dyn);
 
    SET_DYN_BOOL(dyn, DS_STENCIL_TEST_ENABLE,
                 ds.stencil.test_enable, stencilTestEnable);
+
+   SET_DYN_END(dyn);
 }
 
 VKAPI_ATTR void VKAPI_CALL
@@ -2845,6 +2986,7 @@ vk_common_CmdSetStencilOp(VkCommandBuffer commandBuffer,
 {
    VK_FROM_HANDLE(vk_command_buffer, cmd, commandBuffer);
    struct vk_dynamic_graphics_state *dyn = &cmd->dynamic_graphics_state;
+   SET_DYN_BEGIN(dyn);
 
    if (faceMask & VK_STENCIL_FACE_FRONT_BIT) {
       SET_DYN_VALUE(dyn, DS_STENCIL_OP, ds.stencil.front.op.fail, failOp);
@@ -2859,6 +3001,8 @@ vk_common_CmdSetStencilOp(VkCommandBuffer commandBuffer,
       SET_DYN_VALUE(dyn, DS_STENCIL_OP, ds.stencil.back.op.depth_fail, depthFailOp);
       SET_DYN_VALUE(dyn, DS_STENCIL_OP, ds.stencil.back.op.compare, compareOp);
    }
+
+   SET_DYN_END(dyn);
 }
 
 VKAPI_ATTR void VKAPI_CALL
@@ -2868,6 +3012,7 @@ vk_common_CmdSetStencilCompareMask(VkCommandBuffer commandBuffer,
 {
    VK_FROM_HANDLE(vk_command_buffer, cmd, commandBuffer);
    struct vk_dynamic_graphics_state *dyn = &cmd->dynamic_graphics_state;
+   SET_DYN_BEGIN(dyn);
 
    /* We assume 8-bit stencil always */
    STATIC_ASSERT(sizeof(dyn->ds.stencil.front.write_mask) == 1);
@@ -2880,6 +3025,8 @@ vk_common_CmdSetStencilCompareMask(VkCommandBuffer commandBuffer,
       SET_DYN_VALUE(dyn, DS_STENCIL_COMPARE_MASK,
                     ds.stencil.back.compare_mask, (uint8_t)compareMask);
    }
+
+   SET_DYN_END(dyn);
 }
 
 VKAPI_ATTR void VKAPI_CALL
@@ -2889,6 +3036,7 @@ vk_common_CmdSetStencilWriteMask(VkCommandBuffer commandBuffer,
 {
    VK_FROM_HANDLE(vk_command_buffer, cmd, commandBuffer);
    struct vk_dynamic_graphics_state *dyn = &cmd->dynamic_graphics_state;
+   SET_DYN_BEGIN(dyn);
 
    /* We assume 8-bit stencil always */
    STATIC_ASSERT(sizeof(dyn->ds.stencil.front.write_mask) == 1);
@@ -2901,6 +3049,8 @@ vk_common_CmdSetStencilWriteMask(VkCommandBuffer commandBuffer,
       SET_DYN_VALUE(dyn, DS_STENCIL_WRITE_MASK,
                     ds.stencil.back.write_mask, (uint8_t)writeMask);
    }
+
+   SET_DYN_END(dyn);
 }
 
 VKAPI_ATTR void VKAPI_CALL
@@ -2910,6 +3060,7 @@ vk_common_CmdSetStencilReference(VkCommandBuffer commandBuffer,
 {
    VK_FROM_HANDLE(vk_command_buffer, cmd, commandBuffer);
    struct vk_dynamic_graphics_state *dyn = &cmd->dynamic_graphics_state;
+   SET_DYN_BEGIN(dyn);
 
    /* We assume 8-bit stencil always */
    STATIC_ASSERT(sizeof(dyn->ds.stencil.front.write_mask) == 1);
@@ -2922,6 +3073,8 @@ vk_common_CmdSetStencilReference(VkCommandBuffer commandBuffer,
       SET_DYN_VALUE(dyn, DS_STENCIL_REFERENCE,
                     ds.stencil.back.reference, (uint8_t)reference);
    }
+
+   SET_DYN_END(dyn);
 }
 
 VKAPI_ATTR void VKAPI_CALL
@@ -2930,8 +3083,11 @@ vk_common_CmdSetLogicOpEnableEXT(VkCommandBuffer commandBuffer,
 {
    VK_FROM_HANDLE(vk_command_buffer, cmd, commandBuffer);
    struct vk_dynamic_graphics_state *dyn = &cmd->dynamic_graphics_state;
+   SET_DYN_BEGIN(dyn);
 
    SET_DYN_BOOL(dyn, CB_LOGIC_OP_ENABLE, cb.logic_op_enable, logicOpEnable);
+
+   SET_DYN_END(dyn);
 }
 
 VKAPI_ATTR void VKAPI_CALL
@@ -2940,8 +3096,11 @@ vk_common_CmdSetLogicOpEXT(VkCommandBuffer commandBuffer,
 {
    VK_FROM_HANDLE(vk_command_buffer, cmd, commandBuffer);
    struct vk_dynamic_graphics_state *dyn = &cmd->dynamic_graphics_state;
+   SET_DYN_BEGIN(dyn);
 
    SET_DYN_VALUE(dyn, CB_LOGIC_OP, cb.logic_op, logicOp);
+
+   SET_DYN_END(dyn);
 }
 
 VKAPI_ATTR void VKAPI_CALL
@@ -2951,6 +3110,7 @@ vk_common_CmdSetColorWriteEnableEXT(VkCommandBuffer commandBuffer,
 {
    VK_FROM_HANDLE(vk_command_buffer, cmd, commandBuffer);
    struct vk_dynamic_graphics_state *dyn = &cmd->dynamic_graphics_state;
+   SET_DYN_BEGIN(dyn);
 
    assert(attachmentCount <= MESA_VK_MAX_COLOR_ATTACHMENTS);
 
@@ -2962,6 +3122,8 @@ vk_common_CmdSetColorWriteEnableEXT(VkCommandBuffer commandBuffer,
 
    SET_DYN_VALUE(dyn, CB_COLOR_WRITE_ENABLES,
                  cb.color_write_enables, color_write_enables);
+
+   SET_DYN_END(dyn);
 }
 
 VKAPI_ATTR void VKAPI_CALL
@@ -2972,6 +3134,7 @@ vk_common_CmdSetColorBlendEnableEXT(VkCommandBuffer commandBuffer,
 {
    VK_FROM_HANDLE(vk_command_buffer, cmd, commandBuffer);
    struct vk_dynamic_graphics_state *dyn = &cmd->dynamic_graphics_state;
+   SET_DYN_BEGIN(dyn);
 
    for (uint32_t i = 0; i < attachmentCount; i++) {
       uint32_t a = firstAttachment + i;
@@ -2980,6 +3143,8 @@ vk_common_CmdSetColorBlendEnableEXT(VkCommandBuffer commandBuffer,
       SET_DYN_BOOL(dyn, CB_BLEND_ENABLES,
                    cb.attachments[a].blend_enable, pColorBlendEnables[i]);
    }
+
+   SET_DYN_END(dyn);
 }
 
 VKAPI_ATTR void VKAPI_CALL
@@ -2990,6 +3155,7 @@ vk_common_CmdSetColorBlendEquationEXT(VkCommandBuffer commandBuffer,
 {
    VK_FROM_HANDLE(vk_command_buffer, cmd, commandBuffer);
    struct vk_dynamic_graphics_state *dyn = &cmd->dynamic_graphics_state;
+   SET_DYN_BEGIN(dyn);
 
    for (uint32_t i = 0; i < attachmentCount; i++) {
       uint32_t a = firstAttachment + i;
@@ -3019,6 +3185,8 @@ vk_common_CmdSetColorBlendEquationEXT(VkCommandBuffer commandBuffer,
                     cb.attachments[a].alpha_blend_op,
                     pColorBlendEquations[i].alphaBlendOp);
    }
+
+   SET_DYN_END(dyn);
 }
 
 VKAPI_ATTR void VKAPI_CALL
@@ -3029,6 +3197,7 @@ vk_common_CmdSetColorWriteMaskEXT(VkCommandBuffer commandBuffer,
 {
    VK_FROM_HANDLE(vk_command_buffer, cmd, commandBuffer);
    struct vk_dynamic_graphics_state *dyn = &cmd->dynamic_graphics_state;
+   SET_DYN_BEGIN(dyn);
 
    for (uint32_t i = 0; i < attachmentCount; i++) {
       uint32_t a = firstAttachment + i;
@@ -3037,6 +3206,8 @@ vk_common_CmdSetColorWriteMaskEXT(VkCommandBuffer commandBuffer,
       SET_DYN_VALUE(dyn, CB_WRITE_MASKS,
                     cb.attachments[a].write_mask, pColorWriteMasks[i]);
    }
+
+   SET_DYN_END(dyn);
 }
 
 VKAPI_ATTR void VKAPI_CALL
@@ -3045,9 +3216,12 @@ vk_common_CmdSetBlendConstants(VkCommandBuffer commandBuffer,
 {
    VK_FROM_HANDLE(vk_command_buffer, cmd, commandBuffer);
    struct vk_dynamic_graphics_state *dyn = &cmd->dynamic_graphics_state;
+   SET_DYN_BEGIN(dyn);
 
    SET_DYN_ARRAY(dyn, CB_BLEND_CONSTANTS, cb.blend_constants,
                  0, 4, blendConstants);
+
+   SET_DYN_END(dyn);
 }
 
 VKAPI_ATTR void VKAPI_CALL
@@ -3083,8 +3257,11 @@ vk_common_CmdSetDiscardRectangleEnableEXT(VkCommandBuffer commandBuffer,
 {
    VK_FROM_HANDLE(vk_command_buffer, cmd, commandBuffer);
    struct vk_dynamic_graphics_state *dyn = &cmd->dynamic_graphics_state;
+   SET_DYN_BEGIN(dyn);
 
    SET_DYN_VALUE(dyn, DR_ENABLE, dr.enable, discardRectangleEnable);
+
+   SET_DYN_END(dyn);
 }
 
 VKAPI_ATTR void VKAPI_CALL
@@ -3093,8 +3270,11 @@ vk_common_CmdSetDiscardRectangleModeEXT(VkCommandBuffer commandBuffer,
 {
    VK_FROM_HANDLE(vk_command_buffer, cmd, commandBuffer);
    struct vk_dynamic_graphics_state *dyn = &cmd->dynamic_graphics_state;
+   SET_DYN_BEGIN(dyn);
 
    SET_DYN_VALUE(dyn, DR_MODE, dr.mode, discardRectangleMode);
+
+   SET_DYN_END(dyn);
 }
 
 VKAPI_ATTR void VKAPI_CALL
@@ -3104,6 +3284,7 @@ vk_common_CmdSetDepthBias2EXT(
 {
    VK_FROM_HANDLE(vk_command_buffer, cmd, commandBuffer);
    struct vk_dynamic_graphics_state *dyn = &cmd->dynamic_graphics_state;
+   SET_DYN_BEGIN(dyn);
 
    SET_DYN_VALUE(dyn, RS_DEPTH_BIAS_FACTORS,
                  rs.depth_bias.constant_factor, pDepthBiasInfo->depthBiasConstantFactor);
@@ -3134,6 +3315,8 @@ vk_common_CmdSetDepthBias2EXT(
       SET_DYN_VALUE(dyn, RS_DEPTH_BIAS_FACTORS,
                     rs.depth_bias.exact, false);
    }
+
+   SET_DYN_END(dyn);
 }
 
 void
@@ -3158,8 +3341,12 @@ vk_common_CmdSetRenderingAttachmentLocationsKHR(
     const VkRenderingAttachmentLocationInfoKHR* pLocationInfo)
 {
    VK_FROM_HANDLE(vk_command_buffer, cmd, commandBuffer);
+   struct vk_dynamic_graphics_state *dyn = &cmd->dynamic_graphics_state;
+   SET_DYN_BEGIN(dyn);
 
    vk_cmd_set_rendering_attachment_locations(cmd, pLocationInfo);
+
+   SET_DYN_END(dyn);
 }
 
 VKAPI_ATTR void VKAPI_CALL
@@ -3169,6 +3356,7 @@ vk_common_CmdSetRenderingInputAttachmentIndicesKHR(
 {
    VK_FROM_HANDLE(vk_command_buffer, cmd, commandBuffer);
    struct vk_dynamic_graphics_state *dyn = &cmd->dynamic_graphics_state;
+   SET_DYN_BEGIN(dyn);
 
    assert(pLocationInfo->colorAttachmentCount <= MESA_VK_MAX_COLOR_ATTACHMENTS);
    for (uint32_t i = 0; i < pLocationInfo->colorAttachmentCount; i++) {
@@ -3192,6 +3380,8 @@ vk_common_CmdSetRenderingInputAttachmentIndicesKHR(
       map_ds_input_attachment_index(pLocationInfo->pStencilInputAttachmentIndex);
    SET_DYN_VALUE(dyn, INPUT_ATTACHMENT_MAP, ial.depth_att, depth_att);
    SET_DYN_VALUE(dyn, INPUT_ATTACHMENT_MAP, ial.stencil_att, stencil_att);
+
+   SET_DYN_END(dyn);
 }
 
 VKAPI_ATTR void VKAPI_CALL
@@ -3201,6 +3391,7 @@ vk_common_CmdSetDepthClampRangeEXT(VkCommandBuffer commandBuffer,
 {
    VK_FROM_HANDLE(vk_command_buffer, cmd, commandBuffer);
    struct vk_dynamic_graphics_state *dyn = &cmd->dynamic_graphics_state;
+   SET_DYN_BEGIN(dyn);
 
    SET_DYN_BOOL(dyn, VP_DEPTH_CLAMP_RANGE, vp.depth_clamp_mode, depthClampMode);
    if (depthClampMode == VK_DEPTH_CLAMP_MODE_USER_DEFINED_RANGE_EXT) {
@@ -3209,6 +3400,8 @@ vk_common_CmdSetDepthClampRangeEXT(VkCommandBuffer commandBuffer,
       SET_DYN_VALUE(dyn, VP_DEPTH_CLAMP_RANGE, vp.depth_clamp_range.maxDepthClamp,
                     pDepthClampRange->maxDepthClamp);
    }
+
+   SET_DYN_END(dyn);
 }
 
 /* These are stubs required by VK_EXT_shader_object */
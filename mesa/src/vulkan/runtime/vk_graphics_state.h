@@ -957,6 +957,14 @@ struct vk_dynamic_graphics_state {
 
    /** For command buffers, which bits of dynamic state have changed */
    BITSET_DECLARE(dirty, MESA_VK_DYNAMIC_GRAPHICS_STATE_ENUM_MAX);
+
+   /** For command buffers, how many vkCmdSet* calls set the state to what
+    * it already was and therefore did not dirty anything.
+    *
+    * This is reset along with the rest of the state and is reported as a
+    * trace counter when the command buffer ends.
+    */
+   uint32_t redundant_set_count;
 };
 
 /***/
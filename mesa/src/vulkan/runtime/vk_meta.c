@@ -27,10 +27,16 @@
 #include "vk_buffer.h"
 #include "vk_command_buffer.h"
 #include "vk_device.h"
+#include "vk_physical_device.h"
 #include "vk_pipeline.h"
+#include "vk_pipeline_cache.h"
 #include "vk_util.h"
 
+#include "util/blob.h"
+#include "util/disk_cache.h"
 #include "util/hash_table.h"
+#include "util/u_atomic.h"
+#include "util/u_thread.h"
 
 #include <string.h>
 
@@ -92,16 +98,203 @@ vk_meta_device_init(struct vk_device *device,
    return VK_SUCCESS;
 }
 
+static bool
+vk_meta_can_build_pipeline(const struct vk_meta_device *meta,
+                           const void *key_data, size_t key_size)
+{
+   enum vk_meta_object_key_type key_type;
+
+   if (key_size < sizeof(key_type))
+      return false;
+
+   memcpy(&key_type, key_data, sizeof(key_type));
+   switch (key_type) {
+   case VK_META_OBJECT_KEY_CLEAR_PIPELINE:
+   case VK_META_OBJECT_KEY_BLIT_PIPELINE:
+   case VK_META_OBJECT_KEY_COPY_BUFFER_PIPELINE:
+   case VK_META_OBJECT_KEY_FILL_BUFFER_PIPELINE:
+      return true;
+   default:
+      return key_type >= VK_META_OBJECT_KEY_DRIVER_OFFSET &&
+             meta->build_pipeline != NULL;
+   }
+}
+
+static VkResult
+vk_meta_build_pipeline(struct vk_device *device,
+                       struct vk_meta_device *meta,
+                       const void *key_data, size_t key_size)
+{
+   switch (*(const enum vk_meta_object_key_type *)key_data) {
+   case VK_META_OBJECT_KEY_CLEAR_PIPELINE:
+      return vk_meta_clear_build_pipeline(device, meta, key_data, key_size);
+   case VK_META_OBJECT_KEY_BLIT_PIPELINE:
+      return vk_meta_blit_build_pipeline(device, meta, key_data, key_size);
+   case VK_META_OBJECT_KEY_COPY_BUFFER_PIPELINE:
+      return vk_meta_copy_buffer_build_pipeline(device, meta,
+                                                key_data, key_size);
+   case VK_META_OBJECT_KEY_FILL_BUFFER_PIPELINE:
+      return vk_meta_fill_buffer_build_pipeline(device, meta,
+                                                key_data, key_size);
+   default:
+      return meta->build_pipeline(device, meta, key_data, key_size);
+   }
+}
+
+static void
+vk_meta_keys_disk_cache_key(struct vk_device *device, cache_key key_out)
+{
+   static const char name[] = "vk_meta pipeline keys";
+
+   disk_cache_compute_key(device->physical->disk_cache, name, sizeof(name),
+                          key_out);
+}
+
+static int
+vk_meta_warm_up_thread(void *_data)
+{
+   struct vk_meta_device *meta = _data;
+   struct vk_device *device = meta->persist.device;
+
+   u_thread_setname("vk_meta warm-up");
+
+   cache_key key;
+   vk_meta_keys_disk_cache_key(device, key);
+
+   size_t size;
+   void *data = disk_cache_get(device->physical->disk_cache, key, &size);
+   if (data == NULL)
+      return 0;
+
+   struct blob_reader blob;
+   blob_reader_init(&blob, data, size);
+
+   const uint32_t count = blob_read_uint32(&blob);
+   uint32_t loaded = 0;
+   for (; loaded < count; loaded++) {
+      if (p_atomic_read(&meta->persist.warm_up_cancel))
+         break;
+
+      const uint32_t key_size = blob_read_uint32(&blob);
+      blob_reader_align(&blob, 8);
+      const void *key_data = blob_read_bytes(&blob, key_size);
+      if (blob.overrun ||
+          !vk_meta_can_build_pipeline(meta, key_data, key_size))
+         break;
+
+      /* Pipelines that fail to build are created again on first use */
+      vk_meta_build_pipeline(device, meta, key_data, key_size);
+   }
+
+   free(data);
+
+   meta->persist.loaded_key_count = loaded;
+
+   return 0;
+}
+
+static void
+vk_meta_store_keys(struct vk_device *device, struct vk_meta_device *meta)
+{
+   struct blob blob;
+   blob_init(&blob);
+
+   const intptr_t count_offset = blob_reserve_uint32(&blob);
+   uint32_t count = 0;
+
+   hash_table_foreach(meta->cache, entry) {
+      const struct cache_key *key = entry->key;
+
+      if (key->obj_type != VK_OBJECT_TYPE_PIPELINE ||
+          !vk_meta_can_build_pipeline(meta, key->key_data, key->key_size))
+         continue;
+
+      blob_write_uint32(&blob, key->key_size);
+      blob_align(&blob, 8);
+      blob_write_bytes(&blob, key->key_data, key->key_size);
+      count++;
+   }
+
+   /* Don't replace the stored keys with a subset of them, which happens if
+    * the device is destroyed before warm-up is done.
+    */
+   if (count > meta->persist.loaded_key_count && !blob.out_of_memory) {
+      blob_overwrite_uint32(&blob, count_offset, count);
+
+      cache_key disk_key;
+      vk_meta_keys_disk_cache_key(device, disk_key);
+      disk_cache_put(device->physical->disk_cache, disk_key,
+                     blob.data, blob.size, NULL);
+   }
+
+   blob_finish(&blob);
+}
+
+void
+vk_meta_device_enable_persistence(struct vk_device *device,
+                                  struct vk_meta_device *meta)
+{
+   assert(!meta->persist.enabled);
+
+   if (device->physical->disk_cache == NULL ||
+       device->disable_internal_cache)
+      return;
+
+   /* Without a pipeline cache, meta pipelines are compiled from scratch on
+    * each run so give them one, backed by the disk cache.
+    */
+   if (meta->pipeline_cache == VK_NULL_HANDLE && device->mem_cache == NULL) {
+      const struct vk_pipeline_cache_create_info info = {
+         .weak_ref = true,
+      };
+      meta->persist.pipeline_cache =
+         vk_pipeline_cache_create(device, &info, NULL);
+      if (meta->persist.pipeline_cache == NULL)
+         return;
+
+      meta->pipeline_cache =
+         vk_pipeline_cache_to_handle(meta->persist.pipeline_cache);
+   }
+
+   meta->persist.enabled = true;
+   meta->persist.device = device;
+}
+
+void
+vk_meta_device_start_warm_up(struct vk_device *device,
+                             struct vk_meta_device *meta)
+{
+   assert(!meta->persist.warm_up_started);
+
+   if (!meta->persist.enabled)
+      return;
+
+   if (u_thread_create(&meta->persist.warm_up_thread,
+                       vk_meta_warm_up_thread, meta) == thrd_success)
+      meta->persist.warm_up_started = true;
+}
+
 void
 vk_meta_device_finish(struct vk_device *device,
                       struct vk_meta_device *meta)
 {
+   if (meta->persist.warm_up_started) {
+      p_atomic_set(&meta->persist.warm_up_cancel, true);
+      thrd_join(meta->persist.warm_up_thread, NULL);
+   }
+
+   if (meta->persist.enabled)
+      vk_meta_store_keys(device, meta);
+
    hash_table_foreach(meta->cache, entry) {
       free((void *)entry->key);
       vk_meta_destroy_object(device, entry->data);
    }
    _mesa_hash_table_destroy(meta->cache, NULL);
    simple_mtx_destroy(&meta->cache_mtx);
+
+   if (meta->persist.pipeline_cache != NULL)
+      vk_pipeline_cache_destroy(meta->persist.pipeline_cache, NULL);
 }
 
 uint64_t
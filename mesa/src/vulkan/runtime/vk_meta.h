@@ -26,6 +26,7 @@
 #include "vk_limits.h"
 #include "vk_object.h"
 
+#include "c11/threads.h"
 #include "util/simple_mtx.h"
 
 #include "compiler/nir/nir.h"
@@ -39,6 +40,7 @@ struct vk_command_buffer;
 struct vk_buffer;
 struct vk_device;
 struct vk_image;
+struct vk_pipeline_cache;
 
 struct vk_meta_rect {
    uint32_t x0, y0, x1, y1;
@@ -135,6 +137,25 @@ struct vk_meta_device {
                            struct vk_meta_device *meta,
                            const struct vk_meta_rect *rect,
                            uint32_t layer_count);
+
+   /* Creates the pipeline for a key of a driver-specific type, so that it
+    * can be persisted and warmed up.  Optional.
+    */
+   VkResult (*build_pipeline)(struct vk_device *device,
+                              struct vk_meta_device *meta,
+                              const void *key_data, size_t key_size);
+
+   struct {
+      bool enabled;
+      bool warm_up_started;
+      uint32_t warm_up_cancel;
+      uint32_t loaded_key_count;
+      thrd_t warm_up_thread;
+      struct vk_device *device;
+
+      /* Created if the device has no pipeline cache for meta pipelines */
+      struct vk_pipeline_cache *pipeline_cache;
+   } persist;
 };
 
 static inline uint32_t
@@ -155,6 +176,27 @@ VkResult vk_meta_device_init(struct vk_device *device,
 void vk_meta_device_finish(struct vk_device *device,
                            struct vk_meta_device *meta);
 
+/** Persists the meta pipelines used by the device across runs
+ *
+ * The keys of the meta pipelines created are stored in the disk cache when
+ * the device is destroyed, and meta pipelines are created through a
+ * pipeline cache backed by the disk cache.
+ *
+ * Must be called once the meta device is fully set up.  Does nothing if
+ * the disk cache is disabled.
+ */
+void vk_meta_device_enable_persistence(struct vk_device *device,
+                                       struct vk_meta_device *meta);
+
+/** Creates the meta pipelines used by previous runs in the background
+ *
+ * The pipelines are built on a thread which may use any part of the
+ * device, so this must be the last step of device creation.  Does nothing
+ * unless persistence is enabled.
+ */
+void vk_meta_device_start_warm_up(struct vk_device *device,
+                                  struct vk_meta_device *meta);
+
 /** Keys should start with one of these to ensure uniqueness */
 enum vk_meta_object_key_type {
    VK_META_OBJECT_KEY_TYPE_INVALID = 0,
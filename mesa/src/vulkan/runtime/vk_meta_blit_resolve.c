@@ -458,6 +458,25 @@ get_blit_pipeline(struct vk_device *device,
    return result;
 }
 
+VkResult
+vk_meta_blit_build_pipeline(struct vk_device *device,
+                            struct vk_meta_device *meta,
+                            const void *key_data, size_t key_size)
+{
+   const struct vk_meta_blit_key *key = key_data;
+
+   if (key_size != sizeof(*key))
+      return VK_ERROR_UNKNOWN;
+
+   VkPipelineLayout layout;
+   VkResult result = get_blit_pipeline_layout(device, meta, &layout);
+   if (unlikely(result != VK_SUCCESS))
+      return result;
+
+   VkPipeline pipeline;
+   return get_blit_pipeline(device, meta, key, layout, &pipeline);
+}
+
 static VkResult
 get_blit_sampler(struct vk_device *device,
                  struct vk_meta_device *meta,
@@ -186,6 +186,26 @@ get_clear_pipeline(struct vk_device *device,
    return result;
 }
 
+VkResult
+vk_meta_clear_build_pipeline(struct vk_device *device,
+                             struct vk_meta_device *meta,
+                             const void *key_data, size_t key_size)
+{
+   const struct vk_meta_clear_key *key = key_data;
+
+   if (key_size != sizeof(*key) ||
+       key->render.color_attachment_count > MESA_VK_MAX_COLOR_ATTACHMENTS)
+      return VK_ERROR_UNKNOWN;
+
+   VkPipelineLayout layout;
+   VkResult result = get_clear_pipeline_layout(device, meta, &layout);
+   if (unlikely(result != VK_SUCCESS))
+      return result;
+
+   VkPipeline pipeline;
+   return get_clear_pipeline(device, meta, key, layout, &pipeline);
+}
+
 static int
 vk_meta_rect_cmp_layer(const void *_a, const void *_b)
 {
@@ -2262,6 +2262,22 @@ get_copy_buffer_pipeline(struct vk_device *device, struct vk_meta_device *meta,
                                     pipeline_out);
 }
 
+VkResult
+vk_meta_copy_buffer_build_pipeline(struct vk_device *device,
+                                   struct vk_meta_device *meta,
+                                   const void *key_data, size_t key_size)
+{
+   const struct vk_meta_copy_buffer_key *key = key_data;
+
+   if (key_size != sizeof(*key) || key->chunk_size > 16 ||
+       !util_is_power_of_two_nonzero(key->chunk_size))
+      return VK_ERROR_UNKNOWN;
+
+   VkPipelineLayout layout;
+   VkPipeline pipeline;
+   return get_copy_buffer_pipeline(device, meta, key, &layout, &pipeline);
+}
+
 static void
 copy_buffer_region(struct vk_command_buffer *cmd, struct vk_meta_device *meta,
                    VkBuffer src, VkBuffer dst, const VkBufferCopy2 *region)
@@ -2440,6 +2456,20 @@ get_fill_buffer_pipeline(struct vk_device *device, struct vk_meta_device *meta,
                                     pipeline_out);
 }
 
+VkResult
+vk_meta_fill_buffer_build_pipeline(struct vk_device *device,
+                                   struct vk_meta_device *meta,
+                                   const void *key_data, size_t key_size)
+{
+   if (key_size != sizeof(struct vk_meta_fill_buffer_key))
+      return VK_ERROR_UNKNOWN;
+
+   VkPipelineLayout layout;
+   VkPipeline pipeline;
+   return get_fill_buffer_pipeline(device, meta, key_data, &layout,
+                                   &pipeline);
+}
+
 void
 vk_meta_fill_buffer(struct vk_command_buffer *cmd, struct vk_meta_device *meta,
                     VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size,
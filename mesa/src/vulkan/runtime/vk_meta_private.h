@@ -42,6 +42,26 @@ vk_meta_draw_rects_vs_nir(struct vk_meta_device *device, bool use_gs);
 struct nir_shader *
 vk_meta_draw_rects_gs_nir(struct vk_meta_device *device);
 
+VkResult
+vk_meta_clear_build_pipeline(struct vk_device *device,
+                             struct vk_meta_device *meta,
+                             const void *key_data, size_t key_size);
+
+VkResult
+vk_meta_blit_build_pipeline(struct vk_device *device,
+                            struct vk_meta_device *meta,
+                            const void *key_data, size_t key_size);
+
+VkResult
+vk_meta_copy_buffer_build_pipeline(struct vk_device *device,
+                                   struct vk_meta_device *meta,
+                                   const void *key_data, size_t key_size);
+
+VkResult
+vk_meta_fill_buffer_build_pipeline(struct vk_device *device,
+                                   struct vk_meta_device *meta,
+                                   const void *key_data, size_t key_size);
+
 static inline void
 vk_meta_rendering_info_copy(struct vk_meta_rendering_info *dst,
                             const struct vk_meta_rendering_info *src)
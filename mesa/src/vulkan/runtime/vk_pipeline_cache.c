@@ -75,6 +75,56 @@ vk_raw_data_cache_object_deserialize(struct vk_pipeline_cache *cache,
    return data_obj ? &data_obj->base : NULL;
 }
 
+struct vk_pipeline_cache_import_entry {
+   struct vk_raw_data_cache_object data_obj;
+
+   /* Index of the object type in pipeline_cache_import_ops, or -1 */
+   int32_t type;
+
+   /* Set until the entry is used and added to the disk cache */
+   uint32_t disk_cache_pending;
+};
+
+/* Initial data indexed by vk_pipeline_cache_load()
+ *
+ * The entries are raw data objects pointing into a copy of the data owned by
+ * the import.  Each entry holds a reference, so the copy lives until the last
+ * entry is destroyed.
+ */
+struct vk_pipeline_cache_import {
+   uint32_t ref_cnt;
+
+   /* Copy of the initial data */
+   void *data;
+
+   struct vk_pipeline_cache_import_entry entries[];
+};
+
+static void
+vk_pipeline_cache_import_unref(struct vk_device *device,
+                               struct vk_pipeline_cache_import *import)
+{
+   if (p_atomic_dec_zero(&import->ref_cnt)) {
+      vk_free(&device->alloc, import->data);
+      vk_free(&device->alloc, import);
+   }
+}
+
+static struct vk_pipeline_cache_import_entry *
+vk_pipeline_cache_object_as_import_entry(struct vk_pipeline_cache_object *object)
+{
+   if (object->ops != &vk_raw_data_cache_object_ops)
+      return NULL;
+
+   struct vk_raw_data_cache_object *data_obj =
+      container_of(object, struct vk_raw_data_cache_object, base);
+   if (data_obj->import == NULL)
+      return NULL;
+
+   return container_of(data_obj, struct vk_pipeline_cache_import_entry,
+                       data_obj);
+}
+
 static void
 vk_raw_data_cache_object_destroy(struct vk_device *device,
                                  struct vk_pipeline_cache_object *object)
@@ -82,7 +132,10 @@ vk_raw_data_cache_object_destroy(struct vk_device *device,
    struct vk_raw_data_cache_object *data_obj =
       container_of(object, struct vk_raw_data_cache_object, base);
 
-   vk_free(&device->alloc, data_obj);
+   if (data_obj->import)
+      vk_pipeline_cache_import_unref(device, data_obj->import);
+   else
+      vk_free(&device->alloc, data_obj);
 }
 
 const struct vk_pipeline_cache_object_ops vk_raw_data_cache_object_ops = {
@@ -110,6 +163,7 @@ vk_raw_data_cache_object_create(struct vk_device *device,
                                  obj_key_data, key_size);
    data_obj->data = obj_data;
    data_obj->data_size = data_size;
+   data_obj->import = NULL;
 
    memcpy(obj_key_data, key_data, key_size);
    memcpy(obj_data, data, data_size);
@@ -134,35 +188,46 @@ object_key_hash(const void *void_object)
    return _mesa_hash_data(object->key_data, object->key_size);
 }
 
-static void
-vk_pipeline_cache_lock(struct vk_pipeline_cache *cache)
+/* The low bits of the hash pick the slot in the set, so use the high ones
+ * to pick the shard.
+ */
+static struct vk_pipeline_cache_shard *
+vk_pipeline_cache_get_shard(struct vk_pipeline_cache *cache, uint32_t hash)
 {
+   return &cache->shards[hash >> (32 - VK_PIPELINE_CACHE_SHARD_BITS)];
+}
 
+static void
+vk_pipeline_cache_lock(struct vk_pipeline_cache *cache,
+                       struct vk_pipeline_cache_shard *shard)
+{
    if (!(cache->flags & VK_PIPELINE_CACHE_CREATE_EXTERNALLY_SYNCHRONIZED_BIT))
-      simple_mtx_lock(&cache->lock);
+      simple_mtx_lock(&shard->lock);
 }
 
 static void
-vk_pipeline_cache_unlock(struct vk_pipeline_cache *cache)
+vk_pipeline_cache_unlock(struct vk_pipeline_cache *cache,
+                         struct vk_pipeline_cache_shard *shard)
 {
    if (!(cache->flags & VK_PIPELINE_CACHE_CREATE_EXTERNALLY_SYNCHRONIZED_BIT))
-      simple_mtx_unlock(&cache->lock);
+      simple_mtx_unlock(&shard->lock);
 }
 
-/* cache->lock must be held when calling */
+/* shard->lock must be held when calling */
 static void
 vk_pipeline_cache_remove_object(struct vk_pipeline_cache *cache,
+                                struct vk_pipeline_cache_shard *shard,
                                 uint32_t hash,
                                 struct vk_pipeline_cache_object *object)
 {
    struct set_entry *entry =
-      _mesa_set_search_pre_hashed(cache->object_cache, hash, object);
+      _mesa_set_search_pre_hashed(shard->objects, hash, object);
    if (entry && entry->key == (const void *)object) {
       /* Drop the reference owned by the cache */
       if (!cache->weak_ref)
          vk_pipeline_cache_object_unref(cache->base.device, object);
 
-      _mesa_set_remove(cache->object_cache, entry);
+      _mesa_set_remove(shard->objects, entry);
    }
 }
 
@@ -185,13 +250,15 @@ vk_pipeline_cache_object_unref(struct vk_device *device, struct vk_pipeline_cach
       if (p_atomic_dec_zero(&object->ref_cnt))
          object->ops->destroy(device, object);
    } else {
-      vk_pipeline_cache_lock(weak_owner);
+      uint32_t hash = object_key_hash(object);
+      struct vk_pipeline_cache_shard *shard =
+         vk_pipeline_cache_get_shard(weak_owner, hash);
+
+      vk_pipeline_cache_lock(weak_owner, shard);
       bool destroy = p_atomic_dec_zero(&object->ref_cnt);
-      if (destroy) {
-         uint32_t hash = object_key_hash(object);
-         vk_pipeline_cache_remove_object(weak_owner, hash, object);
-      }
-      vk_pipeline_cache_unlock(weak_owner);
+      if (destroy)
+         vk_pipeline_cache_remove_object(weak_owner, shard, hash, object);
+      vk_pipeline_cache_unlock(weak_owner, shard);
       if (destroy)
          object->ops->destroy(device, object);
    }
@@ -284,15 +351,17 @@ vk_pipeline_cache_insert_object(struct vk_pipeline_cache *cache,
 {
    assert(object->ops != NULL);
 
-   if (cache->object_cache == NULL)
+   if (cache->shards == NULL)
       return object;
 
    uint32_t hash = object_key_hash(object);
+   struct vk_pipeline_cache_shard *shard =
+      vk_pipeline_cache_get_shard(cache, hash);
 
-   vk_pipeline_cache_lock(cache);
+   vk_pipeline_cache_lock(cache, shard);
    bool found = false;
    struct set_entry *entry = _mesa_set_search_or_add_pre_hashed(
-       cache->object_cache, hash, object, &found);
+       shard->objects, hash, object, &found);
 
    struct vk_pipeline_cache_object *result = NULL;
    /* add reference to either the found or inserted object */
@@ -315,7 +384,7 @@ vk_pipeline_cache_insert_object(struct vk_pipeline_cache *cache,
       else
          vk_pipeline_cache_object_weak_ref(cache, result);
    }
-   vk_pipeline_cache_unlock(cache);
+   vk_pipeline_cache_unlock(cache, shard);
 
    if (found) {
       vk_pipeline_cache_object_unref(cache->base.device, object);
@@ -323,6 +392,26 @@ vk_pipeline_cache_insert_object(struct vk_pipeline_cache *cache,
    return result;
 }
 
+/* Imported entries are added to the disk cache on first use rather than when
+ * the initial data is loaded.
+ */
+static void
+vk_pipeline_cache_import_entry_used(struct vk_pipeline_cache *cache,
+                                    struct vk_pipeline_cache_object *object)
+{
+   struct vk_pipeline_cache_import_entry *entry =
+      vk_pipeline_cache_object_as_import_entry(object);
+   if (entry == NULL || !p_atomic_xchg(&entry->disk_cache_pending, 0))
+      return;
+
+   struct disk_cache *disk_cache = cache->base.device->physical->disk_cache;
+   cache_key cache_key;
+   disk_cache_compute_key(disk_cache, object->key_data, object->key_size,
+                          cache_key);
+   disk_cache_put(disk_cache, cache_key, entry->data_obj.data,
+                  entry->data_obj.data_size, NULL);
+}
+
 struct vk_pipeline_cache_object *
 vk_pipeline_cache_lookup_object(struct vk_pipeline_cache *cache,
                                 const void *key_data, size_t key_size,
@@ -343,21 +432,27 @@ vk_pipeline_cache_lookup_object(struct vk_pipeline_cache *cache,
 
    struct vk_pipeline_cache_object *object = NULL;
 
-   if (cache != NULL && cache->object_cache != NULL) {
-      vk_pipeline_cache_lock(cache);
+   if (cache != NULL && cache->shards != NULL) {
+      struct vk_pipeline_cache_shard *shard =
+         vk_pipeline_cache_get_shard(cache, hash);
+
+      vk_pipeline_cache_lock(cache, shard);
       struct set_entry *entry =
-         _mesa_set_search_pre_hashed(cache->object_cache, hash, &key);
+         _mesa_set_search_pre_hashed(shard->objects, hash, &key);
       if (entry) {
          object = vk_pipeline_cache_object_ref((void *)entry->key);
          if (cache_hit != NULL)
             *cache_hit = true;
       }
-      vk_pipeline_cache_unlock(cache);
+      vk_pipeline_cache_unlock(cache, shard);
    }
 
+   if (object != NULL)
+      vk_pipeline_cache_import_entry_used(cache, object);
+
    if (object == NULL) {
       struct disk_cache *disk_cache = cache->base.device->physical->disk_cache;
-      if (!cache->skip_disk_cache && disk_cache && cache->object_cache) {
+      if (!cache->skip_disk_cache && disk_cache && cache->shards) {
          cache_key cache_key;
          disk_cache_compute_key(disk_cache, key_data, key_size, cache_key);
 
@@ -397,9 +492,12 @@ vk_pipeline_cache_lookup_object(struct vk_pipeline_cache *cache,
          vk_pipeline_cache_log(cache,
                                "Deserializing pipeline cache object failed");
 
-         vk_pipeline_cache_lock(cache);
-         vk_pipeline_cache_remove_object(cache, hash, object);
-         vk_pipeline_cache_unlock(cache);
+         struct vk_pipeline_cache_shard *shard =
+            vk_pipeline_cache_get_shard(cache, hash);
+
+         vk_pipeline_cache_lock(cache, shard);
+         vk_pipeline_cache_remove_object(cache, shard, hash, object);
+         vk_pipeline_cache_unlock(cache, shard);
          vk_pipeline_cache_object_unref(cache->base.device, object);
          return NULL;
       }
@@ -468,6 +566,24 @@ vk_pipeline_cache_create_and_insert_object(struct vk_pipeline_cache *cache,
    return object;
 }
 
+uint32_t
+vk_pipeline_cache_object_count(struct vk_pipeline_cache *cache)
+{
+   if (cache->shards == NULL)
+      return 0;
+
+   uint32_t count = 0;
+   for (uint32_t i = 0; i < VK_PIPELINE_CACHE_SHARD_COUNT; i++) {
+      struct vk_pipeline_cache_shard *shard = &cache->shards[i];
+
+      vk_pipeline_cache_lock(cache, shard);
+      count += shard->objects->entries;
+      vk_pipeline_cache_unlock(cache, shard);
+   }
+
+   return count;
+}
+
 nir_shader *
 vk_pipeline_cache_lookup_nir(struct vk_pipeline_cache *cache,
                              const void *key_data, size_t key_size,
@@ -559,21 +675,84 @@ find_ops_for_type(const struct vk_physical_device *pdevice,
    return import_ops[type];
 }
 
+/* Deserializes all entries right away */
 static void
-vk_pipeline_cache_load(struct vk_pipeline_cache *cache,
-                       const void *data, size_t size)
+vk_pipeline_cache_load_objects(struct vk_pipeline_cache *cache,
+                               struct blob_reader *blob, uint32_t count)
 {
-   struct blob_reader blob;
-   blob_reader_init(&blob, data, size);
+   for (uint32_t i = 0; i < count; i++) {
+      int32_t type = blob_read_uint32(blob);
+      uint32_t key_size = blob_read_uint32(blob);
+      uint32_t data_size = blob_read_uint32(blob);
+      const void *key_data = blob_read_bytes(blob, key_size);
+      blob_reader_align(blob, VK_PIPELINE_CACHE_BLOB_ALIGN);
+      const void *data = blob_read_bytes(blob, data_size);
+      if (blob->overrun)
+         break;
 
-   struct vk_pipeline_cache_header header;
-   blob_copy_bytes(&blob, &header, sizeof(header));
-   uint32_t count = blob_read_uint32(&blob);
-   if (blob.overrun)
+      const struct vk_pipeline_cache_object_ops *ops =
+         find_ops_for_type(cache->base.device->physical, type);
+
+      struct vk_pipeline_cache_object *object =
+         vk_pipeline_cache_create_and_insert_object(cache, key_data, key_size,
+                                                    data, data_size, ops);
+
+      if (object == NULL) {
+         vk_pipeline_cache_log(cache, "Failed to load pipeline cache object");
+         continue;
+      }
+
+      vk_pipeline_cache_object_unref(cache->base.device, object);
+   }
+}
+
+/* Only indexes the entries.  They are inserted as raw data objects pointing
+ * into the data, which vk_pipeline_cache_lookup_object() deserializes on
+ * first use.
+ */
+static void
+vk_pipeline_cache_import_objects(struct vk_pipeline_cache *cache,
+                                 const void *data, size_t size,
+                                 uint32_t count)
+{
+   struct vk_device *device = cache->base.device;
+   const size_t header_size =
+      sizeof(struct vk_pipeline_cache_header) + sizeof(uint32_t);
+
+   /* Each entry takes at least its type, key size and data size. */
+   count = MIN2(count, (size - header_size) / (3 * sizeof(uint32_t)));
+   if (count == 0)
       return;
 
-   if (memcmp(&header, &cache->header, sizeof(header)) != 0)
+   struct vk_pipeline_cache_import *import =
+      vk_zalloc(&device->alloc,
+                sizeof(*import) + count * sizeof(import->entries[0]), 8,
+                VK_SYSTEM_ALLOCATION_SCOPE_DEVICE);
+   if (import == NULL) {
+      vk_pipeline_cache_log(cache, "Failed to import pipeline cache data");
       return;
+   }
+
+   import->data = vk_alloc(&device->alloc, size, 8,
+                           VK_SYSTEM_ALLOCATION_SCOPE_DEVICE);
+   if (import->data == NULL) {
+      vk_free(&device->alloc, import);
+      vk_pipeline_cache_log(cache, "Failed to import pipeline cache data");
+      return;
+   }
+   memcpy(import->data, data, size);
+
+   struct blob_reader blob;
+   blob_reader_init(&blob, import->data, size);
+   blob_skip_bytes(&blob, header_size);
+
+   const bool disk_cache_pending =
+      !cache->skip_disk_cache && device->physical->disk_cache;
+
+   /* Keep the import alive while inserting, entries with duplicate keys are
+    * destroyed right away.
+    */
+   import->ref_cnt = 1;
 
    for (uint32_t i = 0; i < count; i++) {
       int32_t type = blob_read_uint32(&blob);
@@ -581,24 +760,50 @@ vk_pipeline_cache_load(struct vk_pipeline_cache *cache,
       uint32_t data_size = blob_read_uint32(&blob);
       const void *key_data = blob_read_bytes(&blob, key_size);
       blob_reader_align(&blob, VK_PIPELINE_CACHE_BLOB_ALIGN);
-      const void *data = blob_read_bytes(&blob, data_size);
+      const void *entry_data = blob_read_bytes(&blob, data_size);
       if (blob.overrun)
          break;
 
-      const struct vk_pipeline_cache_object_ops *ops =
-         find_ops_for_type(cache->base.device->physical, type);
+      struct vk_pipeline_cache_import_entry *entry = &import->entries[i];
+      vk_pipeline_cache_object_init(device, &entry->data_obj.base,
+                                    &vk_raw_data_cache_object_ops,
+                                    key_data, key_size);
+      entry->data_obj.data = entry_data;
+      entry->data_obj.data_size = data_size;
+      entry->data_obj.import = import;
+      entry->type = type;
+      entry->disk_cache_pending = disk_cache_pending;
+      p_atomic_inc(&import->ref_cnt);
 
       struct vk_pipeline_cache_object *object =
-         vk_pipeline_cache_create_and_insert_object(cache, key_data, key_size,
-                                                    data, data_size, ops);
+         vk_pipeline_cache_insert_object(cache, &entry->data_obj.base);
+      vk_pipeline_cache_object_unref(device, object);
+   }
 
-      if (object == NULL) {
-         vk_pipeline_cache_log(cache, "Failed to load pipeline cache object");
-         continue;
-      }
+   vk_pipeline_cache_import_unref(device, import);
+}
 
-      vk_pipeline_cache_object_unref(cache->base.device, object);
-   }
+static void
+vk_pipeline_cache_load(struct vk_pipeline_cache *cache,
+                       const void *data, size_t size)
+{
+   struct blob_reader blob;
+   blob_reader_init(&blob, data, size);
+
+   struct vk_pipeline_cache_header header;
+   blob_copy_bytes(&blob, &header, sizeof(header));
+   uint32_t count = blob_read_uint32(&blob);
+   if (blob.overrun)
+      return;
+
+   if (memcmp(&header, &cache->header, sizeof(header)) != 0)
+      return;
+
+   /* Weak reference caches can't deserialize raw data objects lazily. */
+   if (cache->weak_ref)
+      vk_pipeline_cache_load_objects(cache, &blob, count);
+   else
+      vk_pipeline_cache_import_objects(cache, data, size, count);
 }
 
 struct vk_pipeline_cache *
@@ -609,16 +814,21 @@ vk_pipeline_cache_create(struct vk_device *device,
    static const struct VkPipelineCacheCreateInfo default_create_info = {
       .sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
    };
-   struct vk_pipeline_cache *cache;
-
    const struct VkPipelineCacheCreateInfo *pCreateInfo =
       info->pCreateInfo != NULL ? info->pCreateInfo : &default_create_info;
 
    assert(pCreateInfo->sType == VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO);
 
-   cache = vk_object_zalloc(device, pAllocator, sizeof(*cache),
-                            VK_OBJECT_TYPE_PIPELINE_CACHE);
-   if (cache == NULL)
+   const bool enable_object_cache = info->force_enable ||
+      debug_get_bool_option("VK_ENABLE_PIPELINE_CACHE", true);
+
+   VK_MULTIALLOC(ma);
+   VK_MULTIALLOC_DECL(&ma, struct vk_pipeline_cache, cache, 1);
+   VK_MULTIALLOC_DECL(&ma, struct vk_pipeline_cache_shard, shards,
+                      enable_object_cache ? VK_PIPELINE_CACHE_SHARD_COUNT : 0);
+
+   if (!vk_object_multizalloc(device, &ma, pAllocator,
+                              VK_OBJECT_TYPE_PIPELINE_CACHE))
       return NULL;
 
    cache->flags = pCreateInfo->flags;
@@ -641,15 +851,20 @@ vk_pipeline_cache_create(struct vk_device *device,
    };
    memcpy(cache->header.uuid, pdevice_props.pipelineCacheUUID, VK_UUID_SIZE);
 
-   simple_mtx_init(&cache->lock, mtx_plain);
-
-   if (info->force_enable ||
-       debug_get_bool_option("VK_ENABLE_PIPELINE_CACHE", true)) {
-      cache->object_cache = _mesa_set_create(NULL, object_key_hash,
-                                             object_keys_equal);
+   if (shards) {
+      cache->shards = shards;
+      for (uint32_t i = 0; i < VK_PIPELINE_CACHE_SHARD_COUNT; i++) {
+         simple_mtx_init(&shards[i].lock, mtx_plain);
+         shards[i].objects = _mesa_set_create(NULL, object_key_hash,
+                                              object_keys_equal);
+         if (shards[i].objects == NULL) {
+            vk_pipeline_cache_destroy(cache, pAllocator);
+            return NULL;
+         }
+      }
    }
 
-   if (cache->object_cache && pCreateInfo->initialDataSize > 0) {
+   if (cache->shards && pCreateInfo->initialDataSize > 0) {
       vk_pipeline_cache_load(cache, pCreateInfo->pInitialData,
                              pCreateInfo->initialDataSize);
    }
@@ -661,17 +876,21 @@ void
 vk_pipeline_cache_destroy(struct vk_pipeline_cache *cache,
                           const VkAllocationCallbacks *pAllocator)
 {
-   if (cache->object_cache) {
-      if (!cache->weak_ref) {
-         set_foreach(cache->object_cache, entry) {
-            vk_pipeline_cache_object_unref(cache->base.device, (void *)entry->key);
+   for (uint32_t i = 0; cache->shards && i < VK_PIPELINE_CACHE_SHARD_COUNT; i++) {
+      struct vk_pipeline_cache_shard *shard = &cache->shards[i];
+
+      if (shard->objects) {
+         if (!cache->weak_ref) {
+            set_foreach(shard->objects, entry) {
+               vk_pipeline_cache_object_unref(cache->base.device, (void *)entry->key);
+            }
+         } else {
+            assert(shard->objects->entries == 0);
          }
-      } else {
-         assert(cache->object_cache->entries == 0);
+         _mesa_set_destroy(shard->objects, NULL);
       }
-      _mesa_set_destroy(cache->object_cache, NULL);
+      simple_mtx_destroy(&shard->lock);
    }
-   simple_mtx_destroy(&cache->lock);
    vk_object_free(cache->base.device, pAllocator, cache);
 }
 
@@ -737,11 +956,13 @@ vk_common_GetPipelineCacheData(VkDevice _device,
       return VK_INCOMPLETE;
    }
 
-   vk_pipeline_cache_lock(cache);
-
    VkResult result = VK_SUCCESS;
-   if (cache->object_cache != NULL) {
-      set_foreach(cache->object_cache, entry) {
+   for (uint32_t i = 0; cache->shards && i < VK_PIPELINE_CACHE_SHARD_COUNT; i++) {
+      struct vk_pipeline_cache_shard *shard = &cache->shards[i];
+
+      vk_pipeline_cache_lock(cache, shard);
+
+      set_foreach(shard->objects, entry) {
          struct vk_pipeline_cache_object *object = (void *)entry->key;
 
          if (object->ops->serialize == NULL)
@@ -749,7 +970,11 @@ vk_common_GetPipelineCacheData(VkDevice _device,
 
          size_t blob_size_save = blob.size;
 
-         int32_t type = find_type_for_ops(device->physical, object->ops);
+         /* Imported entries that weren't used yet keep their type. */
+         struct vk_pipeline_cache_import_entry *import_entry =
+            vk_pipeline_cache_object_as_import_entry(object);
+         int32_t type = import_entry ? import_entry->type :
+                        find_type_for_ops(device->physical, object->ops);
          blob_write_uint32(&blob, type);
          blob_write_uint32(&blob, object->key_size);
          intptr_t data_size_resv = blob_reserve_uint32(&blob);
@@ -781,9 +1006,12 @@ vk_common_GetPipelineCacheData(VkDevice _device,
 
          count++;
       }
-   }
 
-   vk_pipeline_cache_unlock(cache);
+      vk_pipeline_cache_unlock(cache, shard);
+
+      if (result != VK_SUCCESS)
+         break;
+   }
 
    blob_overwrite_uint32(&blob, count_offset, count);
 
@@ -805,53 +1033,57 @@ vk_common_MergePipelineCaches(VkDevice _device,
    assert(dst->base.device == device);
    assert(!dst->weak_ref);
 
-   if (!dst->object_cache)
+   if (!dst->shards)
       return VK_SUCCESS;
 
-   vk_pipeline_cache_lock(dst);
-
    for (uint32_t i = 0; i < srcCacheCount; i++) {
       VK_FROM_HANDLE(vk_pipeline_cache, src, pSrcCaches[i]);
       assert(src->base.device == device);
 
-      if (!src->object_cache)
+      if (!src->shards)
          continue;
 
       assert(src != dst);
       if (src == dst)
          continue;
 
-      vk_pipeline_cache_lock(src);
-
-      set_foreach(src->object_cache, src_entry) {
-         struct vk_pipeline_cache_object *src_object = (void *)src_entry->key;
-
-         bool found_in_dst = false;
-         struct set_entry *dst_entry =
-            _mesa_set_search_or_add_pre_hashed(dst->object_cache,
-                                               src_entry->hash,
-                                               src_object, &found_in_dst);
-         if (found_in_dst) {
-            struct vk_pipeline_cache_object *dst_object = (void *)dst_entry->key;
-            if (dst_object->ops == &vk_raw_data_cache_object_ops &&
-                src_object->ops != &vk_raw_data_cache_object_ops) {
-               /* Even though dst has the object, it only has the blob version
-                * which isn't as useful.  Replace it with the real object.
-                */
-               vk_pipeline_cache_object_unref(device, dst_object);
-               dst_entry->key = vk_pipeline_cache_object_ref(src_object);
+      /* Objects with the same key land in the same shard of both caches. */
+      for (uint32_t s = 0; s < VK_PIPELINE_CACHE_SHARD_COUNT; s++) {
+         struct vk_pipeline_cache_shard *dst_shard = &dst->shards[s];
+         struct vk_pipeline_cache_shard *src_shard = &src->shards[s];
+
+         vk_pipeline_cache_lock(dst, dst_shard);
+         vk_pipeline_cache_lock(src, src_shard);
+
+         set_foreach(src_shard->objects, src_entry) {
+            struct vk_pipeline_cache_object *src_object = (void *)src_entry->key;
+
+            bool found_in_dst = false;
+            struct set_entry *dst_entry =
+               _mesa_set_search_or_add_pre_hashed(dst_shard->objects,
+                                                  src_entry->hash,
+                                                  src_object, &found_in_dst);
+            if (found_in_dst) {
+               struct vk_pipeline_cache_object *dst_object = (void *)dst_entry->key;
+               if (dst_object->ops == &vk_raw_data_cache_object_ops &&
+                   src_object->ops != &vk_raw_data_cache_object_ops) {
+                  /* Even though dst has the object, it only has the blob version
+                   * which isn't as useful.  Replace it with the real object.
+                   */
+                  vk_pipeline_cache_object_unref(device, dst_object);
+                  dst_entry->key = vk_pipeline_cache_object_ref(src_object);
+               }
+            } else {
+               /* We inserted src_object in dst so it needs a reference */
+               assert(dst_entry->key == (const void *)src_object);
+               vk_pipeline_cache_object_ref(src_object);
             }
-         } else {
-            /* We inserted src_object in dst so it needs a reference */
-            assert(dst_entry->key == (const void *)src_object);
-            vk_pipeline_cache_object_ref(src_object);
          }
-      }
 
-      vk_pipeline_cache_unlock(src);
+         vk_pipeline_cache_unlock(src, src_shard);
+         vk_pipeline_cache_unlock(dst, dst_shard);
+      }
    }
 
-   vk_pipeline_cache_unlock(dst);
-
    return VK_SUCCESS;
 }
@@ -23,6 +23,7 @@
 
 #include "vk_queue.h"
 
+#include "util/os_time.h"
 #include "util/perf/cpu_trace.h"
 #include "util/u_debug.h"
 #include <inttypes.h>
@@ -463,13 +464,9 @@ vk_queue_submit_add_image_bind(
    submit->image_binds[submit->image_bind_count++] = info_tmp;
 }
 
-/* Attempts to merge two submits into one.  If the merge succeeds, the merged
- * submit is return and the two submits passed in are destroyed.
- */
-static struct vk_queue_submit *
-vk_queue_submits_merge(struct vk_queue *queue,
-                       struct vk_queue_submit *first,
-                       struct vk_queue_submit *second)
+static bool
+vk_queue_submits_can_merge(const struct vk_queue_submit *first,
+                           const struct vk_queue_submit *second)
 {
    /* Don't merge if there are signals in between: see 'Signal operation order' */
    if (first->signal_count > 0 &&
@@ -478,15 +475,29 @@ vk_queue_submits_merge(struct vk_queue *queue,
         second->image_opaque_bind_count ||
         second->image_bind_count ||
         second->wait_count))
-      return NULL;
+      return false;
 
    if (vk_queue_submit_has_bind(first) != vk_queue_submit_has_bind(second))
-      return NULL;
+      return false;
 
    if (first->_mem_signal_temp)
-      return NULL;
+      return false;
 
    if (first->perf_pass_index != second->perf_pass_index)
+      return false;
+
+   return true;
+}
+
+/* Attempts to merge two submits into one.  If the merge succeeds, the merged
+ * submit is return and the two submits passed in are destroyed.
+ */
+static struct vk_queue_submit *
+vk_queue_submits_merge(struct vk_queue *queue,
+                       struct vk_queue_submit *first,
+                       struct vk_queue_submit *second)
+{
+   if (!vk_queue_submits_can_merge(first, second))
       return NULL;
 
    /* noop submits can always do a no-op merge */
@@ -596,8 +607,11 @@ static void
 vk_queue_push_submit(struct vk_queue *queue,
                      struct vk_queue_submit *submit)
 {
+   submit->_push_time_ns = os_time_get_nano();
+
    mtx_lock(&queue->submit.mutex);
    list_addtail(&submit->link, &queue->submit.submits);
+   queue->submit.stats.submit_count++;
    cnd_signal(&queue->submit.push);
    mtx_unlock(&queue->submit.mutex);
 }
@@ -793,6 +807,76 @@ done:
    return result;
 }
 
+/* Upper bound on how many queued submits the submit thread merges into a
+ * single driver submit.  Each merge copies the submit so far, so this also
+ * bounds the copying.
+ */
+#define VK_QUEUE_MAX_MERGED_SUBMITS 32
+
+/* Merges the submits queued after the first one into it for as long as they
+ * can be merged and all their waits are already pending, so that they don't
+ * depend on anything which isn't submitted yet.  Otherwise, the thread would
+ * wait on and submit each of them separately right after this one anyway.
+ *
+ * Called and returns with the submit mutex held.  The first submit stays in
+ * the list so vk_queue_drain() keeps waiting, and the merged submit replaces
+ * it at the head of the list.  Returns the number of submits merged.
+ */
+static uint32_t
+vk_queue_merge_ready_submits(struct vk_queue *queue,
+                             struct vk_queue_submit **submit_inout,
+                             int64_t *push_time_sum_ns)
+{
+   struct vk_queue_submit *submit = *submit_inout;
+   uint32_t merge_count = 0;
+
+   assert(&submit->link == queue->submit.submits.next);
+
+   while (merge_count < VK_QUEUE_MAX_MERGED_SUBMITS - 1 &&
+          submit->link.next != &queue->submit.submits) {
+      struct vk_queue_submit *next =
+         list_entry(submit->link.next, struct vk_queue_submit, link);
+
+      if (!vk_queue_submits_can_merge(submit, next))
+         break;
+
+      /* Submits are only ever added at the tail of the list and only this
+       * thread removes them, so next stays valid without the lock.
+       */
+      mtx_unlock(&queue->submit.mutex);
+      VkResult result = vk_sync_wait_many(queue->base.device,
+                                          next->wait_count, next->waits,
+                                          VK_SYNC_WAIT_PENDING, 0);
+      mtx_lock(&queue->submit.mutex);
+
+      /* Errors get reported when the thread gets to that submit */
+      if (result != VK_SUCCESS)
+         break;
+
+      const int64_t next_push_time_ns = next->_push_time_ns;
+
+      list_del(&next->link);
+      list_del(&submit->link);
+
+      struct vk_queue_submit *merged =
+         vk_queue_submits_merge(queue, submit, next);
+      if (merged == NULL) {
+         /* Out of memory, submit them separately */
+         list_add(&next->link, &queue->submit.submits);
+         list_add(&submit->link, &queue->submit.submits);
+         break;
+      }
+
+      list_add(&merged->link, &queue->submit.submits);
+      *push_time_sum_ns += next_push_time_ns;
+      submit = merged;
+      merge_count++;
+   }
+
+   *submit_inout = submit;
+   return merge_count;
+}
+
 static int
 vk_queue_submit_thread_func(void *_data)
 {
@@ -827,6 +911,18 @@ vk_queue_submit_thread_func(void *_data)
          return 1;
       }
 
+      /* Applications doing many small vkQueueSubmit calls per frame queue
+       * up submits while we wait or while the driver submits.  Hand all of
+       * the ready ones to the driver at once.
+       */
+      int64_t push_time_sum_ns = submit->_push_time_ns;
+      mtx_lock(&queue->submit.mutex);
+      const uint32_t merge_count =
+         vk_queue_merge_ready_submits(queue, &submit, &push_time_sum_ns);
+      mtx_unlock(&queue->submit.mutex);
+
+      const int64_t submit_time_ns = os_time_get_nano();
+
       result = vk_queue_submit_final(queue, submit);
       if (unlikely(result != VK_SUCCESS)) {
          vk_queue_set_lost(queue, "queue::driver_submit failed");
@@ -848,6 +944,13 @@ vk_queue_submit_thread_func(void *_data)
       list_del(&submit->link);
       vk_queue_submit_free(queue, submit);
 
+      queue->submit.stats.merged_count += merge_count;
+      queue->submit.stats.driver_submit_count++;
+      queue->submit.stats.latency_ns +=
+         (merge_count + 1) * submit_time_ns - push_time_sum_ns;
+      MESA_TRACE_SET_COUNTER("vk_queue_merged_submits",
+                             queue->submit.stats.merged_count);
+
       cnd_broadcast(&queue->submit.pop);
    }
 
@@ -96,6 +96,25 @@ struct vk_queue {
 
       bool thread_run;
       thrd_t thread;
+
+      /** Submit thread statistics, protected by the mutex */
+      struct {
+         /** Number of vk_queue_submit pushed to the submit thread */
+         uint64_t submit_count;
+
+         /** Number of vk_queue_submit merged into the previous one by the
+          * submit thread
+          */
+         uint64_t merged_count;
+
+         /** Number of calls to vk_queue::driver_submit from the thread */
+         uint64_t driver_submit_count;
+
+         /** Total time vk_queue_submit spent in the queue, from being
+          * pushed to being passed to vk_queue::driver_submit
+          */
+         uint64_t latency_ns;
+      } stats;
    } submit;
 
    struct {
@@ -242,6 +261,7 @@ struct vk_queue_submit {
    VkSparseMemoryBind *_bind_entries;
    VkSparseImageMemoryBind *_image_bind_entries;
 
+   int64_t _push_time_ns;
    bool _has_binary_permanent_semaphore_wait;
    struct vk_sync **_wait_temps;
    struct vk_sync *_mem_signal_temp;
@@ -27,6 +27,7 @@
 
 #include "util/os_time.h"
 #include "util/timespec.h"
+#include "util/u_atomic.h"
 
 #include "vk_alloc.h"
 #include "vk_device.h"
@@ -77,6 +78,7 @@ vk_sync_timeline_init(struct vk_device *device,
 
    timeline->highest_past =
       timeline->highest_pending = initial_value;
+   timeline->point_waiter = false;
    list_inithead(&timeline->pending_points);
    list_inithead(&timeline->free_points);
 
@@ -235,7 +237,7 @@ vk_sync_timeline_point_complete(struct vk_sync_timeline *timeline,
       return;
 
    assert(timeline->highest_past < point->value);
-   timeline->highest_past = point->value;
+   p_atomic_set(&timeline->highest_past, point->value);
 
    point->pending = false;
    list_del(&point->link);
@@ -298,7 +300,7 @@ vk_sync_timeline_point_install(struct vk_device *device,
    mtx_lock(&timeline->mutex);
 
    assert(point->value > timeline->highest_pending);
-   timeline->highest_pending = point->value;
+   p_atomic_set(&timeline->highest_pending, point->value);
 
    assert(point->refcount == 0);
    point->pending = true;
@@ -344,6 +346,12 @@ vk_sync_timeline_get_point(struct vk_device *device,
                            uint64_t wait_value,
                            struct vk_sync_timeline_point **point_out)
 {
+   if (p_atomic_read(&timeline->highest_past) >= wait_value) {
+      /* Nothing to wait on */
+      *point_out = NULL;
+      return VK_SUCCESS;
+   }
+
    mtx_lock(&timeline->mutex);
    VkResult result = vk_sync_timeline_get_point_locked(device, timeline,
                                                   wait_value, point_out);
@@ -379,7 +387,8 @@ vk_sync_timeline_signal_locked(struct vk_device *device,
 
    assert(list_is_empty(&timeline->pending_points));
    assert(timeline->highest_pending == timeline->highest_past);
-   timeline->highest_pending = timeline->highest_past = value;
+   p_atomic_set(&timeline->highest_pending, value);
+   p_atomic_set(&timeline->highest_past, value);
 
    int ret = u_cnd_monotonic_broadcast(&timeline->cond);
    if (ret == thrd_error)
@@ -409,6 +418,17 @@ vk_sync_timeline_get_value(struct vk_device *device,
 {
    struct vk_sync_timeline *timeline = to_vk_sync_timeline(sync);
 
+   /* If nothing is pending, there is nothing to garbage collect.  Both only
+    * ever increase and highest_past never exceeds highest_pending, so if
+    * highest_pending still equals highest_past when read after it, nothing
+    * was pending at that point.
+    */
+   const uint64_t highest_past = p_atomic_read(&timeline->highest_past);
+   if (p_atomic_read(&timeline->highest_pending) == highest_past) {
+      *value = highest_past;
+      return VK_SUCCESS;
+   }
+
    mtx_lock(&timeline->mutex);
    VkResult result = vk_sync_timeline_gc_locked(device, timeline, true);
    mtx_unlock(&timeline->mutex);
@@ -416,7 +436,7 @@ vk_sync_timeline_get_value(struct vk_device *device,
    if (result != VK_SUCCESS)
       return result;
 
-   *value = timeline->highest_past;
+   *value = p_atomic_read(&timeline->highest_past);
 
    return VK_SUCCESS;
 }
@@ -452,10 +472,26 @@ vk_sync_timeline_wait_locked(struct vk_device *device,
       return result;
 
    while (timeline->highest_past < wait_value) {
+      /* Someone is already waiting on the first point.  Wait for them to
+       * complete it or give up instead of waiting on it as well.
+       */
+      if (timeline->point_waiter) {
+         int ret = u_cnd_monotonic_timedwait(&timeline->cond, &timeline->mutex,
+                                             &abs_timeout_ts);
+         if (ret == thrd_timedout)
+            return VK_TIMEOUT;
+
+         if (ret != thrd_success)
+            return vk_errorf(device, VK_ERROR_UNKNOWN, "cnd_timedwait failed");
+
+         continue;
+      }
+
       struct vk_sync_timeline_point *point = vk_sync_timeline_first_point(timeline);
 
       /* Drop the lock while we wait. */
       vk_sync_timeline_point_ref(point);
+      timeline->point_waiter = true;
       mtx_unlock(&timeline->mutex);
 
       result = vk_sync_wait(device, &point->sync, 0,
@@ -464,12 +500,19 @@ vk_sync_timeline_wait_locked(struct vk_device *device,
 
       /* Pick the mutex back up */
       mtx_lock(&timeline->mutex);
+      timeline->point_waiter = false;
       vk_sync_timeline_point_unref(timeline, point);
 
+      /* Whatever happened, let the other waiters know */
+      int ret = u_cnd_monotonic_broadcast(&timeline->cond);
+
       /* This covers both VK_TIMEOUT and VK_ERROR_DEVICE_LOST */
       if (result != VK_SUCCESS)
          return result;
 
+      if (ret == thrd_error)
+         return vk_errorf(device, VK_ERROR_UNKNOWN, "cnd_broadcast failed");
+
       vk_sync_timeline_point_complete(timeline, point);
    }
 
@@ -485,6 +528,14 @@ vk_sync_timeline_wait(struct vk_device *device,
 {
    struct vk_sync_timeline *timeline = to_vk_sync_timeline(sync);
 
+   /* Waits which are already satisfied don't need the mutex */
+   if (p_atomic_read(&timeline->highest_past) >= wait_value)
+      return VK_SUCCESS;
+
+   if ((wait_flags & VK_SYNC_WAIT_PENDING) &&
+       p_atomic_read(&timeline->highest_pending) >= wait_value)
+      return VK_SUCCESS;
+
    mtx_lock(&timeline->mutex);
    VkResult result = vk_sync_timeline_wait_locked(device, timeline,
                                              wait_value, wait_flags,
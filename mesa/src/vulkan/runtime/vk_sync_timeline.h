@@ -82,9 +82,18 @@ struct vk_sync_timeline {
    mtx_t mutex;
    struct u_cnd_monotonic cond;
 
+   /* Only ever increase.  Written with the mutex held but read atomically
+    * without it for waits and queries which are already satisfied.
+    */
    uint64_t highest_past;
    uint64_t highest_pending;
 
+   /* Set while a thread waits on the first pending point without the mutex.
+    * Other CPU waiters wait on cond for it to complete the point instead of
+    * all waiting on the same binary vk_sync.
+    */
+   bool point_waiter;
+
    struct list_head pending_points;
    struct list_head free_points;
 };
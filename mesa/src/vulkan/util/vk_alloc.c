@@ -6,6 +6,9 @@
 #include "vk_alloc.h"
 
 #include <stdlib.h>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
 
 #ifndef _MSC_VER
 #include <stddef.h>
@@ -16,14 +19,28 @@
 #define MAX_ALIGN alignof(uint64_t)
 #endif
 
+/* Allocations may ask for more than the malloc() alignment, a cache line
+ * for instance, which the Vulkan spec requires allocators to honour.  On
+ * Windows that needs the _aligned_* functions for every allocation, since
+ * their memory can't be freed with free().
+ */
 static VKAPI_ATTR void * VKAPI_CALL
 vk_default_alloc(void *pUserData,
                  size_t size,
                  size_t alignment,
                  VkSystemAllocationScope allocationScope)
 {
-   assert(MAX_ALIGN % alignment == 0);
-   return malloc(size);
+#ifdef _WIN32
+   return _aligned_malloc(size, MAX2(alignment, MAX_ALIGN));
+#else
+   if (alignment <= MAX_ALIGN)
+      return malloc(size);
+
+   void *ptr;
+   if (posix_memalign(&ptr, alignment, size) != 0)
+      return NULL;
+   return ptr;
+#endif
 }
 
 static VKAPI_ATTR void * VKAPI_CALL
@@ -33,14 +50,23 @@ vk_default_realloc(void *pUserData,
                    size_t alignment,
                    VkSystemAllocationScope allocationScope)
 {
+#ifdef _WIN32
+   return _aligned_realloc(pOriginal, size, MAX2(alignment, MAX_ALIGN));
+#else
+   /* realloc() doesn't keep a larger alignment */
    assert(MAX_ALIGN % alignment == 0);
    return realloc(pOriginal, size);
+#endif
 }
 
 static VKAPI_ATTR void VKAPI_CALL
 vk_default_free(void *pUserData, void *pMemory)
 {
+#ifdef _WIN32
+   _aligned_free(pMemory);
+#else
    free(pMemory);
+#endif
 }
 
 const VkAllocationCallbacks *
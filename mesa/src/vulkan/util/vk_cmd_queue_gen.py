@@ -76,7 +76,10 @@ TEMPLATE_H = Template(COPYRIGHT + """\
 
 #pragma once
 
+#include <string.h>
+
 #include "util/list.h"
+#include "util/macros.h"
 
 #define VK_PROTOTYPES
 #include <vulkan/vulkan_core.h>
@@ -93,6 +96,18 @@ struct vk_device_dispatch_table;
 struct vk_cmd_queue {
    const VkAllocationCallbacks *alloc;
    struct list_head cmds;
+
+   /* Commands and their payloads are bump-allocated from a chain of blocks,
+    * which are all released at once when the queue is reset.
+    */
+   struct list_head blocks;
+   uint8_t *cursor;
+   uint8_t *end;
+
+   /* Optional list of released blocks to recycle, shared with the other
+    * queues of a command pool.
+    */
+   struct list_head *free_blocks;
 };
 
 enum vk_cmd_type {
@@ -181,11 +196,39 @@ struct vk_cmd_queue_entry {
 
 void vk_free_queue(struct vk_cmd_queue *queue);
 
+void *vk_cmd_queue_alloc_block(struct vk_cmd_queue *queue, size_t size);
+
+void vk_cmd_queue_free_blocks(const VkAllocationCallbacks *alloc,
+                              struct list_head *blocks);
+
+/* Returns zeroed memory that lives until the queue is reset. */
+static inline void *
+vk_cmd_queue_zalloc(struct vk_cmd_queue *queue, size_t size)
+{
+   void *ptr;
+
+   size = (size + 7) & ~(size_t)7;
+   if (likely(size <= (size_t)(queue->end - queue->cursor))) {
+      ptr = queue->cursor;
+      queue->cursor += size;
+   } else {
+      ptr = vk_cmd_queue_alloc_block(queue, size);
+      if (unlikely(!ptr))
+         return NULL;
+   }
+
+   return memset(ptr, 0, size);
+}
+
 static inline void
 vk_cmd_queue_init(struct vk_cmd_queue *queue, VkAllocationCallbacks *alloc)
 {
    queue->alloc = alloc;
    list_inithead(&queue->cmds);
+   list_inithead(&queue->blocks);
+   queue->cursor = NULL;
+   queue->end = NULL;
+   queue->free_blocks = NULL;
 }
 
 static inline void
@@ -255,38 +298,77 @@ size_t vk_cmd_queue_type_sizes[] = {
 % endfor
 };
 
-% for c in commands:
-% if c.guard is not None:
-#ifdef ${c.guard}
-% endif
-static void
-vk_free_${to_underscore(c.name)}(struct vk_cmd_queue *queue,
-${' ' * len('vk_free_' + to_underscore(c.name) + '(')}\\
-struct vk_cmd_queue_entry *cmd)
+/* Blocks are allocated with this size, larger allocations get a block of
+ * their own, which isn't recycled.
+ */
+#define VK_CMD_QUEUE_BLOCK_SIZE (16 * 1024)
+
+struct vk_cmd_queue_block {
+   struct list_head link;
+   size_t size;
+   uint8_t data[];
+};
+
+#define VK_CMD_QUEUE_BLOCK_DATA_SIZE \\
+   (VK_CMD_QUEUE_BLOCK_SIZE - sizeof(struct vk_cmd_queue_block))
+
+void *
+vk_cmd_queue_alloc_block(struct vk_cmd_queue *queue, size_t size)
 {
-   if (cmd->driver_free_cb)
-      cmd->driver_free_cb(queue, cmd);
-   else
-      vk_free(queue->alloc, cmd->driver_data);
-% for p in c.params[1:]:
-% if p.len:
-   vk_free(queue->alloc, (${remove_suffix(p.decl.replace("const", ""), p.name)})cmd->u.${to_struct_field_name(c.name)}.${to_field_name(p.name)});
-% elif '*' in p.decl:
-   ${get_struct_free(c, p, types)}
-% endif
-% endfor
-   vk_free(queue->alloc, cmd);
+   struct vk_cmd_queue_block *block;
+
+   if (size > VK_CMD_QUEUE_BLOCK_DATA_SIZE) {
+      block = vk_alloc(queue->alloc, sizeof(*block) + size, 8,
+                       VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+      if (!block)
+         return NULL;
+
+      /* Keep allocating from the current block. */
+      block->size = size;
+      list_add(&block->link, &queue->blocks);
+      return block->data;
+   }
+
+   if (queue->free_blocks && !list_is_empty(queue->free_blocks)) {
+      block = list_first_entry(queue->free_blocks,
+                               struct vk_cmd_queue_block, link);
+      list_del(&block->link);
+   } else {
+      block = vk_alloc(queue->alloc, VK_CMD_QUEUE_BLOCK_SIZE, 8,
+                       VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+      if (!block)
+         return NULL;
+      block->size = VK_CMD_QUEUE_BLOCK_DATA_SIZE;
+   }
+
+   list_addtail(&block->link, &queue->blocks);
+   queue->cursor = block->data + size;
+   queue->end = block->data + block->size;
+   return block->data;
+}
+
+void
+vk_cmd_queue_free_blocks(const VkAllocationCallbacks *alloc,
+                         struct list_head *blocks)
+{
+   list_for_each_entry_safe(struct vk_cmd_queue_block, block, blocks, link)
+      vk_free(alloc, block);
+   list_inithead(blocks);
 }
 
+% for c in commands:
 % if c.name not in manual_commands and c.name not in no_enqueue_commands:
+% if c.guard is not None:
+#ifdef ${c.guard}
+% endif
 VkResult vk_enqueue_${to_underscore(c.name)}(struct vk_cmd_queue *queue
 % for p in c.params[1:]:
 , ${p.decl}
 % endfor
 )
 {
-   struct vk_cmd_queue_entry *cmd = vk_zalloc(queue->alloc, vk_cmd_queue_type_sizes[${to_enum_name(c.name)}], 8,
-                                              VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+   struct vk_cmd_queue_entry *cmd =
+      vk_cmd_queue_zalloc(queue, vk_cmd_queue_type_sizes[${to_enum_name(c.name)}]);
    if (!cmd) return VK_ERROR_OUT_OF_HOST_MEMORY;
 
    cmd->type = ${to_enum_name(c.name)};
@@ -316,37 +398,39 @@ VkResult vk_enqueue_${to_underscore(c.name)}(struct vk_cmd_queue *queue
 
 % if need_error_handling:
 err:
-   if (cmd)
-      vk_free_${to_underscore(c.name)}(queue, cmd);
+   /* The partial copies are released with the queue. */
    return VK_ERROR_OUT_OF_HOST_MEMORY;
 % endif
 }
-% endif
 % if c.guard is not None:
 #endif // ${c.guard}
 % endif
 
+% endif
 % endfor
 
 void
 vk_free_queue(struct vk_cmd_queue *queue)
 {
-   struct vk_cmd_queue_entry *tmp, *cmd;
-   LIST_FOR_EACH_ENTRY_SAFE(cmd, tmp, &queue->cmds, cmd_link) {
-      switch(cmd->type) {
-% for c in commands:
-% if c.guard is not None:
-#ifdef ${c.guard}
-% endif
-      case ${to_enum_name(c.name)}:
-         vk_free_${to_underscore(c.name)}(queue, cmd);
-         break;
-% if c.guard is not None:
-#endif // ${c.guard}
-% endif
-% endfor
-      }
+   list_for_each_entry(struct vk_cmd_queue_entry, cmd, &queue->cmds, cmd_link) {
+      if (cmd->driver_free_cb)
+         cmd->driver_free_cb(queue, cmd);
+      else
+         vk_free(queue->alloc, cmd->driver_data);
+   }
+
+   /* Commands and their payloads are released with the blocks. */
+   list_for_each_entry_safe(struct vk_cmd_queue_block, block,
+                            &queue->blocks, link) {
+      list_del(&block->link);
+      if (queue->free_blocks && block->size == VK_CMD_QUEUE_BLOCK_DATA_SIZE)
+         list_add(&block->link, queue->free_blocks);
+      else
+         vk_free(queue->alloc, block);
    }
+
+   queue->cursor = NULL;
+   queue->end = NULL;
 }
 
 void
@@ -470,7 +554,7 @@ def get_array_copy(command, param):
         field_size = "1"
     else:
         field_size = "sizeof(*%s)" % field_name
-    allocation = "%s = vk_zalloc(queue->alloc, %s * (%s), 8, VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);\n   if (%s == NULL) goto err;\n" % (field_name, field_size, param.len, field_name)
+    allocation = "%s = vk_cmd_queue_zalloc(queue, %s * (%s));\n   if (%s == NULL) goto err;\n" % (field_name, field_size, param.len, field_name)
     copy = "memcpy((void*)%s, %s, %s * (%s));" % (field_name, param.name, field_size, param.len)
     return "%s\n   %s" % (allocation, copy)
 
@@ -480,7 +564,7 @@ def get_array_member_copy(struct, src_name, member):
         field_size = "sizeof(*%s)" % (field_name)
     else:
         field_size = "sizeof(*%s) * %s->%s" % (field_name, struct, member.len)
-    allocation = "%s = vk_zalloc(queue->alloc, %s, 8, VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);\n   if (%s == NULL) goto err;\n" % (field_name, field_size, field_name)
+    allocation = "%s = vk_cmd_queue_zalloc(queue, %s);\n   if (%s == NULL) goto err;\n" % (field_name, field_size, field_name)
     copy = "memcpy((void*)%s, %s->%s, %s);" % (field_name, src_name, member.name, field_size)
     return "if (%s->%s) {\n   %s\n   %s\n}\n" % (src_name, member.name, allocation, copy)
 
@@ -516,7 +600,7 @@ def get_struct_copy(dst, src_name, src_type, size, types, level=0):
     global tmp_dst_idx
     global tmp_src_idx
 
-    allocation = "%s = vk_zalloc(queue->alloc, %s, 8, VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);\n      if (%s == NULL) goto err;\n" % (dst, size, dst)
+    allocation = "%s = vk_cmd_queue_zalloc(queue, %s);\n      if (%s == NULL) goto err;\n" % (dst, size, dst)
     copy = "memcpy((void*)%s, %s, %s);" % (dst, src_name, size)
 
     level += 1
@@ -536,19 +620,6 @@ def get_struct_copy(dst, src_name, src_type, size, types, level=0):
     indent = "   " * level
     return "%s\n      %s\n      %s\n      %s\n      %s\n      %s\n%s} else {\n      %s\n%s}" % (if_stmt, allocation, copy, tmp_dst, tmp_src, member_copies, indent, null_assignment, indent)
 
-def get_struct_free(command, param, types):
-    field_name = "cmd->u.%s.%s" % (to_struct_field_name(command.name), to_field_name(param.name))
-    const_cast = remove_suffix(param.decl.replace("const", ""), param.name)
-    struct_free = "vk_free(queue->alloc, (%s)%s);" % (const_cast, field_name)
-    member_frees = ""
-    if (param.type in types):
-        for member in types[param.type].members:
-            if member.len and member.len != 'null-terminated':
-                member_name = "cmd->u.%s.%s->%s" % (to_struct_field_name(command.name), to_field_name(param.name), member.name)
-                const_cast = remove_suffix(member.decl.replace("const", ""), member.name)
-                member_frees += "vk_free(queue->alloc, (%s)%s);\n" % (const_cast, member_name)
-    return "%s      %s\n" % (member_frees, struct_free)
-
 EntrypointType = namedtuple('EntrypointType', 'name enum members extended_by guard')
 
 def get_types_defines(doc):
@@ -666,7 +737,6 @@ def main():
         'to_struct_name': to_struct_name,
         'get_array_copy': get_array_copy,
         'get_struct_copy': get_struct_copy,
-        'get_struct_free': get_struct_free,
         'types': types,
         'manual_commands': MANUAL_COMMANDS,
         'no_enqueue_commands': NO_ENQUEUE_COMMANDS,
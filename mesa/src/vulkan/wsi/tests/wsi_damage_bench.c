@@ -0,0 +1,131 @@
+/*
+ * Copyright 2025 Mesa3D authors
+ * SPDX-License-Identifier: MIT
+ */
+
+/*
+ * Present bandwidth of the software WSI copies for partial updates: a
+ * swapchain of 1920x1080 RGBA images is presented in FIFO order with a
+ * moving cursor and a text line as VkPresentRegionKHR damage, once copying
+ * whole images and once copying only the damage.
+ *
+ * Usage: ./wsi_damage_bench [presents] [images]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "wsi_common_private.h"
+
+#include "util/os_time.h"
+
+#define WIDTH 1920
+#define HEIGHT 1080
+#define CPP 4
+#define STRIDE (WIDTH * CPP)
+#define MAX_IMAGES 8
+
+static void
+fill_rect(uint8_t *frame, const VkRectLayerKHR *rect, uint32_t value)
+{
+   for (uint32_t y = 0; y < rect->extent.height; y++) {
+      uint32_t *row = (uint32_t *)(frame + (rect->offset.y + y) * STRIDE) +
+                      rect->offset.x;
+      for (uint32_t x = 0; x < rect->extent.width; x++)
+         row[x] = value + x;
+   }
+}
+
+static void
+run(const char *name, unsigned presents, unsigned image_count,
+    bool use_damage)
+{
+   struct wsi_swapchain chain;
+   struct wsi_image images[MAX_IMAGES];
+   uint8_t *rendered[MAX_IMAGES], *presentable[MAX_IMAGES];
+   uint8_t *frame = calloc(1, STRIDE * HEIGHT);
+   uint64_t copied = 0;
+   int64_t copy_ns = 0;
+
+   memset(&chain, 0, sizeof(chain));
+   memset(images, 0, sizeof(images));
+   for (unsigned i = 0; i < image_count; i++) {
+      rendered[i] = malloc(STRIDE * HEIGHT);
+      presentable[i] = malloc(STRIDE * HEIGHT);
+   }
+
+   for (unsigned p = 0; p < presents; p++) {
+      const unsigned i = p % image_count;
+      const VkRectLayerKHR rects[2] = {
+         /* Cursor */
+         {
+            .offset = { (p * 7) % (WIDTH - 64), (p * 5) % (HEIGHT - 64) },
+            .extent = { 64, 64 },
+         },
+         /* Text line */
+         {
+            .offset = { 100, 1000 },
+            .extent = { 8 * (p % 50 + 1), 20 },
+         },
+      };
+      const VkPresentRegionKHR region = {
+         .rectangleCount = ARRAY_SIZE(rects),
+         .pRectangles = rects,
+      };
+
+      for (unsigned r = 0; r < ARRAY_SIZE(rects); r++)
+         fill_rect(frame, &rects[r], p * 2654435761u + r);
+
+      /* The application renders the whole frame. */
+      memcpy(rendered[i], frame, STRIDE * HEIGHT);
+
+      struct wsi_damage present_damage;
+      wsi_damage_init_from_region(&present_damage,
+                                  use_damage ? &region : NULL,
+                                  (VkExtent2D) { WIDTH, HEIGHT });
+      wsi_swapchain_update_image_damage(&chain, &images[i], &present_damage);
+
+      int64_t start = os_time_get_nano();
+      wsi_copy_damage(&images[i].damage, presentable[i], rendered[i],
+                      STRIDE, CPP, HEIGHT);
+      copy_ns += os_time_get_nano() - start;
+
+      if (images[i].damage.full) {
+         copied += STRIDE * HEIGHT;
+      } else {
+         for (unsigned r = 0; r < images[i].damage.rect_count; r++) {
+            copied += (uint64_t)images[i].damage.rects[r].extent.width *
+                      images[i].damage.rects[r].extent.height * CPP;
+         }
+      }
+
+      images[i].present_serial = ++chain.present_serial;
+      wsi_swapchain_push_damage(&chain, &present_damage);
+   }
+
+   printf("%s: %8.1f KiB/present, %8.2f us/present\n", name,
+          copied / 1024.0 / presents, copy_ns / 1000.0 / presents);
+
+   for (unsigned i = 0; i < image_count; i++) {
+      free(rendered[i]);
+      free(presentable[i]);
+   }
+   free(frame);
+}
+
+int
+main(int argc, char **argv)
+{
+   unsigned presents = argc > 1 ? atoi(argv[1]) : 600;
+   unsigned image_count = argc > 2 ? atoi(argv[2]) : 3;
+
+   image_count = CLAMP(image_count, 1, MAX_IMAGES);
+   if (presents == 0)
+      return 0;
+
+   run("full  ", presents, image_count, false);
+   run("damage", presents, image_count, true);
+
+   return 0;
+}
@@ -0,0 +1,325 @@
+/*
+ * Copyright 2025 Mesa3D authors
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "wsi_common_private.h"
+
+/* What the blit command buffers were recorded with. */
+static std::vector<VkCommandBuffer> begun;
+static std::vector<VkBufferImageCopy> copies;
+
+static VKAPI_ATTR VkResult VKAPI_CALL
+stub_BeginCommandBuffer(VkCommandBuffer commandBuffer,
+                        const VkCommandBufferBeginInfo *pBeginInfo)
+{
+   begun.push_back(commandBuffer);
+   return VK_SUCCESS;
+}
+
+static VKAPI_ATTR VkResult VKAPI_CALL
+stub_EndCommandBuffer(VkCommandBuffer commandBuffer)
+{
+   return VK_SUCCESS;
+}
+
+static VKAPI_ATTR void VKAPI_CALL
+stub_CmdPipelineBarrier(VkCommandBuffer commandBuffer,
+                        VkPipelineStageFlags srcStageMask,
+                        VkPipelineStageFlags dstStageMask,
+                        VkDependencyFlags dependencyFlags,
+                        uint32_t memoryBarrierCount,
+                        const VkMemoryBarrier *pMemoryBarriers,
+                        uint32_t bufferMemoryBarrierCount,
+                        const VkBufferMemoryBarrier *pBufferMemoryBarriers,
+                        uint32_t imageMemoryBarrierCount,
+                        const VkImageMemoryBarrier *pImageMemoryBarriers)
+{
+}
+
+static VKAPI_ATTR void VKAPI_CALL
+stub_CmdCopyImageToBuffer(VkCommandBuffer commandBuffer, VkImage srcImage,
+                          VkImageLayout srcImageLayout, VkBuffer dstBuffer,
+                          uint32_t regionCount,
+                          const VkBufferImageCopy *pRegions)
+{
+   copies.insert(copies.end(), pRegions, pRegions + regionCount);
+}
+
+static VkRect2D
+rect(int32_t x, int32_t y, uint32_t width, uint32_t height)
+{
+   return (VkRect2D) { { x, y }, { width, height } };
+}
+
+class wsi_damage_blit_test : public ::testing::Test {
+protected:
+   wsi_damage_blit_test()
+   {
+      wsi = {};
+      wsi.BeginCommandBuffer = stub_BeginCommandBuffer;
+      wsi.EndCommandBuffer = stub_EndCommandBuffer;
+      wsi.CmdPipelineBarrier = stub_CmdPipelineBarrier;
+      wsi.CmdCopyImageToBuffer = stub_CmdCopyImageToBuffer;
+
+      chain = {};
+      chain.wsi = &wsi;
+      chain.blit.type = WSI_SWAPCHAIN_BUFFER_BLIT;
+      chain.image_info.create.format = VK_FORMAT_B8G8R8A8_UNORM;
+      chain.image_info.create.extent = { width, height, 1 };
+      chain.image_info.linear_stride = stride;
+
+      image = {};
+      image.blit.cmd_buffers = cmd_buffers;
+      image.blit.damage_cmd_buffers = damage_cmd_buffers;
+
+      begun.clear();
+      copies.clear();
+   }
+
+   const VkCommandBuffer *
+   present_blit()
+   {
+      const VkCommandBuffer *cmd_buffer;
+
+      EXPECT_EQ(wsi_get_present_blit_cmd_buffer(&chain, &image, 1,
+                                                &cmd_buffer),
+                VK_SUCCESS);
+      return cmd_buffer;
+   }
+
+   static const uint32_t width = 100;
+   static const uint32_t height = 50;
+   /* Rows padded to 512 bytes, i.e. 128 pixels. */
+   static const uint32_t stride = 512;
+
+   VkCommandBuffer cmd_buffers[2] = {
+      (VkCommandBuffer)(uintptr_t)0x10, (VkCommandBuffer)(uintptr_t)0x11,
+   };
+   VkCommandBuffer damage_cmd_buffers[2] = {
+      (VkCommandBuffer)(uintptr_t)0x20, (VkCommandBuffer)(uintptr_t)0x21,
+   };
+
+   struct wsi_device wsi;
+   struct wsi_swapchain chain;
+   struct wsi_image image;
+};
+
+TEST(wsi_damage, buffer_image_copies_full)
+{
+   const VkExtent3D extent = { 100, 50, 1 };
+   struct wsi_damage damage = {};
+   VkBufferImageCopy regions[WSI_MAX_DAMAGE_RECTS];
+
+   damage.full = true;
+   wsi_damage_add_rect(&damage, rect(1, 2, 3, 4));
+
+   /* A full damage and no damage at all copy the whole image. */
+   const struct wsi_damage *full_damages[] = { &damage, NULL };
+   for (const struct wsi_damage *full : full_damages) {
+      ASSERT_EQ(wsi_damage_get_buffer_image_copies(full, extent, 512, 4,
+                                                   regions), 1);
+      EXPECT_EQ(regions[0].bufferOffset, 0);
+      EXPECT_EQ(regions[0].bufferRowLength, 128);
+      EXPECT_EQ(regions[0].bufferImageHeight, 0);
+      EXPECT_EQ(regions[0].imageSubresource.aspectMask,
+                VK_IMAGE_ASPECT_COLOR_BIT);
+      EXPECT_EQ(regions[0].imageSubresource.layerCount, 1);
+      EXPECT_EQ(regions[0].imageOffset.x, 0);
+      EXPECT_EQ(regions[0].imageOffset.y, 0);
+      EXPECT_EQ(regions[0].imageExtent.width, 100);
+      EXPECT_EQ(regions[0].imageExtent.height, 50);
+      EXPECT_EQ(regions[0].imageExtent.depth, 1);
+   }
+}
+
+TEST(wsi_damage, buffer_image_copies_rects)
+{
+   const VkExtent3D extent = { 100, 50, 1 };
+   struct wsi_damage damage = {};
+   VkBufferImageCopy regions[WSI_MAX_DAMAGE_RECTS];
+
+   EXPECT_EQ(wsi_damage_get_buffer_image_copies(&damage, extent, 512, 4,
+                                                regions), 0);
+
+   wsi_damage_add_rect(&damage, rect(0, 0, 8, 2));
+   wsi_damage_add_rect(&damage, rect(10, 20, 30, 5));
+   wsi_damage_add_rect(&damage, rect(99, 49, 1, 1));
+   ASSERT_EQ(damage.rect_count, 3);
+   ASSERT_EQ(wsi_damage_get_buffer_image_copies(&damage, extent, 512, 4,
+                                                regions), 3);
+
+   /* Each rectangle is at the same place in the buffer as in the image, with
+    * the padded row length.
+    */
+   const VkDeviceSize offsets[] = { 0, 20 * 512 + 10 * 4, 49 * 512 + 99 * 4 };
+   for (uint32_t i = 0; i < 3; i++) {
+      EXPECT_EQ(regions[i].bufferOffset, offsets[i]);
+      EXPECT_EQ(regions[i].bufferRowLength, 128);
+      EXPECT_EQ(regions[i].bufferImageHeight, 0);
+      EXPECT_EQ(regions[i].imageSubresource.aspectMask,
+                VK_IMAGE_ASPECT_COLOR_BIT);
+      EXPECT_EQ(regions[i].imageSubresource.layerCount, 1);
+      EXPECT_EQ(regions[i].imageOffset.x, damage.rects[i].offset.x);
+      EXPECT_EQ(regions[i].imageOffset.y, damage.rects[i].offset.y);
+      EXPECT_EQ(regions[i].imageOffset.z, 0);
+      EXPECT_EQ(regions[i].imageExtent.width, damage.rects[i].extent.width);
+      EXPECT_EQ(regions[i].imageExtent.height, damage.rects[i].extent.height);
+      EXPECT_EQ(regions[i].imageExtent.depth, 1);
+   }
+}
+
+TEST_F(wsi_damage_blit_test, full)
+{
+   /* Full damage submits the blit recorded at swapchain creation. */
+   image.damage.full = true;
+   EXPECT_EQ(present_blit(), &cmd_buffers[1]);
+   EXPECT_TRUE(begun.empty());
+
+   /* So do swapchains without damage command buffers. */
+   image.damage.full = false;
+   wsi_damage_add_rect(&image.damage, rect(0, 0, 1, 1));
+   image.blit.damage_cmd_buffers = NULL;
+   EXPECT_EQ(present_blit(), &cmd_buffers[1]);
+   EXPECT_TRUE(begun.empty());
+}
+
+TEST_F(wsi_damage_blit_test, rects)
+{
+   wsi_damage_add_rect(&image.damage, rect(10, 20, 30, 5));
+   wsi_damage_add_rect(&image.damage, rect(60, 0, 4, 4));
+
+   EXPECT_EQ(present_blit(), &damage_cmd_buffers[1]);
+   EXPECT_EQ(begun, std::vector<VkCommandBuffer>({ damage_cmd_buffers[1] }));
+   ASSERT_EQ(copies.size(), 2);
+   EXPECT_EQ(copies[0].bufferOffset, 20 * stride + 10 * 4);
+   EXPECT_EQ(copies[0].imageExtent.width, 30);
+   EXPECT_EQ(copies[1].bufferOffset, 60 * 4);
+   EXPECT_EQ(copies[1].imageExtent.height, 4);
+}
+
+TEST_F(wsi_damage_blit_test, empty)
+{
+   /* Nothing changed: the present submits no command buffer at all. */
+   EXPECT_EQ(present_blit(), nullptr);
+   EXPECT_TRUE(begun.empty());
+   EXPECT_TRUE(copies.empty());
+
+   /* Empty rectangles don't damage anything either. */
+   wsi_damage_add_rect(&image.damage, rect(5, 5, 0, 10));
+   EXPECT_EQ(present_blit(), nullptr);
+   EXPECT_TRUE(begun.empty());
+}
+
+class wsi_damage_present_test : public ::testing::Test {
+protected:
+   wsi_damage_present_test()
+   {
+      chain = {};
+      for (unsigned i = 0; i < image_count; i++) {
+         images[i] = {};
+         rendered[i].resize(stride * height);
+         presentable[i].resize(stride * height);
+      }
+      frame.resize(stride * height);
+   }
+
+   void
+   fill_rect(const VkRectLayerKHR &rect, uint32_t value)
+   {
+      for (uint32_t y = 0; y < rect.extent.height; y++) {
+         uint32_t *row =
+            (uint32_t *)&frame[(rect.offset.y + y) * stride] + rect.offset.x;
+         for (uint32_t x = 0; x < rect.extent.width; x++)
+            row[x] = value + x;
+      }
+   }
+
+   /* Presents the frame with a moving cursor and a growing text line drawn
+    * into it, in FIFO order, and returns the number of bytes copied into
+    * the presentable image.
+    */
+   uint64_t
+   present(unsigned p, bool use_damage)
+   {
+      const unsigned i = p % image_count;
+      VkRectLayerKHR rects[2] = {};
+      rects[0].offset = { (int32_t)(p * 7 % (width - 16)),
+                          (int32_t)(p * 5 % (height - 16)) };
+      rects[0].extent = { 16, 16 };
+      rects[1].offset = { 10, 50 };
+      rects[1].extent = { 4 * (p % 20 + 1), 8 };
+
+      VkPresentRegionKHR region = {};
+      region.rectangleCount = ARRAY_SIZE(rects);
+      region.pRectangles = rects;
+
+      for (unsigned r = 0; r < ARRAY_SIZE(rects); r++)
+         fill_rect(rects[r], p * 2654435761u + r);
+
+      /* The application renders the whole frame. */
+      rendered[i] = frame;
+
+      struct wsi_damage present_damage;
+      wsi_damage_init_from_region(&present_damage,
+                                  use_damage ? &region : NULL,
+                                  { width, height });
+      wsi_swapchain_update_image_damage(&chain, &images[i], &present_damage);
+      wsi_copy_damage(&images[i].damage, presentable[i].data(),
+                      rendered[i].data(), stride, cpp, height);
+
+      uint64_t copied = 0;
+      if (images[i].damage.full) {
+         copied = stride * height;
+      } else {
+         for (unsigned r = 0; r < images[i].damage.rect_count; r++) {
+            copied += (uint64_t)images[i].damage.rects[r].extent.width *
+                      images[i].damage.rects[r].extent.height * cpp;
+         }
+      }
+
+      images[i].present_serial = ++chain.present_serial;
+      wsi_swapchain_push_damage(&chain, &present_damage);
+
+      return copied;
+   }
+
+   static const uint32_t width = 128;
+   static const uint32_t height = 64;
+   static const uint32_t cpp = 4;
+   static const uint32_t stride = width * cpp;
+   static const unsigned image_count = 3;
+
+   struct wsi_swapchain chain;
+   struct wsi_image images[image_count];
+   std::vector<uint8_t> rendered[image_count];
+   std::vector<uint8_t> presentable[image_count];
+   std::vector<uint8_t> frame;
+};
+
+TEST_F(wsi_damage_present_test, presents)
+{
+   const unsigned presents = 60;
+   uint64_t copied = 0;
+
+   /* Each presentable image catches up with what changed since it was last
+    * presented, which is less than copying the whole image every time.
+    */
+   for (unsigned p = 0; p < presents; p++) {
+      copied += present(p, true);
+      ASSERT_EQ(presentable[p % image_count], frame) << "present " << p;
+   }
+   EXPECT_LT(copied, (uint64_t)presents * stride * height);
+}
+
+TEST_F(wsi_damage_present_test, presents_full)
+{
+   for (unsigned p = 0; p < 10; p++) {
+      EXPECT_EQ(present(p, false), stride * height);
+      ASSERT_EQ(presentable[p % image_count], frame) << "present " << p;
+   }
+}
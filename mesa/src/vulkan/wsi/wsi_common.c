@@ -473,10 +473,12 @@ wsi_swapchain_init(const struct wsi_device *wsi,
             continue;
       }
 
+      /* Software WSI re-records the damage blits on each present. */
       const VkCommandPoolCreateInfo cmd_pool_info = {
          .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
          .pNext = NULL,
-         .flags = 0,
+         .flags = wsi->sw ?
+                  VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT : 0,
          .queueFamilyIndex = queue_family_index,
       };
       result = wsi->CreateCommandPool(_device, &cmd_pool_info, &chain->alloc,
@@ -794,8 +796,13 @@ wsi_destroy_image(const struct wsi_swapchain *chain,
             continue;
          wsi->FreeCommandBuffers(chain->device, chain->cmd_pools[i],
                                  1, &image->blit.cmd_buffers[i]);
+         if (image->blit.damage_cmd_buffers) {
+            wsi->FreeCommandBuffers(chain->device, chain->cmd_pools[i],
+                                    1, &image->blit.damage_cmd_buffers[i]);
+         }
       }
       vk_free(&chain->alloc, image->blit.cmd_buffers);
+      vk_free(&chain->alloc, image->blit.damage_cmd_buffers);
    }
 
    wsi->FreeMemory(chain->device, image->memory, &chain->alloc);
@@ -1384,6 +1391,10 @@ wsi_common_queue_present(const struct wsi_device *wsi,
       uint32_t image_index = pPresentInfo->pImageIndices[i];
       VkResult result;
 
+      const VkPresentRegionKHR *region = NULL;
+      if (regions && regions->pRegions)
+         region = &regions->pRegions[i];
+
       /* Update the present mode for this present and any subsequent present.
        * Only update the present mode when MESA_VK_WSI_PRESENT_MODE is not used.
        * We should also turn any VkSwapchainPresentModesCreateInfoEXT into a nop,
@@ -1451,12 +1462,35 @@ wsi_common_queue_present(const struct wsi_device *wsi,
       struct wsi_image *image =
          swapchain->get_wsi_image(swapchain, image_index);
 
+      /* Software WSI copies images on the CPU or with the blit command
+       * buffers, only copy what changed since the image was last presented.
+       */
+      struct wsi_damage present_damage;
+      if (wsi->sw) {
+         const VkExtent2D extent = {
+            .width = swapchain->image_info.create.extent.width,
+            .height = swapchain->image_info.create.extent.height,
+         };
+         wsi_damage_init_from_region(&present_damage, region, extent);
+         wsi_swapchain_update_image_damage(swapchain, image, &present_damage);
+      }
+
       VkQueue submit_queue = queue;
       if (swapchain->blit.type != WSI_SWAPCHAIN_NO_BLIT) {
          if (swapchain->blit.queue == VK_NULL_HANDLE) {
-            submit_info.commandBufferCount = 1;
-            submit_info.pCommandBuffers =
-               &image->blit.cmd_buffers[queue_family_index];
+            /* The fence wait above guarantees that the previous blit of
+             * this image is done, so its damage command buffer can be
+             * recorded again.
+             */
+            const VkCommandBuffer *blit_cmd_buffer;
+            result = wsi_get_present_blit_cmd_buffer(swapchain, image,
+                                                     queue_family_index,
+                                                     &blit_cmd_buffer);
+            if (result != VK_SUCCESS)
+               goto fail_present;
+
+            submit_info.commandBufferCount = blit_cmd_buffer != NULL;
+            submit_info.pCommandBuffers = blit_cmd_buffer;
          } else {
             /* If we are using a blit using the driver's private queue, then
              * do an empty submit signalling a semaphore, and then submit the
@@ -1541,6 +1575,8 @@ wsi_common_queue_present(const struct wsi_device *wsi,
       assert(image->acquired);
       image->acquired = false;
       image->present_serial = ++swapchain->present_serial;
+      if (wsi->sw)
+         wsi_swapchain_push_damage(swapchain, &present_damage);
 
       if (!explicit_sync) {
 #ifdef HAVE_LIBDRM
@@ -1558,10 +1594,6 @@ wsi_common_queue_present(const struct wsi_device *wsi,
 	      wsi->WaitForFences(device, 1, &swapchain->fences[image_index],
 				 true, ~0ull);
 
-      const VkPresentRegionKHR *region = NULL;
-      if (regions && regions->pRegions)
-         region = &regions->pRegions[i];
-
       uint64_t present_id = 0;
       if (present_ids && present_ids->pPresentIds)
          present_id = present_ids->pPresentIds[i];
@@ -1891,6 +1923,157 @@ wsi_create_buffer_blit_context(const struct wsi_swapchain *chain,
    return VK_SUCCESS;
 }
 
+VkResult
+wsi_record_blit(const struct wsi_swapchain *chain,
+                const struct wsi_image_info *info,
+                const struct wsi_image *image,
+                VkCommandBuffer cmd_buffer,
+                const struct wsi_damage *damage)
+{
+   const struct wsi_device *wsi = chain->wsi;
+
+   const VkCommandBufferBeginInfo begin_info = {
+      .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+   };
+   wsi->BeginCommandBuffer(cmd_buffer, &begin_info);
+
+   VkImageMemoryBarrier img_mem_barriers[] = {
+      {
+         .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+         .pNext = NULL,
+         .srcAccessMask = 0,
+         .dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT,
+         .oldLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+         .newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+         .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+         .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+         .image = image->image,
+         .subresourceRange = {
+            .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+            .baseMipLevel = 0,
+            .levelCount = 1,
+            .baseArrayLayer = 0,
+            .layerCount = 1,
+         },
+      },
+      {
+         .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+         .pNext = NULL,
+         .srcAccessMask = 0,
+         .dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+         .oldLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+         .newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+         .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+         .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+         .image = image->blit.image,
+         .subresourceRange = {
+            .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+            .baseMipLevel = 0,
+            .levelCount = 1,
+            .baseArrayLayer = 0,
+            .layerCount = 1,
+         },
+      },
+   };
+   uint32_t img_mem_barrier_count =
+      chain->blit.type == WSI_SWAPCHAIN_BUFFER_BLIT ? 1 : 2;
+   wsi->CmdPipelineBarrier(cmd_buffer,
+                           VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                           VK_PIPELINE_STAGE_TRANSFER_BIT,
+                           0,
+                           0, NULL,
+                           0, NULL,
+                           1, img_mem_barriers);
+
+   if (chain->blit.type == WSI_SWAPCHAIN_BUFFER_BLIT) {
+      const uint32_t cpp = vk_format_get_blocksize(info->create.format);
+      struct VkBufferImageCopy buffer_image_copies[WSI_MAX_DAMAGE_RECTS];
+      const uint32_t copy_count =
+         wsi_damage_get_buffer_image_copies(damage, info->create.extent,
+                                            info->linear_stride, cpp,
+                                            buffer_image_copies);
+
+      if (copy_count > 0) {
+         wsi->CmdCopyImageToBuffer(cmd_buffer,
+                                   image->image,
+                                   VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                                   image->blit.buffer,
+                                   copy_count, buffer_image_copies);
+      }
+   } else {
+      struct VkImageCopy image_copy = {
+         .srcSubresource = {
+            .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+            .mipLevel = 0,
+            .baseArrayLayer = 0,
+            .layerCount = 1,
+         },
+         .srcOffset = { .x = 0, .y = 0, .z = 0 },
+         .dstSubresource = {
+            .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+            .mipLevel = 0,
+            .baseArrayLayer = 0,
+            .layerCount = 1,
+         },
+         .dstOffset = { .x = 0, .y = 0, .z = 0 },
+         .extent = info->create.extent,
+      };
+
+      wsi->CmdCopyImage(cmd_buffer,
+                        image->image,
+                        VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                        image->blit.image,
+                        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                        1, &image_copy);
+   }
+
+   img_mem_barriers[0].srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+   img_mem_barriers[0].dstAccessMask = 0;
+   img_mem_barriers[0].oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+   img_mem_barriers[0].newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+   img_mem_barriers[1].srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+   img_mem_barriers[1].dstAccessMask = 0;
+   img_mem_barriers[1].oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+   img_mem_barriers[1].newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+   wsi->CmdPipelineBarrier(cmd_buffer,
+                           VK_PIPELINE_STAGE_TRANSFER_BIT,
+                           VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                           0,
+                           0, NULL,
+                           0, NULL,
+                           img_mem_barrier_count, img_mem_barriers);
+
+   return wsi->EndCommandBuffer(cmd_buffer);
+}
+
+VkResult
+wsi_get_present_blit_cmd_buffer(const struct wsi_swapchain *chain,
+                                const struct wsi_image *image,
+                                uint32_t queue_family_index,
+                                const VkCommandBuffer **cmd_buffer)
+{
+   if (!image->blit.damage_cmd_buffers || image->damage.full) {
+      *cmd_buffer = &image->blit.cmd_buffers[queue_family_index];
+      return VK_SUCCESS;
+   }
+
+   /* Nothing changed since the image was last presented. */
+   if (image->damage.rect_count == 0) {
+      *cmd_buffer = NULL;
+      return VK_SUCCESS;
+   }
+
+   VkResult result =
+      wsi_record_blit(chain, &chain->image_info, image,
+                      image->blit.damage_cmd_buffers[queue_family_index],
+                      &image->damage);
+   if (result != VK_SUCCESS)
+      return result;
+
+   *cmd_buffer = &image->blit.damage_cmd_buffers[queue_family_index];
+   return VK_SUCCESS;
+}
+
 VkResult
 wsi_finish_create_blit_context(const struct wsi_swapchain *chain,
                                const struct wsi_image_info *info,
@@ -1908,6 +2091,19 @@ wsi_finish_create_blit_context(const struct wsi_swapchain *chain,
    if (!image->blit.cmd_buffers)
       return VK_ERROR_OUT_OF_HOST_MEMORY;
 
+   /* Software WSI copies only the damage of each present to the buffer,
+    * see wsi_common_queue_present().
+    */
+   if (wsi->sw && chain->blit.type == WSI_SWAPCHAIN_BUFFER_BLIT &&
+       chain->blit.queue == VK_NULL_HANDLE) {
+      image->blit.damage_cmd_buffers =
+         vk_zalloc(&chain->alloc,
+                   sizeof(VkCommandBuffer) * cmd_buffer_count, 8,
+                   VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+      if (!image->blit.damage_cmd_buffers)
+         return VK_ERROR_OUT_OF_HOST_MEMORY;
+   }
+
    for (uint32_t i = 0; i < cmd_buffer_count; i++) {
       if (!chain->cmd_pools[i])
          continue;
@@ -1924,123 +2120,15 @@ wsi_finish_create_blit_context(const struct wsi_swapchain *chain,
       if (result != VK_SUCCESS)
          return result;
 
-      const VkCommandBufferBeginInfo begin_info = {
-         .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
-      };
-      wsi->BeginCommandBuffer(image->blit.cmd_buffers[i], &begin_info);
-
-      VkImageMemoryBarrier img_mem_barriers[] = {
-         {
-            .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
-            .pNext = NULL,
-            .srcAccessMask = 0,
-            .dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT,
-            .oldLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
-            .newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-            .image = image->image,
-            .subresourceRange = {
-               .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
-               .baseMipLevel = 0,
-               .levelCount = 1,
-               .baseArrayLayer = 0,
-               .layerCount = 1,
-            },
-         },
-         {
-            .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
-            .pNext = NULL,
-            .srcAccessMask = 0,
-            .dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
-            .oldLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
-            .newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-            .image = image->blit.image,
-            .subresourceRange = {
-               .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
-               .baseMipLevel = 0,
-               .levelCount = 1,
-               .baseArrayLayer = 0,
-               .layerCount = 1,
-            },
-         },
-      };
-      uint32_t img_mem_barrier_count =
-         chain->blit.type == WSI_SWAPCHAIN_BUFFER_BLIT ? 1 : 2;
-      wsi->CmdPipelineBarrier(image->blit.cmd_buffers[i],
-                              VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
-                              VK_PIPELINE_STAGE_TRANSFER_BIT,
-                              0,
-                              0, NULL,
-                              0, NULL,
-                              1, img_mem_barriers);
-
-      if (chain->blit.type == WSI_SWAPCHAIN_BUFFER_BLIT) {
-         struct VkBufferImageCopy buffer_image_copy = {
-            .bufferOffset = 0,
-            .bufferRowLength = info->linear_stride /
-                               vk_format_get_blocksize(info->create.format),
-            .bufferImageHeight = 0,
-            .imageSubresource = {
-               .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
-               .mipLevel = 0,
-               .baseArrayLayer = 0,
-               .layerCount = 1,
-            },
-            .imageOffset = { .x = 0, .y = 0, .z = 0 },
-            .imageExtent = info->create.extent,
-         };
-         wsi->CmdCopyImageToBuffer(image->blit.cmd_buffers[i],
-                                   image->image,
-                                   VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-                                   image->blit.buffer,
-                                   1, &buffer_image_copy);
-      } else {
-         struct VkImageCopy image_copy = {
-            .srcSubresource = {
-               .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
-               .mipLevel = 0,
-               .baseArrayLayer = 0,
-               .layerCount = 1,
-            },
-            .srcOffset = { .x = 0, .y = 0, .z = 0 },
-            .dstSubresource = {
-               .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
-               .mipLevel = 0,
-               .baseArrayLayer = 0,
-               .layerCount = 1,
-            },
-            .dstOffset = { .x = 0, .y = 0, .z = 0 },
-            .extent = info->create.extent,
-         };
-
-         wsi->CmdCopyImage(image->blit.cmd_buffers[i],
-                           image->image,
-                           VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-                           image->blit.image,
-                           VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                           1, &image_copy);
+      if (image->blit.damage_cmd_buffers) {
+         result = wsi->AllocateCommandBuffers(chain->device, &cmd_buffer_info,
+                                              &image->blit.damage_cmd_buffers[i]);
+         if (result != VK_SUCCESS)
+            return result;
       }
 
-      img_mem_barriers[0].srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-      img_mem_barriers[0].dstAccessMask = 0;
-      img_mem_barriers[0].oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-      img_mem_barriers[0].newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
-      img_mem_barriers[1].srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-      img_mem_barriers[1].dstAccessMask = 0;
-      img_mem_barriers[1].oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-      img_mem_barriers[1].newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
-      wsi->CmdPipelineBarrier(image->blit.cmd_buffers[i],
-                              VK_PIPELINE_STAGE_TRANSFER_BIT,
-                              VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
-                              0,
-                              0, NULL,
-                              0, NULL,
-                              img_mem_barrier_count, img_mem_barriers);
-
-      result = wsi->EndCommandBuffer(image->blit.cmd_buffers[i]);
+      result = wsi_record_blit(chain, info, image,
+                               image->blit.cmd_buffers[i], NULL);
       if (result != VK_SUCCESS)
          return result;
    }
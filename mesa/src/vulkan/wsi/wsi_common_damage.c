@@ -0,0 +1,185 @@
+/*
+ * Copyright 2025 Mesa3D authors
+ * SPDX-License-Identifier: MIT
+ */
+
+/*
+ * Damage tracking for the software WSI paths.
+ *
+ * Each swapchain image has its own presentable copy, a blit buffer or a
+ * shm buffer, which was last updated when that image was last presented.
+ * VkPresentRegionKHR only describes what changed since the previous present
+ * of any image, so what an image has to copy is the damage of all the
+ * presents since its own last one, like EGL buffer age.
+ */
+
+#include "wsi_common_private.h"
+
+#include <string.h>
+
+#include "util/macros.h"
+
+static VkRect2D
+rect_union(VkRect2D a, VkRect2D b)
+{
+   const int32_t x0 = MIN2(a.offset.x, b.offset.x);
+   const int32_t y0 = MIN2(a.offset.y, b.offset.y);
+   const int32_t x1 = MAX2(a.offset.x + a.extent.width,
+                           b.offset.x + b.extent.width);
+   const int32_t y1 = MAX2(a.offset.y + a.extent.height,
+                           b.offset.y + b.extent.height);
+
+   return (VkRect2D) {
+      .offset = { x0, y0 },
+      .extent = { x1 - x0, y1 - y0 },
+   };
+}
+
+void
+wsi_damage_add_rect(struct wsi_damage *damage, VkRect2D rect)
+{
+   if (damage->full || rect.extent.width == 0 || rect.extent.height == 0)
+      return;
+
+   if (damage->rect_count < WSI_MAX_DAMAGE_RECTS) {
+      damage->rects[damage->rect_count++] = rect;
+      return;
+   }
+
+   /* Out of rectangles, fall back to the bounding box of everything. */
+   for (uint32_t i = 1; i < damage->rect_count; i++)
+      rect = rect_union(rect, damage->rects[i]);
+   damage->rects[0] = rect_union(rect, damage->rects[0]);
+   damage->rect_count = 1;
+}
+
+void
+wsi_damage_init_from_region(struct wsi_damage *damage,
+                            const VkPresentRegionKHR *region,
+                            VkExtent2D extent)
+{
+   damage->rect_count = 0;
+
+   /* No rectangles means the whole image changed. */
+   damage->full = region == NULL || region->pRectangles == NULL ||
+                  region->rectangleCount == 0;
+   if (damage->full)
+      return;
+
+   for (uint32_t i = 0; i < region->rectangleCount; i++) {
+      const VkRectLayerKHR *rect = &region->pRectangles[i];
+
+      /* Applications are required to stay within the image, but we use
+       * these to copy memory, so better safe than sorry.
+       */
+      const int64_t x0 = CLAMP(rect->offset.x, 0, (int64_t)extent.width);
+      const int64_t y0 = CLAMP(rect->offset.y, 0, (int64_t)extent.height);
+      const int64_t x1 = CLAMP((int64_t)rect->offset.x + rect->extent.width,
+                               x0, (int64_t)extent.width);
+      const int64_t y1 = CLAMP((int64_t)rect->offset.y + rect->extent.height,
+                               y0, (int64_t)extent.height);
+
+      wsi_damage_add_rect(damage, (VkRect2D) {
+         .offset = { x0, y0 },
+         .extent = { x1 - x0, y1 - y0 },
+      });
+   }
+}
+
+void
+wsi_swapchain_update_image_damage(struct wsi_swapchain *chain,
+                                  struct wsi_image *image,
+                                  const struct wsi_damage *present_damage)
+{
+   image->damage = *present_damage;
+
+   /* Never presented, or presented too long ago. */
+   if (image->present_serial == 0 ||
+       chain->present_serial - image->present_serial >
+       WSI_DAMAGE_HISTORY_SIZE) {
+      image->damage.full = true;
+      return;
+   }
+
+   for (uint64_t serial = image->present_serial + 1;
+        serial <= chain->present_serial && !image->damage.full; serial++) {
+      const struct wsi_damage *past =
+         &chain->damage_history[serial % WSI_DAMAGE_HISTORY_SIZE];
+
+      image->damage.full |= past->full;
+      for (uint32_t i = 0; i < past->rect_count; i++)
+         wsi_damage_add_rect(&image->damage, past->rects[i]);
+   }
+}
+
+void
+wsi_swapchain_push_damage(struct wsi_swapchain *chain,
+                          const struct wsi_damage *present_damage)
+{
+   chain->damage_history[chain->present_serial % WSI_DAMAGE_HISTORY_SIZE] =
+      *present_damage;
+}
+
+void
+wsi_copy_damage(const struct wsi_damage *damage, void *dst, const void *src,
+                uint32_t stride, uint32_t cpp, uint32_t height)
+{
+   if (damage->full) {
+      memcpy(dst, src, (size_t)stride * height);
+      return;
+   }
+
+   for (uint32_t i = 0; i < damage->rect_count; i++) {
+      const VkRect2D *rect = &damage->rects[i];
+      const size_t offset = (size_t)rect->offset.y * stride +
+                            (size_t)rect->offset.x * cpp;
+      const size_t row_size = (size_t)rect->extent.width * cpp;
+
+      for (uint32_t y = 0; y < rect->extent.height; y++) {
+         memcpy((uint8_t *)dst + offset + (size_t)y * stride,
+                (const uint8_t *)src + offset + (size_t)y * stride,
+                row_size);
+      }
+   }
+}
+
+uint32_t
+wsi_damage_get_buffer_image_copies(const struct wsi_damage *damage,
+                                   VkExtent3D extent, uint32_t stride,
+                                   uint32_t cpp, VkBufferImageCopy *copies)
+{
+   const VkBufferImageCopy copy = {
+      .bufferRowLength = stride / cpp,
+      .imageSubresource = {
+         .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+         .mipLevel = 0,
+         .baseArrayLayer = 0,
+         .layerCount = 1,
+      },
+      .imageExtent = extent,
+   };
+
+   if (damage == NULL || damage->full) {
+      copies[0] = copy;
+      return 1;
+   }
+
+   /* The buffer has the same layout as the linear image, so each rectangle
+    * lands at the same place in it.
+    */
+   for (uint32_t i = 0; i < damage->rect_count; i++) {
+      const VkRect2D *rect = &damage->rects[i];
+
+      copies[i] = copy;
+      copies[i].bufferOffset = (VkDeviceSize)rect->offset.y * stride +
+                               (VkDeviceSize)rect->offset.x * cpp;
+      copies[i].imageOffset = (VkOffset3D) {
+         rect->offset.x, rect->offset.y, 0,
+      };
+      copies[i].imageExtent = (VkExtent3D) {
+         rect->extent.width, rect->extent.height, 1,
+      };
+   }
+
+   return damage->rect_count;
+}
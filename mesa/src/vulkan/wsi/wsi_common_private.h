@@ -131,6 +131,24 @@ struct wsi_image_explicit_sync_timeline {
    uint32_t handle;
 };
 
+/* Damage tracking for the software paths, which copy images on the CPU or
+ * from the blit command buffers and only need to copy what changed.  More
+ * rectangles are merged into their bounding box.
+ */
+#define WSI_MAX_DAMAGE_RECTS 16
+
+/* Number of presents whose damage a swapchain remembers.  Images presented
+ * longer ago than that are copied whole.
+ */
+#define WSI_DAMAGE_HISTORY_SIZE 8
+
+struct wsi_damage {
+   /* The whole image is damaged, rects are ignored */
+   bool full;
+   uint32_t rect_count;
+   VkRect2D rects[WSI_MAX_DAMAGE_RECTS];
+};
+
 enum wsi_swapchain_blit_type {
    WSI_SWAPCHAIN_NO_BLIT,
    WSI_SWAPCHAIN_BUFFER_BLIT,
@@ -146,6 +164,11 @@ struct wsi_image {
       VkImage image;
       VkDeviceMemory memory;
       VkCommandBuffer *cmd_buffers;
+
+      /* For software WSI, re-recorded on each present to only copy
+       * wsi_image::damage.
+       */
+      VkCommandBuffer *damage_cmd_buffers;
    } blit;
    /* Whether or not the image has been acquired
     * on the CPU side via acquire_next_image.
@@ -153,6 +176,11 @@ struct wsi_image {
    bool acquired;
    uint64_t present_serial;
 
+   /* For software WSI, what changed since this image was last presented,
+    * i.e. what the current present has to copy.
+    */
+   struct wsi_damage damage;
+
    struct wsi_image_explicit_sync_timeline explicit_sync[WSI_ES_COUNT];
 
 #ifndef _WIN32
@@ -187,6 +215,11 @@ struct wsi_swapchain {
 
    uint64_t present_serial;
 
+   /* For software WSI, the damage of the last presents, indexed by present
+    * serial modulo WSI_DAMAGE_HISTORY_SIZE.
+    */
+   struct wsi_damage damage_history[WSI_DAMAGE_HISTORY_SIZE];
+
    struct {
       enum wsi_swapchain_blit_type type;
       VkSemaphore *semaphores;
@@ -301,6 +334,53 @@ wsi_finish_create_blit_context(const struct wsi_swapchain *chain,
                                const struct wsi_image_info *info,
                                struct wsi_image *image);
 
+VkResult
+wsi_record_blit(const struct wsi_swapchain *chain,
+                const struct wsi_image_info *info,
+                const struct wsi_image *image,
+                VkCommandBuffer cmd_buffer,
+                const struct wsi_damage *damage);
+
+/* Returns the command buffer blitting image when it is presented from
+ * queue_family_index, recording the damage one again for software WSI, or
+ * NULL when nothing changed since the image was last presented.
+ */
+VkResult
+wsi_get_present_blit_cmd_buffer(const struct wsi_swapchain *chain,
+                                const struct wsi_image *image,
+                                uint32_t queue_family_index,
+                                const VkCommandBuffer **cmd_buffer);
+
+void
+wsi_damage_init_from_region(struct wsi_damage *damage,
+                            const VkPresentRegionKHR *region,
+                            VkExtent2D extent);
+
+void
+wsi_damage_add_rect(struct wsi_damage *damage, VkRect2D rect);
+
+void
+wsi_swapchain_update_image_damage(struct wsi_swapchain *chain,
+                                  struct wsi_image *image,
+                                  const struct wsi_damage *present_damage);
+
+void
+wsi_swapchain_push_damage(struct wsi_swapchain *chain,
+                          const struct wsi_damage *present_damage);
+
+void
+wsi_copy_damage(const struct wsi_damage *damage, void *dst, const void *src,
+                uint32_t stride, uint32_t cpp, uint32_t height);
+
+/* Fills copies with the regions of a linear image a buffer blit has to copy
+ * for damage, a NULL damage meaning the whole image, and returns how many
+ * there are.  copies must have room for WSI_MAX_DAMAGE_RECTS regions.
+ */
+uint32_t
+wsi_damage_get_buffer_image_copies(const struct wsi_damage *damage,
+                                   VkExtent3D extent, uint32_t stride,
+                                   uint32_t cpp, VkBufferImageCopy *copies);
+
 void
 wsi_configure_buffer_image(UNUSED const struct wsi_swapchain *chain,
                            const VkSwapchainCreateInfoKHR *pCreateInfo,
@@ -37,6 +37,7 @@
 
 #include "vk_instance.h"
 #include "vk_device.h"
+#include "vk_format.h"
 #include "vk_physical_device.h"
 #include "vk_util.h"
 #include "wsi_common_entrypoints.h"
@@ -2455,8 +2456,10 @@ wsi_wl_swapchain_queue_present(struct wsi_swapchain *wsi_chain,
 
    if (chain->buffer_type == WSI_WL_BUFFER_SHM_MEMCPY) {
       struct wsi_wl_image *image = &chain->images[image_index];
-      memcpy(image->shm_ptr, image->base.cpu_map,
-             image->base.row_pitches[0] * chain->extent.height);
+      wsi_copy_damage(&image->base.damage, image->shm_ptr,
+                      image->base.cpu_map, image->base.row_pitches[0],
+                      vk_format_get_blocksize(chain->vk_format),
+                      chain->extent.height);
    }
 
    /* For EXT_swapchain_maintenance1. We might have transitioned from FIFO to MAILBOX.